@@ -0,0 +1,55 @@
+"""
+bench_crc16.py
+
+AIRMAN – Receiver-side CRC16 micro-benchmark
+--------------------------------------------
+
+Compares the original bit-by-bit Python CRC16 loop with the
+binascii.crc_hqx path now used by the receivers, on a typical
+Level-2 payload.
+
+Usage:
+    python bench_crc16.py
+"""
+
+import binascii
+import timeit
+
+PAYLOAD = b"L2,123456,12.34,-5.67,181.02,100.05,30.00"
+
+
+def crc16_bitwise(data: bytes) -> int:
+    """Original receiver implementation (reference)."""
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = (crc << 1) ^ 0x1021
+            else:
+                crc <<= 1
+            crc &= 0xFFFF
+    return crc
+
+
+def crc16_hqx(data: bytes) -> int:
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def main():
+    assert crc16_bitwise(b"123456789") == crc16_hqx(b"123456789") == 0x29B1
+    assert crc16_bitwise(PAYLOAD) == crc16_hqx(PAYLOAD)
+
+    number = 20000
+    results = {}
+    for name, fn in (("bitwise", crc16_bitwise), ("crc_hqx", crc16_hqx)):
+        sec = min(timeit.repeat(lambda: fn(PAYLOAD), number=number, repeat=5))
+        results[name] = sec / number
+        print(f"{name:8s} {results[name] * 1e9:10.1f} ns/frame  "
+              f"{len(PAYLOAD) / results[name] / 1e6:8.2f} MB/s")
+
+    print(f"speedup  {results['bitwise'] / results['crc_hqx']:.0f}x")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,184 @@
+/*
+ * bench_prng.c
+ *
+ * AIRMAN – Noise generator check and benchmark
+ * --------------------------------------------
+ *
+ * Times rand() against the xoshiro256** streams (prng.h) for uniform
+ * noise, and the ziggurat against Box–Muller for Gaussian noise. Also
+ * checks that a (seed, stream) pair reproduces its sequence, that
+ * streams differ, and that the Gaussian moments and tail mass match
+ * N(0, 1).
+ *
+ * Build & run:
+ *   gcc -O2 bench_prng.c prng.c bench_suite.c -o bench_prng -lm
+ *   ./bench_prng [--quick] [--csv PATH] [--baseline PATH]
+ *
+ * Timing goes through the shared harness (bench_suite.h), one sample
+ * per op.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_suite.h"
+#include "prng.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define SAMPLES   (1 << 24)
+#define BLOCK     4096
+
+static volatile float sink;
+static prng_t         rng;
+static float          block[BLOCK];
+
+/* The noise() the simulators used before prng.h */
+static float rand_noise(float amp)
+{
+    return ((float)rand() / RAND_MAX) * 2.0f * amp - amp;
+}
+
+static float box_muller(prng_t *p)
+{
+    float u1 = 1.0f - prng_uniform(p);
+    float u2 = prng_uniform(p);
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * (float)M_PI * u2);
+}
+
+/* ---------------- timed cases: n samples each ---------------- */
+
+static void run_rand(void *ctx, long n)
+{
+    (void)ctx;
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++)
+        acc += rand_noise(0.1f);
+    sink = acc;
+}
+
+static void run_uniform(void *ctx, long n)
+{
+    (void)ctx;
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++)
+        acc += prng_uniform_pm(&rng, 0.1f);
+    sink = acc;
+}
+
+static void run_fill_uniform(void *ctx, long n)
+{
+    (void)ctx;
+    float acc = 0.0f;
+    for (long i = 0; i < n; i += BLOCK) {
+        int len = n - i < BLOCK ? (int)(n - i) : BLOCK;
+        prng_fill_uniform(&rng, block, len, 0.1f);
+        acc += block[0];
+    }
+    sink = acc;
+}
+
+static void run_box_muller(void *ctx, long n)
+{
+    (void)ctx;
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++)
+        acc += box_muller(&rng);
+    sink = acc;
+}
+
+static void run_gauss(void *ctx, long n)
+{
+    (void)ctx;
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++)
+        acc += prng_gauss(&rng);
+    sink = acc;
+}
+
+static void run_fill_gauss(void *ctx, long n)
+{
+    (void)ctx;
+    float acc = 0.0f;
+    for (long i = 0; i < n; i += BLOCK) {
+        int len = n - i < BLOCK ? (int)(n - i) : BLOCK;
+        prng_fill_gauss(&rng, block, len, 0.1f);
+        acc += block[0];
+    }
+    sink = acc;
+}
+
+/* Speedup of case over base, both possibly filtered out */
+static void report(const bench_case_t *c, const bench_case_t *base)
+{
+    if (c && base)
+        printf("%-22s %6.1fx\n", c->name, base->ns_per_op / c->ns_per_op);
+}
+
+int main(int argc, char **argv)
+{
+    prng_t a, b;
+    int fail = 0;
+
+    /* Reproducibility and stream separation */
+    prng_seed(&a, 42, 1);
+    prng_seed(&b, 42, 1);
+    for (int i = 0; i < 1000; i++)
+        if (prng_next_u64(&a) != prng_next_u64(&b))
+            fail = 1;
+    prng_seed(&b, 42, 2);
+    if (prng_next_u64(&a) == prng_next_u64(&b))
+        fail = 1;
+    printf("reproducible streams: %s\n", fail ? "FAIL" : "PASS");
+
+    /* Gaussian moments */
+    double m1 = 0, m2 = 0, m4 = 0;
+    long beyond3 = 0;
+    prng_seed(&a, 1, 0);
+    for (int i = 0; i < SAMPLES; i++) {
+        double x = prng_gauss(&a);
+        m1 += x;
+        m2 += x * x;
+        m4 += x * x * x * x;
+        beyond3 += fabs(x) > 3.0;
+    }
+    m1 /= SAMPLES;
+    m2 /= SAMPLES;
+    m4 /= SAMPLES;
+    double tail = (double)beyond3 / SAMPLES;
+    int moments_ok = fabs(m1) < 1e-3 && fabs(m2 - 1.0) < 2e-3 &&
+                     fabs(m4 - 3.0) < 2e-2 && fabs(tail - 0.0026998) < 1e-4;
+    printf("gauss: mean %+.5f  var %.5f  kurt %.4f  P(|x|>3) %.6f  %s\n",
+           m1, m2, m4, tail, moments_ok ? "PASS" : "FAIL");
+    fail |= !moments_ok;
+
+    bench_suite_t suite;
+    if (bench_suite_init(&suite, "prng", argc, argv) != 0)
+        return 2;
+
+    srand(1);
+    prng_seed(&rng, 1, 0);
+    const bench_case_t *c_rand  = bench_run(&suite, "rand()", "sample", run_rand, NULL);
+    const bench_case_t *c_uni   = bench_run(&suite, "prng_uniform_pm", "sample",
+                                            run_uniform, NULL);
+    const bench_case_t *c_ufill = bench_run(&suite, "prng_fill_uniform", "sample",
+                                            run_fill_uniform, NULL);
+    const bench_case_t *c_bm    = bench_run(&suite, "box-muller", "sample",
+                                            run_box_muller, NULL);
+    const bench_case_t *c_zig   = bench_run(&suite, "prng_gauss (ziggurat)", "sample",
+                                            run_gauss, NULL);
+    const bench_case_t *c_gfill = bench_run(&suite, "prng_fill_gauss", "sample",
+                                            run_fill_gauss, NULL);
+
+    printf("\nuniform noise vs rand()\n");
+    report(c_uni, c_rand);
+    report(c_ufill, c_rand);
+    printf("gaussian noise vs box-muller\n");
+    report(c_zig, c_bm);
+    report(c_gfill, c_bm);
+
+    return bench_suite_finish(&suite) | fail;
+}
@@ -0,0 +1,211 @@
+/*
+ * bench_suite.c
+ *
+ * AIRMAN – Benchmark harness and regression check (see bench_suite.h)
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench_suite.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+int64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void)
+{
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [--csv PATH] [--baseline PATH] [--tolerance PCT]\n"
+            "          [--quick] [--filter STR] [ARG...]\n", prog);
+}
+
+int bench_suite_init(bench_suite_t *s, const char *suite,
+                     int argc, char **argv)
+{
+    memset(s, 0, sizeof(*s));
+    s->suite         = suite;
+    s->tolerance_pct = BENCH_TOLERANCE_PCT;
+    s->min_ns        = BENCH_MIN_NS;
+    s->repeats       = BENCH_REPEATS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+            s->csv_path = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+            s->baseline_path = argv[++i];
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc)
+            s->tolerance_pct = atof(argv[++i]);
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            s->filter = argv[++i];
+        else if (strcmp(argv[i], "--quick") == 0) {
+            s->min_ns  = BENCH_MIN_NS / 10;
+            s->repeats = 3;
+        } else if (argv[i][0] != '-' && s->n_args < BENCH_MAX_ARGS)
+            s->args[s->n_args++] = argv[i];
+        else {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+long bench_arg(const bench_suite_t *s, int i, long def)
+{
+    return i < s->n_args ? atol(s->args[i]) : def;
+}
+
+/* ============================================================
+ * TIMING
+ * ============================================================
+ */
+
+const bench_case_t *bench_run(bench_suite_t *s, const char *name,
+                              const char *unit, bench_fn_t fn, void *ctx)
+{
+    if (s->filter && !strstr(name, s->filter))
+        return NULL;
+    if (s->n_cases == BENCH_MAX_CASES) {
+        fprintf(stderr, "bench: too many cases, %s skipped\n", name);
+        return NULL;
+    }
+
+    /* Grow n until one call is long enough to time (also warms up) */
+    long n = 1024;
+    for (;;) {
+        int64_t t0 = bench_now_ns();
+        fn(ctx, n);
+        if (bench_now_ns() - t0 >= s->min_ns || n > LONG_MAX / 2)
+            break;
+        n *= 2;
+    }
+
+    int64_t  best = INT64_MAX;
+    uint64_t best_cycles = 0;
+    for (int r = 0; r < s->repeats; r++) {
+        uint64_t c0 = now_cycles();
+        int64_t  t0 = bench_now_ns();
+        fn(ctx, n);
+        int64_t  dt = bench_now_ns() - t0;
+        uint64_t dc = now_cycles() - c0;
+        if (dt < best) {
+            best        = dt;
+            best_cycles = dc;
+        }
+    }
+
+    /* Table header with the first row, after any output of the program */
+    if (s->n_cases == 0)
+        printf("%-24s %12s %10s %16s\n", "case", "ns/op", "cycles/op",
+               "per second");
+
+    bench_case_t *c = &s->cases[s->n_cases++];
+    c->name      = name;
+    c->unit      = unit;
+    c->ops       = n;
+    c->ns_per_op = (double)best / (double)n;
+    c->cycles_per_op = (double)best_cycles / (double)n;
+
+    printf("%-24s %12.2f %10.1f %16.0f %s\n", name, c->ns_per_op,
+           c->cycles_per_op, 1e9 / c->ns_per_op, unit);
+    fflush(stdout);
+    return c;
+}
+
+/* ============================================================
+ * CSV OUTPUT AND BASELINE COMPARISON
+ * ============================================================
+ */
+
+static int write_csv(const bench_suite_t *s)
+{
+    FILE *f = fopen(s->csv_path, "w");
+    if (!f) {
+        perror(s->csv_path);
+        return -1;
+    }
+    fprintf(f, "suite,name,unit,ns_per_op,per_sec,ops,cycles_per_op\n");
+    for (int i = 0; i < s->n_cases; i++) {
+        const bench_case_t *c = &s->cases[i];
+        fprintf(f, "%s,%s,%s,%.3f,%.0f,%ld,%.1f\n", s->suite, c->name, c->unit,
+                c->ns_per_op, 1e9 / c->ns_per_op, c->ops, c->cycles_per_op);
+    }
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+/* ns/op of suite/name in the baseline file, or a negative value */
+static double baseline_ns(FILE *f, const char *suite, const char *name)
+{
+    char line[256];
+    rewind(f);
+    while (fgets(line, sizeof(line), f)) {
+        char b_suite[64], b_name[64];
+        double ns;
+        if (sscanf(line, "%63[^,],%63[^,],%*[^,],%lf", b_suite, b_name, &ns) == 3 &&
+            strcmp(b_suite, suite) == 0 && strcmp(b_name, name) == 0)
+            return ns;
+    }
+    return -1.0;
+}
+
+static int compare_baseline(const bench_suite_t *s)
+{
+    FILE *f = fopen(s->baseline_path, "r");
+    if (!f) {
+        perror(s->baseline_path);
+        return -1;
+    }
+
+    int regressions = 0;
+    printf("\nvs %s (tolerance %.1f %%)\n", s->baseline_path, s->tolerance_pct);
+    for (int i = 0; i < s->n_cases; i++) {
+        const bench_case_t *c = &s->cases[i];
+        double base = baseline_ns(f, s->suite, c->name);
+        if (base <= 0.0) {
+            printf("%-24s %12s\n", c->name, "new");
+            continue;
+        }
+        double pct = (c->ns_per_op / base - 1.0) * 100.0;
+        int slow = pct > s->tolerance_pct;
+        regressions += slow;
+        printf("%-24s %12.2f -> %8.2f ns  %+6.1f %%%s\n", c->name, base,
+               c->ns_per_op, pct, slow ? "  REGRESSION" : "");
+    }
+    fclose(f);
+
+    if (regressions)
+        printf("%d regression(s)\n", regressions);
+    return regressions ? 1 : 0;
+}
+
+int bench_suite_finish(bench_suite_t *s)
+{
+    int status = 0;
+    if (s->csv_path && write_csv(s) != 0)
+        status = 1;
+    if (s->baseline_path && compare_baseline(s) != 0)
+        status = 1;
+    return status;
+}
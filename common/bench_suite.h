@@ -0,0 +1,116 @@
+/*
+ * bench_suite.h
+ *
+ * AIRMAN – Benchmark Harness and Regression Check
+ * -----------------------------------------------
+ *
+ * Shared driver for the benchmarks: the pipeline suites
+ * (level1/bench_telemetry_tx.c, level2/bench_pipeline.c) and the
+ * check-and-time programs next to the modules they cover (bench_crc16,
+ * bench_prng, bench_siggen, bench_madgwick, bench_euler, ...), which keep
+ * their accuracy checks local and time through bench_run(). Each case
+ * is a function that performs n operations of one kind (one noise draw,
+ * one sensor sample, one frame):
+ *
+ *   static void run_noise(void *ctx, long n)
+ *   {
+ *       for (long i = 0; i < n; i++)
+ *           sink += noise(rng, 0.1f);
+ *   }
+ *
+ *   bench_suite_t s;
+ *   if (bench_suite_init(&s, "l1", argc, argv) != 0)
+ *       return 2;
+ *   bench_run(&s, "noise", "op", run_noise, NULL);
+ *   ...
+ *   return bench_suite_finish(&s);
+ *
+ * Timing:
+ *   n is doubled until one call takes at least BENCH_MIN_NS, then the
+ *   call is repeated BENCH_REPEATS times and the fastest run is kept
+ *   (the least disturbed by interrupts and frequency ramps). Cases
+ *   must use fixed seeds so every build times the same work. On x86
+ *   the same run is also counted in TSC cycles.
+ *
+ * Output:
+ *   an aligned table on stdout (ns/op, cycles/op, units/s), and with
+ *   --csv PATH one row per case:
+ *
+ *     suite,name,unit,ns_per_op,per_sec,ops,cycles_per_op
+ *
+ * Regression check:
+ *   --baseline PATH compares every case with the row of the same suite
+ *   and name in an earlier --csv file, and the run fails (exit 1) if
+ *   any case is more than --tolerance percent (default 10) slower.
+ *   Cases missing from the baseline are reported but do not fail.
+ *
+ * Other options:
+ *   --quick        shorter runs (BENCH_MIN_NS / 10, 3 repeats)
+ *   --filter STR   only run cases whose name contains STR
+ *
+ * Arguments that are not options (a sample count, a stream count) are
+ * left to the program: bench_arg() returns them in order.
+ */
+
+#ifndef AIRMAN_BENCH_SUITE_H
+#define AIRMAN_BENCH_SUITE_H
+
+#include <stdint.h>
+
+#define BENCH_MAX_CASES     32
+#define BENCH_MIN_NS        50000000LL    /* 50 ms per timed call */
+#define BENCH_REPEATS       5
+#define BENCH_TOLERANCE_PCT 10.0
+#define BENCH_MAX_ARGS      4
+
+typedef void (*bench_fn_t)(void *ctx, long n);
+
+typedef struct {
+    const char *name;
+    const char *unit;        /* what one op is: "op", "sample", "frame" */
+    double      ns_per_op;
+    double      cycles_per_op;  /* 0 without a cycle counter */
+    long        ops;         /* ops per timed call */
+} bench_case_t;
+
+typedef struct {
+    const char  *suite;
+    const char  *csv_path;
+    const char  *baseline_path;
+    const char  *filter;
+    double       tolerance_pct;
+    long long    min_ns;
+    int          repeats;
+
+    int          n_args;
+    const char  *args[BENCH_MAX_ARGS];
+
+    int          n_cases;
+    bench_case_t cases[BENCH_MAX_CASES];
+} bench_suite_t;
+
+/* Parses the options above; prints usage and returns -1 on bad ones */
+int bench_suite_init(bench_suite_t *s, const char *suite,
+                     int argc, char **argv);
+
+/* Positional argument i as a number, or def if it was not given */
+long bench_arg(const bench_suite_t *s, int i, long def);
+
+/*
+ * Times one case and prints its table row. Returns the result, for
+ * programs that derive further figures (speedups, bytes/cycle), or
+ * NULL if the case was filtered out.
+ */
+const bench_case_t *bench_run(bench_suite_t *s, const char *name,
+                              const char *unit, bench_fn_t fn, void *ctx);
+
+/*
+ * Writes the CSV and runs the baseline comparison. Returns the exit
+ * status: 0, or 1 on a regression or an unreadable / unwritable file.
+ */
+int bench_suite_finish(bench_suite_t *s);
+
+/* Monotonic nanoseconds */
+int64_t bench_now_ns(void);
+
+#endif /* AIRMAN_BENCH_SUITE_H */
@@ -0,0 +1,117 @@
+/*
+ * binframe.c
+ *
+ * AIRMAN – Binary telemetry frame builder / decoder (see binframe.h)
+ */
+
+#include <string.h>
+
+#include "binframe.h"
+
+/* Raw byte i of the frame being staged */
+#define RAW(f, i)   ((f)->wire[1 + (i)])
+
+void binframe_begin(binframe_t *f, uint8_t *wire, uint8_t type)
+{
+    f->wire = wire;
+    RAW(f, 0) = type;
+    f->len  = 1;
+    checksum_init(&f->crc, CHECKSUM_CRC16);
+    checksum_update(&f->crc, &RAW(f, 0), 1);
+}
+
+void binframe_put_u32(binframe_t *f, uint32_t v)
+{
+    if (f->len + 4 > BINFRAME_MAX_PAYLOAD)
+        return;
+
+    /* Explicit byte order: identical on every host and MCU */
+    uint8_t *p = &RAW(f, f->len);
+    p[0] = (uint8_t)(v);
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    checksum_update(&f->crc, p, 4);
+    f->len += 4;
+}
+
+void binframe_put_f32(binframe_t *f, float v)
+{
+    /* IEEE-754 bit pattern, sent as a little-endian u32 */
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    binframe_put_u32(f, bits);
+}
+
+void binframe_put_u8(binframe_t *f, uint8_t v)
+{
+    if (f->len + 1 > BINFRAME_MAX_PAYLOAD)
+        return;
+    RAW(f, f->len) = v;
+    checksum_update(&f->crc, &RAW(f, f->len), 1);
+    f->len++;
+}
+
+void binframe_put_u16(binframe_t *f, uint16_t v)
+{
+    if (f->len + 2 > BINFRAME_MAX_PAYLOAD)
+        return;
+    uint8_t *p = &RAW(f, f->len);
+    p[0] = (uint8_t)(v);
+    p[1] = (uint8_t)(v >> 8);
+    checksum_update(&f->crc, p, 2);
+    f->len += 2;
+}
+
+void binframe_put_varint(binframe_t *f, uint32_t v)
+{
+    uint8_t buf[5];
+    size_t  n = 0;
+
+    while (v >= 0x80) {
+        buf[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = (uint8_t)v;
+
+    /* All or nothing, like the fixed-size fields */
+    if (f->len + n > BINFRAME_MAX_PAYLOAD)
+        return;
+    memcpy(&RAW(f, f->len), buf, n);
+    checksum_update(&f->crc, buf, n);
+    f->len += n;
+}
+
+void binframe_put_svarint(binframe_t *f, int32_t v)
+{
+    binframe_put_varint(f, binframe_zigzag(v));
+}
+
+size_t binframe_finish(binframe_t *f)
+{
+    uint16_t crc = checksum_final(&f->crc);
+
+    RAW(f, f->len) = (uint8_t)(crc);
+    f->len++;
+    RAW(f, f->len) = (uint8_t)(crc >> 8);
+    f->len++;
+
+    size_t n = cobs_encode_inplace(f->wire, f->len);
+    f->wire[n++] = BINFRAME_DELIM;
+    return n;
+}
+
+size_t binframe_decode(const uint8_t *wire, size_t len, uint8_t *raw)
+{
+    size_t n = cobs_decode(wire, len, raw);
+
+    /* At least a type byte and the CRC */
+    if (n == (size_t)-1 || n < 3)
+        return 0;
+
+    n -= 2;
+    uint16_t recv = (uint16_t)(raw[n] | raw[n + 1] << 8);
+    if (crc16_ccitt(raw, n) != recv)
+        return 0;
+    return n;
+}
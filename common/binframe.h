@@ -0,0 +1,189 @@
+/*
+ * binframe.h
+ *
+ * AIRMAN – Binary Telemetry Frames
+ * --------------------------------
+ *
+ * Compact alternative to the ASCII "$Lx,...*CHK" frames. Fields are
+ * serialized as little-endian values instead of formatted text, so the
+ * transmitter never touches printf-style float formatting in the loop.
+ *
+ * Wire format (one frame):
+ *
+ *   COBS( type | payload | crc16 ) 0x00
+ *
+ *   type    : 1 byte  (BINFRAME_TYPE_*)
+ *   payload : packed little-endian fields, layout fixed per type
+ *   crc16   : CRC16-CCITT (poly 0x1021, init 0xFFFF) over type+payload,
+ *             little-endian
+ *
+ * Payload layouts:
+ *
+ *   BINFRAME_TYPE_L1 (37 bytes incl. type)
+ *     u32 timestamp_ms
+ *     f32 ax, ay, az, gx, gy, gz, alt, temp
+ *
+ *   BINFRAME_TYPE_L2 (25 bytes incl. type)
+ *     u32 timestamp_ms
+ *     f32 roll, pitch, heading, alt, temp
+ *
+ *   BINFRAME_TYPE_L2S (33 bytes incl. type), loop statistics, one
+ *   frame per profiled stage (see ahrs_filter.c)
+ *     u32 timestamp_ms
+ *     f32 stage, count, min_us, p50_us, p99_us, max_us, overruns
+ *     (integers carried as f32 are exact below 2^24)
+ *
+ *   BINFRAME_TYPE_L2Q (29 bytes incl. type), L2 with the attitude as
+ *   the filter quaternion instead of Euler angles (ahrs_filter --quat)
+ *     u32 timestamp_ms
+ *     f32 q0, q1, q2, q3, alt, temp
+ *
+ *   BINFRAME_TYPE_DELTA (variable, ~14 bytes on the wire for L2), L2 or L2Q
+ *   quantized to the ASCII precision as keyframes and varint-coded
+ *   deltas (ahrs_filter --delta, layout in deltaframe.h)
+ *
+ *   BINFRAME_TYPE_BATCH (6 + K * (2 + 4 * values) bytes incl. type),
+ *   K consecutive L1 / L2 / L2Q samples under one header and CRC
+ *   (--batch in both transmitters)
+ *     u8  base type (BINFRAME_TYPE_L1 / _L2 / _L2Q)
+ *     u32 timestamp_ms of the first sample
+ *     K times:
+ *       u16 ms since the first sample
+ *       f32 the base layout's fields
+ *     (K follows from the length; at most BINFRAME_BATCH_MAX(values))
+ *
+ * The 0x00 delimiter lets a receiver resynchronize on the next frame
+ * after any byte loss, exactly like '\n' does for the ASCII format.
+ *
+ * Zero-copy builder: fields are serialized straight into the caller's
+ * wire buffer, one byte past the start (room for the COBS code byte),
+ * and the CRC is streamed as they are written. binframe_finish() then
+ * COBS-encodes in place, so the finished frame sits at the start of
+ * the same buffer, ready for write(2) or a UART DMA transfer.
+ *
+ * Receivers go the other way with binframe_decode() and read the
+ * fields with binframe_get_u16() / _u32() / _f32(), or the
+ * variable-length ones with binframe_get_varint().
+ *
+ * Varints are LEB128 (7 bits per byte, least significant first, high
+ * bit set on all but the last byte); signed values are zig-zag mapped
+ * first (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...), so small magnitudes of
+ * either sign take one byte.
+ */
+
+#ifndef AIRMAN_BINFRAME_H
+#define AIRMAN_BINFRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "checksum.h"
+#include "cobs.h"
+
+#define BINFRAME_TYPE_L1      0x01
+#define BINFRAME_TYPE_L2      0x02
+#define BINFRAME_TYPE_L2S     0x03
+#define BINFRAME_TYPE_L2Q     0x04
+#define BINFRAME_TYPE_DELTA   0x05   /* delta-compressed L2 / L2Q, deltaframe.h */
+#define BINFRAME_TYPE_BATCH   0x06   /* K samples of L1 / L2 / L2Q */
+
+#define BINFRAME_DELIM        0x00
+#define BINFRAME_MAX_PAYLOAD  250    /* type + fields, CRC excluded */
+
+/* Largest possible encoded frame including CRC and delimiter */
+#define BINFRAME_MAX_WIRE     (COBS_MAX_ENCODED(BINFRAME_MAX_PAYLOAD + 2) + 1)
+
+/* Batch frames: header, samples per frame, and the encoded size */
+#define BINFRAME_BATCH_HEADER     6      /* type, base type, u32 timestamp */
+#define BINFRAME_BATCH_RECORD(n_values)  (2 + 4 * (n_values))
+#define BINFRAME_BATCH_MAX(n_values) \
+    ((BINFRAME_MAX_PAYLOAD - BINFRAME_BATCH_HEADER) / BINFRAME_BATCH_RECORD(n_values))
+#define BINFRAME_BATCH_WIRE(k, n_values) \
+    (COBS_MAX_ENCODED(BINFRAME_BATCH_HEADER + \
+                      (k) * BINFRAME_BATCH_RECORD(n_values) + 2) + 1)
+
+typedef struct {
+    uint8_t   *wire;      /* caller buffer, BINFRAME_MAX_WIRE bytes */
+    size_t     len;       /* raw bytes staged at wire + 1 */
+    checksum_t crc;       /* CRC16 over everything staged so far */
+} binframe_t;
+
+/* Start a new frame of the given type in wire (BINFRAME_MAX_WIRE bytes) */
+void binframe_begin(binframe_t *f, uint8_t *wire, uint8_t type);
+
+/* Append little-endian fields (silently ignored once the frame is full) */
+void binframe_put_u32(binframe_t *f, uint32_t v);
+void binframe_put_f32(binframe_t *f, float v);
+void binframe_put_u8(binframe_t *f, uint8_t v);
+void binframe_put_u16(binframe_t *f, uint16_t v);
+void binframe_put_varint(binframe_t *f, uint32_t v);     /* 1-5 bytes */
+void binframe_put_svarint(binframe_t *f, int32_t v);     /* zig-zag */
+
+/*
+ * Append the CRC16 trailer, COBS-encode in place and terminate with
+ * 0x00. Returns the number of bytes to transmit from the start of the
+ * wire buffer.
+ */
+size_t binframe_finish(binframe_t *f);
+
+/*
+ * Decode one frame (the len bytes before its 0x00 delimiter) into raw:
+ * the type byte followed by the payload. raw must hold len bytes and
+ * may equal wire. Returns the type + payload length with the CRC
+ * checked and stripped, or 0 if the frame is malformed or the CRC
+ * does not match.
+ */
+size_t binframe_decode(const uint8_t *wire, size_t len, uint8_t *raw);
+
+/* Little-endian field readers for decoded payloads */
+static inline uint32_t binframe_get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 |
+           (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static inline uint16_t binframe_get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static inline float binframe_get_f32(const uint8_t *p)
+{
+    uint32_t bits = binframe_get_u32(p);
+    float    v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+/*
+ * Varint at p, not reading past end. Returns the byte after it, or
+ * NULL if it is truncated or longer than 5 bytes.
+ */
+static inline const uint8_t *binframe_get_varint(const uint8_t *p,
+                                                 const uint8_t *end,
+                                                 uint32_t *v)
+{
+    uint32_t acc = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7) {
+        uint8_t b = *p++;
+        acc |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = acc;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static inline uint32_t binframe_zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t binframe_unzigzag(uint32_t u)
+{
+    return (int32_t)((u >> 1) ^ (0u - (u & 1)));
+}
+
+#endif /* AIRMAN_BINFRAME_H */
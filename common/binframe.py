@@ -0,0 +1,238 @@
+"""
+binframe.py
+
+AIRMAN – Binary Telemetry Frame Decoder
+---------------------------------------
+
+Receiver-side counterpart of common/binframe.c.
+
+Wire format (one frame):
+
+    COBS( type | payload | crc16 ) 0x00
+
+- type    : 1 byte (TYPE_L1 / TYPE_L2 / TYPE_L2S / TYPE_L2Q / TYPE_DELTA /
+            TYPE_BATCH)
+- payload : packed little-endian fields, layout fixed per type
+- crc16   : CRC16-CCITT (poly 0x1021, init 0xFFFF) over type+payload,
+            little-endian
+
+Frames are split on the 0x00 delimiter, so a receiver that starts
+mid-stream (or loses bytes) resynchronizes on the next frame.
+
+TYPE_DELTA frames (common/deltaframe.h) carry an L2 / L2Q layout as
+scaled integers: keyframes and zig-zag varint changes against the
+previous frame. They are stateful, so they are expanded by a
+DeltaDecoder per link; iter_frames() keeps one for its stream.
+
+TYPE_BATCH frames carry K samples of an L1 / L2 / L2Q layout under one
+header and CRC; iter_frames() yields them as K ordinary frames.
+"""
+
+import binascii
+import struct
+
+TYPE_L1 = 0x01
+TYPE_L2 = 0x02
+TYPE_L2S = 0x03   # loop statistics (stage, count, min/p50/p99/max us, overruns)
+TYPE_L2Q = 0x04   # L2 with the attitude quaternion instead of Euler angles
+TYPE_DELTA = 0x05  # delta-compressed L2 / L2Q (scaled integers)
+TYPE_BATCH = 0x06  # K samples of L1 / L2 / L2Q, one header and CRC
+
+DELTA_KEY = 0x80        # base type byte: keyframe flag
+
+DELIM = b"\x00"
+
+# Field layouts per frame type (after the type byte, before the CRC)
+LAYOUTS = {
+    TYPE_L1: struct.Struct("<I8f"),   # ts, ax, ay, az, gx, gy, gz, alt, temp
+    TYPE_L2: struct.Struct("<I5f"),   # ts, roll, pitch, heading, alt, temp
+    TYPE_L2S: struct.Struct("<I7f"),  # ts, stage, count, min..max us, overruns
+    TYPE_L2Q: struct.Struct("<I6f"),  # ts, q0, q1, q2, q3, alt, temp
+}
+
+
+def crc16_ccitt(data: bytes) -> int:
+    """
+    CRC16-CCITT, identical to the transmitter (poly 0x1021, init 0xFFFF).
+
+    binascii.crc_hqx is the same MSB-first 0x1021 CRC, table-driven in C.
+    """
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def cobs_decode(data: bytes):
+    """
+    Decode one COBS block (delimiter already removed).
+
+    Returns the decoded bytes, or None if the block is malformed.
+    """
+    out = bytearray()
+    i = 0
+    n = len(data)
+
+    while i < n:
+        code = data[i]
+        if code == 0 or i + code > n:
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < n:
+            out.append(0)
+
+    return bytes(out)
+
+
+def read_varint(data: bytes, pos: int):
+    """LEB128 varint at data[pos]: (value, next_pos), or None if truncated."""
+    value = 0
+    for shift in range(0, 35, 7):
+        if pos >= len(data):
+            return None
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return value, pos
+    return None
+
+
+def unzigzag(u: int) -> int:
+    return (u >> 1) ^ -(u & 1)
+
+
+def wrap_i32(v: int) -> int:
+    """v as the transmitter's wrapping int32 arithmetic leaves it."""
+    return (v + 0x80000000) % 0x100000000 - 0x80000000
+
+
+class DeltaDecoder:
+    """
+    Reference values of one link's TYPE_DELTA frames (see
+    common/deltaframe.c). decode() returns (TYPE_DELTA, (base_type,
+    timestamp_ms, scaled values...)), or None for a malformed frame or
+    a delta frame whose reference was lost (counted in .unsynced).
+    """
+
+    def __init__(self):
+        self.synced = False
+        self.base_type = None
+        self.seq = 0
+        self.ts = 0
+        self.values = []
+        self.unsynced = 0
+
+    def decode(self, body: bytes):
+        if len(body) < 5 or body[0] != TYPE_DELTA:
+            self.synced = False
+            return None
+
+        base_type, key = body[1] & ~DELTA_KEY, body[1] & DELTA_KEY
+        seq = struct.unpack_from("<H", body, 2)[0]
+        if not key and (not self.synced or base_type != self.base_type or
+                        seq != (self.seq + 1) & 0xFFFF):
+            self.synced = False
+            self.unsynced += 1
+            return None
+
+        fields = []
+        pos = 4
+        while pos < len(body):
+            parsed = read_varint(body, pos)
+            if parsed is None:
+                self.synced = False
+                return None
+            fields.append(parsed[0])
+            pos = parsed[1]
+        if not fields or (not key and len(fields) != 1 + len(self.values)):
+            self.synced = False
+            return None
+
+        ts, values = fields[0], [unzigzag(u) for u in fields[1:]]
+        if key:
+            self.ts, self.values = ts, values
+        else:
+            self.ts = (self.ts + ts) & 0xFFFFFFFF
+            self.values = [wrap_i32(a + d) for a, d in zip(self.values, values)]
+        self.synced, self.base_type, self.seq = True, base_type, seq
+        return TYPE_DELTA, (base_type, self.ts) + tuple(self.values)
+
+
+def decode_batch(body: bytes):
+    """
+    Unpack a TYPE_BATCH body into (TYPE_BATCH, (base_type, frames)),
+    where frames holds one (timestamp_ms, values...) tuple per sample.
+    None if the base type or length is wrong.
+    """
+    layout = LAYOUTS.get(body[1]) if len(body) > 6 else None
+    if layout is None or body[1] == TYPE_L2S:
+        return None
+
+    n_values = (layout.size - 4) // 4
+    record = struct.Struct(f"<H{n_values}f")
+    if (len(body) - 6) % record.size:
+        return None
+
+    ts0 = struct.unpack_from("<I", body, 2)[0]
+    frames = []
+    for offset, *values in record.iter_unpack(body[6:]):
+        frames.append((ts0 + offset,) + tuple(values))
+    return TYPE_BATCH, (body[1], tuple(frames))
+
+
+def decode_frame(block: bytes, delta=None):
+    """
+    Validate and unpack one delimited frame.
+
+    Returns (frame_type, fields_tuple) or None if the frame is corrupt,
+    has a CRC mismatch, or has an unknown type / wrong length.
+    TYPE_DELTA frames need the link's DeltaDecoder (else None); see
+    decode_batch() for TYPE_BATCH results.
+    """
+    raw = cobs_decode(block)
+    if raw is None or len(raw) < 3:
+        return None
+
+    body, recv_crc = raw[:-2], raw[-2] | (raw[-1] << 8)
+    if crc16_ccitt(body) != recv_crc:
+        return None
+
+    if body[0] == TYPE_DELTA:
+        return delta.decode(body) if delta is not None else None
+    if body[0] == TYPE_BATCH:
+        return decode_batch(body)
+
+    layout = LAYOUTS.get(body[0])
+    if layout is None or len(body) - 1 != layout.size:
+        return None
+
+    return body[0], layout.unpack_from(body, 1)
+
+
+def iter_frames(stream, chunk_size=4096):
+    """
+    Yield decode_frame() results for every delimited frame on a binary
+    stream, batch frames as one result per sample. Corrupt frames (and
+    delta frames without a reference) are yielded as None so callers can
+    count them.
+    """
+    pending = b""
+    delta = DeltaDecoder()
+
+    while True:
+        chunk = stream.read1(chunk_size) if hasattr(stream, "read1") \
+            else stream.read(chunk_size)
+        if not chunk:
+            break
+
+        pending += chunk
+        *blocks, pending = pending.split(DELIM)
+        for block in blocks:
+            if not block:
+                continue
+            decoded = decode_frame(block, delta)
+            if decoded is not None and decoded[0] == TYPE_BATCH:
+                base_type, frames = decoded[1]
+                for fields in frames:
+                    yield base_type, fields
+            else:
+                yield decoded
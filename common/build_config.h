@@ -0,0 +1,44 @@
+/*
+ * build_config.h
+ *
+ * AIRMAN – Build Configuration
+ * ----------------------------
+ *
+ * Link formats compiled into the transmitters (level1/telemetry_tx.c,
+ * level2/ahrs_filter.c). The top-level Makefile sets them from the
+ * FORMATS variable of the selected profile (profiles/<name>.mk); a hand
+ * build without -D gets every format, as before.
+ *
+ *   AIRMAN_FORMATS   bitmask of the formats below
+ *                    (default ASCII | BINARY | DELTA)
+ *
+ *   -DAIRMAN_FORMATS=AIRMAN_FMT_BINARY
+ *   -DAIRMAN_FORMATS='(AIRMAN_FMT_ASCII|AIRMAN_FMT_BINARY)'
+ *
+ * A format that is not built is a compile-time constant 0 in the
+ * transmitter's format tests, so its encoder, the code behind its
+ * command-line option and the library objects it pulls in
+ * (txtframe.o, binframe.o, deltaframe.o, ...) are left out of the
+ * image. The command-line option is then rejected, and the default
+ * format is the first one built in the order below.
+ */
+
+#ifndef AIRMAN_BUILD_CONFIG_H
+#define AIRMAN_BUILD_CONFIG_H
+
+#define AIRMAN_FMT_ASCII    1       /* $L1 / $L2 text frames */
+#define AIRMAN_FMT_BINARY   2       /* COBS binary frames (binframe.h) */
+#define AIRMAN_FMT_DELTA    4       /* delta frames (deltaframe.h), L2 */
+
+#ifndef AIRMAN_FORMATS
+#define AIRMAN_FORMATS      (AIRMAN_FMT_ASCII | AIRMAN_FMT_BINARY | AIRMAN_FMT_DELTA)
+#endif
+
+#if (AIRMAN_FORMATS & (AIRMAN_FMT_ASCII | AIRMAN_FMT_BINARY | AIRMAN_FMT_DELTA)) == 0
+#error "AIRMAN_FORMATS selects no link format"
+#endif
+
+/* 1 if format f (ASCII, BINARY, DELTA) is built in */
+#define AIRMAN_HAS_FORMAT(f)    ((AIRMAN_FORMATS & AIRMAN_FMT_##f) != 0)
+
+#endif /* AIRMAN_BUILD_CONFIG_H */
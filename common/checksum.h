@@ -0,0 +1,73 @@
+/*
+ * checksum.h
+ *
+ * AIRMAN – Streaming Frame Checksums
+ * ----------------------------------
+ *
+ * init / update / final interface over both frame checksums, so a
+ * frame builder can feed bytes while the payload is being written
+ * instead of rescanning the finished frame:
+ *
+ *   CHECKSUM_XOR8    8-bit XOR of all bytes      (Level-1 ASCII frames)
+ *   CHECKSUM_CRC16   CRC16-CCITT, see crc16.h    (Level-2 ASCII, binary)
+ *
+ *   checksum_t c;
+ *   checksum_init(&c, CHECKSUM_CRC16);
+ *   checksum_update(&c, part1, n1);
+ *   checksum_update(&c, part2, n2);
+ *   uint16_t v = checksum_final(&c);
+ *
+ * Feeding the data in any split yields the same value as one call
+ * over the whole buffer.
+ */
+
+#ifndef AIRMAN_CHECKSUM_H
+#define AIRMAN_CHECKSUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crc16.h"
+
+typedef enum {
+    CHECKSUM_XOR8,
+    CHECKSUM_CRC16,
+} checksum_kind_t;
+
+typedef struct {
+    checksum_kind_t kind;
+    uint16_t        state;
+} checksum_t;
+
+static inline void checksum_init(checksum_t *c, checksum_kind_t kind)
+{
+    c->kind  = kind;
+    c->state = kind == CHECKSUM_CRC16 ? CRC16_CCITT_INIT : 0;
+}
+
+static inline void checksum_update(checksum_t *c, const void *data, size_t len)
+{
+    if (c->kind == CHECKSUM_CRC16) {
+        c->state = crc16_ccitt_update(c->state, data, len);
+    } else {
+        const uint8_t *p = data;
+        uint8_t x = (uint8_t)c->state;
+        for (size_t i = 0; i < len; i++)
+            x ^= p[i];
+        c->state = x;
+    }
+}
+
+/* Neither checksum has a final XOR; kept for a uniform interface */
+static inline uint16_t checksum_final(const checksum_t *c)
+{
+    return c->state;
+}
+
+/* Hex digits of the checksum in ASCII frames ("*XX" / "*XXXX") */
+static inline int checksum_hex_digits(checksum_kind_t kind)
+{
+    return kind == CHECKSUM_CRC16 ? 4 : 2;
+}
+
+#endif /* AIRMAN_CHECKSUM_H */
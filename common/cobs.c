@@ -0,0 +1,72 @@
+/*
+ * cobs.c
+ *
+ * AIRMAN – COBS encoder / decoder (see cobs.h)
+ */
+
+#include <string.h>
+
+#include "cobs.h"
+
+/*
+ * Single pass encoder.
+ *
+ * code_pos points at the slot holding the length code of the current
+ * block. Each non-zero byte is copied straight through; a zero byte
+ * (or a full 254-byte block) closes the block by patching its code.
+ */
+size_t cobs_encode(const uint8_t *src, size_t len, uint8_t *dst)
+{
+    uint8_t *out      = dst + 1;
+    uint8_t *code_pos = dst;
+    uint8_t  code     = 1;
+
+    for (size_t i = 0; i < len; i++) {
+        if (src[i] == 0) {
+            *code_pos = code;
+            code_pos  = out++;
+            code      = 1;
+        } else {
+            *out++ = src[i];
+            if (++code == 0xFF) {
+                *code_pos = code;
+                code_pos  = out++;
+                code      = 1;
+            }
+        }
+    }
+
+    *code_pos = code;
+    return (size_t)(out - dst);
+}
+
+size_t cobs_encode_inplace(uint8_t *buf, size_t len)
+{
+    if (len > COBS_INPLACE_MAX)
+        return 0;
+    return cobs_encode(buf + 1, len, buf);
+}
+
+/*
+ * Each code byte c is followed by c - 1 data bytes; a code below 0xFF
+ * also stands for a zero byte, except after the final block. The
+ * output never overtakes the input, so in-place decoding is safe.
+ */
+size_t cobs_decode(const uint8_t *src, size_t len, uint8_t *dst)
+{
+    const uint8_t *end = src + len;
+    uint8_t       *out = dst;
+
+    while (src < end) {
+        uint8_t code = *src++;
+        if (code == 0 || (size_t)(end - src) < (size_t)(code - 1))
+            return (size_t)-1;
+
+        memmove(out, src, (size_t)(code - 1));
+        out += code - 1;
+        src += code - 1;
+        if (code != 0xFF && src < end)
+            *out++ = 0;
+    }
+    return (size_t)(out - dst);
+}
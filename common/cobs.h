@@ -0,0 +1,54 @@
+/*
+ * cobs.h
+ *
+ * AIRMAN – Consistent Overhead Byte Stuffing (COBS)
+ * -------------------------------------------------
+ *
+ * COBS removes every 0x00 byte from a packet so that 0x00 can be used
+ * as an unambiguous frame delimiter on a raw byte stream (UART, pipe).
+ *
+ * Overhead is fixed and small: at most one extra byte per 254 bytes of
+ * input, plus one leading code byte. A receiver that joins the stream
+ * mid-frame simply discards bytes until the next 0x00 and is back in
+ * sync on the following frame.
+ */
+
+#ifndef AIRMAN_COBS_H
+#define AIRMAN_COBS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Worst-case encoded size for an input of n bytes (delimiter excluded) */
+#define COBS_MAX_ENCODED(n)   ((n) + ((n) / 254) + 1)
+
+/*
+ * Encode len bytes from src into dst.
+ * dst must hold at least COBS_MAX_ENCODED(len) bytes.
+ * Returns the number of bytes written (no trailing 0x00 is added).
+ */
+size_t cobs_encode(const uint8_t *src, size_t len, uint8_t *dst);
+
+/* Longest input cobs_encode_inplace() accepts (one code block) */
+#define COBS_INPLACE_MAX      254
+
+/*
+ * Encode in place: the len input bytes are at buf + 1 (buf[0] is
+ * scratch for the leading code byte) and the encoded packet ends up at
+ * buf. Needs COBS_MAX_ENCODED(len) bytes at buf.
+ *
+ * Safe because, within one code block, the encoder never writes past
+ * the byte it has just read. Returns the encoded length, or 0 if len
+ * exceeds COBS_INPLACE_MAX.
+ */
+size_t cobs_encode_inplace(uint8_t *buf, size_t len);
+
+/*
+ * Decode one packet of len bytes (delimiter already removed) into dst,
+ * which must hold len bytes. dst may equal src (in-place decode).
+ * Returns the decoded length, or (size_t)-1 if the packet is malformed
+ * (a zero code byte or a block running past the end).
+ */
+size_t cobs_decode(const uint8_t *src, size_t len, uint8_t *dst);
+
+#endif /* AIRMAN_COBS_H */
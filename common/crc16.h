@@ -0,0 +1,67 @@
+/*
+ * crc16.h
+ *
+ * AIRMAN – CRC16-CCITT Engine
+ * ---------------------------
+ *
+ * Shared CRC used by the Level-2 ASCII frames and by all binary frames.
+ *
+ * Parameters (a.k.a. CRC-16/CCITT-FALSE):
+ *   Polynomial : 0x1021
+ *   Init value : 0xFFFF
+ *   No reflection, no final XOR
+ *
+ * All APIs take an explicit length, so they work on binary payloads and
+ * on text that has not been NUL-terminated.
+ *
+ * Engines (select with -DCRC16_ENGINE=...):
+ *   CRC16_ENGINE_BITWISE  8 shift/xor steps per byte, no tables
+ *   CRC16_ENGINE_TABLE    one 256-entry lookup per byte (512 B, default)
+ *   CRC16_ENGINE_SLICE8   8 bytes per step via 8 tables (4 KB), best
+ *                         on 32/64-bit hosts with large caches
+ *   CRC16_ENGINE_HW       hardware CRC peripheral; the target provides
+ *                         crc16_hw_update() (e.g. STM32 CRC unit
+ *                         configured for 16-bit poly 0x1021)
+ */
+
+#ifndef AIRMAN_CRC16_H
+#define AIRMAN_CRC16_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CRC16_CCITT_INIT       0xFFFFu
+
+#define CRC16_ENGINE_BITWISE   1
+#define CRC16_ENGINE_TABLE     2
+#define CRC16_ENGINE_SLICE8    3
+#define CRC16_ENGINE_HW        4
+
+#ifndef CRC16_ENGINE
+#define CRC16_ENGINE           CRC16_ENGINE_TABLE
+#endif
+
+/*
+ * Continue a CRC over len more bytes with the configured engine.
+ * Start with crc = CRC16_CCITT_INIT; the result can be fed back in to
+ * checksum data that arrives in pieces.
+ */
+uint16_t crc16_ccitt_update(uint16_t crc, const void *data, size_t len);
+
+/* One-shot CRC over a complete buffer */
+uint16_t crc16_ccitt(const void *data, size_t len);
+
+/*
+ * Individual engines. Always built so benchmarks can compare them and
+ * cross-check results; firmware should call crc16_ccitt_update().
+ */
+uint16_t crc16_ccitt_update_bitwise(uint16_t crc, const void *data, size_t len);
+uint16_t crc16_ccitt_update_table(uint16_t crc, const void *data, size_t len);
+uint16_t crc16_ccitt_update_slice8(uint16_t crc, const void *data, size_t len);
+
+#if CRC16_ENGINE == CRC16_ENGINE_HW
+/* Supplied by the target BSP when the hardware engine is selected */
+uint16_t crc16_hw_update(uint16_t crc, const uint8_t *data, size_t len);
+#endif
+
+#endif /* AIRMAN_CRC16_H */
@@ -0,0 +1,125 @@
+/*
+ * deltaframe.c
+ *
+ * AIRMAN – Delta-compressed telemetry frames (see deltaframe.h)
+ */
+
+#include <string.h>
+
+#include "binframe.h"
+#include "deltaframe.h"
+
+void deltaframe_init(deltaframe_t *d)
+{
+    memset(d, 0, sizeof(*d));
+}
+
+/* Wrapping difference, so any pair of int32 values round-trips */
+static int32_t wrap_sub(int32_t a, int32_t b)
+{
+    return (int32_t)((uint32_t)a - (uint32_t)b);
+}
+
+static int32_t wrap_add(int32_t a, int32_t b)
+{
+    return (int32_t)((uint32_t)a + (uint32_t)b);
+}
+
+/* ============================================================
+ * ENCODER
+ * ============================================================
+ */
+
+size_t deltaframe_encode(deltaframe_t *d, uint8_t *wire, uint8_t base_type,
+                         uint32_t ts_ms, const int32_t *v, int n_values)
+{
+    if (n_values > DELTAFRAME_MAX_VALUES)
+        n_values = DELTAFRAME_MAX_VALUES;
+
+    int key = !d->synced || d->since_key >= DELTAFRAME_KEY_INTERVAL ||
+              base_type != d->base_type || n_values != d->n_values;
+
+    d->seq++;
+
+    binframe_t f;
+    binframe_begin(&f, wire, BINFRAME_TYPE_DELTA);
+    binframe_put_u8(&f, (uint8_t)(base_type | (key ? DELTAFRAME_KEY : 0)));
+    binframe_put_u16(&f, d->seq);
+
+    if (key) {
+        binframe_put_varint(&f, ts_ms);
+        for (int i = 0; i < n_values; i++)
+            binframe_put_svarint(&f, v[i]);
+        d->since_key = 0;
+    } else {
+        binframe_put_varint(&f, ts_ms - d->ts_ms);
+        for (int i = 0; i < n_values; i++)
+            binframe_put_svarint(&f, wrap_sub(v[i], d->v[i]));
+    }
+    d->since_key++;
+
+    d->synced    = 1;
+    d->base_type = base_type;
+    d->n_values  = n_values;
+    d->ts_ms     = ts_ms;
+    memcpy(d->v, v, (size_t)n_values * sizeof(v[0]));
+
+    return binframe_finish(&f);
+}
+
+/* ============================================================
+ * DECODER
+ * ============================================================
+ */
+
+int deltaframe_decode(deltaframe_t *d, const uint8_t *raw, size_t len)
+{
+    const uint8_t *p   = raw + 4;
+    const uint8_t *end = raw + len;
+
+    if (len < 5 || raw[0] != BINFRAME_TYPE_DELTA) {
+        d->synced = 0;
+        return DELTAFRAME_BAD;
+    }
+
+    uint8_t  base_type = raw[1] & (uint8_t)~DELTAFRAME_KEY;
+    int      key       = (raw[1] & DELTAFRAME_KEY) != 0;
+    uint16_t seq       = binframe_get_u16(raw + 2);
+
+    /* A gap in the counter: the reference is gone until a keyframe */
+    if (!key && (!d->synced || seq != (uint16_t)(d->seq + 1) ||
+                 base_type != d->base_type)) {
+        d->synced = 0;
+        return DELTAFRAME_UNSYNCED;
+    }
+
+    uint32_t ts;
+    int32_t  v[DELTAFRAME_MAX_VALUES];
+    int      n = 0;
+
+    p = binframe_get_varint(p, end, &ts);
+    while (p && p < end && n < DELTAFRAME_MAX_VALUES) {
+        uint32_t u;
+        p = binframe_get_varint(p, end, &u);
+        if (p)
+            v[n++] = binframe_unzigzag(u);
+    }
+    if (!p || p != end || (!key && n != d->n_values)) {
+        d->synced = 0;
+        return DELTAFRAME_BAD;
+    }
+
+    if (key) {
+        d->ts_ms = ts;
+        memcpy(d->v, v, (size_t)n * sizeof(v[0]));
+    } else {
+        d->ts_ms += ts;
+        for (int i = 0; i < n; i++)
+            d->v[i] = wrap_add(d->v[i], v[i]);
+    }
+    d->synced    = 1;
+    d->base_type = base_type;
+    d->seq       = seq;
+    d->n_values  = n;
+    return DELTAFRAME_OK;
+}
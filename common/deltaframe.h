@@ -0,0 +1,98 @@
+/*
+ * deltaframe.h
+ *
+ * AIRMAN – Delta-Compressed Telemetry Frames
+ * ------------------------------------------
+ *
+ * Binary frame type BINFRAME_TYPE_DELTA: a fixed telemetry layout
+ * (L2 or L2Q) at the ASCII frame precision, in about half the bytes of
+ * the float frame. Every field is carried as a scaled integer (the
+ * digits the ASCII frame would print: hundredths of a degree,
+ * ten-thousandths of a quaternion component, centimetres, ...), and
+ * most frames only carry how much each field changed since the
+ * previous frame.
+ *
+ * Payload (after the type byte, CRC16 and COBS as in binframe.h):
+ *
+ *   u8      base type     BINFRAME_TYPE_L2 / _L2Q: layout of the values,
+ *                         bit 7 set on keyframes
+ *   u16     sequence      frame counter (mod 65536)
+ *   varint  timestamp_ms  keyframe: absolute; delta frame: ms since
+ *                         the previous frame
+ *   svarint value[i]      keyframe: the scaled value; delta frame: its
+ *                         change since the previous frame (zig-zag)
+ *
+ * The number of values is whatever fills the payload; receivers check
+ * it against the base layout.
+ *
+ * At 20 Hz the timestamp step (~50 ms), a slowly changing attitude, a
+ * 1 m/s climb and a constant temperature take 1-2 bytes each: an L2
+ * delta frame is ~14 bytes on the wire (COBS and delimiter included;
+ * keyframes ~21) instead of 29 (binary) or ~45 (ASCII).
+ *
+ * Keyframes:
+ *   the first frame and every DELTAFRAME_KEY_INTERVAL-th one after it
+ *   carry absolute values. A receiver that starts mid-stream, or that
+ *   loses frames (CRC errors, drops in the transmitter's ring), sees a
+ *   gap in the counter and discards delta frames until the next
+ *   keyframe: a loss costs at most one keyframe interval of telemetry
+ *   (one second as built by the Makefile), never wrong values. The counter only lines up again after exactly
+ *   65536 lost frames in a row (55 minutes at 20 Hz).
+ *
+ * One deltaframe_t per link on each side holds the reference values.
+ * Encoding is integer-only, so FPU-less builds can use it unchanged.
+ */
+
+#ifndef AIRMAN_DELTAFRAME_H
+#define AIRMAN_DELTAFRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DELTAFRAME_MAX_VALUES   8
+
+/*
+ * Frames per keyframe. The Makefile sets TELEMETRY_HZ, one keyframe a
+ * second at any telemetry rate; 20 is a second at the default 20 Hz.
+ */
+#ifndef DELTAFRAME_KEY_INTERVAL
+#define DELTAFRAME_KEY_INTERVAL 20
+#endif
+
+#define DELTAFRAME_KEY          0x80    /* base type byte: keyframe flag */
+
+typedef struct {
+    int      synced;        /* reference values valid */
+    int      since_key;     /* encoder: frames since the last keyframe */
+    uint8_t  base_type;
+    uint16_t seq;           /* counter of the last frame */
+    int      n_values;
+    uint32_t ts_ms;
+    int32_t  v[DELTAFRAME_MAX_VALUES];
+} deltaframe_t;
+
+/* Clear the reference: the next frame is (or must be) a keyframe */
+void deltaframe_init(deltaframe_t *d);
+
+/*
+ * Encode n_values scaled values of layout base_type into wire
+ * (BINFRAME_MAX_WIRE bytes), as a keyframe when one is due or the
+ * layout changed. Returns the number of bytes to transmit.
+ */
+size_t deltaframe_encode(deltaframe_t *d, uint8_t *wire, uint8_t base_type,
+                         uint32_t ts_ms, const int32_t *v, int n_values);
+
+enum {
+    DELTAFRAME_OK,
+    DELTAFRAME_UNSYNCED,     /* delta frame without its reference */
+    DELTAFRAME_BAD,          /* malformed payload */
+};
+
+/*
+ * Apply one frame (raw from binframe_decode(): type byte, payload, len
+ * bytes). On DELTAFRAME_OK the frame's values are d->base_type,
+ * d->ts_ms and d->v[0 .. d->n_values - 1].
+ */
+int deltaframe_decode(deltaframe_t *d, const uint8_t *raw, size_t len);
+
+#endif /* AIRMAN_DELTAFRAME_H */
@@ -0,0 +1,137 @@
+/*
+ * flightlog.c
+ *
+ * AIRMAN – Append-only binary flight log (see flightlog.h)
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define close _close
+#define open  _open
+#else
+#include <unistd.h>
+#endif
+
+#include "flightlog.h"
+#include "link_io.h"
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+#define HEADER_FIXED   16
+#define FIELD_BYTES    20
+
+/* Explicit byte order: identical files from every host */
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++)
+        p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_u64(uint8_t *p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++)
+        p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_field(uint8_t *p, const char *name, uint8_t type, size_t offset)
+{
+    memset(p, 0, FIELD_BYTES);
+    strncpy((char *)p, name, FLIGHTLOG_NAME_MAX);
+    p[FLIGHTLOG_NAME_MAX] = type;
+    put_u16(p + FLIGHTLOG_NAME_MAX + 2, (uint16_t)offset);
+}
+
+int flightlog_create(flightlog_t *l, const char *path,
+                     const char *const *names, int n_values)
+{
+    if (n_values < 0 || n_values + 1 > FLIGHTLOG_MAX_FIELDS) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    l->n_values    = n_values;
+    l->record_size = (8 + 4 * (size_t)n_values + 7) & ~(size_t)7;
+    l->buffered    = 0;
+
+    int    n_fields    = n_values + 1;
+    size_t header_size = (HEADER_FIXED + FIELD_BYTES * (size_t)n_fields + 7) & ~(size_t)7;
+    uint8_t header[HEADER_FIXED + FIELD_BYTES * FLIGHTLOG_MAX_FIELDS + 8];
+
+    memset(header, 0, header_size);
+    memcpy(header, FLIGHTLOG_MAGIC, 4);
+    put_u16(header + 4, FLIGHTLOG_VERSION);
+    put_u16(header + 6, (uint16_t)header_size);
+    put_u32(header + 8, (uint32_t)l->record_size);
+    put_u16(header + 12, (uint16_t)n_fields);
+
+    uint8_t *field = header + HEADER_FIXED;
+    put_field(field, "timestamp_ms", FLIGHTLOG_I64, 0);
+    for (int i = 0; i < n_values; i++)
+        put_field(field + FIELD_BYTES * (i + 1), names[i], FLIGHTLOG_F32,
+                  8 + 4 * (size_t)i);
+
+    if (strcmp(path, "-") == 0)
+        l->fd = 1;
+    else
+        l->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+    if (l->fd < 0)
+        return -1;
+
+    if (link_write(l->fd, header, header_size) != 0) {
+        close(l->fd);
+        l->fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+int flightlog_append(flightlog_t *l, int64_t ts_ms, const float *values)
+{
+    uint8_t *rec = l->buf + l->buffered * l->record_size;
+
+    put_u64(rec, (uint64_t)ts_ms);
+    for (int i = 0; i < l->n_values; i++) {
+        uint32_t bits;
+        memcpy(&bits, &values[i], sizeof(bits));
+        put_u32(rec + 8 + 4 * i, bits);
+    }
+    /* Padding stays deterministic */
+    memset(rec + 8 + 4 * l->n_values, 0,
+           l->record_size - 8 - 4 * (size_t)l->n_values);
+
+    if (++l->buffered == FLIGHTLOG_BUF_RECORDS)
+        return flightlog_flush(l);
+    return 0;
+}
+
+int flightlog_flush(flightlog_t *l)
+{
+    if (l->buffered == 0)
+        return 0;
+
+    /* One write(2) per batch of whole records */
+    size_t len = l->buffered * l->record_size;
+    l->buffered = 0;
+    return link_write(l->fd, l->buf, len);
+}
+
+void flightlog_close(flightlog_t *l)
+{
+    if (l->fd < 0)
+        return;
+    flightlog_flush(l);
+    close(l->fd);
+    l->fd = -1;
+}
@@ -0,0 +1,84 @@
+/*
+ * flightlog.h
+ *
+ * AIRMAN – Append-Only Binary Flight Log
+ * --------------------------------------
+ *
+ * Fixed-record replacement for the row-by-row CSV logs. Every record is
+ * an int64 timestamp followed by float32 columns, so a reader can
+ * memory-map the file and address record i directly, take a column as a
+ * strided array (numpy.frombuffer) and, on every refresh, read only the
+ * records appended since the last one instead of re-parsing the file.
+ *
+ * File layout (little-endian):
+ *
+ *   offset  size
+ *   0       4     magic "AFLG"
+ *   4       2     version (FLIGHTLOG_VERSION)
+ *   6       2     header_size: bytes before the first record
+ *   8       4     record_size
+ *   12      2     n_fields
+ *   14      2     reserved (0)
+ *   16      20*n  field table: name[16] (NUL-padded), type (u8),
+ *                 reserved (u8), offset in record (u16)
+ *   ...           padding to a multiple of 8
+ *   header_size   records, record_size bytes each
+ *
+ * Field 0 is always "timestamp_ms" (FLIGHTLOG_I64); the others are
+ * FLIGHTLOG_F32. Timestamps never decrease, so the time column is the
+ * seek index: the record at or after time t is a binary search over
+ * record offsets, with no separate index to maintain.
+ *
+ * Appends are whole records only. A reader that sees a partial record
+ * at the end of the file (a write in progress) ignores it until the
+ * next refresh. Readers: common/flightlog.py.
+ */
+
+#ifndef AIRMAN_FLIGHTLOG_H
+#define AIRMAN_FLIGHTLOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FLIGHTLOG_MAGIC        "AFLG"
+#define FLIGHTLOG_VERSION      1
+#define FLIGHTLOG_NAME_MAX     16
+#define FLIGHTLOG_MAX_FIELDS   32
+
+/* Records buffered before one write(2) (see flightlog_flush) */
+#define FLIGHTLOG_BUF_RECORDS  64
+
+#define FLIGHTLOG_I64          1
+#define FLIGHTLOG_F32          2
+
+typedef struct {
+    int      fd;
+    int      n_values;         /* float columns after the timestamp */
+    size_t   record_size;
+    size_t   buffered;         /* records waiting in buf */
+    uint8_t  buf[FLIGHTLOG_BUF_RECORDS * (8 + 4 * FLIGHTLOG_MAX_FIELDS)];
+} flightlog_t;
+
+/*
+ * Create (truncate) path and write the header for a timestamp column
+ * plus the n_values float columns named in names[]. Path "-" streams
+ * the log to stdout instead (see FlightLogStream in flightlog.py).
+ * Returns 0, or -1 (errno set).
+ */
+int flightlog_create(flightlog_t *l, const char *path,
+                     const char *const *names, int n_values);
+
+/* Append one record: ts_ms and values[0..n_values) */
+int flightlog_append(flightlog_t *l, int64_t ts_ms, const float *values);
+
+/*
+ * Write buffered records to the file. Appends flush on their own every
+ * FLIGHTLOG_BUF_RECORDS records; call this periodically (e.g. once per
+ * second) so live readers see slow streams promptly.
+ */
+int flightlog_flush(flightlog_t *l);
+
+/* Flush and close */
+void flightlog_close(flightlog_t *l);
+
+#endif /* AIRMAN_FLIGHTLOG_H */
@@ -0,0 +1,314 @@
+"""
+flightlog.py
+
+AIRMAN – Append-Only Binary Flight Log
+--------------------------------------
+
+Python writer, memory-mapped reader and pipe reader for the
+fixed-record flight log described in common/flightlog.h (written
+directly by the C transmitters with --log, or by the receivers with
+--flog; `telemetry_rx --flog -` streams it to a pipe).
+
+File layout (little-endian):
+
+    header   "AFLG", version, header_size, record_size, n_fields,
+             then one 20-byte descriptor per field
+             (name[16], type, reserved, offset)
+    records  record_size bytes each: int64 timestamp_ms, float32 columns
+
+Because records have a fixed size and timestamps never decrease:
+
+- record i is at header_size + i * record_size (no parsing to seek)
+- a refresh reads only the records appended since the last one
+- the record at time t is found by binary search over the time column
+- numpy, when available, can view any column as a strided array
+"""
+
+import mmap
+import os
+import struct
+import time
+
+MAGIC = b"AFLG"
+VERSION = 1
+
+TYPE_I64 = 1
+TYPE_F32 = 2
+
+NAME_MAX = 16
+HEADER = struct.Struct("<4sHHIHH")
+FIELD = struct.Struct("<16sBBH")
+
+_TYPE_FMT = {TYPE_I64: "q", TYPE_F32: "f"}
+_TYPE_NUMPY = {TYPE_I64: "<i8", TYPE_F32: "<f4"}
+
+
+def _layout(columns):
+    """Field table and record size for a timestamp + float columns log."""
+    fields = [("timestamp_ms", TYPE_I64, 0)]
+    fields += [(name, TYPE_F32, 8 + 4 * i) for i, name in enumerate(columns)]
+    record_size = (8 + 4 * len(columns) + 7) & ~7
+    return fields, record_size
+
+
+def _read_header(log, f):
+    """Parse the header from f into log.header_size/record_size/fields."""
+    head = _read_exact(f, HEADER.size)
+    if len(head) < HEADER.size:
+        raise ValueError("flight log header incomplete")
+
+    magic, version, log.header_size, log.record_size, n_fields, _ = \
+        HEADER.unpack(head)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("not an AIRMAN flight log (v%d)" % VERSION)
+
+    table = _read_exact(f, log.header_size - HEADER.size)
+    if len(table) < FIELD.size * n_fields:
+        raise ValueError("flight log header incomplete")
+    log.fields = []
+    for i in range(n_fields):
+        name, ftype, _, offset = FIELD.unpack_from(table, FIELD.size * i)
+        log.fields.append((name.rstrip(b"\0").decode(), ftype, offset))
+    log.columns = [name for name, _, _ in log.fields]
+
+    # struct format with explicit padding for each field offset
+    fmt, pos = "<", 0
+    for _, ftype, offset in log.fields:
+        fmt += "%dx" % (offset - pos) if offset > pos else ""
+        fmt += _TYPE_FMT[ftype]
+        pos = offset + struct.calcsize(_TYPE_FMT[ftype])
+    fmt += "%dx" % (log.record_size - pos) if log.record_size > pos else ""
+    log._record = struct.Struct(fmt)
+
+
+def _read_exact(f, n):
+    """Up to n bytes from f, short only at end of stream (pipes)."""
+    data = b""
+    while len(data) < n:
+        chunk = f.read(n - len(data))
+        if not chunk:
+            break
+        data += chunk
+    return data
+
+
+def _numpy_dtype(log):
+    import numpy as np
+    return np.dtype({
+        "names": log.columns,
+        "formats": [_TYPE_NUMPY[t] for _, t, _ in log.fields],
+        "offsets": [o for _, _, o in log.fields],
+        "itemsize": log.record_size,
+    })
+
+
+class FlightLogWriter:
+    """
+    Append records (timestamp_ms + float columns) to a new flight log.
+
+    Records are buffered and written as whole records at most every
+    flush_sec seconds, so high frame rates cost one write per batch
+    rather than one per frame.
+    """
+
+    def __init__(self, path, columns, flush_sec=0.1):
+        fields, self.record_size = _layout(columns)
+        header_size = (HEADER.size + FIELD.size * len(fields) + 7) & ~7
+
+        header = bytearray(header_size)
+        HEADER.pack_into(header, 0, MAGIC, VERSION, header_size,
+                         self.record_size, len(fields), 0)
+        for i, (name, ftype, offset) in enumerate(fields):
+            FIELD.pack_into(header, HEADER.size + FIELD.size * i,
+                            name.encode()[:NAME_MAX], ftype, 0, offset)
+
+        pad = self.record_size - 8 - 4 * len(columns)
+        self._record = struct.Struct("<q%df%dx" % (len(columns), pad))
+        self._file = open(path, "wb")
+        self._file.write(header)
+        self._file.flush()
+
+        self._pending = []
+        self._flush_sec = flush_sec
+        self._last_flush = time.monotonic()
+
+    def append(self, ts_ms, values):
+        self._pending.append(self._record.pack(int(ts_ms), *values))
+        now = time.monotonic()
+        if now - self._last_flush >= self._flush_sec:
+            self.flush()
+            self._last_flush = now
+
+    def flush(self):
+        if self._pending:
+            self._file.write(b"".join(self._pending))
+            self._pending.clear()
+        self._file.flush()
+
+    def close(self):
+        self.flush()
+        self._file.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+class FlightLogReader:
+    """
+    Memory-mapped reader that follows a growing flight log.
+
+    read_new() returns only the complete records appended since the
+    previous call; a partial record still being written is left for the
+    next call.
+    """
+
+    def __init__(self, path):
+        self._file = open(path, "rb")
+        _read_header(self, self._file)
+        self._ts = struct.Struct("<q")
+
+        self._map = None
+        self.next_index = 0
+
+    # --------------------------------------------------------
+    # Mapping
+    # --------------------------------------------------------
+
+    def count(self):
+        """Number of complete records currently in the file."""
+        size = os.fstat(self._file.fileno()).st_size
+        return max(0, (size - self.header_size) // self.record_size)
+
+    def _mapped(self, n):
+        """Mapping that covers the first n records (remapped as it grows)."""
+        need = self.header_size + n * self.record_size
+        if self._map is None or len(self._map) < need:
+            if self._map is not None:
+                self._map.close()
+            self._map = mmap.mmap(self._file.fileno(), 0,
+                                  access=mmap.ACCESS_READ)
+        return self._map
+
+    def _offset(self, index):
+        return self.header_size + index * self.record_size
+
+    # --------------------------------------------------------
+    # Access
+    # --------------------------------------------------------
+
+    def read_new_raw(self, max_records=None):
+        """
+        Bytes of the complete records after next_index (advances it),
+        suitable for numpy.frombuffer(raw, dtype=reader.numpy_dtype()).
+        """
+        n = self.count()
+        end = n if max_records is None else min(n, self.next_index + max_records)
+        if end <= self.next_index:
+            return b""
+        m = self._mapped(end)
+        raw = m[self._offset(self.next_index):self._offset(end)]
+        self.next_index = end
+        return raw
+
+    def read_new(self, max_records=None):
+        """New complete records as a list of tuples, one value per column."""
+        return list(self._record.iter_unpack(self.read_new_raw(max_records)))
+
+    def timestamp(self, index):
+        return self._ts.unpack_from(self._mapped(index + 1),
+                                    self._offset(index))[0]
+
+    def find_time(self, t_ms):
+        """Index of the first record with timestamp_ms >= t_ms."""
+        lo, hi = 0, self.count()
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if self.timestamp(mid) < t_ms:
+                lo = mid + 1
+            else:
+                hi = mid
+        return lo
+
+    def seek(self, index):
+        """Make read_new() continue from record index."""
+        self.next_index = max(0, min(index, self.count()))
+
+    def numpy_dtype(self):
+        """numpy structured dtype matching one record (numpy required)."""
+        return _numpy_dtype(self)
+
+    def close(self):
+        if self._map is not None:
+            self._map.close()
+        self._file.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+class FlightLogStream:
+    """
+    Reader for a flight log arriving on a pipe, e.g. from
+    `telemetry_rx --flog -`. The native receiver does the per-frame
+    parsing; Python only sees batches of whole records:
+
+        stream = FlightLogStream(sys.stdin.buffer)
+        dtype = stream.numpy_dtype()
+        for raw in stream.iter_batches():
+            batch = numpy.frombuffer(raw, dtype=dtype)
+    """
+
+    def __init__(self, stream):
+        self._stream = stream
+        _read_header(self, stream)
+        self._pending = b""
+
+    def read_batch_raw(self, chunk_size=65536):
+        """
+        Bytes of the next whole records (b"" at end of stream). Blocks
+        until at least one chunk arrives; a partial record is kept for
+        the next call.
+        """
+        while True:
+            chunk = self._stream.read1(chunk_size) \
+                if hasattr(self._stream, "read1") \
+                else self._stream.read(chunk_size)
+            if not chunk:
+                return b""
+
+            data = self._pending + chunk
+            whole = len(data) - len(data) % self.record_size
+            self._pending = data[whole:]
+            if whole:
+                return data[:whole]
+
+    def read_batch(self, chunk_size=65536):
+        """Next records as a list of tuples ([] at end of stream)."""
+        return list(self._record.iter_unpack(self.read_batch_raw(chunk_size)))
+
+    def iter_batches(self, chunk_size=65536):
+        """Yield read_batch_raw() results until the stream ends."""
+        while True:
+            raw = self.read_batch_raw(chunk_size)
+            if not raw:
+                return
+            yield raw
+
+    def numpy_dtype(self):
+        """numpy structured dtype matching one record (numpy required)."""
+        return _numpy_dtype(self)
+
+
+def is_flight_log(path):
+    """True if path starts with the flight log magic."""
+    try:
+        with open(path, "rb") as f:
+            return f.read(4) == MAGIC
+    except OSError:
+        return False
@@ -0,0 +1,977 @@
+/*
+ * ground_station.c
+ *
+ * AIRMAN – Multi-Vehicle Ground Station
+ * -------------------------------------
+ *
+ * One process ingesting telemetry from many vehicles at once (Linux,
+ * epoll), without a thread per link:
+ *
+ *   --stdin              one vehicle on standard input
+ *   --serial DEV[@BAUD]  one vehicle per UART (serial_port.h)
+ *   --tcp [HOST:]PORT    listen; one vehicle per accepted connection
+ *   --udp [HOST:]PORT    one vehicle per sender address
+ *   --reconnect          resume closed TCP vehicles (see below)
+ *
+ * --binary / --ascii switch the frame format for the links that follow
+ * on the command line (default ASCII), so mixed fleets can share one
+ * station. The current layout (L1 / L2 / L2Q) of each vehicle is taken from its
+ * first valid frame. Binary links also take delta-compressed frames
+ * (ahrs_filter --delta), expanded per vehicle to their L2 / L2Q layout.
+ *
+ * Ingestion (main thread): every descriptor is non-blocking and
+ * registered with one epoll instance. A ready link is drained in large
+ * reads into a shared chunk buffer and fed to the vehicle's rx_stream_t
+ * (rx_stream.h), which reassembles and validates frames in place.
+ * Vehicle IDs are assigned in order of first appearance (1, 2, ...) and
+ * each validated frame is tagged with its ID. Every TCP connection is a
+ * new vehicle, since one host may be running several (SITL, NAT). With
+ * --reconnect, a connection to the same listener from the host of a
+ * closed vehicle resumes that vehicle instead, for fleets of one vehicle
+ * per host whose links drop; if it then sends another layout, it
+ * continues in a new flight log.
+ *
+ * Fan-out: tagged records are pushed into one bounded SPSC ring
+ * (spsc_ring.h) per consumer, each drained by its own writer thread:
+ *
+ *   --log-dir DIR   one flight log per vehicle, DIR/vehicle_<ID>.flog,
+ *                   plus DIR/vehicles.csv (id, layout, source) and
+ *                   DIR/vehicle_<ID>_L2S.flog for the loop statistics
+ *                   frames of L2 / L2Q vehicles (ahrs_filter.c) and
+ *                   DIR/vehicle_<ID>.<N>.flog after the Nth layout
+ *                   change of a resumed vehicle (--reconnect). The
+ *                   ring drops the newest record when full, so a log
+ *                   only ever has one gap per overload.
+ *   --feed PATH|-   all vehicles as one CSV stream
+ *                   "vehicle,tag,timestamp_ms,v0,...", for dashboards
+ *                   and tools. Drops the oldest record when full: a
+ *                   live view wants the freshest data.
+ *
+ * Ingestion never blocks on a slow consumer. Backpressure is measured
+ * instead: every --stats SEC seconds (default 10) the station prints
+ * per-vehicle frame rates and error counts, and per-consumer queue
+ * depth, high-water mark and drops, on stderr.
+ *
+ * Usage:
+ *   ./ground_station --tcp 5760 --binary --udp 14550 --log-dir flights
+ *   ./ahrs_filter | ./ground_station --stdin --feed - --stats 1
+ *   ./ground_station --serial /dev/ttyUSB0@921600 --log-dir flights
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "flightlog.h"
+#include "link_io.h"
+#include "rx_stream.h"
+#include "serial_port.h"
+#include "spsc_ring.h"
+
+#define GS_MAX_LINKS       64      /* listeners, ports and connections */
+#define GS_MAX_VEHICLES    256
+#define GS_SOURCE_MAX      64
+
+/* Bytes per read(2) / recvfrom(2), shared by every link */
+#ifndef GS_CHUNK_BYTES
+#define GS_CHUNK_BYTES     (256 * 1024)
+#endif
+
+/*
+ * Reads per link per epoll round: a saturated link yields to the others
+ * (epoll is level-triggered and reports it again next round)
+ */
+#define GS_READS_PER_ROUND 4
+
+/* Bytes per round from a regular file (well under half a queue of frames) */
+#define GS_FILE_READ_BYTES (16 * 1024)
+
+/* Default slots per consumer queue (power of two) */
+#define GS_QUEUE_SLOTS     8192
+
+/* Writer threads flush at least this often */
+#define GS_FLUSH_MS        100
+
+#define FEED_BUF_BYTES     (256 * 1024)
+#define FEED_ROW_MAX       (RX_ROW_MAX + 16)
+
+/* ============================================================
+ * VEHICLES AND LINKS
+ * ============================================================
+ */
+
+typedef enum {
+    LINK_STREAM,        /* stdin, serial port, TCP connection */
+    LINK_TCP_LISTEN,
+    LINK_UDP,
+} link_kind_t;
+
+typedef struct vehicle vehicle_t;
+
+typedef struct {
+    link_kind_t kind;
+    int         fd;
+    int         binary;
+    int         serial;
+    int         polled;           /* regular file: not pollable, always ready */
+    vehicle_t  *vehicle;          /* LINK_STREAM */
+} link_t;
+
+struct vehicle {
+    int                id;
+    char               source[GS_SOURCE_MAX];
+    rx_stream_t        stream;
+    const rx_layout_t *layout;    /* from the first valid frame */
+    unsigned long      other_layout;
+    unsigned long      side;          /* statistics frames */
+    int                connected;
+
+    /* TCP vehicles: accepting listener; resumed with --reconnect */
+    const link_t      *listener;
+    int                resumed;       /* layout not yet confirmed */
+    uint8_t            segment;       /* flight log, bumped per layout change */
+
+    /* UDP sender (LINK_UDP vehicles only) */
+    link_t                 *udp;
+    struct sockaddr_storage peer;
+    socklen_t               peer_len;
+};
+
+static link_t    links[GS_MAX_LINKS];
+static int       n_links;
+static vehicle_t vehicles[GS_MAX_VEHICLES];
+static int       n_vehicles;
+static int       reconnect;       /* --reconnect */
+
+/* ============================================================
+ * CONSUMERS (WRITER THREADS)
+ * ============================================================
+ */
+
+/* One tagged frame, as queued to every consumer */
+typedef struct {
+    int64_t  ts_ms;
+    uint16_t vehicle;
+    uint8_t  layout;              /* index into rx_layouts[] */
+    uint8_t  segment;             /* vehicle_t.segment */
+    float    v[RX_MAX_VALUES];
+} gs_record_t;
+
+_Static_assert(sizeof(gs_record_t) <= SPSC_SLOT_BYTES,
+               "record must fit a queue slot");
+
+typedef struct consumer consumer_t;
+
+struct consumer {
+    const char   *name;
+    spsc_ring_t   ring;
+    sem_t         ready;
+    pthread_t     tid;
+    atomic_int    stop;
+    int           pushed;         /* records since the last sem_post */
+
+    /* Backpressure metrics (producer side) */
+    size_t        depth_max;
+
+    /* Consumer side */
+    atomic_ulong  written;
+    void        (*write)(consumer_t *c, const gs_record_t *r);
+    void        (*flush)(consumer_t *c);
+    void        (*close)(consumer_t *c);
+    void         *state;
+};
+
+static consumer_t *consumers[2];
+static int         n_consumers;
+
+static size_t ring_depth(spsc_ring_t *r)
+{
+    return atomic_load(&r->head) - atomic_load(&r->tail);
+}
+
+static void consumer_push(consumer_t *c, const gs_record_t *r)
+{
+    spsc_ring_push(&c->ring, r, sizeof(*r));
+    c->pushed++;
+
+    size_t depth = ring_depth(&c->ring);
+    if (depth > c->depth_max)
+        c->depth_max = depth;
+}
+
+/* Wake writers once per epoll round rather than once per record */
+static void consumers_wake(void)
+{
+    for (int i = 0; i < n_consumers; i++) {
+        if (consumers[i]->pushed) {
+            consumers[i]->pushed = 0;
+            sem_post(&consumers[i]->ready);
+        }
+    }
+}
+
+static void *consumer_main(void *arg)
+{
+    consumer_t *c = arg;
+    gs_record_t r;
+
+    for (;;) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += GS_FLUSH_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        sem_timedwait(&c->ready, &deadline);
+
+        unsigned long n = 0;
+        while (spsc_ring_pop(&c->ring, &r, sizeof(r)) >= 0) {
+            c->write(c, &r);
+            n++;
+        }
+        if (n)
+            atomic_fetch_add(&c->written, n);
+        c->flush(c);
+
+        if (atomic_load(&c->stop) && ring_depth(&c->ring) == 0)
+            break;
+    }
+    c->close(c);
+    return NULL;
+}
+
+static consumer_t *consumer_start(const char *name, size_t slots,
+                                  spsc_policy_t policy, void *state,
+                                  void (*write)(consumer_t *, const gs_record_t *),
+                                  void (*flush)(consumer_t *),
+                                  void (*close_fn)(consumer_t *))
+{
+    consumer_t  *c       = calloc(1, sizeof(*c));
+    spsc_slot_t *storage = calloc(slots, sizeof(*storage));
+    if (!c || !storage || spsc_ring_init(&c->ring, storage, slots, policy) != 0)
+        return NULL;
+
+    c->name  = name;
+    c->state = state;
+    c->write = write;
+    c->flush = flush;
+    c->close = close_fn;
+    sem_init(&c->ready, 0, 0);
+    if (pthread_create(&c->tid, NULL, consumer_main, c) != 0)
+        return NULL;
+
+    consumers[n_consumers++] = c;
+    return c;
+}
+
+static void consumers_stop(void)
+{
+    for (int i = 0; i < n_consumers; i++) {
+        atomic_store(&consumers[i]->stop, 1);
+        sem_post(&consumers[i]->ready);
+    }
+    for (int i = 0; i < n_consumers; i++)
+        pthread_join(consumers[i]->tid, NULL);
+}
+
+/* ---------------- per-vehicle flight logs (--log-dir) ---------------- */
+
+/*
+ * Per vehicle: the telemetry log, plus DIR/vehicle_<ID>_<TAG>.flog for
+ * side-channel frames (loop statistics)
+ */
+typedef struct {
+    const char  *dir;
+    FILE        *index;
+    flightlog_t *logs[GS_MAX_VEHICLES + 1][2];
+    uint8_t      segment[GS_MAX_VEHICLES + 1];
+} log_state_t;
+
+static void log_write(consumer_t *c, const gs_record_t *r)
+{
+    log_state_t       *s      = c->state;
+    const rx_layout_t *layout = &rx_layouts[r->layout];
+    flightlog_t       *l      = s->logs[r->vehicle][layout->side];
+
+    /* A resumed vehicle that changed layout: its next log */
+    if (l && !layout->side && r->segment != s->segment[r->vehicle]) {
+        flightlog_close(l);
+        free(l);
+        l = NULL;
+    }
+    if (!l) {
+        char path[4096];
+        if (layout->side)
+            snprintf(path, sizeof(path), "%s/vehicle_%d_%s.flog", s->dir,
+                     r->vehicle, layout->tag);
+        else if (r->segment)
+            snprintf(path, sizeof(path), "%s/vehicle_%d.%d.flog", s->dir,
+                     r->vehicle, r->segment);
+        else
+            snprintf(path, sizeof(path), "%s/vehicle_%d.flog", s->dir,
+                     r->vehicle);
+        if (!layout->side)
+            s->segment[r->vehicle] = r->segment;
+
+        l = s->logs[r->vehicle][layout->side] = malloc(sizeof(*l));
+        if (!l || flightlog_create(l, path, layout->columns,
+                                   layout->n_values) != 0) {
+            perror(path);
+            exit(1);
+        }
+        /* Written before the vehicle's first record was queued */
+        if (!layout->side) {
+            fprintf(s->index, "%d,%s,%s\n", r->vehicle, layout->tag,
+                    vehicles[r->vehicle - 1].source);
+            fflush(s->index);
+        }
+    }
+    flightlog_append(l, r->ts_ms, r->v);
+}
+
+static void log_flush(consumer_t *c)
+{
+    log_state_t *s = c->state;
+    for (int id = 1; id <= GS_MAX_VEHICLES; id++)
+        for (int side = 0; side < 2; side++)
+            if (s->logs[id][side])
+                flightlog_flush(s->logs[id][side]);
+}
+
+static void log_close(consumer_t *c)
+{
+    log_state_t *s = c->state;
+    for (int id = 1; id <= GS_MAX_VEHICLES; id++)
+        for (int side = 0; side < 2; side++)
+            if (s->logs[id][side])
+                flightlog_close(s->logs[id][side]);
+    fclose(s->index);
+}
+
+/* ---------------- combined CSV feed (--feed) ---------------- */
+
+typedef struct {
+    int    fd;
+    size_t len;
+    char   buf[FEED_BUF_BYTES];
+} feed_state_t;
+
+static void feed_flush(consumer_t *c)
+{
+    feed_state_t *s = c->state;
+    if (s->len > 0 && link_write(s->fd, s->buf, s->len) != 0)
+        perror("feed");
+    s->len = 0;
+}
+
+static void feed_write(consumer_t *c, const gs_record_t *r)
+{
+    feed_state_t *s = c->state;
+    if (FEED_BUF_BYTES - s->len < FEED_ROW_MAX)
+        feed_flush(c);
+
+    rx_frame_t f = { .layout = &rx_layouts[r->layout], .ts_ms = r->ts_ms };
+    memcpy(f.v, r->v, sizeof(f.v));
+
+    char *p = s->buf + s->len;
+    p = numfmt_i64(p, r->vehicle);
+    *p++ = ',';
+    memcpy(p, f.layout->tag, strlen(f.layout->tag));
+    p += strlen(f.layout->tag);
+    *p++ = ',';
+    p = rx_format_row(p, &f);
+    s->len = (size_t)(p - s->buf);
+}
+
+static void feed_close(consumer_t *c)
+{
+    feed_state_t *s = c->state;
+    if (s->fd != STDOUT_FILENO)
+        close(s->fd);
+}
+
+/* ============================================================
+ * INGESTION
+ * ============================================================
+ */
+
+/* rx_stream_t callback: tag the frame and queue it to every consumer */
+static void on_frame(void *ctx, const rx_frame_t *f)
+{
+    vehicle_t *v = ctx;
+
+    /* Side-channel frames ride along with whatever layout the vehicle sends */
+    if (f->layout->side)
+        v->side++;
+    else if (!v->layout || (v->resumed && f->layout != v->layout)) {
+        v->segment += v->layout != NULL;
+        v->layout   = f->layout;
+        fprintf(stderr, "[gs] vehicle %d: %s (%s)\n", v->id, v->source,
+                f->layout->tag);
+    }
+    if (!f->layout->side)
+        v->resumed = 0;
+    if (!f->layout->side && f->layout != v->layout) {
+        v->other_layout++;
+        return;
+    }
+
+    gs_record_t r;
+    r.ts_ms    = f->ts_ms;
+    r.vehicle  = (uint16_t)v->id;
+    r.layout   = (uint8_t)(f->layout - rx_layouts);
+    r.segment  = v->segment;
+    memcpy(r.v, f->v, sizeof(r.v));
+
+    for (int i = 0; i < n_consumers; i++)
+        consumer_push(consumers[i], &r);
+}
+
+/* Part of a TCP source that identifies the vehicle: the host, not the port */
+static size_t host_len(const char *source)
+{
+    const char *colon = strrchr(source, ':');
+    return colon ? (size_t)(colon - source) : strlen(source);
+}
+
+/* listener: the TCP listener that accepted the stream, else NULL */
+static vehicle_t *vehicle_new(const char *source, int binary,
+                              const link_t *listener)
+{
+    /*
+     * --reconnect: a closed vehicle of the same listener (so the same
+     * framing) and host. It starts over from a clean stream; its source
+     * string is left as it is, writer threads may be reading it. Once its
+     * segment counter is used up it is no longer resumed.
+     */
+    size_t key = host_len(source);
+    for (int i = 0; reconnect && listener && i < n_vehicles; i++) {
+        vehicle_t *v = &vehicles[i];
+        if (!v->connected && v->listener == listener && v->segment < UINT8_MAX &&
+            host_len(v->source) == key && strncmp(v->source, source, key) == 0) {
+            rx_counters_t n = v->stream.n;
+            rx_stream_init(&v->stream, binary, on_frame, v);
+            v->stream.n  = n;
+            v->connected = 1;
+            v->resumed   = 1;
+            fprintf(stderr, "[gs] vehicle %d: %s reconnected\n", v->id, source);
+            return v;
+        }
+    }
+
+    if (n_vehicles == GS_MAX_VEHICLES)
+        return NULL;
+
+    vehicle_t *v = &vehicles[n_vehicles];
+    memset(v, 0, sizeof(*v));
+    v->id        = ++n_vehicles;
+    v->connected = 1;
+    v->listener  = listener;
+    snprintf(v->source, sizeof(v->source), "%s", source);
+    rx_stream_init(&v->stream, binary, on_frame, v);
+    return v;
+}
+
+static void addr_name(const struct sockaddr *sa, char *out, size_t cap)
+{
+    char host[INET6_ADDRSTRLEN] = "?";
+    int  port = 0;
+
+    if (sa->sa_family == AF_INET) {
+        const struct sockaddr_in *in = (const void *)sa;
+        inet_ntop(AF_INET, &in->sin_addr, host, sizeof(host));
+        port = ntohs(in->sin_port);
+    } else if (sa->sa_family == AF_INET6) {
+        const struct sockaddr_in6 *in6 = (const void *)sa;
+        inet_ntop(AF_INET6, &in6->sin6_addr, host, sizeof(host));
+        port = ntohs(in6->sin6_port);
+    }
+    snprintf(out, cap, "%s:%d", host, port);
+}
+
+static int epoll_fd;
+
+static link_t *link_add(link_kind_t kind, int fd, int binary)
+{
+    /* Reuse the slot of a closed connection */
+    link_t *l = NULL;
+    for (int i = 0; i < n_links && !l; i++)
+        if (links[i].fd < 0)
+            l = &links[i];
+    if (!l) {
+        if (n_links == GS_MAX_LINKS) {
+            fprintf(stderr, "[gs] too many links (max %d)\n", GS_MAX_LINKS);
+            close(fd);
+            return NULL;
+        }
+        l = &links[n_links++];
+    }
+
+    memset(l, 0, sizeof(*l));
+    l->kind   = kind;
+    l->fd     = fd;
+    l->binary = binary;
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = l };
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0)
+        return l;
+
+    /* Regular files (stdin redirected from a capture) are always readable */
+    if (errno == EPERM && kind == LINK_STREAM) {
+        l->polled = 1;
+        return l;
+    }
+    perror("epoll_ctl");
+    close(fd);
+    l->fd = -1;
+    return NULL;
+}
+
+static void link_close(link_t *l)
+{
+    if (!l->polled)
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, l->fd, NULL);
+    if (l->fd != STDIN_FILENO)
+        close(l->fd);
+    l->fd = -1;
+
+    if (l->vehicle) {
+        rx_stream_reset(&l->vehicle->stream);
+        l->vehicle->connected = 0;
+        fprintf(stderr, "[gs] vehicle %d: %s closed\n", l->vehicle->id,
+                l->vehicle->source);
+    }
+}
+
+static uint8_t chunk[GS_CHUNK_BYTES];
+
+/* One read from a stream link; 0 once it has nothing more for now */
+static int stream_read(link_t *l, size_t cap)
+{
+    ssize_t n = read(l->fd, chunk, cap);
+    if (n > 0) {
+        rx_stream_feed(&l->vehicle->stream, chunk, (size_t)n);
+        return 1;
+    }
+    /* Serial ports (VMIN = 0) read 0 when empty; EOF otherwise */
+    if (!((n == 0 && l->serial) ||
+          (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))))
+        link_close(l);
+    return 0;
+}
+
+static void on_stream(link_t *l)
+{
+    for (int i = 0; i < GS_READS_PER_ROUND && stream_read(l, sizeof(chunk)); i++)
+        ;
+}
+
+/*
+ * Service the links epoll cannot watch; returns how many are open. A
+ * file has no deadline, so unlike live links it is read in small steps
+ * and waits for queue room instead of overrunning the writers (*busy
+ * set while it waits).
+ */
+static int poll_files(int *busy)
+{
+    int open = 0;
+
+    *busy = 0;
+    for (int i = 0; i < n_consumers; i++)
+        if (ring_depth(&consumers[i]->ring) > consumers[i]->ring.mask / 2)
+            *busy = 1;
+
+    for (int i = 0; i < n_links; i++) {
+        link_t *l = &links[i];
+        if (!l->polled || l->fd < 0)
+            continue;
+        if (!*busy)
+            stream_read(l, GS_FILE_READ_BYTES);
+        open += l->fd >= 0;
+    }
+    return open;
+}
+
+static void on_accept(link_t *listener)
+{
+    for (;;) {
+        struct sockaddr_storage peer;
+        socklen_t len = sizeof(peer);
+        int fd = accept4(listener->fd, (struct sockaddr *)&peer, &len,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return;
+
+        char name[GS_SOURCE_MAX] = "tcp ";
+        addr_name((struct sockaddr *)&peer, name + 4, sizeof(name) - 4);
+
+        vehicle_t *v = vehicle_new(name, listener->binary, listener);
+        link_t    *l = v ? link_add(LINK_STREAM, fd, listener->binary) : NULL;
+        if (!l) {
+            if (!v)
+                close(fd);
+            else
+                v->connected = 0;
+            fprintf(stderr, "[gs] rejected %s\n", name);
+            continue;
+        }
+        l->vehicle = v;
+    }
+}
+
+static vehicle_t *udp_vehicle(link_t *l, const struct sockaddr_storage *peer,
+                              socklen_t len)
+{
+    static vehicle_t *last;
+
+    if (last && last->udp == l && last->peer_len == len &&
+        memcmp(&last->peer, peer, len) == 0)
+        return last;
+
+    for (int i = 0; i < n_vehicles; i++) {
+        vehicle_t *v = &vehicles[i];
+        if (v->udp == l && v->peer_len == len && memcmp(&v->peer, peer, len) == 0)
+            return last = v;
+    }
+
+    char name[GS_SOURCE_MAX] = "udp ";
+    addr_name((const struct sockaddr *)peer, name + 4, sizeof(name) - 4);
+    vehicle_t *v = vehicle_new(name, l->binary, NULL);
+    if (!v)
+        return NULL;
+    v->udp      = l;
+    v->peer     = *peer;
+    v->peer_len = len;
+    return last = v;
+}
+
+static void on_datagram(link_t *l)
+{
+    for (int i = 0; i < 64 * GS_READS_PER_ROUND; i++) {
+        struct sockaddr_storage peer;
+        socklen_t len = sizeof(peer);
+        ssize_t n = recvfrom(l->fd, chunk, sizeof(chunk), 0,
+                             (struct sockaddr *)&peer, &len);
+        if (n < 0)
+            return;
+
+        memset((char *)&peer + len, 0, sizeof(peer) - len);
+        vehicle_t *v = udp_vehicle(l, &peer, len);
+        if (v)
+            rx_stream_feed(&v->stream, chunk, (size_t)n);
+    }
+}
+
+/* ============================================================
+ * SETUP
+ * ============================================================
+ */
+
+/* "[HOST:]PORT" -> bound socket, listening for SOCK_STREAM */
+static int open_socket(const char *spec, int type)
+{
+    char host[256] = "";
+    const char *port = spec;
+    const char *colon = strrchr(spec, ':');
+    if (colon) {
+        snprintf(host, sizeof(host), "%.*s", (int)(colon - spec), spec);
+        port = colon + 1;
+    }
+
+    struct addrinfo hints = { .ai_flags = AI_PASSIVE, .ai_socktype = type };
+    struct addrinfo *res;
+    if (getaddrinfo(host[0] ? host : NULL, port, &hints, &res) != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int fd = socket(res->ai_family, res->ai_socktype | SOCK_CLOEXEC, 0);
+    int on = 1;
+    if (fd >= 0)
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (fd >= 0 && type == SOCK_DGRAM) {
+        /* Bursts from many vehicles queue in the kernel, not on the wire */
+        int rcvbuf = 4 * 1024 * 1024;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+    if (fd >= 0 &&
+        (bind(fd, res->ai_addr, res->ai_addrlen) != 0 ||
+         (type == SOCK_STREAM && listen(fd, 64) != 0))) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+static volatile sig_atomic_t stop_requested;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* ============================================================
+ * STATISTICS
+ * ============================================================
+ */
+
+static void report(double dt)
+{
+    static rx_counters_t prev[GS_MAX_VEHICLES];
+    unsigned long frames = 0;
+    unsigned long long bytes = 0;
+
+    for (int i = 0; i < n_vehicles; i++) {
+        frames += vehicles[i].stream.n.frames - prev[i].frames;
+        bytes  += vehicles[i].stream.n.bytes - prev[i].bytes;
+    }
+    fprintf(stderr, "[gs] %d vehicles, %.0f frames/s, %.3f MB/s in\n",
+            n_vehicles, frames / dt, bytes / dt * 1e-6);
+
+    for (int i = 0; i < n_vehicles; i++) {
+        const vehicle_t     *v = &vehicles[i];
+        const rx_counters_t *n = &v->stream.n;
+        fprintf(stderr,
+                "  vehicle %3d %-2s %-28s %8.1f frames/s  errors: %lu checksum, "
+                "%lu format, %lu other-layout, %lu resync bytes, "
+                "%lu unsynced%s\n",
+                v->id, v->layout ? v->layout->tag : "--", v->source,
+                (n->frames - prev[i].frames) / dt, n->bad_checksum,
+                n->bad_format, v->other_layout, n->resync_bytes,
+                n->unsynced, v->connected ? "" : " (closed)");
+        prev[i] = *n;
+    }
+
+    for (int i = 0; i < n_consumers; i++) {
+        consumer_t *c = consumers[i];
+        fprintf(stderr,
+                "  queue %-4s depth %zu (max %zu of %zu), written %lu, "
+                "dropped %lu newest / %lu oldest\n",
+                c->name, ring_depth(&c->ring), c->depth_max, c->ring.mask + 1,
+                atomic_load(&c->written), atomic_load(&c->ring.dropped_newest),
+                atomic_load(&c->ring.dropped_oldest));
+        c->depth_max = 0;
+    }
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================
+ */
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: ground_station [--binary | --ascii] LINK... [--log-dir DIR]\n"
+            "                      [--feed PATH|-] [--stats SEC] [--queue SLOTS] [--reconnect]\n"
+            "  LINK: --stdin | --serial DEV[@BAUD] | --tcp [HOST:]PORT | --udp [HOST:]PORT\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *log_dir   = NULL;
+    const char *feed_path = NULL;
+    double      stats_sec = 10.0;
+    long        queue     = GS_QUEUE_SLOTS;
+    int         binary    = 0;
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        perror("epoll_create1");
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--binary") == 0)
+            binary = 1;
+        else if (strcmp(arg, "--ascii") == 0)
+            binary = 0;
+        else if (strcmp(arg, "--reconnect") == 0)
+            reconnect = 1;
+        else if (strcmp(arg, "--stdin") == 0) {
+            vehicle_t *v = vehicle_new("stdin", binary, NULL);
+            link_t    *l = link_add(LINK_STREAM, STDIN_FILENO, binary);
+            if (!l)
+                return 1;
+            l->vehicle = v;
+        } else if (strcmp(arg, "--serial") == 0 && val) {
+            char dev[256];
+            long baud = SERIAL_DEFAULT_BAUD;
+            const char *at = strchr(val, '@');
+            snprintf(dev, sizeof(dev), "%.*s",
+                     at ? (int)(at - val) : (int)strlen(val), val);
+            if (at)
+                baud = atol(at + 1);
+
+            int fd = serial_open(dev, baud, 0);
+            if (fd < 0) {
+                perror(dev);
+                return 1;
+            }
+            char name[GS_SOURCE_MAX];
+            snprintf(name, sizeof(name), "serial %.56s", dev);
+            vehicle_t *v = vehicle_new(name, binary, NULL);
+            link_t    *l = link_add(LINK_STREAM, fd, binary);
+            if (!l)
+                return 1;
+            l->vehicle = v;
+            l->serial  = 1;
+            i++;
+        } else if ((strcmp(arg, "--tcp") == 0 || strcmp(arg, "--udp") == 0) && val) {
+            int tcp = arg[2] == 't';
+            int fd  = open_socket(val, tcp ? SOCK_STREAM : SOCK_DGRAM);
+            if (fd < 0) {
+                perror(val);
+                return 1;
+            }
+            if (!link_add(tcp ? LINK_TCP_LISTEN : LINK_UDP, fd, binary))
+                return 1;
+            fprintf(stderr, "[gs] %s %s (%s)\n", tcp ? "tcp" : "udp", val,
+                    binary ? "binary" : "ASCII");
+            i++;
+        } else if (strcmp(arg, "--log-dir") == 0 && val) {
+            log_dir = val;
+            i++;
+        } else if (strcmp(arg, "--feed") == 0 && val) {
+            feed_path = val;
+            i++;
+        } else if (strcmp(arg, "--stats") == 0 && val) {
+            stats_sec = atof(val);
+            i++;
+        } else if (strcmp(arg, "--queue") == 0 && val) {
+            queue = atol(val);
+            i++;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (n_links == 0 || stats_sec <= 0 || queue < 2 || (queue & (queue - 1))) {
+        usage();
+        return 2;
+    }
+
+    if (log_dir) {
+        static log_state_t log_state;
+        char path[4096];
+        mkdir(log_dir, 0755);
+        snprintf(path, sizeof(path), "%s/vehicles.csv", log_dir);
+        log_state.dir   = log_dir;
+        log_state.index = fopen(path, "w");
+        if (!log_state.index) {
+            perror(path);
+            return 1;
+        }
+        fputs("vehicle,layout,source\n", log_state.index);
+        if (!consumer_start("log", (size_t)queue, SPSC_DROP_NEWEST, &log_state,
+                            log_write, log_flush, log_close)) {
+            fprintf(stderr, "[gs] cannot start the log writer\n");
+            return 1;
+        }
+    }
+    if (feed_path) {
+        static feed_state_t feed_state;
+        feed_state.fd = strcmp(feed_path, "-") == 0 ? STDOUT_FILENO :
+                        open(feed_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (feed_state.fd < 0) {
+            perror(feed_path);
+            return 1;
+        }
+        if (!consumer_start("feed", (size_t)queue, SPSC_DROP_OLDEST, &feed_state,
+                            feed_write, feed_flush, feed_close)) {
+            fprintf(stderr, "[gs] cannot start the feed writer\n");
+            return 1;
+        }
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    double t0 = now_sec();
+    double last_report = t0;
+
+    int files = 0, busy = 0;
+    for (int i = 0; i < n_links; i++)
+        files += links[i].polled;
+
+    while (!stop_requested) {
+        struct epoll_event ev[GS_MAX_LINKS];
+        int timeout_ms = (int)((last_report + stats_sec - now_sec()) * 1000) + 1;
+        if (files > 0)
+            timeout_ms = busy;
+        if (timeout_ms < 0)
+            timeout_ms = 0;
+        int n = epoll_wait(epoll_fd, ev, GS_MAX_LINKS, timeout_ms);
+        if (n < 0 && errno != EINTR) {
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            link_t *l = ev[i].data.ptr;
+            if (l->fd < 0)
+                continue;       /* closed earlier in this round */
+            switch (l->kind) {
+            case LINK_STREAM:     on_stream(l);   break;
+            case LINK_TCP_LISTEN: on_accept(l);   break;
+            case LINK_UDP:        on_datagram(l); break;
+            }
+        }
+        if (files > 0)
+            files = poll_files(&busy);
+        consumers_wake();
+
+        double now = now_sec();
+        if (now - last_report >= stats_sec) {
+            report(now - last_report);
+            last_report = now;
+        }
+
+        /* Nothing left that could still deliver data */
+        int open = 0;
+        for (int i = 0; i < n_links; i++)
+            open += links[i].fd >= 0;
+        if (open == 0)
+            break;
+    }
+
+    consumers_wake();
+    consumers_stop();
+    report(now_sec() - last_report);
+    fprintf(stderr, "[gs] ran %.1f s\n", now_sec() - t0);
+    return 0;
+}
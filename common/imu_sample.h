@@ -0,0 +1,109 @@
+/*
+ * imu_sample.h
+ *
+ * AIRMAN – IMU Sample Layout
+ * --------------------------
+ *
+ * The one in-memory representation of an IMU sample, shared by the
+ * sensor simulators, the calibration stage, the batch and fixed-point
+ * filters, the binary IMU log and the Level-1 transmitter, so samples
+ * move between them without repacking.
+ *
+ * Layout (64 bytes, one cache line):
+ *
+ *   offset  size
+ *   0       16    accel   x, y, z, pad    m/s^2
+ *   16      16    gyro    x, y, z, pad    deg/s
+ *   32      16    mag     x, y, z, pad    normalized
+ *   48      8     t_us    sample time, microseconds (monotonic)
+ *   56      4     valid   IMU_VALID_* bits
+ *   60      4     reserved
+ *
+ * Every sensor block is a 16-byte-aligned vector: one SSE / NEON load
+ * or store per sensor, and a DMA engine or IIO buffer can deliver
+ * samples in this exact format. Arrays of samples are whole cache
+ * lines; declare them IMU_SAMPLE_ALIGN-aligned (or use
+ * imu_sample_alloc()) so no sample straddles two lines.
+ *
+ * imu_sample_q_t is the fixed-point build's image: the same offsets
+ * with int32 Q16 lanes.
+ *
+ * Validity: a block whose IMU_VALID_* bit is clear is ignored by the
+ * filters exactly like a zero vector (no magnetometer: IMU-only mode,
+ * no accelerometer: gyro-only integration).
+ */
+
+#ifndef AIRMAN_IMU_SAMPLE_H
+#define AIRMAN_IMU_SAMPLE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define IMU_SAMPLE_ALIGN   64
+
+#define IMU_VALID_ACCEL    0x01
+#define IMU_VALID_GYRO     0x02
+#define IMU_VALID_MAG      0x04
+#define IMU_VALID_ALL      (IMU_VALID_ACCEL | IMU_VALID_GYRO | IMU_VALID_MAG)
+
+typedef struct {
+    _Alignas(16) float x;
+    float y, z;
+    float pad;                /* keeps the next block 16-byte aligned */
+} vec3_t;
+
+typedef struct {
+    _Alignas(16) int32_t x;
+    int32_t y, z;
+    int32_t pad;
+} vec3_q_t;
+
+typedef struct {
+    vec3_t   accel;           /* accelerometer (m/s²) */
+    vec3_t   gyro;            /* gyroscope (deg/s) */
+    vec3_t   mag;             /* magnetometer (normalized) */
+    int64_t  t_us;            /* sample time, microseconds */
+    uint32_t valid;           /* IMU_VALID_* */
+    uint32_t reserved;
+} imu_sample_t;
+
+typedef struct {
+    vec3_q_t accel;           /* m/s², Q16 */
+    vec3_q_t gyro;            /* deg/s, Q16 */
+    vec3_q_t mag;             /* normalized, Q16 */
+    int64_t  t_us;
+    uint32_t valid;
+    uint32_t reserved;
+} imu_sample_q_t;
+
+_Static_assert(sizeof(imu_sample_t) == IMU_SAMPLE_ALIGN, "imu_sample_t layout");
+_Static_assert(sizeof(imu_sample_q_t) == IMU_SAMPLE_ALIGN, "imu_sample_q_t layout");
+_Static_assert(sizeof(vec3_t) == 16 && sizeof(vec3_q_t) == 16, "vec3 blocks");
+
+static inline vec3_t vec3(float x, float y, float z)
+{
+    vec3_t v = { x, y, z, 0.0f };
+    return v;
+}
+
+static inline vec3_q_t vec3_q(int32_t x, int32_t y, int32_t z)
+{
+    vec3_q_t v = { x, y, z, 0 };
+    return v;
+}
+
+/*
+ * Zeroed, cache-line-aligned array of n samples of either type
+ * (free() it). NULL on failure.
+ */
+static inline void *imu_sample_alloc(size_t n)
+{
+    size_t bytes = (n ? n : 1) * IMU_SAMPLE_ALIGN;
+    void  *p     = aligned_alloc(IMU_SAMPLE_ALIGN, bytes);
+    if (p)
+        memset(p, 0, bytes);
+    return p;
+}
+
+#endif /* AIRMAN_IMU_SAMPLE_H */
@@ -0,0 +1,42 @@
+/*
+ * link_io.c
+ *
+ * AIRMAN – Raw link output (see link_io.h)
+ */
+
+#include <errno.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define write _write
+#else
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+#include "link_io.h"
+
+int link_write(int fd, const void *buf, size_t len)
+{
+    const char *p = buf;
+
+    while (len > 0) {
+        long n = (long)write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+#ifndef _WIN32
+            /* Non-blocking link (serial_port.h): wait for TX room */
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                struct pollfd pfd = { .fd = fd, .events = POLLOUT };
+                if (poll(&pfd, 1, -1) >= 0 || errno == EINTR)
+                    continue;
+            }
+#endif
+            return -1;
+        }
+        p   += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
@@ -0,0 +1,25 @@
+/*
+ * link_io.h
+ *
+ * AIRMAN – Raw Link Output
+ * ------------------------
+ *
+ * Frames are handed to the kernel with write(2) straight from the
+ * buffer they were built in (frame buffer, ring slot), bypassing the
+ * stdio buffer copy and the per-frame fflush(). On an MCU the same
+ * call site is where a UART DMA transfer would be started.
+ */
+
+#ifndef AIRMAN_LINK_IO_H
+#define AIRMAN_LINK_IO_H
+
+#include <stddef.h>
+
+/*
+ * Write all len bytes to fd, retrying on partial writes and EINTR. On a
+ * non-blocking descriptor (a serial port, serial_port.h) a full queue
+ * is waited out with poll(2). Returns 0, or -1 on error (errno set).
+ */
+int link_write(int fd, const void *buf, size_t len);
+
+#endif /* AIRMAN_LINK_IO_H */
@@ -0,0 +1,182 @@
+/*
+ * live_feed.c
+ *
+ * AIRMAN – Live frame feed (see live_feed.h)
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "live_feed.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#ifdef _WIN32
+
+int live_feed_open(live_feed_t *f, const char *path)
+{
+    (void)path;
+    memset(f, 0, sizeof(*f));
+    f->listen_fd = -1;
+    errno = ENOSYS;
+    return -1;
+}
+
+void live_feed_put(live_feed_t *f, uint8_t type, int64_t ts_ms,
+                   const float *values, int n)
+{
+    (void)f; (void)type; (void)ts_ms; (void)values; (void)n;
+}
+
+void live_feed_flush(live_feed_t *f)
+{
+    (void)f;
+}
+
+void live_feed_close(live_feed_t *f)
+{
+    (void)f;
+}
+
+#else
+
+int live_feed_open(live_feed_t *f, const char *path)
+{
+    struct sockaddr_un addr;
+
+    memset(f, 0, sizeof(*f));
+    f->listen_fd = -1;
+    f->path      = path;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (fd < 0)
+        return -1;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    /* A socket left behind by a receiver that did not exit cleanly */
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(fd, LIVE_FEED_MAX_SUBS) != 0) {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+
+    f->listen_fd = fd;
+    return 0;
+}
+
+static int64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void drop_sub(live_feed_t *f, int i)
+{
+    close(f->subs[i]);
+    f->subs[i] = f->subs[--f->n_subs];
+}
+
+static void accept_subs(live_feed_t *f)
+{
+    for (;;) {
+        int fd = accept(f->listen_fd, NULL, NULL);
+        if (fd < 0)
+            return;                     /* EAGAIN: nobody waiting */
+        if (f->n_subs == LIVE_FEED_MAX_SUBS) {
+            close(fd);
+            continue;
+        }
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        f->subs[f->n_subs++] = fd;
+        f->subscribers++;
+    }
+}
+
+void live_feed_flush(live_feed_t *f)
+{
+    if (f->listen_fd < 0)
+        return;
+    accept_subs(f);
+
+    if (f->buffered == 0)
+        return;
+
+    /* One timestamp per message: every record in it is published now */
+    int64_t now = monotonic_ns();
+    for (int i = 0; i < f->buffered; i++)
+        f->buf[i].pub_ns = now;
+
+    size_t len = (size_t)f->buffered * sizeof(f->buf[0]);
+    for (int i = 0; i < f->n_subs; ) {
+        ssize_t n = send(f->subs[i], f->buf, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK ||
+                      errno == ENOBUFS || errno == EINTR)) {
+            f->dropped += (unsigned long)f->buffered;
+            i++;
+        } else if (n < 0) {
+            drop_sub(f, i);             /* EPIPE: subscriber went away */
+        } else {
+            i++;
+        }
+    }
+
+    f->published += (unsigned long)f->buffered;
+    f->buffered = 0;
+}
+
+void live_feed_put(live_feed_t *f, uint8_t type, int64_t ts_ms,
+                   const float *values, int n)
+{
+    if (f->listen_fd < 0)
+        return;
+    if (f->buffered == LIVE_FEED_BATCH)
+        live_feed_flush(f);
+
+    if (n > LIVE_FEED_MAX_VALUES)
+        n = LIVE_FEED_MAX_VALUES;
+
+    live_feed_rec_t *r = &f->buf[f->buffered++];
+    memset(r, 0, sizeof(*r));
+    r->seq      = f->seq++;
+    r->type     = type;
+    r->n_values = (uint8_t)n;
+    r->ts_ms    = ts_ms;
+    memcpy(r->v, values, (size_t)n * sizeof(float));
+}
+
+void live_feed_close(live_feed_t *f)
+{
+    if (f->listen_fd < 0)
+        return;
+    live_feed_flush(f);
+    while (f->n_subs > 0)
+        drop_sub(f, 0);
+    close(f->listen_fd);
+    unlink(f->path);
+    f->listen_fd = -1;
+}
+
+#endif /* _WIN32 */
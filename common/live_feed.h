@@ -0,0 +1,89 @@
+/*
+ * live_feed.h
+ *
+ * AIRMAN – Live Frame Feed
+ * ------------------------
+ *
+ * Publishes the receiver's decoded frames to local subscribers (the
+ * dashboard, level2/dash.py --feed) over a Unix SOCK_SEQPACKET socket,
+ * so a display update costs one blocking recv() instead of a timed
+ * poll of a log file on disk. Subscribers sleep in recv() until a
+ * frame arrives and see it within microseconds of the receiver
+ * decoding it; the logs on disk are written as before.
+ *
+ * Wire format (little-endian, host = x86 / ARM):
+ *   one message per publisher flush (one per receiver wakeup), made of
+ *   whole LIVE_FEED_REC_SIZE records:
+ *
+ *   offset  size
+ *   0       4     seq: +1 per published record, all layouts
+ *   4       1     type: binary frame type of the layout (binframe.h)
+ *   5       1     n_values
+ *   6       2     reserved (0)
+ *   8       8     ts_ms: frame timestamp
+ *   16      8     pub_ns: CLOCK_MONOTONIC at publication, for latency
+ *   24      32    v[8]: float32 values, unused ones 0
+ *
+ * Slow subscribers never stall the receiver: sends do not block, and a
+ * message that does not fit a subscriber's socket buffer is dropped for
+ * that subscriber only. The gap shows up in its sequence numbers.
+ * Subscribers are accepted on the next flush after they connect.
+ * Python side: common/live_feed.py.
+ */
+
+#ifndef AIRMAN_LIVE_FEED_H
+#define AIRMAN_LIVE_FEED_H
+
+#include <stdint.h>
+
+#define LIVE_FEED_MAX_VALUES    8
+#define LIVE_FEED_REC_SIZE      56
+#define LIVE_FEED_MAX_SUBS      8
+
+/* Records per message; a full buffer is flushed on its own */
+#define LIVE_FEED_BATCH         64
+
+typedef struct {
+    uint32_t seq;
+    uint8_t  type;
+    uint8_t  n_values;
+    uint16_t reserved;
+    int64_t  ts_ms;
+    int64_t  pub_ns;
+    float    v[LIVE_FEED_MAX_VALUES];
+} live_feed_rec_t;
+
+_Static_assert(sizeof(live_feed_rec_t) == LIVE_FEED_REC_SIZE, "live_feed_rec_t layout");
+
+typedef struct {
+    int             listen_fd;
+    int             subs[LIVE_FEED_MAX_SUBS];
+    int             n_subs;
+    const char     *path;
+    uint32_t        seq;
+    int             buffered;
+    live_feed_rec_t buf[LIVE_FEED_BATCH];
+
+    /* Statistics */
+    unsigned long   published;      /* records */
+    unsigned long   dropped;        /* records not delivered to a subscriber */
+    unsigned long   subscribers;    /* connections accepted */
+} live_feed_t;
+
+/*
+ * Listen on path (a stale socket file is replaced). Returns 0, or -1
+ * (errno set; ENOSYS where Unix sockets are not available).
+ */
+int  live_feed_open(live_feed_t *f, const char *path);
+
+/* Queue one record: type, ts_ms and values[0..n) */
+void live_feed_put(live_feed_t *f, uint8_t type, int64_t ts_ms,
+                   const float *values, int n);
+
+/* Accept new subscribers and send them the queued records */
+void live_feed_flush(live_feed_t *f);
+
+/* Flush, disconnect the subscribers and remove the socket file */
+void live_feed_close(live_feed_t *f);
+
+#endif /* AIRMAN_LIVE_FEED_H */
@@ -0,0 +1,255 @@
+"""
+live_feed.py
+
+AIRMAN – Live Frame Feed
+------------------------
+
+Python publisher and subscriber for the Unix SOCK_SEQPACKET feed
+described in common/live_feed.h (published by `telemetry_rx --feed` or
+`plot_live.py --feed`, subscribed to by `dash.py -- --feed`).
+
+Each message is a batch of 56-byte records (little-endian):
+
+    seq u32, type u8, n_values u8, reserved u16,
+    ts_ms i64, pub_ns i64 (CLOCK_MONOTONIC), v float32[8]
+
+A subscriber blocks in recv() until the next message, so it wakes
+when a frame is published instead of polling a log file. Sequence
+numbers run over all records; a jump means the subscriber fell behind
+and the publisher dropped messages for it.
+
+time.monotonic_ns() reads the same clock as the C publisher, so
+now - pub_ns is the publisher-to-subscriber latency.
+
+Run as a script to watch a feed: rate, gaps and latency per second.
+
+    python live_feed.py /tmp/airman.feed
+"""
+
+import errno
+import os
+import socket
+import struct
+import sys
+import time
+
+import binframe
+
+MAX_VALUES = 8
+RECORD = struct.Struct("<IBBHqq8f")
+MAX_SUBSCRIBERS = 8
+
+# Records per message (C: LIVE_FEED_BATCH); bounds a recv() buffer
+BATCH = 64
+MESSAGE_MAX = BATCH * RECORD.size
+
+# Column names per frame type, as logged by the receivers
+COLUMNS = {
+    binframe.TYPE_L1: ["ax", "ay", "az", "gx", "gy", "gz", "alt", "temp"],
+    binframe.TYPE_L2: ["roll", "pitch", "heading", "altitude", "temperature"],
+    binframe.TYPE_L2S: ["stage", "count", "min_us", "p50_us", "p99_us",
+                        "max_us", "overruns"],
+    binframe.TYPE_L2Q: ["q0", "q1", "q2", "q3", "altitude", "temperature"],
+}
+
+NUMPY_DTYPE = [("seq", "<u4"), ("type", "u1"), ("n_values", "u1"),
+               ("reserved", "<u2"), ("ts_ms", "<i8"), ("pub_ns", "<i8"),
+               ("v", "<f4", (MAX_VALUES,))]
+
+
+def unpack(message):
+    """Records of one message as (seq, type, ts_ms, pub_ns, values) tuples."""
+    out = []
+    for off in range(0, len(message) - RECORD.size + 1, RECORD.size):
+        seq, ftype, n, _, ts, pub, *v = RECORD.unpack_from(message, off)
+        out.append((seq, ftype, ts, pub, v[:n]))
+    return out
+
+
+class LiveFeedPublisher:
+    """
+    Listening end, same behavior as live_feed.c: non-blocking sends, a
+    message that does not fit a subscriber's buffer is dropped for that
+    subscriber only, new subscribers are accepted on the next flush.
+    """
+
+    def __init__(self, path):
+        self.path = str(path)
+        self.seq = 0
+        self.pending = []
+        self.subs = []
+        self.published = 0
+        self.dropped = 0
+
+        try:
+            os.unlink(self.path)      # stale socket from an unclean exit
+        except FileNotFoundError:
+            pass
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_SEQPACKET)
+        self.sock.bind(self.path)
+        self.sock.listen(MAX_SUBSCRIBERS)
+        self.sock.setblocking(False)
+
+    def put(self, ftype, ts_ms, values):
+        """Queue one record."""
+        if len(self.pending) == BATCH:
+            self.flush()
+        v = list(values[:MAX_VALUES]) + [0.0] * (MAX_VALUES - len(values))
+        self.pending.append((self.seq & 0xFFFFFFFF, ftype, len(values),
+                             int(ts_ms), v))
+        self.seq += 1
+
+    def _accept(self):
+        while True:
+            try:
+                conn, _ = self.sock.accept()
+            except (BlockingIOError, InterruptedError):
+                return
+            if len(self.subs) < MAX_SUBSCRIBERS:
+                self.subs.append(conn)
+            else:
+                conn.close()
+
+    def flush(self):
+        """Accept new subscribers and send them the queued records."""
+        self._accept()
+        if not self.pending:
+            return
+
+        now = time.monotonic_ns()
+        message = b"".join(RECORD.pack(seq, ftype, n, 0, ts, now, *v)
+                           for seq, ftype, n, ts, v in self.pending)
+        for conn in list(self.subs):
+            try:
+                conn.send(message, socket.MSG_DONTWAIT)
+            except (BlockingIOError, InterruptedError):
+                self.dropped += len(self.pending)
+            except OSError as e:
+                if e.errno == errno.ENOBUFS:
+                    self.dropped += len(self.pending)
+                else:
+                    conn.close()       # EPIPE: subscriber went away
+                    self.subs.remove(conn)
+
+        self.published += len(self.pending)
+        self.pending = []
+
+    def close(self):
+        self.flush()
+        for conn in self.subs:
+            conn.close()
+        self.sock.close()
+        try:
+            os.unlink(self.path)
+        except FileNotFoundError:
+            pass
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+class LiveFeedSubscriber:
+    """
+    Connected end. recv_raw() blocks until the publisher's next message
+    (or the timeout), then takes every message already queued, so one
+    wakeup catches up on whatever arrived meanwhile.
+
+    Raises OSError (FileNotFoundError / ConnectionRefusedError) when no
+    publisher is listening on path.
+    """
+
+    def __init__(self, path):
+        self.path = str(path)
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_SEQPACKET)
+        try:
+            self.sock.connect(self.path)
+        except OSError:
+            self.sock.close()
+            raise
+        self.next_seq = None
+        self.lost = 0               # records missing from the sequence
+        self.closed = False         # publisher hung up
+
+    def _track(self, message):
+        if len(message) < RECORD.size:
+            return
+        first = RECORD.unpack_from(message, 0)[0]
+        last = RECORD.unpack_from(message, len(message) - RECORD.size)[0]
+        if self.next_seq is not None and first != self.next_seq:
+            self.lost += (first - self.next_seq) & 0xFFFFFFFF
+        self.next_seq = (last + 1) & 0xFFFFFFFF
+
+    def recv_raw(self, timeout=None):
+        """Concatenated records received (b"" on timeout or hang-up)."""
+        if self.closed:
+            return b""
+        chunks = []
+        self.sock.settimeout(timeout)
+        try:
+            message = self.sock.recv(MESSAGE_MAX)
+        except socket.timeout:
+            return b""
+        # A timeout socket would wait again on EAGAIN: drain non-blocking
+        self.sock.setblocking(False)
+        while message:
+            self._track(message)
+            chunks.append(message)
+            try:
+                message = self.sock.recv(MESSAGE_MAX)
+            except (BlockingIOError, InterruptedError):
+                break
+        if not message:
+            self.closed = True      # recv() of b"": publisher exited
+        return b"".join(chunks)
+
+    def recv(self, timeout=None):
+        """Records received, see unpack()."""
+        return unpack(self.recv_raw(timeout))
+
+    def fileno(self):
+        return self.sock.fileno()
+
+    def close(self):
+        self.sock.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+def _percentile(sorted_values, p):
+    return sorted_values[min(len(sorted_values) - 1,
+                             int(p / 100 * len(sorted_values)))]
+
+
+def main(argv):
+    if len(argv) != 2:
+        print("usage: live_feed.py SOCKET", file=sys.stderr)
+        return 2
+
+    with LiveFeedSubscriber(argv[1]) as sub:
+        count, latency, last = 0, [], time.monotonic()
+        while not sub.closed:
+            records = sub.recv(timeout=1.0)
+            now = time.monotonic_ns()
+            count += len(records)
+            latency += [(now - pub) * 1e-6 for _, _, _, pub, _ in records]
+
+            t = time.monotonic()
+            if t - last >= 1.0:
+                lat = sorted(latency)
+                print(f"{count / (t - last):.0f} records/s, {sub.lost} lost"
+                      + (f"; latency ms p50 {_percentile(lat, 50):.3f} "
+                         f"p99 {_percentile(lat, 99):.3f} max {lat[-1]:.3f}"
+                         if lat else ""), flush=True)
+                count, latency, last = 0, [], t
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,194 @@
+/*
+ * loop_prof.c
+ *
+ * AIRMAN – Loop stage profiler (see loop_prof.h)
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "loop_prof.h"
+
+/* ============================================================
+ * HISTOGRAM
+ * ============================================================
+ *
+ * Bucket i < LATENCY_SUB holds exactly the value i. Above that, a value
+ * with its top bit at position msb is shifted right by
+ * shift = msb - LATENCY_SUB_BITS, leaving LATENCY_SUB_BITS + 1
+ * significant bits; its bucket is (shift + 1) * LATENCY_SUB plus the
+ * bits below the top one.
+ */
+
+static int msb32(uint32_t v)
+{
+#if defined(__GNUC__)
+    return 31 - __builtin_clz(v);
+#else
+    int n = 0;
+    while (v >>= 1)
+        n++;
+    return n;
+#endif
+}
+
+static unsigned bucket_of(uint32_t ns)
+{
+    if (ns < LATENCY_SUB)
+        return ns;
+    int shift = msb32(ns) - LATENCY_SUB_BITS;
+    return (unsigned)(shift + 1) * LATENCY_SUB + ((ns >> shift) - LATENCY_SUB);
+}
+
+/* Middle of the value range covered by bucket i */
+static uint32_t bucket_value(unsigned i)
+{
+    if (i < LATENCY_SUB)
+        return i;
+    int shift = (int)(i / LATENCY_SUB) - 1;
+    uint64_t low = (uint64_t)(LATENCY_SUB + i % LATENCY_SUB) << shift;
+    uint64_t mid = low + ((1ull << shift) >> 1);
+    return mid > UINT32_MAX ? UINT32_MAX : (uint32_t)mid;
+}
+
+void latency_hist_reset(latency_hist_t *h)
+{
+    memset(h, 0, sizeof(*h));
+    h->min_ns = UINT32_MAX;
+}
+
+void latency_hist_record(latency_hist_t *h, uint32_t ns, uint32_t budget_ns)
+{
+    h->bucket[bucket_of(ns)]++;
+    h->count++;
+    if (ns < h->min_ns)
+        h->min_ns = ns;
+    if (ns > h->max_ns)
+        h->max_ns = ns;
+    if (ns > budget_ns)
+        h->overruns++;
+}
+
+uint32_t latency_hist_quantile(const latency_hist_t *h, double q)
+{
+    if (h->count == 0)
+        return 0;
+
+    /* Rank of the sample at quantile q, 1-based */
+    uint64_t rank = (uint64_t)(q * h->count + 0.5);
+    if (rank < 1)
+        rank = 1;
+    if (rank > h->count)
+        rank = h->count;
+
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += h->bucket[i];
+        if (seen >= rank) {
+            uint32_t v = bucket_value(i);
+            if (v < h->min_ns)
+                return h->min_ns;
+            return v > h->max_ns ? h->max_ns : v;
+        }
+    }
+    return h->max_ns;
+}
+
+/* ============================================================
+ * CLOCK CALIBRATION
+ * ============================================================
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+
+static uint64_t raw_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* TSC rate: count ticks across ~10 ms of CLOCK_MONOTONIC_RAW */
+static uint64_t ns_per_tick_q32(void)
+{
+    static uint64_t scale;
+    if (scale)
+        return scale;
+
+    uint64_t ns0 = raw_ns();
+    loop_prof_tick_t t0 = loop_prof_ticks();
+    uint64_t ns1;
+    do {
+        ns1 = raw_ns();
+    } while (ns1 - ns0 < 10000000u);
+    loop_prof_tick_t t1 = loop_prof_ticks();
+
+    scale = ((ns1 - ns0) << 32) / (t1 - t0 ? t1 - t0 : 1);
+    return scale;
+}
+
+#elif defined(__aarch64__)
+
+static uint64_t ns_per_tick_q32(void)
+{
+    uint64_t hz;
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(hz));
+    return (1000000000ull << 32) / (hz ? hz : 1);
+}
+
+#else
+
+static uint64_t ns_per_tick_q32(void)
+{
+    return 1ull << 32;      /* ticks are nanoseconds */
+}
+
+#endif
+
+/* ============================================================
+ * STAGES
+ * ============================================================
+ */
+
+void loop_prof_init(loop_prof_t *p, int n_stages, uint32_t budget_ns)
+{
+    memset(p, 0, sizeof(*p));
+    p->n_stages        = n_stages > LOOP_PROF_MAX_STAGES ?
+                         LOOP_PROF_MAX_STAGES : n_stages;
+    p->budget_ns       = budget_ns;
+    p->ns_per_tick_q32 = ns_per_tick_q32();
+    p->max_ticks       = UINT64_MAX / p->ns_per_tick_q32;
+    loop_prof_reset(p);
+}
+
+void loop_prof_reset(loop_prof_t *p)
+{
+    for (int i = 0; i < p->n_stages; i++)
+        latency_hist_reset(&p->stage[i]);
+}
+
+void loop_prof_record(loop_prof_t *p, int stage, loop_prof_tick_t ticks)
+{
+    /* Samples over ~4.3 s saturate */
+    uint64_t ns = ticks > p->max_ticks ? UINT32_MAX :
+                  (ticks * p->ns_per_tick_q32) >> 32;
+    latency_hist_record(&p->stage[stage],
+                        ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns,
+                        p->budget_ns);
+}
+
+void loop_prof_report(const loop_prof_t *p, const char *const *names,
+                      FILE *out)
+{
+    for (int i = 0; i < p->n_stages; i++) {
+        const latency_hist_t *h = &p->stage[i];
+        if (h->count == 0)
+            continue;
+        fprintf(out, "[prof] %-8s n=%-6u min=%.2fus p50=%.2fus p99=%.2fus "
+                     "max=%.2fus over=%u\n",
+                names[i], h->count, h->min_ns / 1e3,
+                latency_hist_quantile(h, 0.50) / 1e3,
+                latency_hist_quantile(h, 0.99) / 1e3,
+                h->max_ns / 1e3, h->overruns);
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * loop_prof.h
+ *
+ * AIRMAN – Loop Stage Profiler
+ * ----------------------------
+ *
+ * Always-on timing of the stages of a fixed-rate loop (sensor read,
+ * filter update, encoding, ...), cheap enough to leave in flight code:
+ * one counter read and one histogram increment per stage per cycle.
+ *
+ * Clock (loop_prof_ticks()):
+ *   x86 / x86-64   TSC (rdtsc), calibrated against CLOCK_MONOTONIC_RAW
+ *                  at init. Assumes an invariant TSC (any x86 CPU from
+ *                  the last ~15 years).
+ *   AArch64        generic timer (CNTVCT_EL0, rate from CNTFRQ_EL0)
+ *   otherwise      clock_gettime(CLOCK_MONOTONIC_RAW)
+ *
+ * Histograms are log-linear in the HDR style: exact below 32 ns, then
+ * 32 sub-buckets per power of two, so every percentile is within ~3 %
+ * of the true value at any scale (ns to seconds) in a fixed 3.5 KB,
+ * with no allocation and O(1) recording.
+ *
+ * Per stage: count, min, max, p50 / p99, and overruns, the samples that
+ * took longer than the budget given at init (normally the loop period).
+ */
+
+#ifndef AIRMAN_LOOP_PROF_H
+#define AIRMAN_LOOP_PROF_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif !defined(__aarch64__)
+#include <time.h>
+#endif
+
+#define LOOP_PROF_MAX_STAGES  8
+
+/* 2^LATENCY_SUB_BITS sub-buckets per power of two */
+#define LATENCY_SUB_BITS      5
+#define LATENCY_SUB           (1u << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS       ((32 - LATENCY_SUB_BITS + 1) * LATENCY_SUB)
+
+typedef struct {
+    uint32_t count;
+    uint32_t overruns;               /* samples above the budget */
+    uint32_t min_ns;
+    uint32_t max_ns;
+    uint32_t bucket[LATENCY_BUCKETS];
+} latency_hist_t;
+
+void     latency_hist_reset(latency_hist_t *h);
+void     latency_hist_record(latency_hist_t *h, uint32_t ns, uint32_t budget_ns);
+
+/* Value at quantile q (0..1), clamped to [min, max]; 0 if empty */
+uint32_t latency_hist_quantile(const latency_hist_t *h, double q);
+
+/* ============================================================
+ * CLOCK
+ * ============================================================
+ */
+
+typedef uint64_t loop_prof_tick_t;
+
+static inline loop_prof_tick_t loop_prof_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t t;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(t));
+    return t;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* ============================================================
+ * STAGES
+ * ============================================================
+ *
+ * Per cycle:
+ *
+ *   loop_prof_begin(&p);            after the wake-up
+ *   read_sensors();
+ *   loop_prof_lap(&p, STAGE_READ);  time since begin / previous lap
+ *   update_filter();
+ *   loop_prof_lap(&p, STAGE_FILTER);
+ *   ...
+ *   loop_prof_end(&p, STAGE_CYCLE); whole cycle, since begin
+ *
+ * Stages skipped in a cycle (decimated work) simply record nothing.
+ */
+
+typedef struct {
+    int              n_stages;
+    uint32_t         budget_ns;
+    uint64_t         ns_per_tick_q32;   /* tick -> ns scale, Q32 */
+    uint64_t         max_ticks;         /* largest ticks * scale in 64 bits */
+
+    loop_prof_tick_t start;
+    loop_prof_tick_t lap;
+
+    latency_hist_t   stage[LOOP_PROF_MAX_STAGES];
+} loop_prof_t;
+
+/* Calibrates the clock (~10 ms on x86, once per process) */
+void loop_prof_init(loop_prof_t *p, int n_stages, uint32_t budget_ns);
+
+/* Clear every histogram (start of a new report window) */
+void loop_prof_reset(loop_prof_t *p);
+
+void loop_prof_record(loop_prof_t *p, int stage, loop_prof_tick_t ticks);
+
+static inline void loop_prof_begin(loop_prof_t *p)
+{
+    p->start = p->lap = loop_prof_ticks();
+}
+
+static inline void loop_prof_lap(loop_prof_t *p, int stage)
+{
+    loop_prof_tick_t now = loop_prof_ticks();
+    loop_prof_record(p, stage, now - p->lap);
+    p->lap = now;
+}
+
+static inline void loop_prof_end(loop_prof_t *p, int stage)
+{
+    loop_prof_record(p, stage, loop_prof_ticks() - p->start);
+}
+
+/* Print one line per stage (count, min / p50 / p99 / max, overruns) */
+void loop_prof_report(const loop_prof_t *p, const char *const *names,
+                      FILE *out);
+
+#endif /* AIRMAN_LOOP_PROF_H */
@@ -0,0 +1,111 @@
+/*
+ * loop_sched.c
+ *
+ * AIRMAN – Fixed-rate loop scheduler (see loop_sched.h)
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+
+#include <errno.h>
+
+#include "loop_sched.h"
+
+#define NSEC_PER_SEC  1000000000L
+
+static void timespec_add_ns(struct timespec *t, long ns)
+{
+    t->tv_nsec += ns;
+    while (t->tv_nsec >= NSEC_PER_SEC) {
+        t->tv_nsec -= NSEC_PER_SEC;
+        t->tv_sec++;
+    }
+}
+
+/* a - b in nanoseconds */
+static long long timespec_diff_ns(const struct timespec *a,
+                                  const struct timespec *b)
+{
+    return (long long)(a->tv_sec - b->tv_sec) * NSEC_PER_SEC +
+           (a->tv_nsec - b->tv_nsec);
+}
+
+void loop_sched_init(loop_sched_t *s, unsigned hz)
+{
+    s->period_ns   = NSEC_PER_SEC / (long)(hz ? hz : 1);
+    s->cycles      = 0;
+    s->overruns    = 0;
+    s->skipped     = 0;
+    s->max_late_ns = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &s->next);
+    timespec_add_ns(&s->next, s->period_ns);
+}
+
+int loop_sched_wait(loop_sched_t *s)
+{
+    struct timespec now;
+    int overrun = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long long late = timespec_diff_ns(&now, &s->next);
+
+    if (late > 0) {
+        overrun = 1;
+        s->overruns++;
+        if (late > s->max_late_ns)
+            s->max_late_ns = (long)late;
+
+        /* More than a period behind: drop missed ticks, re-anchor */
+        if (late >= s->period_ns) {
+            long long missed = late / s->period_ns;
+            s->skipped += (unsigned long)missed;
+            s->next = now;
+        }
+    } else {
+        /* Restart on signal interruption; deadline is absolute */
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME,
+                               &s->next, NULL) == EINTR)
+            ;
+    }
+
+    timespec_add_ns(&s->next, s->period_ns);
+    s->cycles++;
+    return overrun;
+}
+
+void loop_sched_report(const loop_sched_t *s, FILE *out)
+{
+    fprintf(out, "[sched] period=%ldus cycles=%lu overruns=%lu "
+                 "skipped=%lu max_late=%ldus\n",
+            s->period_ns / 1000, s->cycles, s->overruns,
+            s->skipped, s->max_late_ns / 1000);
+}
+
+int loop_sched_set_realtime(int priority, int cpu)
+{
+#ifdef __linux__
+    int rc = 0;
+
+    if (priority > 0) {
+        struct sched_param sp = { .sched_priority = priority };
+        if (sched_setscheduler(0, SCHED_FIFO, &sp) != 0)
+            rc = -1;
+    }
+
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0)
+            rc = -1;
+    }
+    return rc;
+#else
+    (void)priority;
+    (void)cpu;
+    return (priority > 0 || cpu >= 0) ? -1 : 0;
+#endif
+}
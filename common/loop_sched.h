@@ -0,0 +1,58 @@
+/*
+ * loop_sched.h
+ *
+ * AIRMAN – Fixed-Rate Loop Scheduler
+ * ----------------------------------
+ *
+ * Drift-free periodic scheduling on an absolute CLOCK_MONOTONIC
+ * timeline. Each cycle sleeps until next = start + n * period, so
+ * compute and I/O time inside the loop no longer stretch the period
+ * (unlike a relative usleep at the end of the loop).
+ *
+ * If a cycle runs past its deadline it is counted as an overrun. When
+ * the loop falls more than one full period behind, the missed ticks are
+ * dropped and the timeline is re-anchored to "now" instead of bursting
+ * through them back-to-back.
+ *
+ * Optional real-time setup (Linux): SCHED_FIFO priority and pinning to
+ * a single CPU, which bounds jitter at 200–1000 Hz loop rates.
+ */
+
+#ifndef AIRMAN_LOOP_SCHED_H
+#define AIRMAN_LOOP_SCHED_H
+
+#include <stdio.h>
+#include <time.h>
+
+typedef struct {
+    struct timespec next;            /* absolute deadline of next cycle */
+    long            period_ns;
+
+    /* Statistics */
+    unsigned long   cycles;          /* completed waits */
+    unsigned long   overruns;        /* cycles that missed their deadline */
+    unsigned long   skipped;         /* whole periods dropped after overruns */
+    long            max_late_ns;     /* worst lateness observed */
+} loop_sched_t;
+
+/* Start a timeline at the current time with the given rate */
+void loop_sched_init(loop_sched_t *s, unsigned hz);
+
+/*
+ * Sleep until the next absolute deadline.
+ * Returns 1 if the cycle that just finished overran its deadline,
+ * 0 otherwise.
+ */
+int loop_sched_wait(loop_sched_t *s);
+
+/* Print cycle / overrun counters (one line) */
+void loop_sched_report(const loop_sched_t *s, FILE *out);
+
+/*
+ * Request SCHED_FIFO at the given priority (0 = leave policy alone)
+ * and pin the calling thread to cpu (-1 = no pinning).
+ * Returns 0 on success, -1 if any request was refused or unsupported.
+ */
+int loop_sched_set_realtime(int priority, int cpu);
+
+#endif /* AIRMAN_LOOP_SCHED_H */
@@ -0,0 +1,194 @@
+/*
+ * numfmt.c
+ *
+ * AIRMAN – Fast fixed-precision number formatting (see numfmt.h)
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "numfmt.h"
+
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint64_t pow10_u64[NUMFMT_MAX_DECIMALS + 1] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+    1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+};
+
+/* Write exactly `width` digits of v (zero-padded) ending at end */
+static void put_digits_rev(char *end, uint64_t v, int width)
+{
+    while (width >= 2) {
+        unsigned d = (unsigned)(v % 100);
+        v /= 100;
+        end -= 2;
+        memcpy(end, &digit_pairs[2 * d], 2);
+        width -= 2;
+    }
+    if (width)
+        *--end = (char)('0' + v % 10);
+}
+
+static int count_digits(uint64_t v)
+{
+    int n = 1;
+    while (v >= 10) {
+        v /= 10;
+        n++;
+    }
+    return n;
+}
+
+char *numfmt_u64(char *dst, uint64_t v)
+{
+    int n = count_digits(v);
+    put_digits_rev(dst + n, v, n);
+    return dst + n;
+}
+
+char *numfmt_i64(char *dst, int64_t v)
+{
+    if (v < 0) {
+        *dst++ = '-';
+        return numfmt_u64(dst, (uint64_t)0 - (uint64_t)v);
+    }
+    return numfmt_u64(dst, (uint64_t)v);
+}
+
+char *numfmt_scaled(char *dst, int64_t v, int decimals)
+{
+    if (decimals < 0)
+        decimals = 0;
+    if (decimals > NUMFMT_MAX_DECIMALS)
+        decimals = NUMFMT_MAX_DECIMALS;
+
+    uint64_t mag = v < 0 ? (uint64_t)0 - (uint64_t)v : (uint64_t)v;
+    if (v < 0)
+        *dst++ = '-';
+
+    dst = numfmt_u64(dst, mag / pow10_u64[decimals]);
+    if (decimals > 0) {
+        *dst++ = '.';
+        put_digits_rev(dst + decimals, mag % pow10_u64[decimals], decimals);
+        dst += decimals;
+    }
+    return dst;
+}
+
+char *numfmt_fixed(char *dst, double v, int decimals)
+{
+    if (decimals < 0)
+        decimals = 0;
+    if (decimals > NUMFMT_MAX_DECIMALS)
+        decimals = NUMFMT_MAX_DECIMALS;
+
+    /* NaN, inf and anything beyond int64 range take the slow path */
+    if (!(fabs(v * (double)pow10_u64[decimals]) < 9.0e18)) {
+        int n = snprintf(dst, NUMFMT_MAX_CHARS, "%.*f", decimals, v);
+        if (n < 0)
+            n = 0;
+        if (n > NUMFMT_MAX_CHARS - 1)
+            n = NUMFMT_MAX_CHARS - 1;
+        return dst + n;
+    }
+    return numfmt_scaled(dst, numfmt_round(v, decimals), decimals);
+}
+
+int64_t numfmt_round(double v, int decimals)
+{
+    if (decimals < 0)
+        decimals = 0;
+    if (decimals > NUMFMT_MAX_DECIMALS)
+        decimals = NUMFMT_MAX_DECIMALS;
+
+    double scaled = v * (double)pow10_u64[decimals];
+    if (!(fabs(scaled) < 9.0e18))
+        return 0;
+
+    /* Round to nearest, exact ties to even (matches glibc printf) */
+    int64_t r    = (int64_t)scaled;
+    double  frac = fabs(scaled - (double)r);
+    if (frac > 0.5 || (frac == 0.5 && (r & 1)))
+        r += scaled < 0.0 ? -1 : 1;
+    return r;
+}
+
+/* ============================================================
+ * PARSING
+ * ============================================================
+ */
+
+/* Exact doubles: integer / 10^k is then correctly rounded (k <= 22) */
+static const double pow10_f64[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+#define PARSE_MAX_POW10  22
+#define PARSE_MANT_LIMIT 100000000000000000ULL   /* 1e17: 17 digits kept */
+
+const char *numfmt_parse(const char *p, const char *end, double *out)
+{
+    int neg = 0, digits = 0, exp10 = 0;
+    uint64_t mant = 0;
+
+    if (p < end && (*p == '-' || *p == '+'))
+        neg = *p++ == '-';
+
+    for (; p < end && (unsigned)(*p - '0') <= 9; p++, digits++) {
+        if (mant < PARSE_MANT_LIMIT)
+            mant = mant * 10 + (uint64_t)(*p - '0');
+        else
+            exp10++;
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && (unsigned)(*p - '0') <= 9; p++, digits++) {
+            if (mant < PARSE_MANT_LIMIT) {
+                mant = mant * 10 + (uint64_t)(*p - '0');
+                exp10--;
+            }
+        }
+    }
+    if (digits == 0)
+        return NULL;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        int eneg = 0, e = 0, edigits = 0;
+        if (q < end && (*q == '-' || *q == '+'))
+            eneg = *q++ == '-';
+        for (; q < end && (unsigned)(*q - '0') <= 9; q++, edigits++)
+            if (e < 10000)
+                e = e * 10 + (*q - '0');
+        if (edigits > 0) {
+            exp10 += eneg ? -e : e;
+            p = q;
+        }
+    }
+
+    double v = (double)mant;
+    while (exp10 > PARSE_MAX_POW10) {
+        v *= 1e22;
+        exp10 -= PARSE_MAX_POW10;
+    }
+    while (exp10 < -PARSE_MAX_POW10) {
+        v /= 1e22;
+        exp10 += PARSE_MAX_POW10;
+    }
+    v = exp10 < 0 ? v / pow10_f64[-exp10] : v * pow10_f64[exp10];
+
+    *out = neg ? -v : v;
+    return p;
+}
@@ -0,0 +1,73 @@
+/*
+ * numfmt.h
+ *
+ * AIRMAN – Fast Fixed-Precision Number Formatting
+ * -----------------------------------------------
+ *
+ * Replacement for sprintf("%d") / sprintf("%.3f") in the ASCII frame
+ * encoders. Each function writes the digits straight to dst (no NUL)
+ * and returns the new end pointer, so fields can be appended to a
+ * frame buffer back to back.
+ *
+ * Compared with printf-style formatting:
+ *   - no format-string parsing, no locale lookups, no varargs
+ *   - integer digit generation, two digits per step from a table
+ *   - fixed-precision values are rounded once to a scaled integer
+ *     (nearest, ties to even like printf), then printed as integer
+ *     digits
+ *
+ * The one output difference from printf is the sign of zero: a value
+ * that rounds to zero prints without a sign, so -0.001 at 2 decimals
+ * is "0.00" where printf gives "-0.00". This is deliberate: the scaled
+ * integer from numfmt_round() (delta frames) cannot carry a negative
+ * zero, and every link format has to yield the same text for a value.
+ *
+ * numfmt_scaled() is integer-only, for builds without an FPU that
+ * already carry values as scaled integers.
+ *
+ * numfmt_parse() is the receiver-side counterpart: a bounded decimal
+ * parser for frame fields and log columns.
+ */
+
+#ifndef AIRMAN_NUMFMT_H
+#define AIRMAN_NUMFMT_H
+
+#include <stdint.h>
+
+/* Upper bound on characters written by any function below */
+#define NUMFMT_MAX_CHARS   32
+
+/* Largest supported number of decimals */
+#define NUMFMT_MAX_DECIMALS 9
+
+/* Decimal integer */
+char *numfmt_u64(char *dst, uint64_t v);
+char *numfmt_i64(char *dst, int64_t v);
+
+/* v / 10^decimals with exactly `decimals` digits after the point */
+char *numfmt_scaled(char *dst, int64_t v, int decimals);
+
+/*
+ * v with exactly `decimals` digits after the point, never "-0.00" (see
+ * above). Values that do not fit a scaled 64-bit integer (and NaN /
+ * inf) fall back to snprintf.
+ */
+char *numfmt_fixed(char *dst, double v, int decimals);
+
+/*
+ * v * 10^decimals rounded exactly as numfmt_fixed() prints it, for
+ * encoders that carry the ASCII precision as scaled integers (delta
+ * frames, deltaframe.h). 0 for NaN, inf and values beyond int64.
+ */
+int64_t numfmt_round(double v, int decimals);
+
+/*
+ * Parse a decimal number ("-12.345", "+1e-3") from [p, end), without
+ * locale lookups and without reading past end (the input need not be
+ * NUL-terminated). Values with up to 15 significant digits convert
+ * exactly-rounded. Returns the first character after the number, or
+ * NULL if there is no number at p.
+ */
+const char *numfmt_parse(const char *p, const char *end, double *out);
+
+#endif /* AIRMAN_NUMFMT_H */
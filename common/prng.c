@@ -0,0 +1,196 @@
+/*
+ * prng.c
+ *
+ * AIRMAN – Float noise on top of the per-stream generator (see prng.h)
+ */
+
+#include <math.h>
+
+#include "prng.h"
+
+/* ============================================================
+ * UNIFORM
+ * ============================================================
+ */
+
+float prng_uniform(prng_t *p)
+{
+    return (float)(prng_next_u64(p) >> 40) * 0x1.0p-24f;
+}
+
+float prng_uniform_pm(prng_t *p, float amp)
+{
+    /* Signed 24-bit integer scaled to [-1, 1) */
+    int32_t v = (int32_t)(prng_next_u64(p) >> 40) - (1 << 23);
+    return (float)v * (amp * 0x1.0p-23f);
+}
+
+/* ============================================================
+ * GAUSSIAN — ZIGGURAT
+ * ============================================================
+ *
+ * Marsaglia & Tsang (2000), 128 layers of equal area under the normal
+ * density. ~99% of samples take the fast path: one 64-bit draw, one
+ * table compare and one multiply. The rest are edge samples (one exp())
+ * or tail samples beyond ZIG_R (two log()s).
+ *
+ * Tables are the output of the paper's zigset() for 128 layers with
+ * x scaled to a signed 32-bit draw:
+ *   zig_k[i]  acceptance bound on |draw| for layer i
+ *   zig_w[i]  draw -> x scale for layer i
+ *   zig_f[i]  density exp(-x^2/2) at the layer edge
+ * Kept const so they live in flash on MCUs.
+ *
+ * The layer index comes from the low 7 bits of the draw and the value
+ * from the high 32, so the two are independent (the original SHR3
+ * version reused the same bits for both).
+ */
+
+#define ZIG_LAYERS  128
+#define ZIG_R       3.442619855899f     /* start of the tail */
+
+static const uint32_t zig_k[ZIG_LAYERS] = {
+    0x76AD2212u, 0x00000000u, 0x600F1B53u, 0x6CE447A6u, 0x725B46A2u, 0x7560051Du,
+    0x774921EBu, 0x789A25BDu, 0x799045C3u, 0x7A4BCE5Du, 0x7ADF629Fu, 0x7B5682A6u,
+    0x7BB8A8C6u, 0x7C0AE722u, 0x7C50CCE7u, 0x7C8CEC5Bu, 0x7CC12CD6u, 0x7CEEFED2u,
+    0x7D177E0Bu, 0x7D3B8883u, 0x7D5BCE6Cu, 0x7D78DD64u, 0x7D932886u, 0x7DAB0E57u,
+    0x7DC0DD30u, 0x7DD4D688u, 0x7DE73185u, 0x7DF81CEAu, 0x7E07C0A3u, 0x7E163EFAu,
+    0x7E23B587u, 0x7E303DFDu, 0x7E3BEEC2u, 0x7E46DB77u, 0x7E51155Du, 0x7E5AABB3u,
+    0x7E63ABF7u, 0x7E6C222Cu, 0x7E741906u, 0x7E7B9A18u, 0x7E82ADFAu, 0x7E895C63u,
+    0x7E8FAC4Bu, 0x7E95A3FBu, 0x7E9B4924u, 0x7EA0A0EFu, 0x7EA5B00Du, 0x7EAA7AC3u,
+    0x7EAF04F3u, 0x7EB3522Au, 0x7EB765A5u, 0x7EBB4259u, 0x7EBEEAFDu, 0x7EC2620Au,
+    0x7EC5A9C4u, 0x7EC8C441u, 0x7ECBB365u, 0x7ECE78EDu, 0x7ED11671u, 0x7ED38D62u,
+    0x7ED5DF12u, 0x7ED80CB4u, 0x7EDA175Cu, 0x7EDC0005u, 0x7EDDC78Eu, 0x7EDF6EBFu,
+    0x7EE0F647u, 0x7EE25EBEu, 0x7EE3A8A9u, 0x7EE4D473u, 0x7EE5E276u, 0x7EE6D2F5u,
+    0x7EE7A620u, 0x7EE85C10u, 0x7EE8F4CDu, 0x7EE97047u, 0x7EE9CE59u, 0x7EEA0ECAu,
+    0x7EEA3147u, 0x7EEA3568u, 0x7EEA1AABu, 0x7EE9E071u, 0x7EE98602u, 0x7EE90A88u,
+    0x7EE86D08u, 0x7EE7AC6Au, 0x7EE6C769u, 0x7EE5BC9Cu, 0x7EE48A67u, 0x7EE32EFCu,
+    0x7EE1A857u, 0x7EDFF42Fu, 0x7EDE0FFAu, 0x7EDBF8D9u, 0x7ED9AB94u, 0x7ED7248Du,
+    0x7ED45FAEu, 0x7ED1585Cu, 0x7ECE095Fu, 0x7ECA6CCBu, 0x7EC67BE2u, 0x7EC22EEEu,
+    0x7EBD7D1Au, 0x7EB85C35u, 0x7EB2C075u, 0x7EAC9C20u, 0x7EA5DF27u, 0x7E9E769Fu,
+    0x7E964C16u, 0x7E8D44BAu, 0x7E834033u, 0x7E781728u, 0x7E6B9933u, 0x7E5D8A1Au,
+    0x7E4D9DEDu, 0x7E3B737Au, 0x7E268C2Fu, 0x7E0E3FF5u, 0x7DF1AA5Du, 0x7DCF8C72u,
+    0x7DA61A1Eu, 0x7D72A0FBu, 0x7D30E097u, 0x7CD9B4ABu, 0x7C600F1Au, 0x7BA90BDCu,
+    0x7A722176u, 0x77D664E5u,
+};
+
+static const float zig_w[ZIG_LAYERS] = {
+    1.729040522e-09f, 1.268092845e-10f, 1.689751777e-10f, 1.986268844e-10f,
+    2.223243179e-10f, 2.424493613e-10f, 2.601613190e-10f, 2.761198871e-10f,
+    2.907396282e-10f, 3.042997041e-10f, 3.169979521e-10f, 3.289802053e-10f,
+    3.403573812e-10f, 3.512160221e-10f, 3.616250995e-10f, 3.716405763e-10f,
+    3.813085643e-10f, 3.906675681e-10f, 3.997501187e-10f, 4.085839862e-10f,
+    4.171930964e-10f, 4.255982353e-10f, 4.338175974e-10f, 4.418672181e-10f,
+    4.497613196e-10f, 4.575125889e-10f, 4.651324048e-10f, 4.726310238e-10f,
+    4.800177347e-10f, 4.873009868e-10f, 4.944884981e-10f, 5.015873466e-10f,
+    5.086040482e-10f, 5.155446229e-10f, 5.224146520e-10f, 5.292193275e-10f,
+    5.359634953e-10f, 5.426516925e-10f, 5.492881800e-10f, 5.558769721e-10f,
+    5.624218613e-10f, 5.689264417e-10f, 5.753941290e-10f, 5.818281786e-10f,
+    5.882317021e-10f, 5.946076818e-10f, 6.009589843e-10f, 6.072883728e-10f,
+    6.135985177e-10f, 6.198920075e-10f, 6.261713578e-10f, 6.324390202e-10f,
+    6.386973906e-10f, 6.449488167e-10f, 6.511956053e-10f, 6.574400293e-10f,
+    6.636843339e-10f, 6.699307434e-10f, 6.761814667e-10f, 6.824387039e-10f,
+    6.887046513e-10f, 6.949815079e-10f, 7.012714804e-10f, 7.075767893e-10f,
+    7.138996747e-10f, 7.202424015e-10f, 7.266072661e-10f, 7.329966016e-10f,
+    7.394127850e-10f, 7.458582428e-10f, 7.523354585e-10f, 7.588469793e-10f,
+    7.653954238e-10f, 7.719834898e-10f, 7.786139632e-10f, 7.852897266e-10f,
+    7.920137693e-10f, 7.987891979e-10f, 8.056192475e-10f, 8.125072942e-10f,
+    8.194568683e-10f, 8.264716694e-10f, 8.335555823e-10f, 8.407126946e-10f,
+    8.479473165e-10f, 8.552640026e-10f, 8.626675754e-10f, 8.701631525e-10f,
+    8.777561764e-10f, 8.854524480e-10f, 8.932581641e-10f, 9.011799601e-10f,
+    9.092249580e-10f, 9.174008206e-10f, 9.257158144e-10f, 9.341788804e-10f,
+    9.427997160e-10f, 9.515888694e-10f, 9.605578494e-10f, 9.697192525e-10f,
+    9.790869128e-10f, 9.886760771e-10f, 9.985036135e-10f, 1.008588259e-09f,
+    1.018950917e-09f, 1.029615015e-09f, 1.040606944e-09f, 1.051956589e-09f,
+    1.063697999e-09f, 1.075870210e-09f, 1.088518296e-09f, 1.101694708e-09f,
+    1.115461010e-09f, 1.129890161e-09f, 1.145069570e-09f, 1.161105243e-09f,
+    1.178127561e-09f, 1.196299505e-09f, 1.215828698e-09f, 1.236985629e-09f,
+    1.260132330e-09f, 1.285769684e-09f, 1.314620185e-09f, 1.347783956e-09f,
+    1.387063532e-09f, 1.435740319e-09f, 1.500865903e-09f, 1.603094794e-09f,
+};
+
+static const float zig_f[ZIG_LAYERS] = {
+    1.000000000e+00f, 9.635996931e-01f, 9.362826817e-01f, 9.130436480e-01f,
+    8.922816508e-01f, 8.732430489e-01f, 8.555006079e-01f, 8.387836053e-01f,
+    8.229072114e-01f, 8.077382947e-01f, 7.931770118e-01f, 7.791460859e-01f,
+    7.655841739e-01f, 7.524415592e-01f, 7.396772437e-01f, 7.272569183e-01f,
+    7.151515074e-01f, 7.033360990e-01f, 6.917891434e-01f, 6.804918410e-01f,
+    6.694276673e-01f, 6.585820001e-01f, 6.479418211e-01f, 6.374954773e-01f,
+    6.272324852e-01f, 6.171433708e-01f, 6.072195366e-01f, 5.974531509e-01f,
+    5.878370544e-01f, 5.783646811e-01f, 5.690299911e-01f, 5.598274127e-01f,
+    5.507517931e-01f, 5.417983550e-01f, 5.329626594e-01f, 5.242405727e-01f,
+    5.156282382e-01f, 5.071220511e-01f, 4.987186355e-01f, 4.904148253e-01f,
+    4.822076463e-01f, 4.740943007e-01f, 4.660721527e-01f, 4.581387163e-01f,
+    4.502916437e-01f, 4.425287153e-01f, 4.348478302e-01f, 4.272469983e-01f,
+    4.197243320e-01f, 4.122780401e-01f, 4.049064208e-01f, 3.976078565e-01f,
+    3.903808082e-01f, 3.832238111e-01f, 3.761354695e-01f, 3.691144537e-01f,
+    3.621594954e-01f, 3.552693848e-01f, 3.484429675e-01f, 3.416791412e-01f,
+    3.349768533e-01f, 3.283350984e-01f, 3.217529159e-01f, 3.152293881e-01f,
+    3.087636380e-01f, 3.023548278e-01f, 2.960021568e-01f, 2.897048604e-01f,
+    2.834622082e-01f, 2.772735029e-01f, 2.711380791e-01f, 2.650553023e-01f,
+    2.590245674e-01f, 2.530452985e-01f, 2.471169475e-01f, 2.412389935e-01f,
+    2.354109423e-01f, 2.296323252e-01f, 2.239026994e-01f, 2.182216466e-01f,
+    2.125887731e-01f, 2.070037094e-01f, 2.014661101e-01f, 1.959756531e-01f,
+    1.905320403e-01f, 1.851349970e-01f, 1.797842721e-01f, 1.744796383e-01f,
+    1.692208922e-01f, 1.640078547e-01f, 1.588403711e-01f, 1.537183122e-01f,
+    1.486415742e-01f, 1.436100801e-01f, 1.386237800e-01f, 1.336826526e-01f,
+    1.287867062e-01f, 1.239359802e-01f, 1.191305467e-01f, 1.143705124e-01f,
+    1.096560210e-01f, 1.049872554e-01f, 1.003644410e-01f, 9.578784912e-02f,
+    9.125780083e-02f, 8.677467189e-02f, 8.233889824e-02f, 7.795098251e-02f,
+    7.361150188e-02f, 6.932111739e-02f, 6.508058521e-02f, 6.089077035e-02f,
+    5.675266348e-02f, 5.266740190e-02f, 4.863629586e-02f, 4.466086220e-02f,
+    4.074286807e-02f, 3.688438879e-02f, 3.308788615e-02f, 2.935631744e-02f,
+    2.569329194e-02f, 2.210330462e-02f, 1.859210274e-02f, 1.516729801e-02f,
+    1.183947866e-02f, 8.624484413e-03f, 5.548995221e-03f, 2.669629084e-03f,
+};
+
+/* Tail beyond ZIG_R (Marsaglia 1964), sign taken from the draw */
+static float zig_tail(prng_t *p, int negative)
+{
+    float x, y;
+    do {
+        x = -logf(1.0f - prng_uniform(p)) * (1.0f / ZIG_R);
+        y = -logf(1.0f - prng_uniform(p));
+    } while (y + y < x * x);
+    return negative ? -(ZIG_R + x) : ZIG_R + x;
+}
+
+float prng_gauss(prng_t *p)
+{
+    for (;;) {
+        uint64_t r   = prng_next_u64(p);
+        int      i   = (int)(r & (ZIG_LAYERS - 1));
+        int32_t  hz  = (int32_t)(r >> 32);
+        uint32_t mag = hz < 0 ? 0u - (uint32_t)hz : (uint32_t)hz;
+        float    x   = (float)hz * zig_w[i];
+
+        /* Inside the rectangle: accept */
+        if (mag < zig_k[i])
+            return x;
+
+        if (i == 0)
+            return zig_tail(p, hz < 0);
+
+        /* Wedge between the rectangle and the curve */
+        float y = zig_f[i] + prng_uniform(p) * (zig_f[i - 1] - zig_f[i]);
+        if (y < expf(-0.5f * x * x))
+            return x;
+    }
+}
+
+/* ============================================================
+ * BLOCK FILLS
+ * ============================================================
+ */
+
+void prng_fill_uniform(prng_t *p, float *out, int n, float amp)
+{
+    for (int i = 0; i < n; i++)
+        out[i] = prng_uniform_pm(p, amp);
+}
+
+void prng_fill_gauss(prng_t *p, float *out, int n, float sigma)
+{
+    for (int i = 0; i < n; i++)
+        out[i] = prng_gauss(p) * sigma;
+}
@@ -0,0 +1,135 @@
+/*
+ * prng.h
+ *
+ * AIRMAN – Per-Stream Pseudo-Random Generator
+ * -------------------------------------------
+ *
+ * Replaces rand() for simulated sensor noise. rand() keeps one hidden
+ * global state (taken under a lock by some libcs, so generator threads
+ * serialize on it), is slow, and seeding it from time(NULL) makes every
+ * run different, so perf and output regressions cannot be diffed.
+ *
+ * Generator: xoshiro256** (Blackman & Vigna). 256-bit state, period
+ * 2^256 - 1, a handful of shifts/rotates per 64-bit output. All state
+ * lives in a prng_t owned by the caller: one per sensor or per thread.
+ *
+ * Streams: prng_seed(p, seed, stream) expands seed with splitmix64 and
+ * then applies the xoshiro jump function `stream` times. Each jump skips
+ * 2^128 outputs, so streams of the same seed never overlap, and a given
+ * (seed, stream) always reproduces the same sequence.
+ *
+ * The integer core is header-only and uses no floating point, so the
+ * fixed-point (FPU-less) builds can use it without linking prng.c.
+ * prng.c adds float noise: uniform and Gaussian (ziggurat), single
+ * values and block fills for batch generators.
+ *
+ * Usage:
+ *   prng_t rng;
+ *   prng_seed(&rng, seed, 0);
+ *   float u = prng_uniform_pm(&rng, 0.1f);    // uniform in [-0.1, 0.1)
+ *   float g = prng_gauss(&rng) * 0.05f;       // N(0, 0.05^2)
+ */
+
+#ifndef AIRMAN_PRNG_H
+#define AIRMAN_PRNG_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t s[4];
+} prng_t;
+
+/* ============================================================
+ * INTEGER CORE (header-only)
+ * ============================================================
+ */
+
+static inline uint64_t prng_rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+/* Next 64 random bits */
+static inline uint64_t prng_next_u64(prng_t *p)
+{
+    uint64_t *s = p->s;
+    uint64_t result = prng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = prng_rotl(s[3], 45);
+
+    return result;
+}
+
+/* Next 32 random bits (the high half, which has the best quality) */
+static inline uint32_t prng_next_u32(prng_t *p)
+{
+    return (uint32_t)(prng_next_u64(p) >> 32);
+}
+
+/* Advance the state by 2^128 outputs */
+static inline void prng_jump(prng_t *p)
+{
+    static const uint64_t jump[4] = {
+        0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+        0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull,
+    };
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (jump[i] & (1ull << b)) {
+                s0 ^= p->s[0];
+                s1 ^= p->s[1];
+                s2 ^= p->s[2];
+                s3 ^= p->s[3];
+            }
+            prng_next_u64(p);
+        }
+    }
+    p->s[0] = s0;
+    p->s[1] = s1;
+    p->s[2] = s2;
+    p->s[3] = s3;
+}
+
+/*
+ * Seed stream number `stream` of `seed`. splitmix64 turns any seed
+ * (including 0) into a well-mixed, non-zero state.
+ */
+static inline void prng_seed(prng_t *p, uint64_t seed, unsigned stream)
+{
+    for (int i = 0; i < 4; i++) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        p->s[i] = z ^ (z >> 31);
+    }
+    while (stream--)
+        prng_jump(p);
+}
+
+/* ============================================================
+ * FLOAT NOISE (prng.c)
+ * ============================================================
+ */
+
+/* Uniform in [0, 1), 24 random bits */
+float prng_uniform(prng_t *p);
+
+/* Uniform in [-amp, amp) */
+float prng_uniform_pm(prng_t *p, float amp);
+
+/* Standard normal N(0, 1), Marsaglia–Tsang ziggurat (128 layers) */
+float prng_gauss(prng_t *p);
+
+/* Block fills for batch generators: out[0..n) */
+void prng_fill_uniform(prng_t *p, float *out, int n, float amp);
+void prng_fill_gauss(prng_t *p, float *out, int n, float sigma);
+
+#endif /* AIRMAN_PRNG_H */
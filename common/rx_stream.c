@@ -0,0 +1,339 @@
+/*
+ * rx_stream.c
+ *
+ * AIRMAN – Telemetry stream reassembly (see rx_stream.h)
+ */
+
+#include <string.h>
+
+#include "binframe.h"
+#include "rx_stream.h"
+#include "txtparse.h"
+
+const rx_layout_t rx_layouts[] = {
+    { "L1", BINFRAME_TYPE_L1, 8,
+      { "ax", "ay", "az", "gx", "gy", "gz", "alt", "temp" },
+      { 3, 3, 3, 3, 3, 3, 2, 2 }, 0 },
+    { "L2", BINFRAME_TYPE_L2, 5,
+      { "roll", "pitch", "heading", "altitude", "temperature" },
+      { 2, 2, 2, 2, 2 }, 0 },
+    { "L2S", BINFRAME_TYPE_L2S, 7,
+      { "stage", "count", "min_us", "p50_us", "p99_us", "max_us", "overruns" },
+      { 0, 0, 2, 2, 2, 2, 0 }, 1 },
+    { "L2Q", BINFRAME_TYPE_L2Q, 6,
+      { "q0", "q1", "q2", "q3", "altitude", "temperature" },
+      { 4, 4, 4, 4, 2, 2 }, 0 },
+};
+
+const int rx_n_layouts = (int)(sizeof(rx_layouts) / sizeof(rx_layouts[0]));
+
+static const rx_layout_t *layout_by_tag(const char *tag)
+{
+    for (int i = 0; i < rx_n_layouts; i++)
+        if (strcmp(rx_layouts[i].tag, tag) == 0)
+            return &rx_layouts[i];
+    return NULL;
+}
+
+static const rx_layout_t *layout_by_type(uint8_t type)
+{
+    for (int i = 0; i < rx_n_layouts; i++)
+        if (rx_layouts[i].type == type)
+            return &rx_layouts[i];
+    return NULL;
+}
+
+/* ============================================================
+ * FRAME DECODERS
+ * ============================================================
+ */
+
+static void ascii_frame(rx_stream_t *s, const char *frame, size_t len)
+{
+    txtparse_t f;
+
+    switch (txtparse_line(&f, frame, len)) {
+    case TXTPARSE_OK:
+        break;
+    case TXTPARSE_ERR_CHECKSUM:
+        s->n.bad_checksum++;
+        return;
+    default:
+        s->n.bad_format++;
+        return;
+    }
+
+    const rx_layout_t *layout = layout_by_tag(f.tag);
+    if (!layout || f.n_fields != 1 + layout->n_values) {
+        s->n.bad_format++;
+        return;
+    }
+
+    rx_frame_t out;
+    out.layout   = layout;
+    out.ts_ms    = (int64_t)f.v[0];
+    out.text     = f.text;
+    out.text_len = f.text_len;
+    for (int i = 0; i < layout->n_values; i++)
+        out.v[i] = (float)f.v[1 + i];
+
+    s->n.frames++;
+    s->on_frame(s->ctx, &out);
+}
+
+/*
+ * One '\n'-terminated line. Normally a single frame, but a lost '\n'
+ * (byte loss, a reset transmitter) joins a torn frame and the next
+ * complete one: every '$' starts a candidate, so only the torn part is
+ * lost, not the whole line.
+ */
+static void ascii_line(rx_stream_t *s, const char *line, size_t len)
+{
+    const char *end = line + len;
+    const char *p   = memchr(line, '$', len);
+
+    if (len == 0)
+        return;
+    if (!p) {
+        s->n.resync_bytes += len;
+        return;
+    }
+    s->n.resync_bytes += (size_t)(p - line);
+
+    while (p) {
+        const char *next = memchr(p + 1, '$', (size_t)(end - p - 1));
+        ascii_frame(s, p, (size_t)((next ? next : end) - p));
+        p = next;
+    }
+}
+
+/*
+ * Scaled integers back to the values the ASCII frame would carry; powers
+ * of ten up to the largest layout precision.
+ */
+static const float pow10_f32[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f };
+
+static void delta_frame(rx_stream_t *s, const uint8_t *raw, size_t n)
+{
+    switch (deltaframe_decode(&s->delta, raw, n)) {
+    case DELTAFRAME_OK:
+        break;
+    case DELTAFRAME_UNSYNCED:
+        s->n.unsynced++;
+        return;
+    default:
+        s->n.bad_format++;
+        return;
+    }
+
+    const deltaframe_t *d      = &s->delta;
+    const rx_layout_t  *layout = layout_by_type(d->base_type);
+    if (!layout || d->n_values != layout->n_values) {
+        s->n.bad_format++;
+        return;
+    }
+
+    rx_frame_t out;
+    out.layout   = layout;
+    out.ts_ms    = d->ts_ms;
+    out.text     = NULL;
+    out.text_len = 0;
+    for (int i = 0; i < layout->n_values; i++)
+        out.v[i] = (float)d->v[i] / pow10_f32[layout->decimals[i]];
+
+    s->n.frames++;
+    s->on_frame(s->ctx, &out);
+}
+
+/* K samples of one layout: handed on one by one, like single frames */
+static void batch_frame(rx_stream_t *s, const uint8_t *raw, size_t n)
+{
+    const rx_layout_t *layout = n > BINFRAME_BATCH_HEADER
+                              ? layout_by_type(raw[1]) : NULL;
+    if (!layout || layout->side) {
+        s->n.bad_format++;
+        return;
+    }
+
+    size_t rec = BINFRAME_BATCH_RECORD((size_t)layout->n_values);
+    if ((n - BINFRAME_BATCH_HEADER) % rec != 0) {
+        s->n.bad_format++;
+        return;
+    }
+
+    uint32_t ts0 = binframe_get_u32(raw + 2);
+    for (const uint8_t *p = raw + BINFRAME_BATCH_HEADER; p < raw + n; p += rec) {
+        rx_frame_t out;
+        out.layout   = layout;
+        out.ts_ms    = (int64_t)ts0 + binframe_get_u16(p);
+        out.text     = NULL;
+        out.text_len = 0;
+        for (int i = 0; i < layout->n_values; i++)
+            out.v[i] = binframe_get_f32(p + 2 + 4 * i);
+
+        s->n.frames++;
+        s->on_frame(s->ctx, &out);
+    }
+}
+
+static void binary_frame(rx_stream_t *s, const uint8_t *block, size_t len)
+{
+    uint8_t raw[BINFRAME_MAX_WIRE];
+
+    if (len == 0)
+        return;
+    if (len > sizeof(raw)) {
+        s->n.bad_format++;
+        return;
+    }
+
+    size_t n = binframe_decode(block, len, raw);
+    if (n == 0) {
+        s->n.bad_checksum++;
+        return;
+    }
+
+    if (raw[0] == BINFRAME_TYPE_DELTA) {
+        delta_frame(s, raw, n);
+        return;
+    }
+    if (raw[0] == BINFRAME_TYPE_BATCH) {
+        batch_frame(s, raw, n);
+        return;
+    }
+
+    const rx_layout_t *layout = layout_by_type(raw[0]);
+    if (!layout || n != 1 + 4 + 4 * (size_t)layout->n_values) {
+        s->n.bad_format++;
+        return;
+    }
+
+    rx_frame_t out;
+    out.layout   = layout;
+    out.ts_ms    = binframe_get_u32(raw + 1);
+    out.text     = NULL;
+    out.text_len = 0;
+    for (int i = 0; i < layout->n_values; i++)
+        out.v[i] = binframe_get_f32(raw + 5 + 4 * i);
+
+    s->n.frames++;
+    s->on_frame(s->ctx, &out);
+}
+
+static void frame(rx_stream_t *s, const uint8_t *p, size_t len)
+{
+    if (s->binary)
+        binary_frame(s, p, len);
+    else
+        ascii_line(s, (const char *)p, len);
+}
+
+/* ============================================================
+ * STREAM
+ * ============================================================
+ */
+
+void rx_stream_init(rx_stream_t *s, int binary, rx_frame_fn on_frame, void *ctx)
+{
+    memset(s, 0, sizeof(*s));
+    s->binary   = binary;
+    s->on_frame = on_frame;
+    s->ctx      = ctx;
+    deltaframe_init(&s->delta);
+}
+
+void rx_stream_reset(rx_stream_t *s)
+{
+    s->n.resync_bytes += s->have;
+    s->have = 0;
+    deltaframe_init(&s->delta);
+}
+
+void rx_stream_feed(rx_stream_t *s, const uint8_t *data, size_t n)
+{
+    const uint8_t  delim = s->binary ? BINFRAME_DELIM : '\n';
+    const uint8_t *p     = data;
+    const uint8_t *end   = data + n;
+    const uint8_t *d;
+
+    s->n.bytes += n;
+
+    /* Complete the frame carried over from the previous chunk */
+    if (s->have > 0) {
+        d = memchr(p, delim, n);
+        size_t take = (size_t)((d ? d : end) - p);
+
+        if (s->have + take > RX_FRAME_MAX) {
+            /* The delta reference survives: the counter tells if it is stale */
+            s->n.resync_bytes += s->have;
+            s->have = 0;
+        } else {
+            memcpy(s->tail + s->have, p, take);
+            s->have += take;
+            if (!d)
+                return;
+            frame(s, s->tail, s->have);
+            s->have = 0;
+            p = d + 1;
+        }
+    }
+
+    while ((d = memchr(p, delim, (size_t)(end - p))) != NULL) {
+        frame(s, p, (size_t)(d - p));
+        p = d + 1;
+    }
+
+    /*
+     * No delimiter for RX_FRAME_MAX bytes: garbage. Keep only what could
+     * still be the start of a frame (from the last '$' in ASCII mode).
+     */
+    if ((size_t)(end - p) > RX_FRAME_MAX) {
+        const uint8_t *keep = end;
+        if (!s->binary) {
+            for (const uint8_t *q = p; (q = memchr(q, '$', (size_t)(end - q))); q++)
+                keep = q;
+            if (end - keep > RX_FRAME_MAX)
+                keep = end;
+        }
+        s->n.resync_bytes += (size_t)(keep - p);
+        p = keep;
+    }
+
+    s->have = (size_t)(end - p);
+    memcpy(s->tail, p, s->have);
+}
+
+/* ============================================================
+ * CSV ROWS
+ * ============================================================
+ */
+
+char *rx_format_header(char *dst, const rx_layout_t *layout)
+{
+    memcpy(dst, "timestamp_ms", 12);
+    dst += 12;
+    for (int i = 0; i < layout->n_values; i++) {
+        size_t n = strlen(layout->columns[i]);
+        *dst++ = ',';
+        memcpy(dst, layout->columns[i], n);
+        dst += n;
+    }
+    *dst++ = '\n';
+    return dst;
+}
+
+char *rx_format_row(char *dst, const rx_frame_t *f)
+{
+    if (f->text && f->text_len < RX_ROW_MAX) {
+        memcpy(dst, f->text, f->text_len);
+        dst += f->text_len;
+    } else {
+        dst = numfmt_i64(dst, f->ts_ms);
+        for (int i = 0; i < f->layout->n_values; i++) {
+            *dst++ = ',';
+            dst = numfmt_fixed(dst, f->v[i], f->layout->decimals[i]);
+        }
+    }
+    *dst++ = '\n';
+    return dst;
+}
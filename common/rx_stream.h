@@ -0,0 +1,112 @@
+/*
+ * rx_stream.h
+ *
+ * AIRMAN – Telemetry Stream Reassembly
+ * ------------------------------------
+ *
+ * Receiver core shared by telemetry_rx (one link) and ground_station
+ * (many links): turns arbitrary read(2) / recv(2) chunks of one link
+ * into validated frames.
+ *
+ *   - frame delimiters ('\n', or 0x00 for binary links) are found with
+ *     memchr() and frames are parsed in place in the caller's chunk;
+ *     only a partial frame at the end of a chunk is copied, into the
+ *     stream's small tail buffer, so per-link state stays ~600 bytes
+ *     and any number of links can share one read buffer
+ *   - ASCII lines go through txtparse.h. Every '$' on a line starts a
+ *     candidate frame, so a frame torn by byte loss costs only itself
+ *   - binary frames go through binframe_decode() (COBS + CRC16);
+ *     delta-compressed frames (deltaframe.h) are expanded against the
+ *     stream's reference values, and dropped from a lost frame until
+ *     the next keyframe; batch frames are handed on sample by sample,
+ *     so consumers see the same frames as from an unbatched link
+ *   - a run of RX_FRAME_MAX bytes without a delimiter is garbage and is
+ *     dropped up to the last possible frame start
+ *
+ * Valid frames are handed to the stream's callback with the layout
+ * (L1 / L2 / L2Q) looked up from the tag or frame type.
+ */
+
+#ifndef AIRMAN_RX_STREAM_H
+#define AIRMAN_RX_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "deltaframe.h"
+#include "numfmt.h"
+
+/* A partial frame longer than this is line noise */
+#define RX_FRAME_MAX     512
+
+#define RX_MAX_VALUES    8
+
+/* Longest CSV row rx_format_row() writes, '\n' included */
+#define RX_ROW_MAX       ((RX_MAX_VALUES + 1) * (NUMFMT_MAX_CHARS + 1) + 1)
+
+typedef struct {
+    const char *tag;                        /* ASCII frame tag */
+    uint8_t     type;                       /* binary frame type */
+    int         n_values;                   /* fields after the timestamp */
+    const char *columns[RX_MAX_VALUES];     /* receiver log column names */
+    int         decimals[RX_MAX_VALUES];    /* ASCII frame precision */
+    int         side;                       /* side channel (statistics),
+                                               interleaved with the main
+                                               telemetry layout */
+} rx_layout_t;
+
+/* L1, L2, L2S and L2Q layouts, as written by the transmitters */
+extern const rx_layout_t rx_layouts[];
+extern const int         rx_n_layouts;
+
+typedef struct {
+    const rx_layout_t *layout;
+    int64_t            ts_ms;
+    float              v[RX_MAX_VALUES];
+
+    /* ASCII frames: field text as received ("ts,v0,v1,..."), else NULL */
+    const char        *text;
+    size_t             text_len;
+} rx_frame_t;
+
+typedef void (*rx_frame_fn)(void *ctx, const rx_frame_t *f);
+
+typedef struct {
+    unsigned long      frames;
+    unsigned long      bad_checksum;
+    unsigned long      bad_format;      /* framing, tag, layout, fields */
+    unsigned long      resync_bytes;    /* skipped looking for a frame */
+    unsigned long      unsynced;        /* delta frames awaiting a keyframe */
+    unsigned long long bytes;
+} rx_counters_t;
+
+typedef struct {
+    int           binary;               /* COBS frames instead of ASCII */
+    rx_frame_fn   on_frame;
+    void         *ctx;
+    rx_counters_t n;
+    deltaframe_t  delta;                /* delta frame reference values */
+
+    size_t        have;                 /* bytes in tail */
+    uint8_t       tail[RX_FRAME_MAX];
+} rx_stream_t;
+
+void rx_stream_init(rx_stream_t *s, int binary, rx_frame_fn on_frame, void *ctx);
+
+/* Feed the next n bytes received on the link */
+void rx_stream_feed(rx_stream_t *s, const uint8_t *data, size_t n);
+
+/* Discard a partial frame and the delta reference (link closed or reconnected) */
+void rx_stream_reset(rx_stream_t *s);
+
+/*
+ * CSV in the receivers' log format. The header is
+ * "timestamp_ms,<columns>\n"; a row is the ASCII field text as received
+ * or, for binary frames, the values at the ASCII frame precision, so
+ * both link formats log identical rows. Return the new end of dst
+ * (RX_ROW_MAX bytes of room needed).
+ */
+char *rx_format_header(char *dst, const rx_layout_t *layout);
+char *rx_format_row(char *dst, const rx_frame_t *f);
+
+#endif /* AIRMAN_RX_STREAM_H */
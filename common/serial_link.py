@@ -0,0 +1,83 @@
+"""
+serial_link.py
+
+AIRMAN – Serial Port Input for the Python Receivers
+---------------------------------------------------
+
+Opens a UART (USB-serial adapter, on-board port) as a binary stream that
+the receivers read exactly like sys.stdin.buffer, using only the
+standard library (termios). Settings match common/serial_port.h: raw
+8N1, no echo or CR/LF translation, optional RTS/CTS flow control.
+
+Unlike the C backend the port is left blocking (VMIN = 1): the Python
+receivers read one stream with a for-loop and have nothing else to wait
+on. Large buffered reads keep the syscall count per frame low.
+"""
+
+import io
+import os
+import sys
+
+DEFAULT_BAUD = 115200
+
+# Bytes per read(2) through the buffered stream
+READ_BUFFER = 64 * 1024
+
+
+def open_serial(path, baud=DEFAULT_BAUD, rtscts=False):
+    """Open and configure path; returns a buffered binary reader."""
+    import termios   # POSIX only; pipe mode keeps working without it
+
+    speed = getattr(termios, "B%d" % baud, None)
+    if speed is None:
+        raise ValueError("unsupported baud rate on this platform: %d" % baud)
+
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    try:
+        iflag, oflag, cflag, lflag, _, _, cc = termios.tcgetattr(fd)
+
+        # Equivalent of cfmakeraw() + CLOCAL | CREAD, 8N1
+        iflag &= ~(termios.IGNBRK | termios.BRKINT | termios.PARMRK |
+                   termios.ISTRIP | termios.INLCR | termios.IGNCR |
+                   termios.ICRNL | termios.IXON | termios.IXOFF)
+        oflag &= ~termios.OPOST
+        lflag &= ~(termios.ECHO | termios.ECHONL | termios.ICANON |
+                   termios.ISIG | termios.IEXTEN)
+        cflag &= ~(termios.CSIZE | termios.PARENB | termios.CSTOPB)
+        cflag |= termios.CS8 | termios.CLOCAL | termios.CREAD
+        if hasattr(termios, "CRTSCTS"):
+            if rtscts:
+                cflag |= termios.CRTSCTS
+            else:
+                cflag &= ~termios.CRTSCTS
+
+        cc[termios.VMIN] = 1
+        cc[termios.VTIME] = 0
+
+        termios.tcsetattr(fd, termios.TCSANOW,
+                          [iflag, oflag, cflag, lflag, speed, speed, cc])
+        termios.tcflush(fd, termios.TCIOFLUSH)
+    except Exception:
+        os.close(fd)
+        raise
+
+    return io.BufferedReader(io.FileIO(fd, "rb", closefd=True),
+                             buffer_size=READ_BUFFER)
+
+
+def add_arguments(parser):
+    """--serial / --baud / --rtscts options shared by the receivers."""
+    parser.add_argument("--serial", metavar="DEV",
+                        help="read from a serial port instead of stdin")
+    parser.add_argument("--baud", type=int, default=DEFAULT_BAUD,
+                        help="serial rate, up to 4000000 (default %d)"
+                             % DEFAULT_BAUD)
+    parser.add_argument("--rtscts", action="store_true",
+                        help="RTS/CTS hardware flow control")
+
+
+def open_input(args):
+    """The serial port from --serial, otherwise binary stdin."""
+    if args.serial:
+        return open_serial(args.serial, args.baud, args.rtscts)
+    return sys.stdin.buffer
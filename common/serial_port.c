@@ -0,0 +1,166 @@
+/*
+ * serial_port.c
+ *
+ * AIRMAN – Serial port backend (see serial_port.h)
+ */
+
+#include <errno.h>
+
+#include "serial_port.h"
+
+#ifdef _WIN32
+
+int serial_open(const char *path, long baud, int flags)
+{
+    (void)path;
+    (void)baud;
+    (void)flags;
+    errno = ENOSYS;
+    return -1;
+}
+
+int serial_counters(int fd, serial_counters_t *c)
+{
+    (void)fd;
+    (void)c;
+    return -1;
+}
+
+#else
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/serial.h>
+#endif
+
+static const struct {
+    long    baud;
+    speed_t code;
+} baud_table[] = {
+    { 9600, B9600 },       { 19200, B19200 },     { 38400, B38400 },
+    { 57600, B57600 },     { 115200, B115200 },   { 230400, B230400 },
+#ifdef B460800
+    { 460800, B460800 },
+#endif
+#ifdef B500000
+    { 500000, B500000 },
+#endif
+#ifdef B921600
+    { 921600, B921600 },
+#endif
+#ifdef B1000000
+    { 1000000, B1000000 },
+#endif
+#ifdef B1500000
+    { 1500000, B1500000 },
+#endif
+#ifdef B2000000
+    { 2000000, B2000000 },
+#endif
+#ifdef B3000000
+    { 3000000, B3000000 },
+#endif
+#ifdef B3500000
+    { 3500000, B3500000 },
+#endif
+#ifdef B4000000
+    { 4000000, B4000000 },
+#endif
+};
+
+static int baud_code(long baud, speed_t *code)
+{
+    for (size_t i = 0; i < sizeof(baud_table) / sizeof(baud_table[0]); i++) {
+        if (baud_table[i].baud == baud) {
+            *code = baud_table[i].code;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int configure(int fd, speed_t speed, int flags)
+{
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0)
+        return -1;
+
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(tcflag_t)CSTOPB;
+#ifdef CRTSCTS
+    if (flags & SERIAL_RTSCTS)
+        tio.c_cflag |= CRTSCTS;
+    else
+        tio.c_cflag &= ~(tcflag_t)CRTSCTS;
+#else
+    (void)flags;
+#endif
+    tio.c_cc[VMIN]  = 0;
+    tio.c_cc[VTIME] = 0;
+
+    if (cfsetispeed(&tio, speed) != 0 || cfsetospeed(&tio, speed) != 0 ||
+        tcsetattr(fd, TCSANOW, &tio) != 0)
+        return -1;
+
+#ifdef __linux__
+    /* Push received bytes to the tty layer at once (best effort) */
+    struct serial_struct ss;
+    if (ioctl(fd, TIOCGSERIAL, &ss) == 0) {
+        ss.flags |= ASYNC_LOW_LATENCY;
+        ioctl(fd, TIOCSSERIAL, &ss);
+    }
+#endif
+
+    return tcflush(fd, TCIOFLUSH);
+}
+
+int serial_open(const char *path, long baud, int flags)
+{
+    speed_t speed;
+    if (baud_code(baud, &speed) != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* O_NONBLOCK: do not wait for carrier detect on open */
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0)
+        return -1;
+
+    if (configure(fd, speed, flags) != 0) {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+    return fd;
+}
+
+int serial_counters(int fd, serial_counters_t *c)
+{
+#if defined(__linux__) && defined(TIOCGICOUNT)
+    struct serial_icounter_struct ic;
+    if (ioctl(fd, TIOCGICOUNT, &ic) != 0)
+        return -1;
+
+    c->rx          = (unsigned long)ic.rx;
+    c->tx          = (unsigned long)ic.tx;
+    c->frame       = (unsigned long)ic.frame;
+    c->parity      = (unsigned long)ic.parity;
+    c->overrun     = (unsigned long)ic.overrun;
+    c->buf_overrun = (unsigned long)ic.buf_overrun;
+    return 0;
+#else
+    (void)fd;
+    memset(c, 0, sizeof(*c));
+    return -1;
+#endif
+}
+
+#endif /* _WIN32 */
@@ -0,0 +1,52 @@
+/*
+ * serial_port.h
+ *
+ * AIRMAN – Serial Port Backend
+ * ----------------------------
+ *
+ * Raw termios setup for a real UART link (USB-serial adapters, on-board
+ * UARTs), used by the transmitters and telemetry_rx in place of the
+ * stdout / stdin pipe.
+ *
+ *   - raw 8N1: no echo, no line editing, no CR/LF translation, no
+ *     software flow control, so binary frames pass through unchanged
+ *   - standard rates up to 4 Mbaud where the platform defines them
+ *   - the descriptor is non-blocking (VMIN = VTIME = 0): receivers
+ *     wait for data with epoll / poll and then drain it in large
+ *     read(2) chunks; link_write() waits for room on a full TX queue
+ *   - optional RTS/CTS hardware flow control, advisable above ~1 Mbaud
+ *     on adapters with small FIFOs
+ *
+ * Any bytes queued before the port was opened are discarded, so a
+ * receiver starts on a clean stream and resyncs on the next delimiter.
+ */
+
+#ifndef AIRMAN_SERIAL_PORT_H
+#define AIRMAN_SERIAL_PORT_H
+
+#define SERIAL_DEFAULT_BAUD  115200L
+
+/* serial_open() flags */
+#define SERIAL_RTSCTS        0x01
+
+/* UART driver error counters (Linux TIOCGICOUNT) */
+typedef struct {
+    unsigned long rx;            /* bytes received by the driver */
+    unsigned long tx;
+    unsigned long frame;         /* framing errors (baud mismatch, noise) */
+    unsigned long parity;
+    unsigned long overrun;       /* UART FIFO overruns */
+    unsigned long buf_overrun;   /* tty buffer overruns (reader too slow) */
+} serial_counters_t;
+
+/*
+ * Open and configure path (e.g. "/dev/ttyUSB0") at baud. Returns a
+ * non-blocking descriptor, or -1 (errno set; EINVAL for a rate the
+ * platform cannot set).
+ */
+int serial_open(const char *path, long baud, int flags);
+
+/* Read the driver counters; -1 if the port does not provide them */
+int serial_counters(int fd, serial_counters_t *c);
+
+#endif /* AIRMAN_SERIAL_PORT_H */
@@ -0,0 +1,17 @@
+/*
+ * sim_noise.c
+ *
+ * AIRMAN – Simulated sensor noise (see sim_noise.h)
+ */
+
+#include "sim_noise.h"
+
+#ifndef SIM_NOISE_GAUSS
+int sim_noise_gaussian;
+#endif
+
+void sim_noise_seed(prng_t *rng, int n, uint64_t seed)
+{
+    for (int i = 0; i < n; i++)
+        prng_seed(&rng[i], seed, (unsigned)i);
+}
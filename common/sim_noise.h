@@ -0,0 +1,76 @@
+/*
+ * sim_noise.h
+ *
+ * AIRMAN – Simulated Sensor Noise
+ * -------------------------------
+ *
+ * The noise term of the simulated sensors, shared by the Level-1 and
+ * Level-2 transmitters (level1/telemetry_tx.c, level2/ahrs_filter.c)
+ * and their benchmarks:
+ *
+ *   sim_noise(rng, amp)      float: uniform in [-amp, amp), or normal
+ *                            with the same RMS (amp / sqrt(3))
+ *   sim_noise_q16(rng, amp)  Q16 for the fixed-point build: uniform, or
+ *                            the sum of four 16-bit uniforms (Irwin–Hall),
+ *                            same RMS, near-normal, no float math
+ *   sim_noise_seed(...)      one generator per sensor from one seed
+ *
+ * Distribution:
+ *   chosen at run time (--gauss, sim_noise_set_gaussian()), or fixed
+ *   at build time with -DSIM_NOISE_GAUSS=0 / 1, which compiles the
+ *   other path out of the image (profiles/embedded.mk).
+ *
+ * Both functions are inline so the per-sample call costs one branch
+ * at most. The Q16 path uses only the integer core of prng.h, so the
+ * FPU-less builds do not link prng.c.
+ */
+
+#ifndef AIRMAN_SIM_NOISE_H
+#define AIRMAN_SIM_NOISE_H
+
+#include <stdint.h>
+
+#include "prng.h"
+
+#ifdef SIM_NOISE_GAUSS
+#define sim_noise_gaussian  SIM_NOISE_GAUSS
+#else
+extern int sim_noise_gaussian;
+#endif
+
+/*
+ * Select normal (1) or uniform (0) noise; call once at startup.
+ * Returns -1 when the build fixed the other distribution.
+ */
+static inline int sim_noise_set_gaussian(int on)
+{
+#ifdef SIM_NOISE_GAUSS
+    return on == SIM_NOISE_GAUSS ? 0 : -1;
+#else
+    sim_noise_gaussian = on;
+    return 0;
+#endif
+}
+
+static inline float sim_noise(prng_t *rng, float amp)
+{
+    if (sim_noise_gaussian)
+        return prng_gauss(rng) * (amp * 0.57735027f);
+    return prng_uniform_pm(rng, amp);
+}
+
+static inline int32_t sim_noise_q16(prng_t *rng, int32_t amp)
+{
+    if (sim_noise_gaussian) {
+        uint64_t r = prng_next_u64(rng);
+        int32_t sum = (int32_t)(r & 0xFFFF) + (int32_t)((r >> 16) & 0xFFFF) +
+                      (int32_t)((r >> 32) & 0xFFFF) + (int32_t)(r >> 48);
+        return (int32_t)(((int64_t)(sum - 0x20000) * amp) >> 16);
+    }
+    return (int32_t)(((int64_t)(prng_next_u32(rng) >> 16) * (2 * amp)) >> 16) - amp;
+}
+
+/* Streams 0 .. n-1 of seed into rng[0..n), one per sensor */
+void sim_noise_seed(prng_t *rng, int n, uint64_t seed);
+
+#endif /* AIRMAN_SIM_NOISE_H */
@@ -0,0 +1,121 @@
+/*
+ * spsc_ring.c
+ *
+ * AIRMAN – Lock-free SPSC frame ring (see spsc_ring.h)
+ */
+
+#include <string.h>
+
+#include "spsc_ring.h"
+
+int spsc_ring_init(spsc_ring_t *r, spsc_slot_t *storage, size_t capacity,
+                   spsc_policy_t policy)
+{
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+        return -1;
+
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    atomic_init(&r->dropped_newest, 0);
+    atomic_init(&r->dropped_oldest, 0);
+
+    r->slots  = storage;
+    r->mask   = capacity - 1;
+    r->policy = policy;
+    return 0;
+}
+
+uint8_t *spsc_ring_reserve(spsc_ring_t *r)
+{
+    size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+
+    while (head - tail > r->mask) {
+        /* Full */
+        if (r->policy == SPSC_DROP_NEWEST) {
+            atomic_fetch_add_explicit(&r->dropped_newest, 1, memory_order_relaxed);
+            return NULL;
+        }
+
+        /* Discard the oldest frame; fails only if the consumer took it */
+        if (atomic_compare_exchange_weak_explicit(&r->tail, &tail, tail + 1,
+                                                  memory_order_acq_rel,
+                                                  memory_order_acquire)) {
+            atomic_fetch_add_explicit(&r->dropped_oldest, 1, memory_order_relaxed);
+            tail++;
+        }
+    }
+
+    return r->slots[head & r->mask].data;
+}
+
+void spsc_ring_commit(spsc_ring_t *r, size_t len)
+{
+    size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    r->slots[head & r->mask].len = (uint16_t)len;
+
+    /* Publish: slot contents become visible before the new head */
+    atomic_store_explicit(&r->head, head + 1, memory_order_release);
+}
+
+int spsc_ring_push(spsc_ring_t *r, const void *data, size_t len)
+{
+    if (len > SPSC_SLOT_BYTES) {
+        atomic_fetch_add_explicit(&r->dropped_newest, 1, memory_order_relaxed);
+        return -1;
+    }
+
+    uint8_t *slot = spsc_ring_reserve(r);
+    if (!slot)
+        return -1;
+
+    memcpy(slot, data, len);
+    spsc_ring_commit(r, len);
+    return 0;
+}
+
+int spsc_ring_peek(spsc_ring_t *r, const uint8_t **data)
+{
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+    if (tail == head)
+        return -1;
+
+    const spsc_slot_t *slot = &r->slots[tail & r->mask];
+    *data = slot->data;
+    return slot->len;
+}
+
+void spsc_ring_release(spsc_ring_t *r)
+{
+    /* Only the consumer moves tail under SPSC_DROP_NEWEST */
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+}
+
+int spsc_ring_pop(spsc_ring_t *r, void *out, size_t cap)
+{
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+
+    for (;;) {
+        size_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (tail == head)
+            return -1;
+
+        const spsc_slot_t *slot = &r->slots[tail & r->mask];
+        size_t len = slot->len;
+        if (len > cap)
+            len = cap;
+        memcpy(out, slot->data, len);
+
+        /*
+         * Claim the frame. If the producer discarded it meanwhile
+         * (SPSC_DROP_OLDEST) the copy may be torn: retry with the
+         * updated tail.
+         */
+        if (atomic_compare_exchange_strong_explicit(&r->tail, &tail, tail + 1,
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire))
+            return (int)len;
+    }
+}
@@ -0,0 +1,110 @@
+/*
+ * spsc_ring.h
+ *
+ * AIRMAN – Lock-Free Single-Producer / Single-Consumer Frame Ring
+ * ---------------------------------------------------------------
+ *
+ * Carries encoded telemetry frames from the control loop (producer)
+ * to the I/O thread (consumer) without locks, so a stalled pipe or
+ * UART can never block the estimator.
+ *
+ * Each slot holds one frame of up to SPSC_SLOT_BYTES. Capacity must be
+ * a power of two. When the ring is full the overflow policy decides
+ * which frame is lost:
+ *
+ *   SPSC_DROP_NEWEST  the frame being pushed is discarded
+ *   SPSC_DROP_OLDEST  the oldest queued frame is discarded to make room
+ *                     (the link always carries the freshest data)
+ *
+ * Both cases are counted so overflow is visible in telemetry stats.
+ *
+ * Synchronization:
+ *   head is written only by the producer. tail is advanced by the
+ *   consumer, and also by the producer under SPSC_DROP_OLDEST; both
+ *   sides advance it with compare-and-swap, so a frame the producer
+ *   discards while the consumer is copying it is detected and skipped.
+ *
+ * Zero-copy use:
+ *   The producer can reserve the next slot, encode a frame directly
+ *   into it and commit it (no staging buffer, no memcpy). Under
+ *   SPSC_DROP_NEWEST the producer never touches queued slots, so the
+ *   consumer can also peek at a frame, hand the slot memory to
+ *   write(2) and release it afterwards. Under SPSC_DROP_OLDEST the
+ *   consumer must pop (copy), since the producer may recycle the slot
+ *   while it is being read.
+ */
+
+#ifndef AIRMAN_SPSC_RING_H
+#define AIRMAN_SPSC_RING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SPSC_SLOT_BYTES    120
+#define SPSC_CACHE_LINE    64
+
+typedef enum {
+    SPSC_DROP_NEWEST = 0,
+    SPSC_DROP_OLDEST = 1
+} spsc_policy_t;
+
+typedef struct {
+    uint16_t len;
+    uint8_t  data[SPSC_SLOT_BYTES];
+} spsc_slot_t;
+
+typedef struct {
+    /* Producer and consumer indices on separate cache lines */
+    _Alignas(SPSC_CACHE_LINE) atomic_size_t head;
+    _Alignas(SPSC_CACHE_LINE) atomic_size_t tail;
+
+    _Alignas(SPSC_CACHE_LINE) atomic_ulong dropped_newest;
+    atomic_ulong  dropped_oldest;
+
+    spsc_slot_t  *slots;
+    size_t        mask;
+    spsc_policy_t policy;
+} spsc_ring_t;
+
+/*
+ * Initialize a ring over caller-provided storage of `capacity` slots.
+ * Returns 0, or -1 if capacity is not a non-zero power of two.
+ */
+int spsc_ring_init(spsc_ring_t *r, spsc_slot_t *storage, size_t capacity,
+                   spsc_policy_t policy);
+
+/*
+ * Producer: queue one frame (len <= SPSC_SLOT_BYTES).
+ * Never blocks. Returns 0 if the frame was queued, -1 if it was
+ * dropped (too long, or ring full under SPSC_DROP_NEWEST).
+ */
+int spsc_ring_push(spsc_ring_t *r, const void *data, size_t len);
+
+/*
+ * Producer, zero-copy: return the next free slot's data area
+ * (SPSC_SLOT_BYTES), applying the overflow policy if the ring is full.
+ * Returns NULL if the frame must be dropped (SPSC_DROP_NEWEST, full);
+ * the drop is already counted. Follow with spsc_ring_commit().
+ */
+uint8_t *spsc_ring_reserve(spsc_ring_t *r);
+
+/* Producer: publish the reserved slot holding len bytes */
+void spsc_ring_commit(spsc_ring_t *r, size_t len);
+
+/*
+ * Consumer, zero-copy (SPSC_DROP_NEWEST rings only): point *data at the
+ * oldest frame in place. Returns its length, or -1 if the ring is
+ * empty. The slot stays owned by the consumer until
+ * spsc_ring_release().
+ */
+int  spsc_ring_peek(spsc_ring_t *r, const uint8_t **data);
+void spsc_ring_release(spsc_ring_t *r);
+
+/*
+ * Consumer: copy the oldest frame into out (cap bytes).
+ * Returns the frame length, or -1 if the ring is empty.
+ */
+int spsc_ring_pop(spsc_ring_t *r, void *out, size_t cap);
+
+#endif /* AIRMAN_SPSC_RING_H */
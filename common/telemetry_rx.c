@@ -0,0 +1,470 @@
+/*
+ * telemetry_rx.c
+ *
+ * AIRMAN – Native Telemetry Receiver
+ * ----------------------------------
+ *
+ * C replacement for the per-line parsing in level1/uart_rx.py and
+ * level2/plot_live.py, for frame rates (1 kHz, several vehicles) that
+ * Python's strip / split / int(..., 16) per line cannot keep up with.
+ *
+ *   - input is stdin, a file, or a UART (--serial, serial_port.h).
+ *     Pipes and ports are non-blocking: the receiver sleeps in epoll
+ *     and drains everything available in large read(2) chunks
+ *   - chunks are split into frames by rx_stream.h: memchr() for the
+ *     delimiters, per-frame resync, ASCII frames validated by
+ *     txtparse.h (XOR8 or CRC16, locale-free numfmt_parse()), binary
+ *     frames by binframe_decode() (COBS + CRC16), delta-compressed
+ *     ones (ahrs_filter --delta) expanded by deltaframe.h
+ *   - valid frames are written in batches: one write(2) per wakeup
+ *
+ * The first valid frame selects the layout (L1, L2 or L2Q); frames of the
+ * other layout are counted and dropped. Loop-statistics frames ($L2S,
+ * see ahrs_filter.c) are side-channel frames, kept apart from the
+ * telemetry. Outputs, any combination:
+ *
+ *   --csv PATH    the same CSV as uart_rx.py / plot_live.py. ASCII field
+ *                 text is copied as received; binary floats are printed
+ *                 at the ASCII frame precision, so both modes match.
+ *   --flog PATH   binary flight log (flightlog.h). "-" streams it to
+ *                 stdout, where flightlog.FlightLogStream hands whole
+ *                 record batches to Python / numpy.frombuffer().
+ *   --loop-csv PATH the $L2S loop statistics as CSV (read by the
+ *                 dashboard, like plot_live.py's level2_loop_stats.csv).
+ *   --feed PATH   every valid frame (telemetry and statistics) to the
+ *                 live subscribers of a Unix socket (live_feed.h), one
+ *                 message per wakeup; `dash.py -- --feed PATH` updates
+ *                 on arrival instead of polling the logs.
+ *
+ * Counters (frames, checksum and format errors, resync bytes, delta
+ * frames dropped while waiting for a keyframe ("unsynced"), MB/s)
+ * are printed on stderr at the end of the stream or on SIGINT/SIGTERM;
+ * --stats adds a line per second, with the UART driver's overrun and
+ * framing counters when reading a serial port.
+ *
+ * Usage:
+ *   ./telemetry_tx | ./telemetry_rx --csv output.csv
+ *   ./telemetry_tx --binary | ./telemetry_rx --binary --flog output.flog
+ *   ./ahrs_filter | ./telemetry_rx --flog - | python consumer.py
+ *   ./telemetry_rx capture.bin --binary --csv out.csv
+ *   ./ahrs_filter | ./telemetry_rx --flog flight.flog --feed /tmp/airman.feed
+ *   ./telemetry_rx --serial /dev/ttyUSB0 --baud 3000000 --binary \
+ *                  --flog flight.flog --stats
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define read  _read
+#define close _close
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+#include "flightlog.h"
+#include "link_io.h"
+#include "live_feed.h"
+#include "rx_stream.h"
+#include "serial_port.h"
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+/* Bytes per read(2) */
+#ifndef RX_CHUNK_BYTES
+#define RX_CHUNK_BYTES   (256 * 1024)
+#endif
+
+#define CSV_BUF_BYTES    (256 * 1024)
+
+/* ============================================================
+ * OUTPUTS
+ * ============================================================
+ */
+
+typedef struct {
+    int    fd;
+    char   buf[CSV_BUF_BYTES];
+    size_t len;
+} csv_out_t;
+
+typedef struct {
+    rx_stream_t        stream;
+    const rx_layout_t *layout;      /* set by the first valid frame */
+    int                serial;      /* input is a serial_port.h UART */
+
+    const char  *csv_path;
+    const char  *flog_path;
+    const char  *loop_csv_path;
+    const char  *feed_path;
+    csv_out_t   *csv;
+    flightlog_t *flog;
+    csv_out_t   *loop_csv;
+    live_feed_t *feed;
+
+    unsigned long unexpected;       /* valid, but not the selected layout */
+    unsigned long side;             /* side-channel (statistics) frames */
+} rx_t;
+
+static int open_out(const char *path)
+{
+    if (strcmp(path, "-") == 0)
+        return 1;
+    return open(path, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+}
+
+static void csv_flush(csv_out_t *o)
+{
+    if (o->len > 0 && link_write(o->fd, o->buf, o->len) != 0)
+        perror("csv");
+    o->len = 0;
+}
+
+static void csv_put(csv_out_t *o, const rx_frame_t *f)
+{
+    if (CSV_BUF_BYTES - o->len < RX_ROW_MAX)
+        csv_flush(o);
+    o->len = (size_t)(rx_format_row(o->buf + o->len, f) - o->buf);
+}
+
+/* --loop-csv, opened by the first statistics frame; -1 on error */
+static int rx_open_side(rx_t *rx, const rx_layout_t *layout)
+{
+    static csv_out_t csv;
+    csv.fd = open_out(rx->loop_csv_path);
+    if (csv.fd < 0) {
+        perror(rx->loop_csv_path);
+        return -1;
+    }
+    csv.len = (size_t)(rx_format_header(csv.buf, layout) - csv.buf);
+    rx->loop_csv = &csv;
+    return 0;
+}
+
+/* Open the outputs once the layout is known; -1 on error */
+static int rx_select(rx_t *rx, const rx_layout_t *layout)
+{
+    rx->layout = layout;
+
+    if (rx->csv_path) {
+        static csv_out_t csv;
+        csv.fd = open_out(rx->csv_path);
+        if (csv.fd < 0) {
+            perror(rx->csv_path);
+            return -1;
+        }
+        csv.len = (size_t)(rx_format_header(csv.buf, layout) - csv.buf);
+        rx->csv = &csv;
+    }
+
+    if (rx->flog_path) {
+        static flightlog_t flog;
+        if (flightlog_create(&flog, rx->flog_path, layout->columns,
+                             layout->n_values) != 0) {
+            perror(rx->flog_path);
+            return -1;
+        }
+        rx->flog = &flog;
+    }
+    return 0;
+}
+
+/* rx_stream_t callback: one validated frame */
+static void rx_frame(void *ctx, const rx_frame_t *f)
+{
+    rx_t *rx = ctx;
+
+    if (f->layout->side) {
+        rx->side++;
+        if (rx->loop_csv_path && !rx->loop_csv && rx_open_side(rx, f->layout) != 0)
+            exit(1);
+        if (rx->loop_csv)
+            csv_put(rx->loop_csv, f);
+        if (rx->feed)
+            live_feed_put(rx->feed, f->layout->type, f->ts_ms, f->v,
+                          f->layout->n_values);
+        return;
+    }
+
+    if (!rx->layout && rx_select(rx, f->layout) != 0)
+        exit(1);
+    if (f->layout != rx->layout) {
+        rx->unexpected++;
+        return;
+    }
+
+    if (rx->csv)
+        csv_put(rx->csv, f);
+    if (rx->flog)
+        flightlog_append(rx->flog, f->ts_ms, f->v);
+    if (rx->feed)
+        live_feed_put(rx->feed, f->layout->type, f->ts_ms, f->v,
+                      f->layout->n_values);
+}
+
+static void rx_flush(rx_t *rx)
+{
+    if (rx->csv)
+        csv_flush(rx->csv);
+    if (rx->loop_csv)
+        csv_flush(rx->loop_csv);
+    if (rx->flog)
+        flightlog_flush(rx->flog);
+    if (rx->feed)
+        live_feed_flush(rx->feed);
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================
+ */
+
+static volatile sig_atomic_t stop_requested;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* One read(2): 1 data, 0 end of stream, -1 nothing available / error */
+static int rx_read(rx_t *rx, int fd)
+{
+    static uint8_t chunk[RX_CHUNK_BYTES];
+
+    ssize_t n = read(fd, chunk, sizeof(chunk));
+    if (n > 0) {
+        rx_stream_feed(&rx->stream, chunk, (size_t)n);
+        return 1;
+    }
+    if (n == 0)
+        return rx->serial ? -1 : 0;     /* VMIN = 0: no data, not EOF */
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+        return -1;
+    perror("read");
+    return 0;
+}
+
+/* --stats: one line per second of rates and cumulative error counters */
+static void rx_report(const rx_t *rx, int fd, const rx_counters_t *prev,
+                      double dt)
+{
+    const rx_counters_t *n = &rx->stream.n;
+
+    fprintf(stderr,
+            "[rx] %.0f frames/s, %.3f MB/s; errors: %lu checksum, "
+            "%lu format, %lu other-layout, %lu resync bytes, %lu unsynced",
+            (n->frames - prev->frames) / dt, (n->bytes - prev->bytes) / dt * 1e-6,
+            n->bad_checksum, n->bad_format, rx->unexpected, n->resync_bytes,
+            n->unsynced);
+
+    serial_counters_t c;
+    if (rx->serial && serial_counters(fd, &c) == 0)
+        fprintf(stderr, "; uart: %lu overrun, %lu buf-overrun, %lu framing, "
+                "%lu parity", c.overrun, c.buf_overrun, c.frame, c.parity);
+    fputc('\n', stderr);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: telemetry_rx [input | --serial DEV [--baud N] [--rtscts]]\n"
+            "                    [--binary] [--csv PATH|-] [--flog PATH|-]\n"
+            "                    [--loop-csv PATH|-] [--feed PATH] [--stats]\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *in_path     = NULL;
+    const char *serial_path = NULL;
+    long serial_baud  = SERIAL_DEFAULT_BAUD;
+    int  serial_flags = 0;
+    int  binary_mode  = 0;
+    int  stats        = 0;
+    static rx_t rx;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--binary") == 0)
+            binary_mode = 1;
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+            rx.csv_path = argv[++i];
+        else if (strcmp(argv[i], "--flog") == 0 && i + 1 < argc)
+            rx.flog_path = argv[++i];
+        else if (strcmp(argv[i], "--loop-csv") == 0 && i + 1 < argc)
+            rx.loop_csv_path = argv[++i];
+        else if (strcmp(argv[i], "--feed") == 0 && i + 1 < argc)
+            rx.feed_path = argv[++i];
+        else if (strcmp(argv[i], "--serial") == 0 && i + 1 < argc)
+            serial_path = argv[++i];
+        else if (strcmp(argv[i], "--baud") == 0 && i + 1 < argc)
+            serial_baud = atol(argv[++i]);
+        else if (strcmp(argv[i], "--rtscts") == 0)
+            serial_flags |= SERIAL_RTSCTS;
+        else if (strcmp(argv[i], "--stats") == 0)
+            stats = 1;
+        else if (argv[i][0] != '-' && !in_path)
+            in_path = argv[i];
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if ((in_path && serial_path) ||
+        (rx.csv_path && rx.flog_path &&
+         strcmp(rx.csv_path, "-") == 0 && strcmp(rx.flog_path, "-") == 0)) {
+        usage();
+        return 2;
+    }
+
+    rx_stream_init(&rx.stream, binary_mode, rx_frame, &rx);
+
+    int fd = 0;
+    if (serial_path) {
+        fd = serial_open(serial_path, serial_baud, serial_flags);
+        if (fd < 0) {
+            perror(serial_path);
+            return 1;
+        }
+        rx.serial = 1;
+    } else if (in_path) {
+        fd = open(in_path, O_RDONLY | O_BINARY);
+        if (fd < 0) {
+            perror(in_path);
+            return 1;
+        }
+    }
+
+    static live_feed_t feed;
+    if (rx.feed_path) {
+        if (live_feed_open(&feed, rx.feed_path) != 0) {
+            perror(rx.feed_path);
+            return 1;
+        }
+        rx.feed = &feed;
+    }
+
+#ifndef _WIN32
+    /* No SA_RESTART: a blocked read(2) / epoll_wait() returns at once */
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+#else
+    signal(SIGINT, on_signal);
+#endif
+
+    /*
+     * Pipes, sockets and serial ports: wait in epoll, then drain every
+     * available byte in RX_CHUNK_BYTES reads. Regular files cannot be
+     * polled and are read straight through.
+     */
+    int ep = -1;
+#ifdef __linux__
+    struct stat st;
+    if (fstat(fd, &st) == 0 && !S_ISREG(st.st_mode)) {
+        struct epoll_event ev = { .events = EPOLLIN };
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        ep = epoll_create1(0);
+        if (ep >= 0 && epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(ep);
+            ep = -1;
+        }
+        if (ep < 0)
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    }
+#endif
+
+    double t0 = now_sec();
+    double last_report = t0;
+    rx_counters_t reported = rx.stream.n;
+    int open_stream = 1;
+
+    while (open_stream && !stop_requested) {
+#ifdef __linux__
+        if (ep >= 0) {
+            /* Hang-ups show up as EOF / EIO from the read below */
+            struct epoll_event ev;
+            if (epoll_wait(ep, &ev, 1, stats ? 1000 : -1) < 0 &&
+                errno != EINTR) {
+                perror("epoll_wait");
+                break;
+            }
+        }
+#endif
+        /* Drain: several chunks per wakeup at high rates */
+        int r;
+        while ((r = rx_read(&rx, fd)) > 0 && ep >= 0 && !stop_requested)
+            ;
+        if (r == 0)
+            open_stream = 0;
+
+        /* One write per wakeup keeps slow links live for readers */
+        rx_flush(&rx);
+
+        double now = now_sec();
+        if (stats && now - last_report >= 1.0) {
+            rx_report(&rx, fd, &reported, now - last_report);
+            reported    = rx.stream.n;
+            last_report = now;
+        }
+    }
+
+    double elapsed = now_sec() - t0;
+    const rx_counters_t *n = &rx.stream.n;
+
+    rx_flush(&rx);
+    if (rx.csv && rx.csv->fd != 1)
+        close(rx.csv->fd);
+    if (rx.loop_csv && rx.loop_csv->fd != 1)
+        close(rx.loop_csv->fd);
+    if (rx.flog)
+        flightlog_close(rx.flog);
+    if (rx.feed)
+        live_feed_close(rx.feed);
+    if (ep >= 0)
+        close(ep);
+    if (in_path || serial_path)
+        close(fd);
+
+    unsigned long telemetry = n->frames - rx.unexpected - rx.side;
+    fprintf(stderr,
+            "received %lu %s frames (%.2f MB) in %.3f s: "
+            "%.0f frames/s, %.1f MB/s\n",
+            telemetry, rx.layout ? rx.layout->tag : "--",
+            n->bytes * 1e-6, elapsed,
+            elapsed > 0 ? telemetry / elapsed : 0.0,
+            elapsed > 0 ? n->bytes / elapsed * 1e-6 : 0.0);
+    if (rx.side)
+        fprintf(stderr, "%lu loop-statistics frames\n", rx.side);
+    fprintf(stderr,
+            "errors: %lu checksum, %lu format, %lu other-layout, "
+            "%lu resync bytes, %lu unsynced\n",
+            n->bad_checksum, n->bad_format, rx.unexpected, n->resync_bytes,
+            n->unsynced);
+    if (rx.feed)
+        fprintf(stderr, "feed: %lu records published, %lu subscribers, "
+                "%lu records dropped\n", feed.published, feed.subscribers,
+                feed.dropped);
+    return 0;
+}
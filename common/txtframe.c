@@ -0,0 +1,97 @@
+/*
+ * txtframe.c
+ *
+ * AIRMAN – Single-pass ASCII telemetry frames (see txtframe.h)
+ */
+
+#include <string.h>
+
+#include "txtframe.h"
+
+/* Fold the bytes written since the last call into the checksum */
+static void fold(txtframe_t *f)
+{
+    checksum_update(&f->chk, f->buf + f->chk_from, f->len - f->chk_from);
+    f->chk_from = f->len;
+}
+
+/* Room for a separator plus one formatted number */
+static char *field_start(txtframe_t *f)
+{
+    if (f->overflow || f->cap - f->len < 1 + NUMFMT_MAX_CHARS) {
+        f->overflow = 1;
+        return NULL;
+    }
+    f->buf[f->len++] = ',';
+    return f->buf + f->len;
+}
+
+static void field_end(txtframe_t *f, char *end)
+{
+    f->len = (size_t)(end - f->buf);
+    fold(f);
+}
+
+void txtframe_begin(txtframe_t *f, char *buf, size_t cap,
+                    checksum_kind_t kind, const char *tag)
+{
+    size_t tag_len = strlen(tag);
+
+    f->buf      = buf;
+    f->cap      = cap;
+    f->overflow = cap < 1 + tag_len;
+    f->len      = 0;
+    f->chk_from = 0;
+
+    checksum_init(&f->chk, kind);
+    if (f->overflow)
+        return;
+
+    /* '$' is not covered by the checksum */
+    buf[f->len++] = '$';
+    f->chk_from = f->len;
+    memcpy(buf + f->len, tag, tag_len);
+    f->len += tag_len;
+    fold(f);
+}
+
+void txtframe_put_i64(txtframe_t *f, int64_t v)
+{
+    char *p = field_start(f);
+    if (p)
+        field_end(f, numfmt_i64(p, v));
+}
+
+void txtframe_put_fixed(txtframe_t *f, double v, int decimals)
+{
+    char *p = field_start(f);
+    if (p)
+        field_end(f, numfmt_fixed(p, v, decimals));
+}
+
+void txtframe_put_scaled(txtframe_t *f, int64_t v, int decimals)
+{
+    char *p = field_start(f);
+    if (p)
+        field_end(f, numfmt_scaled(p, v, decimals));
+}
+
+size_t txtframe_finish(txtframe_t *f)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    if (f->overflow || f->cap - f->len < TXTFRAME_TRAILER_MAX)
+        return 0;
+
+    uint16_t chk    = checksum_final(&f->chk);
+    int      digits = checksum_hex_digits(f->chk.kind);
+
+    char *p = f->buf + f->len;
+    *p++ = '*';
+    for (int shift = 4 * (digits - 1); shift >= 0; shift -= 4)
+        *p++ = hex[(chk >> shift) & 0xF];
+    *p++ = '\n';
+
+    f->len = (size_t)(p - f->buf);
+    return f->len;
+}
@@ -0,0 +1,65 @@
+/*
+ * txtframe.h
+ *
+ * AIRMAN – Single-Pass ASCII Telemetry Frames
+ * -------------------------------------------
+ *
+ * Builds "$<tag>,<field>,...*<CHK>\n" frames directly in the caller's
+ * buffer. Fields are formatted with numfmt.h and folded into the
+ * checksum as soon as they are written, while the bytes are still in
+ * L1, so there is no separate payload buffer, no copy into a frame
+ * buffer and no second checksum pass over the finished string.
+ *
+ * Checksums (over every byte between '$' and '*', streamed through
+ * checksum.h):
+ *   CHECKSUM_XOR8    8-bit XOR, "*%02X"   (Level-1 frames)
+ *   CHECKSUM_CRC16   CRC16-CCITT, "*%04X" (Level-2 frames)
+ *
+ * The buffer can be the final transmit buffer (a ring slot, a DMA
+ * buffer): the finished frame is ready for write(2) as it stands.
+ *
+ * Usage:
+ *   txtframe_t f;
+ *   txtframe_begin(&f, buf, sizeof(buf), CHECKSUM_CRC16, "L2");
+ *   txtframe_put_i64(&f, ts);
+ *   txtframe_put_fixed(&f, roll, 2);
+ *   size_t n = txtframe_finish(&f);    // 0 if buf was too small
+ */
+
+#ifndef AIRMAN_TXTFRAME_H
+#define AIRMAN_TXTFRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "checksum.h"
+#include "numfmt.h"
+
+/* Trailer is at most "*XXXX\n" */
+#define TXTFRAME_TRAILER_MAX  6
+
+typedef struct {
+    char          *buf;
+    size_t         cap;
+    size_t         len;
+    size_t         chk_from;   /* first byte not yet checksummed */
+    checksum_t     chk;
+    int            overflow;
+} txtframe_t;
+
+/* Start a frame: writes '$' and the tag (e.g. "L1") */
+void txtframe_begin(txtframe_t *f, char *buf, size_t cap,
+                    checksum_kind_t kind, const char *tag);
+
+/* Append ",<value>" */
+void txtframe_put_i64(txtframe_t *f, int64_t v);
+void txtframe_put_fixed(txtframe_t *f, double v, int decimals);
+void txtframe_put_scaled(txtframe_t *f, int64_t v, int decimals);
+
+/*
+ * Append "*<CHK>\n". Returns the frame length, or 0 if any field did
+ * not fit in the buffer.
+ */
+size_t txtframe_finish(txtframe_t *f);
+
+#endif /* AIRMAN_TXTFRAME_H */
@@ -0,0 +1,86 @@
+/*
+ * txtparse.c
+ *
+ * AIRMAN – ASCII telemetry frame parser (see txtparse.h)
+ */
+
+#include <string.h>
+
+#include "numfmt.h"
+#include "txtparse.h"
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+txtparse_status_t txtparse_line(txtparse_t *f, const char *line, size_t len)
+{
+    const char *end = line + len;
+
+    if (len > 0 && end[-1] == '\r')
+        end--;
+
+    /* "*XX" or "*XXXX" closes the line, so '*' is at a fixed offset */
+    const char *star;
+    if (end - line >= 4 && end[-3] == '*') {
+        star    = end - 3;
+        f->kind = CHECKSUM_XOR8;
+    } else if (end - line >= 6 && end[-5] == '*') {
+        star    = end - 5;
+        f->kind = CHECKSUM_CRC16;
+    } else {
+        return TXTPARSE_ERR_FORMAT;
+    }
+
+    /* Last '$' before '*': resync past a torn frame on the same line */
+    const char *start = memchr(line, '$', (size_t)(star - line));
+    if (!start)
+        return TXTPARSE_ERR_FORMAT;
+    for (const char *q; (q = memchr(start + 1, '$', (size_t)(star - start - 1)));)
+        start = q;
+    f->skipped = (size_t)(start - line);
+
+    unsigned recv = 0;
+    for (const char *h = star + 1; h < end; h++) {
+        int d = hex_value(*h);
+        if (d < 0)
+            return TXTPARSE_ERR_FORMAT;
+        recv = recv << 4 | (unsigned)d;
+    }
+
+    checksum_t chk;
+    checksum_init(&chk, f->kind);
+    checksum_update(&chk, start + 1, (size_t)(star - start - 1));
+    if (checksum_final(&chk) != recv)
+        return TXTPARSE_ERR_CHECKSUM;
+
+    const char *p       = start + 1;
+    const char *tag_end = memchr(p, ',', (size_t)(star - p));
+    if (!tag_end)
+        tag_end = star;
+    if (tag_end == p || tag_end - p >= TXTPARSE_TAG_MAX)
+        return TXTPARSE_ERR_FORMAT;
+    memcpy(f->tag, p, (size_t)(tag_end - p));
+    f->tag[tag_end - p] = '\0';
+
+    f->text     = tag_end < star ? tag_end + 1 : star;
+    f->text_len = (size_t)(star - f->text);
+    f->n_fields = 0;
+
+    /* p is always at a ',' (or at '*' once the fields are done) */
+    for (p = tag_end; p < star; f->n_fields++) {
+        if (f->n_fields == TXTPARSE_MAX_FIELDS)
+            return TXTPARSE_ERR_FIELDS;
+        p = numfmt_parse(p + 1, star, &f->v[f->n_fields]);
+        if (!p || (p < star && *p != ','))
+            return TXTPARSE_ERR_FIELDS;
+    }
+    return TXTPARSE_OK;
+}
@@ -0,0 +1,65 @@
+/*
+ * txtparse.h
+ *
+ * AIRMAN – ASCII Telemetry Frame Parser
+ * -------------------------------------
+ *
+ * Receiver-side counterpart of txtframe.h. Validates and splits one
+ * "$<tag>,<field>,...*<CHK>" line in a single pass over the bytes:
+ *
+ *   - the checksum closes the line, so '*' is looked up at its fixed
+ *     offset from the end: "*XX" is XOR8, "*XXXX" CRC16 (checksum.h)
+ *   - '$' and the tag's ',' are found with memchr(), not a per-char
+ *     loop
+ *   - fields are converted with numfmt_parse(), without strtod() and
+ *     its locale lookups, straight from the receive buffer (the line
+ *     need not be NUL-terminated)
+ *
+ * Bytes before the last '$' ahead of '*' are skipped, so a frame torn
+ * by byte loss and followed by a complete one on the same line still
+ * yields the complete frame; the number of skipped bytes is reported.
+ *
+ * Usage:
+ *   txtparse_t f;
+ *   if (txtparse_line(&f, line, len) == TXTPARSE_OK)
+ *       ... f.tag, f.n_fields, f.v[0..n_fields) ...
+ */
+
+#ifndef AIRMAN_TXTPARSE_H
+#define AIRMAN_TXTPARSE_H
+
+#include <stddef.h>
+
+#include "checksum.h"
+
+#define TXTPARSE_TAG_MAX     8      /* tag characters, NUL included */
+#define TXTPARSE_MAX_FIELDS  16
+
+typedef enum {
+    TXTPARSE_OK = 0,
+    TXTPARSE_ERR_FORMAT,            /* no '$' / '*', bad tag or hex digits */
+    TXTPARSE_ERR_CHECKSUM,          /* checksum mismatch */
+    TXTPARSE_ERR_FIELDS,            /* a field is not a number, or too many */
+} txtparse_status_t;
+
+typedef struct {
+    char            tag[TXTPARSE_TAG_MAX];
+    checksum_kind_t kind;
+    int             n_fields;
+    double          v[TXTPARSE_MAX_FIELDS];
+
+    /* Field text as received: from the first field up to '*' */
+    const char     *text;
+    size_t          text_len;
+
+    size_t          skipped;        /* bytes before '$' */
+} txtparse_t;
+
+/*
+ * Parse the len bytes of one line (the '\n' excluded; a trailing '\r'
+ * is allowed). Returns TXTPARSE_OK once the checksum has been verified
+ * and every field converted.
+ */
+txtparse_status_t txtparse_line(txtparse_t *f, const char *line, size_t len);
+
+#endif /* AIRMAN_TXTPARSE_H */
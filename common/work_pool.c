@@ -0,0 +1,196 @@
+/*
+ * work_pool.c
+ *
+ * AIRMAN – Work-stealing task pool (see work_pool.h)
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "work_pool.h"
+
+#define WORK_POOL_LINE  64
+
+/* head << 32 | tail: positions in pool_t.ids, [head, tail) queued */
+typedef struct {
+    _Alignas(WORK_POOL_LINE)
+    _Atomic uint64_t span;
+} deque_t;
+
+typedef struct {
+    work_pool_fn       fn;
+    void              *ctx;
+    int                n_workers;
+    const int         *ids;           /* dealt tasks, one slice per deque */
+    deque_t           *deque;
+    work_pool_stats_t *stats;
+} pool_t;
+
+typedef struct {
+    pool_t   *pool;
+    int       worker;
+    pthread_t tid;
+} worker_t;
+
+static uint64_t pack(uint32_t head, uint32_t tail)
+{
+    return (uint64_t)head << 32 | tail;
+}
+
+/* Owner end: oldest task first, so the caller's order is kept */
+static int take_front(pool_t *p, deque_t *d)
+{
+    uint64_t s = atomic_load(&d->span);
+    for (;;) {
+        uint32_t head = (uint32_t)(s >> 32), tail = (uint32_t)s;
+        if (head >= tail)
+            return -1;
+        if (atomic_compare_exchange_weak(&d->span, &s, pack(head + 1, tail)))
+            return p->ids[head];
+    }
+}
+
+/* Thief end: the task the owner would reach last */
+static int take_back(pool_t *p, deque_t *d)
+{
+    uint64_t s = atomic_load(&d->span);
+    for (;;) {
+        uint32_t head = (uint32_t)(s >> 32), tail = (uint32_t)s;
+        if (head >= tail)
+            return -1;
+        if (atomic_compare_exchange_weak(&d->span, &s, pack(head, tail - 1)))
+            return p->ids[tail - 1];
+    }
+}
+
+/* Deques only shrink: one pass that finds them all empty ends the worker */
+static int steal(pool_t *p, int self, uint32_t *rng)
+{
+    /* xorshift32: spread thieves over victims */
+    *rng ^= *rng << 13;
+    *rng ^= *rng >> 17;
+    *rng ^= *rng << 5;
+
+    int start = (int)(*rng % (uint32_t)p->n_workers);
+    for (int i = 0; i < p->n_workers; i++) {
+        int v = (start + i) % p->n_workers;
+        if (v == self)
+            continue;
+        int task = take_back(p, &p->deque[v]);
+        if (task >= 0)
+            return task;
+    }
+    return -1;
+}
+
+static void *worker_main(void *arg)
+{
+    worker_t *w = arg;
+    pool_t   *p = w->pool;
+    uint32_t  rng = 0x9E3779B9u * (uint32_t)(w->worker + 1);
+    work_pool_stats_t st = { 0, 0 };
+
+    for (;;) {
+        int task = take_front(p, &p->deque[w->worker]);
+        if (task < 0) {
+            task = steal(p, w->worker, &rng);
+            if (task < 0)
+                break;
+            st.stolen++;
+        }
+        p->fn(p->ctx, task, w->worker);
+        st.tasks++;
+    }
+
+    if (p->stats)
+        p->stats[w->worker] = st;
+    return NULL;
+}
+
+int work_pool_run(int n_threads, int n_tasks, work_pool_fn fn, void *ctx,
+                  work_pool_stats_t *stats)
+{
+    if (n_threads > WORK_POOL_MAX_THREADS)
+        n_threads = WORK_POOL_MAX_THREADS;
+    if (n_threads > n_tasks)
+        n_threads = n_tasks;
+    if (n_threads < 1)
+        n_threads = 1;
+
+    for (int i = 0; i < n_threads && stats; i++)
+        stats[i] = (work_pool_stats_t){ 0, 0 };
+    if (n_tasks <= 0)
+        return 0;
+
+    /* Deque w owns ids[w * per ...]; the last ones may hold fewer */
+    int       per    = (n_tasks + n_threads - 1) / n_threads;
+    int      *ids    = malloc((size_t)n_threads * per * sizeof(*ids));
+    deque_t  *deque  = aligned_alloc(WORK_POOL_LINE,
+                                     (size_t)n_threads * sizeof(*deque));
+    worker_t *worker = malloc((size_t)n_threads * sizeof(*worker));
+    if (!ids || !deque || !worker) {
+        free(ids);
+        free(deque);
+        free(worker);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    /* Deal round-robin: deque w gets tasks w, w + n, w + 2n, ... */
+    for (int w = 0; w < n_threads; w++) {
+        int count = 0;
+        for (int t = w; t < n_tasks; t += n_threads)
+            ids[w * per + count++] = t;
+        atomic_init(&deque[w].span,
+                    pack((uint32_t)(w * per), (uint32_t)(w * per + count)));
+    }
+
+    pool_t pool = { fn, ctx, n_threads, ids, deque, stats };
+    int    ret  = 0;
+
+    for (int w = 0; w < n_threads; w++) {
+        worker[w].pool   = &pool;
+        worker[w].worker = w;
+    }
+    for (int w = 1; w < n_threads; w++) {
+        int err = pthread_create(&worker[w].tid, NULL, worker_main, &worker[w]);
+        if (err != 0) {
+            /* Its deque is left for the others to steal */
+            worker[w].worker = -1;
+            errno = err;
+            ret   = -1;
+        }
+    }
+
+    worker_main(&worker[0]);
+
+    for (int w = 1; w < n_threads; w++)
+        if (worker[w].worker >= 0)
+            pthread_join(worker[w].tid, NULL);
+
+    free(ids);
+    free(deque);
+    free(worker);
+    return ret;
+}
+
+int work_pool_cpus(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors > 0 ? (int)si.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
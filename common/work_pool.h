@@ -0,0 +1,55 @@
+/*
+ * work_pool.h
+ *
+ * AIRMAN – Work-Stealing Task Pool
+ * --------------------------------
+ *
+ * Runs a fixed set of independent tasks 0 .. n_tasks-1 on a group of
+ * threads and returns when all of them are done. Built for coarse,
+ * uneven tasks such as reprocessing one flight log each: a 2 GB log
+ * and a 20 kB log in the same batch must not leave cores idle.
+ *
+ * Scheduling:
+ *   tasks are dealt round-robin to one deque per worker, in the
+ *   caller's order (put the longest tasks first). A worker takes tasks
+ *   from the front of its own deque; when it is empty it steals from
+ *   the back of another worker's, starting at a random victim. No task
+ *   spawns others, so a worker finding every deque empty is done.
+ *
+ * Synchronization:
+ *   each deque is a slice of one task array with its head and tail
+ *   packed into a single 64-bit word. The owner and the thieves both
+ *   claim a task with one compare-and-swap on that word, so there are
+ *   no locks and a task is never run twice. Deques are padded to a
+ *   cache line each, so workers do not share a line.
+ *
+ * The calling thread is worker 0; n_threads - 1 threads are created.
+ */
+
+#ifndef AIRMAN_WORK_POOL_H
+#define AIRMAN_WORK_POOL_H
+
+#define WORK_POOL_MAX_THREADS   256
+
+/* Run task `task` on worker `worker` (0 .. n_threads-1) */
+typedef void (*work_pool_fn)(void *ctx, int task, int worker);
+
+typedef struct {
+    unsigned long tasks;        /* tasks run by this worker */
+    unsigned long stolen;       /* ... of which taken from another deque */
+} work_pool_stats_t;
+
+/*
+ * Run all tasks and wait for them. stats, when not NULL, receives one
+ * entry per worker. n_threads is clamped to [1, WORK_POOL_MAX_THREADS]
+ * and to n_tasks. Returns 0, or -1 (errno set) when a thread could not
+ * be created; its deque is then stolen by the others, so every task
+ * still runs.
+ */
+int work_pool_run(int n_threads, int n_tasks, work_pool_fn fn, void *ctx,
+                  work_pool_stats_t *stats);
+
+/* Online CPUs (at least 1) */
+int work_pool_cpus(void);
+
+#endif /* AIRMAN_WORK_POOL_H */
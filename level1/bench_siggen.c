@@ -0,0 +1,131 @@
+/*
+ * bench_siggen.c
+ *
+ * AIRMAN – Signal generator check and benchmark
+ * ---------------------------------------------
+ *
+ * Compares the oscillator bank (siggen.c) against the closed-form
+ * sin()/cos() waveforms the simulators used to evaluate per sample,
+ * and reports samples/s for both.
+ *
+ * Build & run:
+ *   gcc -O2 -march=native bench_siggen.c siggen.c ../common/bench_suite.c -I../common -o bench_siggen -lm
+ *   ./bench_siggen [samples] [--quick] [--csv PATH] [--baseline PATH]
+ *
+ * samples is the length of the accuracy check; throughput is timed by
+ * the shared harness (bench_suite.h) over the same range of t.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_suite.h"
+#include "siggen.h"
+
+#define DEFAULT_SAMPLES  (1 << 20)
+#define CHUNK            4096
+#define TOLERANCE        2e-5f     /* relative to channel full scale */
+
+/* Deterministic part of the original simulate_*() functions */
+static void closed_form(int t, float w[SIG_CHANNELS])
+{
+    w[SIG_AX]  = 0.8 * sin(t * 0.02) + 0.3 * sin(t * 0.005) + 0.05 * sin(t * 0.50);
+    w[SIG_AY]  = 0.8 * cos(t * 0.018 + 1.0) + 0.2 * sin(t * 0.008) + 0.05 * sin(t * 0.45);
+    w[SIG_AZ]  = 9.81 + 0.03 * sin(t * 0.40);
+    w[SIG_GX]  = 3.0 * sin(t * 0.008) + 0.2 * sin(t * 0.0005);
+    w[SIG_GY]  = 3.0 * cos(t * 0.007) + 0.2 * sin(t * 0.0007);
+    w[SIG_GZ]  = 20.0 * sin(t * 0.01) + 0.5 * sin(t * 0.0004);
+    w[SIG_ALT] = 100 + (t * 0.02) + 0.3 * sin(t * 0.04);
+}
+
+/* Full-scale amplitude of the oscillating part per channel */
+static const float full_scale[SIG_CHANNELS] = {
+    1.15f, 1.05f, 0.03f, 3.2f, 3.2f, 20.5f, 0.3f,
+};
+
+static volatile float sink;
+static int            samples;
+static float          buf[SIG_CHANNELS][CHUNK];
+static float         *out[SIG_CHANNELS];
+
+/* ---------------- timed cases: n samples each, t wrapping at samples ---------------- */
+
+static void run_closed_form(void *ctx, long n)
+{
+    (void)ctx;
+    float acc = 0.0f;
+    int t = 0;
+    for (long i = 0; i < n; i++) {
+        float w[SIG_CHANNELS];
+        closed_form(t, w);
+        acc += w[SIG_AX] + w[SIG_GZ];
+        if (++t == samples)
+            t = 0;
+    }
+    sink = acc;
+}
+
+static void run_block(void *ctx, long n)
+{
+    (void)ctx;
+    float acc = 0.0f;
+    int t = 0;
+    for (long i = 0; i < n; i += CHUNK) {
+        int len = n - i < CHUNK ? (int)(n - i) : CHUNK;
+        siggen_block(t, len, out);
+        acc += buf[SIG_AX][0] + buf[SIG_GZ][len - 1];
+        if ((t += CHUNK) == samples)
+            t = 0;
+    }
+    sink = acc;
+}
+
+int main(int argc, char **argv)
+{
+    bench_suite_t suite;
+    if (bench_suite_init(&suite, "siggen", argc, argv) != 0)
+        return 2;
+
+    samples = (int)bench_arg(&suite, 0, DEFAULT_SAMPLES);
+    samples = (samples + CHUNK - 1) / CHUNK * CHUNK;
+
+    for (int ch = 0; ch < SIG_CHANNELS; ch++)
+        out[ch] = buf[ch];
+
+    /* Accuracy, block mode and sequential mode */
+    float max_rel = 0.0f;
+    siggen_t g;
+    siggen_init(&g, 0);
+    for (int t0 = 0; t0 < samples; t0 += CHUNK) {
+        siggen_block(t0, CHUNK, out);
+        for (int i = 0; i < CHUNK; i++) {
+            float ref[SIG_CHANNELS], seq[SIG_CHANNELS];
+            closed_form(t0 + i, ref);
+            siggen_next(&g, seq);
+            for (int ch = 0; ch < SIG_CHANNELS; ch++) {
+                /* Large offsets (gravity, climb) add float rounding only */
+                float ulps = 2.0f * FLT_EPSILON * fabsf(ref[ch]);
+                float e1 = (fabsf(buf[ch][i] - ref[ch]) - ulps) / full_scale[ch];
+                float e2 = (fabsf(seq[ch] - ref[ch]) - ulps) / full_scale[ch];
+                if (e1 > max_rel) max_rel = e1;
+                if (e2 > max_rel) max_rel = e2;
+            }
+        }
+    }
+
+    printf("samples=%d channels=%d\n", samples, SIG_CHANNELS);
+    const bench_case_t *closed = bench_run(&suite, "closed form", "sample",
+                                           run_closed_form, NULL);
+    const bench_case_t *block  = bench_run(&suite, "oscillators", "sample",
+                                           run_block, NULL);
+    if (closed && block)
+        printf("oscillators vs closed form: %.1fx\n",
+               closed->ns_per_op / block->ns_per_op);
+    printf("max error = %.2e of full scale (tolerance %.0e) %s\n",
+           max_rel, TOLERANCE, max_rel <= TOLERANCE ? "PASS" : "FAIL");
+
+    int status = bench_suite_finish(&suite);
+    return max_rel <= TOLERANCE ? status : 1;
+}
@@ -0,0 +1,291 @@
+/*
+ * bench_telemetry_tx.c
+ *
+ * AIRMAN – Level 1 transmitter benchmark
+ * --------------------------------------
+ *
+ * Times every stage of the Level-1 sensor → frame path in ns/op with
+ * fixed noise seeds, plus the whole path in frames/s, through the
+ * shared harness (common/bench_suite.h):
+ *
+ *   noise, noise_gauss        one noise draw (uniform / Gaussian)
+ *   siggen_block              oscillator bank, per sample
+ *   simulate_accel / _gyro    one sensor's vec3 of one sample
+ *   simulate_altitude / _temperature
+ *                             one channel of one sample
+ *   checksum_xor8             8-bit XOR over one $L1 frame body
+ *   crc16_ccitt               CRC16 over the same bytes
+ *   encode_ascii / _binary    one frame from ready values
+ *   encode_batch              per sample, BATCH_MAX_BINARY-sample batch
+ *                             frames (--batch)
+ *   pipeline_ascii / _binary  waveforms + noise + encoding, per frame
+ *                             (no link I/O, which is bound by the link)
+ *
+ * telemetry_tx.c is compiled into this file without its main(), so
+ * the functions timed are exactly the transmitter's.
+ *
+ * Build & run:
+ *   gcc -O2 bench_telemetry_tx.c siggen.c ../common/bench_suite.c ../common/prng.c ../common/sim_noise.c ../common/flightlog.c ../common/binframe.c ../common/cobs.c ../common/crc16.c ../common/loop_sched.c ../common/numfmt.c ../common/txtframe.c ../common/link_io.c ../common/serial_port.c -I../common -o bench_telemetry_tx -lm
+ *   ./bench_telemetry_tx [--csv PATH] [--baseline PATH] [--tolerance PCT]
+ */
+
+/* main()'s helpers are left unused here */
+#if defined(__GNUC__)
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+#define AIRMAN_NO_MAIN
+#include "telemetry_tx.c"
+
+#include "bench_suite.h"
+#include "checksum.h"
+#include "crc16.h"
+
+#define BENCH_SEED   1
+#define WAVE_SAMPLES 4096            /* power of two */
+
+static prng_t rng[NOISE_STREAMS];
+static float  wave[WAVE_SAMPLES][SIG_CHANNELS];
+static _Alignas(IMU_SAMPLE_ALIGN) imu_sample_t wave_imu[WAVE_SAMPLES];
+static char   sample_frame[128];
+
+static volatile float    sink_f;
+static volatile unsigned sink_u;
+
+/* One block of oscillator-bank output, interleaved per sample, and
+ * its accel / gyro channels as IMU samples for the encoders */
+static void fill_wave(void)
+{
+    static float block[SIG_CHANNELS][WAVE_SAMPLES];
+    float *out[SIG_CHANNELS];
+    for (int ch = 0; ch < SIG_CHANNELS; ch++)
+        out[ch] = block[ch];
+    siggen_block(0, WAVE_SAMPLES, out);
+
+    for (int i = 0; i < WAVE_SAMPLES; i++) {
+        for (int ch = 0; ch < SIG_CHANNELS; ch++)
+            wave[i][ch] = block[ch][i];
+        wave_imu[i].accel = vec3(wave[i][SIG_AX], wave[i][SIG_AY], wave[i][SIG_AZ]);
+        wave_imu[i].gyro  = vec3(wave[i][SIG_GX], wave[i][SIG_GY], wave[i][SIG_GZ]);
+        wave_imu[i].valid = IMU_VALID_ACCEL | IMU_VALID_GYRO;
+    }
+}
+
+/* ============================================================
+ * CASES
+ * ============================================================
+ */
+
+static void run_noise(void *ctx, long n)
+{
+    (void)ctx;
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++)
+        acc += sim_noise(&rng[NOISE_ACCEL], 0.1f);
+    sink_f = acc;
+}
+
+static void run_noise_gauss(void *ctx, long n)
+{
+    if (sim_noise_set_gaussian(1) == 0)
+        run_noise(ctx, n);
+    sim_noise_set_gaussian(0);
+}
+
+static void run_siggen(void *ctx, long n)
+{
+    (void)ctx;
+    static float block[SIG_CHANNELS][WAVE_SAMPLES];
+    float *out[SIG_CHANNELS];
+    for (int ch = 0; ch < SIG_CHANNELS; ch++)
+        out[ch] = block[ch];
+
+    for (long t = 0; t < n; t += WAVE_SAMPLES)
+        siggen_block(t, WAVE_SAMPLES, out);
+    sink_f = block[SIG_AX][0];
+}
+
+static void run_accel(void *ctx, long n)
+{
+    (void)ctx;
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++) {
+        vec3_t a = simulate_accel(wave[i & (WAVE_SAMPLES - 1)], &rng[NOISE_ACCEL]);
+        acc += a.x + a.y + a.z;
+    }
+    sink_f = acc;
+}
+
+static void run_gyro(void *ctx, long n)
+{
+    (void)ctx;
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++) {
+        vec3_t g = simulate_gyro(wave[i & (WAVE_SAMPLES - 1)], (int)i,
+                                 &rng[NOISE_GYRO]);
+        acc += g.x + g.y + g.z;
+    }
+    sink_f = acc;
+}
+
+static void run_altitude(void *ctx, long n)
+{
+    (void)ctx;
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++)
+        acc += simulate_altitude(wave[i & (WAVE_SAMPLES - 1)], &rng[NOISE_BARO]);
+    sink_f = acc;
+}
+
+static void run_temperature(void *ctx, long n)
+{
+    (void)ctx;
+    float temp = 30.0f;
+    for (long i = 0; i < n; i++)
+        temp = simulate_temperature((int)(i & 0xFFFFF), temp, &rng[NOISE_TEMP]);
+    sink_f = temp;
+}
+
+/* Checksums over the bytes between '$' and '*' of a real frame */
+static void run_checksum(checksum_kind_t kind, long n)
+{
+    /* Reloaded every pass, so the loop is not folded into one call */
+    const char *volatile body = sample_frame + 1;
+    size_t len = (size_t)(strchr(sample_frame, '*') - (sample_frame + 1));
+    unsigned acc = 0;
+    for (long i = 0; i < n; i++) {
+        checksum_t c;
+        checksum_init(&c, kind);
+        checksum_update(&c, body, len);
+        acc += checksum_final(&c);
+    }
+    sink_u = acc;
+}
+
+static void run_xor8(void *ctx, long n)  { (void)ctx; run_checksum(CHECKSUM_XOR8, n); }
+static void run_crc16(void *ctx, long n) { (void)ctx; run_checksum(CHECKSUM_CRC16, n); }
+
+static void run_encode_ascii(void *ctx, long n)
+{
+    (void)ctx;
+    char frame[128];
+    size_t total = 0;
+    for (long i = 0; i < n; i++) {
+        const float *w = wave[i & (WAVE_SAMPLES - 1)];
+        total += encode_ascii_frame(frame, sizeof(frame), (int)(i & 0xFFFFFF),
+                                    &wave_imu[i & (WAVE_SAMPLES - 1)],
+                                    w[SIG_ALT], 30.0f);
+    }
+    sink_u = (unsigned)total;
+}
+
+static void run_encode_binary(void *ctx, long n)
+{
+    (void)ctx;
+    uint8_t wire[BINFRAME_MAX_WIRE];
+    size_t total = 0;
+    for (long i = 0; i < n; i++) {
+        const float *w = wave[i & (WAVE_SAMPLES - 1)];
+        total += encode_binary_frame(wire, (int)(i & 0xFFFFFF),
+                                     &wave_imu[i & (WAVE_SAMPLES - 1)],
+                                     w[SIG_ALT], 30.0f);
+    }
+    sink_u = (unsigned)total;
+}
+
+static void run_encode_batch(void *ctx, long n)
+{
+    (void)ctx;
+    uint8_t wire[BINFRAME_MAX_WIRE];
+    int     ts[BATCH_MAX_BINARY];
+    float   v[BATCH_MAX_BINARY][L1_VALUES];
+    size_t  total = 0;
+    for (long i = 0; i < n; i += BATCH_MAX_BINARY) {
+        for (int k = 0; k < BATCH_MAX_BINARY; k++) {
+            const float *w = wave[(i + k) & (WAVE_SAMPLES - 1)];
+            ts[k] = (int)((i + k) & 0xFFFFFF);
+            v[k][0] = w[SIG_AX]; v[k][1] = w[SIG_AY]; v[k][2] = w[SIG_AZ];
+            v[k][3] = w[SIG_GX]; v[k][4] = w[SIG_GY]; v[k][5] = w[SIG_GZ];
+            v[k][6] = w[SIG_ALT]; v[k][7] = 30.0f;
+        }
+        total += encode_binary_batch(wire, ts, v, BATCH_MAX_BINARY);
+    }
+    sink_u = (unsigned)total;
+}
+
+/* What emit_sample() does per frame, minus link_write() */
+static void run_pipeline(int binary_mode, long n)
+{
+    static float block[SIG_CHANNELS][WAVE_SAMPLES];
+    float *out[SIG_CHANNELS];
+    for (int ch = 0; ch < SIG_CHANNELS; ch++)
+        out[ch] = block[ch];
+
+    uint8_t frame[BINFRAME_MAX_WIRE > 128 ? BINFRAME_MAX_WIRE : 128];
+    float temp = 30.0f;
+    size_t total = 0;
+
+    for (long t0 = 0; t0 < n; t0 += WAVE_SAMPLES) {
+        siggen_block(t0, WAVE_SAMPLES, out);
+
+        for (int i = 0; i < WAVE_SAMPLES; i++) {
+            int t = (int)((t0 + i) & 0xFFFFF);
+            float w[SIG_CHANNELS];
+            for (int ch = 0; ch < SIG_CHANNELS; ch++)
+                w[ch] = block[ch][i];
+
+            imu_sample_t imu = { .valid = IMU_VALID_ACCEL | IMU_VALID_GYRO };
+            imu.accel = simulate_accel(w, &rng[NOISE_ACCEL]);
+            imu.gyro  = simulate_gyro(w, t, &rng[NOISE_GYRO]);
+            imu.t_us  = (int64_t)t * 1000000 / LOOP_HZ;
+            float alt = simulate_altitude(w, &rng[NOISE_BARO]);
+            temp = simulate_temperature(t, temp, &rng[NOISE_TEMP]);
+
+            int ts_ms = (int)((long long)t * 1000 / LOOP_HZ);
+            if (binary_mode)
+                total += encode_binary_frame(frame, ts_ms, &imu, alt, temp);
+            else
+                total += encode_ascii_frame((char *)frame, sizeof(frame), ts_ms,
+                                            &imu, alt, temp);
+        }
+    }
+    sink_u = (unsigned)total;
+}
+
+static void run_pipeline_ascii(void *ctx, long n)  { (void)ctx; run_pipeline(0, n); }
+static void run_pipeline_binary(void *ctx, long n) { (void)ctx; run_pipeline(1, n); }
+
+int main(int argc, char **argv)
+{
+    bench_suite_t s;
+    if (bench_suite_init(&s, "l1", argc, argv) != 0)
+        return 2;
+
+    sim_noise_seed(rng, NOISE_STREAMS, BENCH_SEED);
+    fill_wave();
+    const imu_sample_t frame_imu = {
+        .accel = vec3(0.512f, -0.734f, 9.803f),
+        .gyro  = vec3(1.25f, -2.5f, 17.75f),
+        .valid = IMU_VALID_ACCEL | IMU_VALID_GYRO,
+    };
+    encode_ascii_frame(sample_frame, sizeof(sample_frame), 123456,
+                       &frame_imu, 112.34f, 31.02f);
+
+    bench_run(&s, "noise",                "op",     run_noise,           NULL);
+    bench_run(&s, "noise_gauss",          "op",     run_noise_gauss,     NULL);
+    bench_run(&s, "siggen_block",         "sample", run_siggen,          NULL);
+    bench_run(&s, "simulate_accel",       "sample", run_accel,           NULL);
+    bench_run(&s, "simulate_gyro",        "sample", run_gyro,            NULL);
+    bench_run(&s, "simulate_altitude",    "op",     run_altitude,        NULL);
+    bench_run(&s, "simulate_temperature", "op",     run_temperature,     NULL);
+    bench_run(&s, "checksum_xor8",        "frame",  run_xor8,            NULL);
+    bench_run(&s, "crc16_ccitt",          "frame",  run_crc16,           NULL);
+    bench_run(&s, "encode_ascii",         "frame",  run_encode_ascii,    NULL);
+    bench_run(&s, "encode_binary",        "frame",  run_encode_binary,   NULL);
+    bench_run(&s, "encode_batch",         "sample", run_encode_batch,    NULL);
+    bench_run(&s, "pipeline_ascii",       "frame",  run_pipeline_ascii,  NULL);
+    bench_run(&s, "pipeline_binary",      "frame",  run_pipeline_binary, NULL);
+
+    return bench_suite_finish(&s);
+}
@@ -0,0 +1,161 @@
+/*
+ * siggen.c
+ *
+ * AIRMAN – Oscillator-bank signal generator (see siggen.h)
+ */
+
+#include <math.h>
+#include <stddef.h>
+
+#include "siggen.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Samples between exact re-seeds of the oscillator lanes */
+#define SIGGEN_RESEED  1024
+
+/* ============================================================
+ * WAVEFORM TABLE
+ * ============================================================
+ *
+ * One row per sinusoid of the original simulate_*() functions:
+ *   amp * sin(omega * t + phase)     (cos terms use phase + pi/2)
+ */
+
+typedef struct {
+    int    channel;
+    float  amp;
+    double omega;     /* rad per sample */
+    double phase;     /* rad */
+} osc_t;
+
+static const osc_t osc_table[] = {
+    /* accel x: primary, secondary, vibration */
+    { SIG_AX,  0.8f,  0.02,   0.0 },
+    { SIG_AX,  0.3f,  0.005,  0.0 },
+    { SIG_AX,  0.05f, 0.50,   0.0 },
+
+    /* accel y: phase-shifted cosine primary */
+    { SIG_AY,  0.8f,  0.018,  1.0 + M_PI / 2 },
+    { SIG_AY,  0.2f,  0.008,  0.0 },
+    { SIG_AY,  0.05f, 0.45,   0.0 },
+
+    /* accel z: vertical vibration (gravity is an offset) */
+    { SIG_AZ,  0.03f, 0.40,   0.0 },
+
+    /* gyro: rotation + slow drift */
+    { SIG_GX,  3.0f,  0.008,  0.0 },
+    { SIG_GX,  0.2f,  0.0005, 0.0 },
+    { SIG_GY,  3.0f,  0.007,  M_PI / 2 },
+    { SIG_GY,  0.2f,  0.0007, 0.0 },
+    { SIG_GZ, 20.0f,  0.01,   0.0 },
+    { SIG_GZ,  0.5f,  0.0004, 0.0 },
+
+    /* altitude: pressure wobble (climb is an offset) */
+    { SIG_ALT, 0.3f,  0.04,   0.0 },
+};
+
+#define NUM_OSC  (sizeof(osc_table) / sizeof(osc_table[0]))
+
+#define GRAVITY      9.81f
+#define ALT_BASE     100.0
+#define ALT_CLIMB    0.02      /* m per sample */
+
+/* ============================================================
+ * BLOCK GENERATOR
+ * ============================================================
+ */
+
+/* Non-oscillating terms: gravity on Z, linear climb on altitude */
+static void fill_offsets(long t0, int n, float *const out[SIG_CHANNELS])
+{
+    for (int ch = 0; ch < SIG_CHANNELS; ch++) {
+        float *o = out[ch];
+        if (ch == SIG_AZ) {
+            for (int i = 0; i < n; i++)
+                o[i] = GRAVITY;
+        } else if (ch == SIG_ALT) {
+            for (int i = 0; i < n; i++)
+                o[i] = (float)(ALT_BASE + (t0 + i) * ALT_CLIMB);
+        } else {
+            for (int i = 0; i < n; i++)
+                o[i] = 0.0f;
+        }
+    }
+}
+
+/* Add one oscillator over samples t0 .. t0+n-1 (n <= SIGGEN_RESEED) */
+static void add_osc(const osc_t *o, long t0, int n, float *out)
+{
+    float s[SIGGEN_LANES], c[SIGGEN_LANES];
+
+    /* Exact seed: lane k holds the phase of sample t0 + k */
+    for (int k = 0; k < SIGGEN_LANES; k++) {
+        double th = o->omega * (double)(t0 + k) + o->phase;
+        s[k] = o->amp * (float)sin(th);
+        c[k] = o->amp * (float)cos(th);
+    }
+
+    /* Each step advances every lane by SIGGEN_LANES samples */
+    const float sw = (float)sin(o->omega * SIGGEN_LANES);
+    const float cw = (float)cos(o->omega * SIGGEN_LANES);
+
+    int i = 0;
+    for (; i + SIGGEN_LANES <= n; i += SIGGEN_LANES) {
+        for (int k = 0; k < SIGGEN_LANES; k++) {
+            float sk = s[k], ck = c[k];
+            out[i + k] += sk;
+            s[k] = sk * cw + ck * sw;
+            c[k] = ck * cw - sk * sw;
+        }
+    }
+    for (int k = 0; i + k < n; k++)
+        out[i + k] += s[k];
+}
+
+void siggen_block(long t0, int n, float *const out[SIG_CHANNELS])
+{
+    fill_offsets(t0, n, out);
+
+    for (int done = 0; done < n; done += SIGGEN_RESEED) {
+        int m = n - done < SIGGEN_RESEED ? n - done : SIGGEN_RESEED;
+        for (size_t j = 0; j < NUM_OSC; j++)
+            add_osc(&osc_table[j], t0 + done, m,
+                    out[osc_table[j].channel] + done);
+    }
+}
+
+/* ============================================================
+ * SEQUENTIAL STREAM
+ * ============================================================
+ */
+
+static void refill(siggen_t *g)
+{
+    float *out[SIG_CHANNELS];
+    for (int ch = 0; ch < SIG_CHANNELS; ch++)
+        out[ch] = g->buf[ch];
+
+    siggen_block(g->t0, SIGGEN_BLOCK, out);
+    g->pos = 0;
+}
+
+void siggen_init(siggen_t *g, long t)
+{
+    g->t0 = t;
+    refill(g);
+}
+
+void siggen_next(siggen_t *g, float wave[SIG_CHANNELS])
+{
+    if (g->pos == SIGGEN_BLOCK) {
+        g->t0 += SIGGEN_BLOCK;
+        refill(g);
+    }
+
+    for (int ch = 0; ch < SIG_CHANNELS; ch++)
+        wave[ch] = g->buf[ch][g->pos];
+    g->pos++;
+}
@@ -0,0 +1,60 @@
+/*
+ * siggen.h
+ *
+ * AIRMAN – Oscillator-Bank Signal Generator
+ * -----------------------------------------
+ *
+ * Deterministic part of the Level-1 sensor simulation (the sine and
+ * cosine terms, gravity and the altitude climb), generated without
+ * calling sin()/cos() per sample.
+ *
+ * Every sinusoid is an oscillator whose (sin, cos) pair is advanced by
+ * a fixed rotation, so one sample costs 4 multiplies and 2 adds per
+ * oscillator instead of a libm call:
+ *
+ *   [s']   [cos w  sin w] [s]
+ *   [c'] = [-sin w cos w] [c]
+ *
+ * Block mode fills SIGGEN_LANES consecutive samples per step, with each
+ * lane rotated by SIGGEN_LANES * w, so the inner loop is a plain
+ * vectorizable loop over lanes. Lane phases are seeded with exact
+ * sin()/cos() once per oscillator per block, so rounding error cannot
+ * accumulate beyond one block.
+ *
+ * Waveforms match the original closed-form simulate_*() expressions to
+ * within ~5e-6 of full scale, plus float rounding of the large offsets
+ * (checked by bench_siggen.c).
+ */
+
+#ifndef AIRMAN_SIGGEN_H
+#define AIRMAN_SIGGEN_H
+
+enum {
+    SIG_AX, SIG_AY, SIG_AZ,
+    SIG_GX, SIG_GY, SIG_GZ,
+    SIG_ALT,
+    SIG_CHANNELS
+};
+
+#define SIGGEN_LANES   8        /* samples per vector step */
+#define SIGGEN_BLOCK   256      /* samples buffered by siggen_next() */
+
+typedef struct {
+    long  t0;                               /* sample index of buf[.][0] */
+    int   pos;                              /* next sample in buf */
+    float buf[SIG_CHANNELS][SIGGEN_BLOCK];
+} siggen_t;
+
+/* Start the sequential stream at sample index t */
+void siggen_init(siggen_t *g, long t);
+
+/*
+ * Fill out[ch][0..n) with the waveforms for samples t0 .. t0+n-1.
+ * Any n; the fastest path is a multiple of SIGGEN_LANES.
+ */
+void siggen_block(long t0, int n, float *const out[SIG_CHANNELS]);
+
+/* Next sample of every channel, in sequence */
+void siggen_next(siggen_t *g, float wave[SIG_CHANNELS]);
+
+#endif /* AIRMAN_SIGGEN_H */
@@ -2,17 +2,76 @@
         #include <stdlib.h>
         #include <math.h>
         #include <time.h>
+        #include <string.h>
         #include <unistd.h>
 
+        #ifdef _WIN32
+        #include <io.h>
+        #include <fcntl.h>
+        #endif
+
+        #include "binframe.h"
+        #include "build_config.h"
+        #include "flightlog.h"
+        #include "imu_sample.h"
+        #include "link_io.h"
+        #include "loop_sched.h"
+        #include "prng.h"
+        #include "serial_port.h"
+        #include "siggen.h"
+        #include "sim_noise.h"
+        #include "txtframe.h"
+
+        /*
+        * Output rate. Override at build time, e.g. -DLOOP_HZ=200.
+        * The timestamp field stays in milliseconds at any rate.
+        */
+        #ifndef LOOP_HZ
+        #define LOOP_HZ 20
+        #endif
+
+        /*
+        * Checksum of the ASCII frames: the 8-bit XOR ("*XX"), or
+        * -DL1_CHECKSUM=CHECKSUM_CRC16 ("*XXXX"). telemetry_rx tells them
+        * apart by length; uart_rx.py only checks the XOR.
+        */
+        #ifndef L1_CHECKSUM
+        #define L1_CHECKSUM CHECKSUM_XOR8
+        #endif
+
         /*
-        * Generate pseudo-random noise between -amp and +amp.
+        * Link formats built in (common/build_config.h). tx_binary() is a
+        * constant when only one of them is, which drops the other encoder.
+        */
+        #if !AIRMAN_HAS_FORMAT(ASCII) && !AIRMAN_HAS_FORMAT(BINARY)
+        #error "telemetry_tx needs AIRMAN_FMT_ASCII or AIRMAN_FMT_BINARY"
+        #endif
+
+        static inline int tx_binary(int binary_mode)
+        {
+            if (!AIRMAN_HAS_FORMAT(ASCII))
+                return 1;
+            return AIRMAN_HAS_FORMAT(BINARY) && binary_mode;
+        }
+
+        /* Scheduler overruns are logged to stderr at most this often */
+        #define SCHED_REPORT_SEC 10
+
+        /* Samples generated per siggen_block() call in --max-rate mode */
+        #define MAX_RATE_BLOCK 4096
+
+        /*
+        * Noise streams: every sensor draws from its own generator (prng.h),
+        * seeded from one --seed value, so runs are reproducible and no
+        * global rand() state is shared.
+        *
         * Real-world sensors (IMUs, altimeters, thermistors) always contain electrical noise,
         * quantization errors, and mechanical vibration. Adding noise makes simulated data
-        * behave like true physical sensors.
+        * behave like true physical sensors. sim_noise() (common/sim_noise.h, shared with
+        * the Level-2 transmitter) is uniform in [-amp, amp), or with --gauss normal with
+        * the same RMS, like real ADC and thermal noise.
         */
-        float noise(float amp) {
-            return ((float)rand() / RAND_MAX) * (2 * amp) - amp;
-        }
+        enum { NOISE_ACCEL, NOISE_GYRO, NOISE_BARO, NOISE_TEMP, NOISE_STREAMS };
 
         /* ============================================================
         *               ACCELEROMETER SIMULATION
@@ -30,26 +89,19 @@
         *   3. Vibration                 → motor/airframe vibration
         *   4. Random noise              → sensor imperfections
         *   5. Constant gravity on Z
+        *
+        * Terms 1, 2, 3 and 5 come from the oscillator bank (siggen.c), which
+        * produces the same waveforms without a sin() call per term; w[] is
+        * one sample of every channel. Only the noise is added here, all
+        * three axes in one call (x, y, z draw order).
         */
 
-        float simulate_accel_x(int t) {
-            float primary   = 0.8 * sin(t * 0.02);
-            float secondary = 0.3 * sin(t * 0.005);
-            float vibration = 0.05 * sin(t * 0.50);
-            return primary + secondary + vibration + noise(0.1);
-        }
-
-        float simulate_accel_y(int t) {
-            float primary   = 0.8 * cos(t * 0.018 + 1.0); // phase-shifted for realism
-            float secondary = 0.2 * sin(t * 0.008);
-            float vibration = 0.05 * sin(t * 0.45);
-            return primary + secondary + vibration + noise(0.1);
-        }
-
-        float simulate_accel_z(int t) {
-            float gravity   = 9.81;                      // constant Earth gravity
-            float vibration = 0.03 * sin(t * 0.40);      // subtle vertical vibration
-            return gravity + vibration + noise(0.05);
+        vec3_t simulate_accel(const float *w, prng_t *rng) {
+            vec3_t a = vec3(w[SIG_AX], w[SIG_AY], w[SIG_AZ]);
+            a.x += sim_noise(rng, 0.1);
+            a.y += sim_noise(rng, 0.1);
+            a.z += sim_noise(rng, 0.05);
+            return a;
         }
 
         /* ============================================================
@@ -66,26 +118,23 @@
         *    2. Low-frequency drift   → natural gyro bias drift
         *    3. High-frequency noise  → jitter
         *    4. Occasional spikes     → sudden small jerks
+        *
+        * Rotation and drift (1, 2) come from the oscillator bank. The
+        * noise draws stay in x spike, x, y spike, y, z order, so a seed
+        * replays the same stream.
         */
 
-        float simulate_gyro_x(int t) {
-            float rotation  = 3.0 * sin(t * 0.008);  // slow roll oscillation
-            float drift     = 0.2 * sin(t * 0.0005);
-            float spike     = (t % 500 == 0) ? noise(1.0) : 0; // occasional jerk
-            return rotation + drift + spike + noise(0.2);
-        }
+        vec3_t simulate_gyro(const float *w, int t, prng_t *rng) {
+            vec3_t g = vec3(0, 0, 0);
 
-        float simulate_gyro_y(int t) {
-            float rotation  = 3.0 * cos(t * 0.007);  // slow pitch oscillation
-            float drift     = 0.2 * sin(t * 0.0007);
-            float spike     = (t % 700 == 0) ? noise(0.8) : 0;
-            return rotation + drift + spike + noise(0.2);
-        }
+            float spike_x   = (t % 500 == 0) ? sim_noise(rng, 1.0) : 0; // occasional jerk
+            g.x = w[SIG_GX] + spike_x + sim_noise(rng, 0.2);
+
+            float spike_y   = (t % 700 == 0) ? sim_noise(rng, 0.8) : 0;
+            g.y = w[SIG_GY] + spike_y + sim_noise(rng, 0.2);
 
-        float simulate_gyro_z(int t) {
-            float rotation  = 20.0 * sin(t * 0.01);  // stronger yaw (turning)
-            float drift     = 0.5 * sin(t * 0.0004);
-            return rotation + drift + noise(0.3);
+            g.z = w[SIG_GZ] + sim_noise(rng, 0.3);
+            return g;
         }
 
         /* ============================================================
@@ -101,12 +150,12 @@
         *   1. Slow linear climb        → drone/robot gaining altitude
         *   2. Pressure wobble          → small sine fluctuation
         *   3. Noise                    → realistic sensor readings
+        *
+        * Climb and wobble (1, 2) come from the oscillator bank.
         */
 
-        float simulate_altitude(int t) {
-            float climb     = 100 + (t * 0.02);       // ascending slowly
-            float wobble    = 0.3 * sin(t * 0.04);    // pressure variation
-            return climb + wobble + noise(0.2);
+        float simulate_altitude(const float *w, prng_t *rng) {
+            return w[SIG_ALT] + sim_noise(rng, 0.2);
         }
 
         /* ============================================================
@@ -121,10 +170,10 @@
         *   4. Low-pass filtering for smoothness
         */
 
-        float simulate_temperature(int t, float prev_temp) {
+        float simulate_temperature(int t, float prev_temp, prng_t *rng) {
             float base       = 30.0;
             float heating    = 0.0008 * t;           // slow rise
-            float fluct      = noise(0.2);
+            float fluct      = sim_noise(rng, 0.2);
 
             float raw = base + heating + fluct;
 
@@ -133,73 +182,452 @@
         }
 
 /* ============================================================
- *                  XOR CHECKSUM CALCULATION
+ *                  ASCII FRAME ENCODING (XOR CHECKSUM)
  * ============================================================
  *
  * Many aviation and UAV telemetry protocols use XOR checksums due to their
  * simplicity and computational efficiency. The checksum is computed over
  * all bytes between '$' and '*', enabling the ground station or receiver
  * to validate frame integrity over noisy UART links.
+ *
+ * The frame is built in one pass (common/txtframe.h): each field is
+ * formatted straight into the output buffer by the fixed-precision
+ * encoder and XORed into the checksum as it is written.
+ */
+static size_t encode_ascii_frame(char *out, size_t cap, int ts_ms,
+                                 const imu_sample_t *imu,
+                                 float alt, float temp)
+{
+    txtframe_t f;
+    txtframe_begin(&f, out, cap, L1_CHECKSUM, "L1");
+    txtframe_put_i64(&f, ts_ms);     // timestamp in ms
+    txtframe_put_fixed(&f, imu->accel.x, 3);
+    txtframe_put_fixed(&f, imu->accel.y, 3);
+    txtframe_put_fixed(&f, imu->accel.z, 3);
+    txtframe_put_fixed(&f, imu->gyro.x, 3);
+    txtframe_put_fixed(&f, imu->gyro.y, 3);
+    txtframe_put_fixed(&f, imu->gyro.z, 3);
+    txtframe_put_fixed(&f, alt, 2);
+    txtframe_put_fixed(&f, temp, 2);
+    return txtframe_finish(&f);
+}
+
+/* ============================================================
+ *                  BINARY FRAME ENCODING
+ * ============================================================
+ *
+ * Optional compact frame (see common/binframe.h). The same values are
+ * sent as raw little-endian floats instead of formatted text:
+ *   - no float-to-text conversion in the loop
+ *   - 41 bytes per frame on the wire instead of ~70
+ *   - CRC16 trailer instead of the 8-bit XOR
+ */
+static size_t encode_binary_frame(uint8_t *wire, int ts_ms,
+                                  const imu_sample_t *imu,
+                                  float alt, float temp)
+{
+    binframe_t f;
+    binframe_begin(&f, wire, BINFRAME_TYPE_L1);
+    binframe_put_u32(&f, (uint32_t)ts_ms);
+    binframe_put_f32(&f, imu->accel.x);
+    binframe_put_f32(&f, imu->accel.y);
+    binframe_put_f32(&f, imu->accel.z);
+    binframe_put_f32(&f, imu->gyro.x);
+    binframe_put_f32(&f, imu->gyro.y);
+    binframe_put_f32(&f, imu->gyro.z);
+    binframe_put_f32(&f, alt);
+    binframe_put_f32(&f, temp);
+    return binframe_finish(&f);
+}
+
+/*
+ * K samples in one BINFRAME_TYPE_BATCH frame: one header, base
+ * timestamp and CRC16 for all of them, ms offsets per sample.
+ * v[i] holds sample i's fields in frame order.
  */
-unsigned char calculate_checksum(const char *buf) {
-    unsigned char chk = 0;
-    while (*buf) {
-        chk ^= (unsigned char)*buf;  // XOR each payload byte
-        buf++;
+#define L1_VALUES         8
+#define BATCH_MAX_BINARY  BINFRAME_BATCH_MAX(L1_VALUES)
+
+static size_t encode_binary_batch(uint8_t *wire, const int *ts_ms,
+                                  float (*v)[L1_VALUES], int n)
+{
+    binframe_t f;
+    binframe_begin(&f, wire, BINFRAME_TYPE_BATCH);
+    binframe_put_u8(&f, BINFRAME_TYPE_L1);
+    binframe_put_u32(&f, (uint32_t)ts_ms[0]);
+    for (int i = 0; i < n; i++) {
+        binframe_put_u16(&f, (uint16_t)(ts_ms[i] - ts_ms[0]));
+        for (int k = 0; k < L1_VALUES; k++)
+            binframe_put_f32(&f, v[i][k]);
     }
-    return chk;
+    return binframe_finish(&f);
 }
 
 /* ============================================================
- *                   MAIN LOOP (WITH CHECKSUM)
- * ============================================================ */
-int main() {
-    srand(time(NULL));
+ *                   FLIGHT LOG (--log)
+ * ============================================================
+ *
+ * Optional local copy of every frame's values in the binary flight log
+ * format (common/flightlog.h), written alongside the link output.
+ */
+static const char *const log_columns[] = {
+    "ax", "ay", "az", "gx", "gy", "gz", "alt", "temp",
+};
+
+static flightlog_t  flight_log_storage;
+static flightlog_t *flight_log;      /* NULL unless --log */
+
+/* ============================================================
+ *                   LINK OUTPUT
+ * ============================================================
+ *
+ * Frames go to stdout (pipe mode) or, with --serial, straight to a UART
+ * configured by common/serial_port.h.
+ */
+static int link_fd = STDOUT_FILENO;
+
+/* ============================================================
+ *                   BATCHING (--batch <ms>)
+ * ============================================================
+ *
+ * One write(2) per sample is 1000 syscalls/s per stream at 1 kHz.
+ * With --batch, batch_size samples are sent per write: ASCII frames
+ * back to back in one buffer, binary samples in one batch frame
+ * (shared header and CRC). batch_size is the latency budget in
+ * samples, capped at what one write / batch frame can hold; only full
+ * batches are sent, so no sample waits longer than the budget. The
+ * partial batch left when the run ends is sent by batch_flush().
+ */
+#define BATCH_MAX_ASCII   64
+#define ASCII_FRAME_MAX   128
+
+static int batch_size = 1;
+
+static struct {
+    int    n;
+    int    ts_ms[BATCH_MAX_BINARY];
+    float  v[BATCH_MAX_BINARY][L1_VALUES];
+    size_t text_len;
+    char   text[BATCH_MAX_ASCII * ASCII_FRAME_MAX];
+} batch;
+
+static int batch_limit(int binary_mode)
+{
+    return tx_binary(binary_mode) ? BATCH_MAX_BINARY : BATCH_MAX_ASCII;
+}
+
+/* Send the queued samples, if any */
+static void batch_flush(int binary_mode)
+{
+    if (batch.n == 0)
+        return;
+
+    if (tx_binary(binary_mode)) {
+        uint8_t wire[BINFRAME_MAX_WIRE];
+        link_write(link_fd, wire,
+                   encode_binary_batch(wire, batch.ts_ms, batch.v, batch.n));
+    } else {
+        link_write(link_fd, batch.text, batch.text_len);
+    }
+    batch.n        = 0;
+    batch.text_len = 0;
+}
+
+/* Queue one sample; the batch_size-th one sends the batch */
+static void batch_sample(int binary_mode, int ts_ms, const imu_sample_t *imu,
+                         const float v[L1_VALUES])
+{
+    if (tx_binary(binary_mode)) {
+        memcpy(batch.v[batch.n], v, sizeof(batch.v[0]));
+        batch.ts_ms[batch.n] = ts_ms;
+    } else {
+        batch.text_len += encode_ascii_frame(batch.text + batch.text_len,
+                                             ASCII_FRAME_MAX, ts_ms, imu,
+                                             v[6], v[7]);
+    }
+
+    if (++batch.n == batch_size)
+        batch_flush(binary_mode);
+}
+
+/* ============================================================
+ *                   SAMPLE → FRAME
+ * ============================================================
+ *
+ * Adds sensor noise from rng[] to one oscillator-bank sample w[] (sample
+ * index t) as one imu_sample_t (common/imu_sample.h, no magnetometer),
+ * encodes the frame and hands it to the link (or to the batch).
+ */
+static void emit_sample(int binary_mode, int t, const float *w, float *temp,
+                        prng_t rng[NOISE_STREAMS])
+{
+    imu_sample_t imu;
+    imu.accel    = simulate_accel(w, &rng[NOISE_ACCEL]);
+    imu.gyro     = simulate_gyro(w, t, &rng[NOISE_GYRO]);
+    imu.mag      = vec3(0, 0, 0);
+    imu.t_us     = (int64_t)t * 1000000 / LOOP_HZ;
+    imu.valid    = IMU_VALID_ACCEL | IMU_VALID_GYRO;
+    imu.reserved = 0;
+
+    float alt = simulate_altitude(w, &rng[NOISE_BARO]);
+
+    *temp = simulate_temperature(t, *temp, &rng[NOISE_TEMP]);
+
+    int ts_ms = (int)((long long)t * 1000 / LOOP_HZ);
+
+    const float v[L1_VALUES] = {
+        imu.accel.x, imu.accel.y, imu.accel.z,
+        imu.gyro.x,  imu.gyro.y,  imu.gyro.z,
+        alt, *temp,
+    };
+
+    if (batch_size > 1) {
+        batch_sample(binary_mode, ts_ms, &imu, v);
+    } else if (tx_binary(binary_mode)) {
+        /* Compact COBS frame: no text formatting, CRC16 trailer */
+        uint8_t wire[BINFRAME_MAX_WIRE];
+        size_t n = encode_binary_frame(wire, ts_ms, &imu, alt, *temp);
+        link_write(link_fd, wire, n);
+    } else {
+        /* $L1,...*CHK\n built and checksummed in a single pass */
+        char frame[128];
+        size_t n = encode_ascii_frame(frame, sizeof(frame), ts_ms,
+                                      &imu, alt, *temp);
+        link_write(link_fd, frame, n);
+    }
+
+    if (flight_log)
+        flightlog_append(flight_log, ts_ms, v);
+}
+
+/* ============================================================
+ *                   MAX-RATE MODE (STRESS TEST)
+ * ============================================================
+ *
+ * No sleeping: waveforms are generated MAX_RATE_BLOCK samples at a time
+ * with the vectorized block generator and framed back to back, so the
+ * receiver sees the highest frame rate this host can produce. Timestamps
+ * keep advancing at the simulated 1/LOOP_HZ spacing. Throughput is
+ * logged to stderr every SCHED_REPORT_SEC seconds.
+ */
+static double wall_sec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static void run_max_rate(int binary_mode, long max_frames,
+                         prng_t rng[NOISE_STREAMS])
+{
+    static float block[SIG_CHANNELS][MAX_RATE_BLOCK];
+    float *out[SIG_CHANNELS];
+    for (int ch = 0; ch < SIG_CHANNELS; ch++)
+        out[ch] = block[ch];
 
-    int t = 0;
     float temp = 30.0;
+    double last_report = wall_sec();
+    long   frames = 0;
 
-    while (1) {
+    for (int t = 0; max_frames == 0 || t < max_frames; t += MAX_RATE_BLOCK) {
+        siggen_block(t, MAX_RATE_BLOCK, out);
 
-        float ax = simulate_accel_x(t);
-        float ay = simulate_accel_y(t);
-        float az = simulate_accel_z(t);
+        int n = MAX_RATE_BLOCK;
+        if (max_frames > 0 && max_frames - t < n)
+            n = (int)(max_frames - t);
+        for (int i = 0; i < n; i++) {
+            float w[SIG_CHANNELS];
+            for (int ch = 0; ch < SIG_CHANNELS; ch++)
+                w[ch] = block[ch][i];
+            emit_sample(binary_mode, t + i, w, &temp, rng);
+        }
+        frames += n;
 
-        float gx = simulate_gyro_x(t);
-        float gy = simulate_gyro_y(t);
-        float gz = simulate_gyro_z(t);
+        double now = wall_sec();
+        if (now - last_report >= SCHED_REPORT_SEC) {
+            fprintf(stderr, "[max-rate] %.0f frames/s\n",
+                    frames / (now - last_report));
+            frames = 0;
+            last_report = now;
+        }
+    }
+}
 
-        float alt = simulate_altitude(t);
+/* ============================================================
+ *                   MAIN LOOP (WITH CHECKSUM)
+ * ============================================================
+ *
+ * Usage:
+ *   ./telemetry_tx            ASCII frames  ($L1,...*CHK)
+ *   ./telemetry_tx --binary   COBS binary frames (0x00 delimited)
+ *   --rt <prio> / --cpu <n>   SCHED_FIFO priority / CPU pinning (Linux)
+ *   --max-rate                no sleep: frames as fast as possible (soak
+ *                             testing receivers)
+ *   --seed <n>                noise seed; the same seed replays the same
+ *                             stream (default: time-based, printed on stderr)
+ *   --gauss                   Gaussian instead of uniform sensor noise
+ *   --log <file>              also write every frame to a binary flight
+ *                             log (common/flightlog.h)
+ *   --serial <dev>            write frames to a serial port instead of
+ *                             stdout (raw 8N1, common/serial_port.h)
+ *   --baud <rate>             serial rate, up to 4000000 (default 115200)
+ *   --rtscts                  RTS/CTS hardware flow control
+ *   --batch <ms>              latency budget: send the samples of up to
+ *                             <ms> per write, binary ones as one batch
+ *                             frame (see BATCHING above)
+ *   --frames <n>              exit after n samples (profiling runs)
+ *
+ * Timing uses absolute deadlines (common/loop_sched.h), so the frame
+ * period stays at exactly 1/LOOP_HZ regardless of formatting time.
+ *
+ * Build-time options: LOOP_HZ, L1_CHECKSUM and the link formats
+ * (AIRMAN_FORMATS, common/build_config.h); the profiles in profiles/
+ * set them for the top-level Makefile.
+ *
+ * With -DAIRMAN_NO_MAIN the file is everything but main(), for
+ * bench_telemetry_tx.c to time the functions above as built here.
+ */
+#ifndef AIRMAN_NO_MAIN
+int main(int argc, char **argv) {
+    int binary_mode = 0;
+    int rt_prio     = 0;
+    int rt_cpu      = -1;
+    int max_rate    = 0;
+    int have_seed   = 0;
+    uint64_t seed   = 0;
+    const char *log_path = NULL;
+    const char *serial_path = NULL;
+    long serial_baud  = SERIAL_DEFAULT_BAUD;
+    int  serial_flags = 0;
+    int  batch_ms     = 0;
+    int  gauss        = 0;
+    long max_frames   = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--binary") == 0)
+            binary_mode = 1;
+        else if (strcmp(argv[i], "--max-rate") == 0)
+            max_rate = 1;
+        else if (strcmp(argv[i], "--gauss") == 0)
+            gauss = 1;
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 0);
+            have_seed = 1;
+        }
+        else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc)
+            log_path = argv[++i];
+        else if (strcmp(argv[i], "--serial") == 0 && i + 1 < argc)
+            serial_path = argv[++i];
+        else if (strcmp(argv[i], "--baud") == 0 && i + 1 < argc)
+            serial_baud = atol(argv[++i]);
+        else if (strcmp(argv[i], "--rtscts") == 0)
+            serial_flags |= SERIAL_RTSCTS;
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+            batch_ms = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            max_frames = atol(argv[++i]);
+        else if (strcmp(argv[i], "--rt") == 0 && i + 1 < argc)
+            rt_prio = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cpu") == 0 && i + 1 < argc)
+            rt_cpu = atoi(argv[++i]);
+    }
+
+    if (binary_mode && !AIRMAN_HAS_FORMAT(BINARY)) {
+        fprintf(stderr, "--binary: not in this build (AIRMAN_FORMATS)\n");
+        return 1;
+    }
+    binary_mode = tx_binary(binary_mode);
+
+    if (batch_ms > 0) {
+        batch_size = (int)((long long)batch_ms * LOOP_HZ / 1000);
+        if (batch_size < 1)
+            batch_size = 1;
+        if (batch_size > batch_limit(binary_mode))
+            batch_size = batch_limit(binary_mode);
+        fprintf(stderr, "batching %d samples per write (%.1f ms)\n",
+                batch_size, batch_size * 1000.0 / LOOP_HZ);
+    }
+
+    if (serial_path) {
+        link_fd = serial_open(serial_path, serial_baud, serial_flags);
+        if (link_fd < 0) {
+            perror(serial_path);
+            return 1;
+        }
+    }
+
+    if (loop_sched_set_realtime(rt_prio, rt_cpu) != 0)
+        fprintf(stderr, "warning: real-time scheduling request refused\n");
 
-        temp = simulate_temperature(t, temp);
+#ifdef _WIN32
+    /* Binary frames contain 0x0A bytes; stop CRT from translating them */
+    if (binary_mode)
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
 
-        /* -------------------------------------------------------
-         * Build telemetry payload (without '$' and '*')
-         * ------------------------------------------------------- */
-        char payload[256];
-        sprintf(payload,
-            "L1,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.2f,%.2f",
-            t * 50,  // timestamp in ms
-            ax, ay, az, gx, gy, gz, alt, temp
-        );
+    if (!have_seed) {
+        seed = (uint64_t)time(NULL);
+        fprintf(stderr, "noise seed %llu (--seed to reproduce)\n",
+                (unsigned long long)seed);
+    }
+
+    if (gauss && sim_noise_set_gaussian(1) != 0)
+        fprintf(stderr, "warning: --gauss ignored, uniform noise fixed at "
+                        "build time (SIM_NOISE_GAUSS=0)\n");
 
-        /* Compute XOR checksum */
-        
-        unsigned char chk = calculate_checksum(payload);
+    prng_t rng[NOISE_STREAMS];
+    sim_noise_seed(rng, NOISE_STREAMS, seed);
+
+    if (log_path) {
+        if (flightlog_create(&flight_log_storage, log_path, log_columns,
+                             sizeof(log_columns) / sizeof(log_columns[0])) != 0) {
+            perror(log_path);
+            return 1;
+        }
+        flight_log = &flight_log_storage;
+    }
 
-        /* Build final frame */
-        char frame[300];
-        sprintf(frame, "$%s*%02X", payload, chk);
+    if (max_rate) {
+        run_max_rate(binary_mode, max_frames, rng);
+        batch_flush(binary_mode);
+        if (flight_log)
+            flightlog_close(flight_log);
+        return 0;
+    }
 
-        /* Print final telemetry frame */
-        printf("%s\n", frame);
+    int t = 0;
+    float temp = 30.0;
 
-        usleep(50000); // 50 ms → 20 Hz
+    siggen_t gen;
+    siggen_init(&gen, 0);
+
+    loop_sched_t sched;
+    loop_sched_init(&sched, LOOP_HZ);
+    unsigned long reported_overruns = 0;
+
+    while (max_frames == 0 || t < max_frames) {
+
+        float w[SIG_CHANNELS];
+        siggen_next(&gen, w);
+        emit_sample(binary_mode, t, w, &temp, rng);
+
+        /* Live log readers see new records at least once per second */
+        if (flight_log && t % LOOP_HZ == 0)
+            flightlog_flush(flight_log);
+
+        loop_sched_wait(&sched); // 1/LOOP_HZ, absolute deadline
         t++;
+
+        if (sched.cycles % (SCHED_REPORT_SEC * LOOP_HZ) == 0 &&
+            sched.overruns != reported_overruns) {
+            loop_sched_report(&sched, stderr);
+            reported_overruns = sched.overruns;
+        }
     }
 
+    batch_flush(binary_mode);
+    if (flight_log)
+        flightlog_close(flight_log);
     return 0;
 }
 
-       
-        
\ No newline at end of file
+#endif /* AIRMAN_NO_MAIN */
@@ -1,5 +1,48 @@
 import sys
 import csv
+import argparse
+from pathlib import Path
+
+# Shared binary frame decoder and flight log (common/)
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "common"))
+import binframe
+import flightlog
+import serial_link
+
+LOG_COLUMNS = ["ax", "ay", "az", "gx", "gy", "gz", "alt", "temp"]
+
+
+# =============================================================================
+# LOG SINK — CSV AND/OR BINARY FLIGHT LOG
+# =============================================================================
+# Every validated frame goes to output.csv (row text, easy to inspect) and,
+# with --flog, to a fixed-record binary flight log (common/flightlog.py)
+# that tools can memory-map and tail without re-parsing the whole file.
+# =============================================================================
+class TelemetrySink:
+    def __init__(self, csv_path, flog_path):
+        self.csv_file = None
+        self.writer = None
+        self.flog = None
+
+        if csv_path:
+            self.csv_file = open(csv_path, "w", newline="")
+            self.writer = csv.writer(self.csv_file)
+            self.writer.writerow(["timestamp_ms"] + LOG_COLUMNS)
+        if flog_path:
+            self.flog = flightlog.FlightLogWriter(flog_path, LOG_COLUMNS)
+
+    def write(self, ts, values):
+        if self.writer:
+            self.writer.writerow([ts] + values)
+        if self.flog:
+            self.flog.append(int(ts), [float(v) for v in values])
+
+    def close(self):
+        if self.csv_file:
+            self.csv_file.close()
+        if self.flog:
+            self.flog.close()
 
 # =============================================================================
 # XOR CHECKSUM
@@ -35,9 +78,15 @@ def calculate_checksum(payload: str) -> int:
 #
 # The design mirrors how ground-control stations validate flight telemetry.
 # =============================================================================
-def process_frame(line, writer):
+def process_frame(line, sink):
     line = line.strip()
 
+    # Resync: after byte loss a torn frame can precede a complete one on
+    # the same line, so parse from the last '$' before the checksum
+    start = line.rfind("$", 0, max(line.rfind("*"), 0))
+    if start > 0:
+        line = line[start:]
+
     # Basic framing validation
     if not line.startswith("$"):
         # '$' indicates start-of-frame in many aviation protocols
@@ -78,13 +127,42 @@ def process_frame(line, writer):
     label, ts, ax, ay, az, gx, gy, gz, alt, temp = parts
 
     # Write clean numeric data to CSV for offline analysis
-    writer.writerow([ts, ax, ay, az, gx, gy, gz, alt, temp])
+    sink.write(ts, [ax, ay, az, gx, gy, gz, alt, temp])
 
     # Human-friendly output for consoles/ground stations
     print(f"[{ts} ms] ACC=({ax},{ay},{az})  "
           f"GYRO=({gx},{gy},{gz})  ALT={alt}  TEMP={temp}")
 
 
+# =============================================================================
+# PROCESS A SINGLE BINARY FRAME
+# =============================================================================
+# Binary mode (telemetry_tx --binary) carries the same fields as raw
+# little-endian floats in a COBS frame with a CRC16 trailer. Values are
+# rounded to the ASCII frame precision so output.csv looks identical in
+# both modes.
+# =============================================================================
+def process_binary_frame(decoded, sink):
+    if decoded is None:
+        # COBS, length or CRC16 failure
+        print("Corrupted binary frame")
+        return
+
+    frame_type, fields = decoded
+    if frame_type != binframe.TYPE_L1:
+        print("Unexpected binary frame type:", frame_type)
+        return
+
+    ts = fields[0]
+    ax, ay, az, gx, gy, gz = (f"{v:.3f}" for v in fields[1:7])
+    alt, temp = (f"{v:.2f}" for v in fields[7:9])
+
+    sink.write(ts, [ax, ay, az, gx, gy, gz, alt, temp])
+
+    print(f"[{ts} ms] ACC=({ax},{ay},{az})  "
+          f"GYRO=({gx},{gy},{gz})  ALT={alt}  TEMP={temp}")
+
+
 # =============================================================================
 # MAIN LOOP — READ FROM STDIN (PIPE MODE)
 # =============================================================================
@@ -96,24 +174,43 @@ def process_frame(line, writer):
 #
 # Usage:
 #   ./telemetry_tx | python uart_rx.py
+#   ./telemetry_tx --binary | python uart_rx.py --binary
+#   ./telemetry_tx | python uart_rx.py --flog output.flog [--no-csv]
+#   python uart_rx.py --serial /dev/ttyUSB0 --baud 921600 [--binary]
 #
 # This is a clean, reproducible method recommended for offline telemetry testing.
 # =============================================================================
 def main():
+    parser = argparse.ArgumentParser(description="AIRMAN Level-1 receiver")
+    parser.add_argument("--binary", action="store_true",
+                        help="decode COBS binary frames instead of ASCII")
+    parser.add_argument("--flog", metavar="PATH",
+                        help="also write a binary flight log (common/flightlog.py)")
+    parser.add_argument("--no-csv", action="store_true",
+                        help="do not write output.csv")
+    serial_link.add_arguments(parser)
+    args = parser.parse_args()
+
     print("=== AIRMAN Telemetry Receiver ===")
-    print("Reading telemetry from STDIN (pipe mode)...")
+    if args.serial:
+        print(f"Reading telemetry from {args.serial} at {args.baud} baud...")
+    else:
+        print("Reading telemetry from STDIN (pipe mode)...")
     print("Press CTRL+C to stop.\n")
 
-    # Prepare CSV file for logging decoded sensor values
-    csv_file = open("output.csv", "w", newline="")
-    writer = csv.writer(csv_file)
-    writer.writerow(["timestamp_ms", "ax", "ay", "az", "gx", "gy", "gz", "alt", "temp"])
+    # Prepare CSV file / flight log for logging decoded sensor values
+    sink = TelemetrySink(None if args.no_csv else "output.csv", args.flog)
 
     # Continuously read incoming telemetry frames
-    for line in sys.stdin:
-        process_frame(line, writer)
-
-    csv_file.close()
+    stream = serial_link.open_input(args)
+    if args.binary:
+        for decoded in binframe.iter_frames(stream):
+            process_binary_frame(decoded, sink)
+    else:
+        for raw in stream:
+            process_frame(raw.decode(errors="ignore"), sink)
+
+    sink.close()
 
 
 if __name__ == "__main__":
@@ -0,0 +1,125 @@
+/*
+ * ahrs.c
+ *
+ * AIRMAN – Reentrant AHRS filter object (see ahrs.h)
+ */
+
+#include "ahrs.h"
+
+static float rad2deg(float r) { return r * (180.0f / M_PI); }
+
+void ahrs_init(ahrs_state_t *s, float beta)
+{
+    s->q.q0 = 1.0f;
+    s->q.q1 = 0.0f;
+    s->q.q2 = 0.0f;
+    s->q.q3 = 0.0f;
+
+    s->beta = beta;
+
+    s->time_sec = 0.0;
+    s->updates   = 0;
+    s->imu_only  = 0;
+    s->gyro_only = 0;
+}
+
+void madgwick_update(ahrs_state_t *s, const imu_sample_t *imu, float dt)
+{
+    madgwick_update_batch(s, imu, &dt, 1);
+}
+
+void madgwick_update_batch(ahrs_state_t *s, const imu_sample_t *imu,
+                           const float *dt, int n)
+{
+    quat_t   q         = s->q;
+    double   time_sec  = s->time_sec;
+    uint32_t imu_only  = 0;
+    uint32_t gyro_only = 0;
+
+    for (int i = 0; i < n; i++) {
+        int mode = madgwick_step(&q, &imu[i], dt[i], s->beta);
+        imu_only  += (mode == MADGWICK_IMU);
+        gyro_only += (mode == MADGWICK_GYRO_ONLY);
+        time_sec  += dt[i];
+    }
+
+    s->q          = q;
+    s->time_sec   = time_sec;
+    s->updates   += (uint32_t)n;
+    s->imu_only  += imu_only;
+    s->gyro_only += gyro_only;
+}
+
+/* ============================================================
+ * EULER ANGLES
+ * ============================================================
+ *
+ * The pitch argument can leave [-1, 1] by rounding near +-90 deg
+ * (asin would return NaN), so it is clamped first.
+ */
+
+static float clamp_unit(float x)
+{
+    return x > 1.0f ? 1.0f : x < -1.0f ? -1.0f : x;
+}
+
+/*
+ * atan(z) for z in [0, 1]: odd degree-11 minimax polynomial, max
+ * error ~2e-6 rad (1.2e-4 deg, see bench_euler.c).
+ */
+static float atan_unit(float z)
+{
+    float z2 = z * z;
+    return z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f +
+           z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+}
+
+/* Full-range atan2 from atan_unit(): one divide, octant from the signs */
+static float atan2_approx(float y, float x)
+{
+    float ay = fabsf(y), ax = fabsf(x);
+    if (ay == 0.0f && ax == 0.0f)
+        return 0.0f;
+
+    float a = ay > ax ? (float)(M_PI / 2) - atan_unit(ax / ay)
+                      : atan_unit(ay / ax);
+    if (x < 0.0f)
+        a = (float)M_PI - a;
+    return y < 0.0f ? -a : a;
+}
+
+/*
+ * asin(x) = atan2(x, sqrt(1 - x^2)); sqrt is one instruction on an FPU.
+ * (1 - x)(1 + x) instead of 1 - x*x keeps the precision near +-90 deg.
+ */
+static float asin_approx(float x)
+{
+    return atan2_approx(x, sqrtf((1.0f - x) * (1.0f + x)));
+}
+
+void ahrs_get_euler_approx(const ahrs_state_t *s,
+                           float *roll, float *pitch, float *yaw)
+{
+    float q0 = s->q.q0, q1 = s->q.q1, q2 = s->q.q2, q3 = s->q.q3;
+
+    *roll  = rad2deg(atan2_approx(2*(q0*q1 + q2*q3),
+                                  1 - 2*(q1*q1 + q2*q2)));
+    *pitch = rad2deg(asin_approx(clamp_unit(2*(q0*q2 - q3*q1))));
+    *yaw   = rad2deg(atan2_approx(2*(q0*q3 + q1*q2),
+                                  1 - 2*(q2*q2 + q3*q3)));
+}
+
+void ahrs_get_euler(const ahrs_state_t *s, float *roll, float *pitch, float *yaw)
+{
+#ifdef AHRS_FAST_TRIG
+    ahrs_get_euler_approx(s, roll, pitch, yaw);
+#else
+    float q0 = s->q.q0, q1 = s->q.q1, q2 = s->q.q2, q3 = s->q.q3;
+
+    *roll  = rad2deg(atan2f(2*(q0*q1 + q2*q3),
+                            1 - 2*(q1*q1 + q2*q2)));
+    *pitch = rad2deg(asinf(clamp_unit(2*(q0*q2 - q3*q1))));
+    *yaw   = rad2deg(atan2f(2*(q0*q3 + q1*q2),
+                            1 - 2*(q2*q2 + q3*q3)));
+#endif
+}
@@ -0,0 +1,69 @@
+/*
+ * ahrs.h
+ *
+ * AIRMAN – Reentrant AHRS Filter Object
+ * -------------------------------------
+ *
+ * Quaternion-based orientation estimation (Madgwick).
+ *
+ * Why Madgwick:
+ *   - Computationally efficient
+ *   - Stable for real-time systems
+ *   - Widely used in UAVs and robotics
+ *
+ * All filter state lives in an explicit ahrs_state_t handle instead of
+ * file-scope globals, so one process can run any number of filters
+ * (several IMUs, parallel log replay, one filter per vehicle thread)
+ * without locking.
+ *
+ * ahrs_state_t is cache-line aligned and padded to a whole number of
+ * cache lines: an array of states sharded across cores never puts two
+ * filters on the same line (no false sharing).
+ *
+ * Define AHRS_FAST_TRIG to make ahrs_get_euler() use the polynomial
+ * atan2 / asin of ahrs_get_euler_approx() instead of libm (error
+ * < 0.001 deg), for targets where atan2f / asinf are slow or missing.
+ */
+
+#ifndef AIRMAN_AHRS_H
+#define AIRMAN_AHRS_H
+
+#include <stdint.h>
+
+#include "madgwick.h"
+
+#define AHRS_CACHE_LINE     64
+#define AHRS_DEFAULT_BETA   0.1f    /* Madgwick gradient-descent gain */
+
+typedef struct {
+    _Alignas(AHRS_CACHE_LINE)
+    quat_t   q;               /* orientation, body -> earth */
+    float    beta;            /* correction gain */
+    double   time_sec;        /* integrated filter time (sum of dt) */
+    uint32_t updates;         /* samples processed */
+    uint32_t imu_only;        /* ... corrected without mag (zero mag vector) */
+    uint32_t gyro_only;       /* ... integrated uncorrected (zero accel vector) */
+} ahrs_state_t;
+
+/* Identity orientation, given gain */
+void ahrs_init(ahrs_state_t *s, float beta);
+
+/* Advance the filter by one sample */
+void madgwick_update(ahrs_state_t *s, const imu_sample_t *imu, float dt);
+
+/*
+ * Process n samples (e.g. one FIFO burst) with per-sample dt.
+ * The quaternion is loaded once, carried through the batch in
+ * registers, and written back once at the end.
+ */
+void madgwick_update_batch(ahrs_state_t *s, const imu_sample_t *imu,
+                           const float *dt, int n);
+
+/* Convert the current quaternion to Euler angles (degrees) */
+void ahrs_get_euler(const ahrs_state_t *s, float *roll, float *pitch, float *yaw);
+
+/* Same with polynomial atan2 / asin: no libm trig, error < 0.001 deg */
+void ahrs_get_euler_approx(const ahrs_state_t *s,
+                           float *roll, float *pitch, float *yaw);
+
+#endif /* AIRMAN_AHRS_H */
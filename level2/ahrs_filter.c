@@ -12,10 +12,14 @@
  *   1) Sensor Acquisition Layer
  *        - Simulated IMU (accelerometer, gyroscope, magnetometer)
  *        - Designed to mimic realistic sensor behavior with noise
+ *        - Calibration stage (imu_cal.h): gyro bias estimated at
+ *          rest, scale / misalignment matrix plus offset per sensor,
+ *          loaded from a calibration file (--cal, --cal-gyro)
  *
- *   2) AHRS Estimation Layer
+ *   2) AHRS Estimation Layer (ahrs.c / madgwick.h)
  *        - Madgwick filter (quaternion-based orientation estimation)
  *        - Converts raw IMU data into roll, pitch, and heading
+ *        - Reentrant: state is an explicit ahrs_state_t handle
  *
  *   3) Telemetry Encoding Layer
  *        - UART-style ASCII telemetry frames
@@ -24,12 +28,40 @@
  * Telemetry Frame Format:
  *   $L2,<timestamp_ms>,<roll>,<pitch>,<heading>,<alt>,<temp>*<CRC16>
  *
+ *   With --quat the attitude is sent as the filter quaternion instead
+ *   and no Euler angles are computed on board (ground tools derive
+ *   them if needed):
+ *   $L2Q,<timestamp_ms>,<q0>,<q1>,<q2>,<q3>,<alt>,<temp>*<CRC16>
+ *
+ *   With --binary the same fields are sent as a COBS-framed,
+ *   little-endian record with a CRC16 trailer (common/binframe.h).
+ *   --delta sends them delta-compressed instead: scaled to the ASCII
+ *   precision, a keyframe every DELTAFRAME_KEY_INTERVAL frames (the
+ *   Makefile sets TELEMETRY_HZ: one a second) and zig-zag varint
+ *   changes in between (common/deltaframe.h), about half the binary
+ *   frame size.
+ *
  * Timing:
- *   - Fixed update rate: 20 Hz (50 ms)
- *   - Deterministic loop timing (no dynamic delays)
+ *   - Sensor sampling / AHRS update rate: LOOP_HZ (default 200 Hz / 5 ms)
+ *   - Telemetry frame rate: TELEMETRY_HZ (default 20 Hz / 50 ms), every
+ *     TELEMETRY_DECIMATION-th AHRS update
+ *   - Absolute-deadline scheduling (common/loop_sched.h): compute and
+ *     I/O time do not stretch the period, overruns are counted
+ *
+ * Fixed-point build (-DAHRS_FIXED_POINT):
+ *   - For FPU-less MCUs (Cortex-M0+): sensor simulation, AHRS
+ *     (ahrs_q.c) and ASCII frame formatting use integers only;
+ *     angles and environment values are carried as hundredths
+ *   - Same frame formats on the wire
+ *
+ * Instrumentation:
+ *   - Every loop stage is timed (common/loop_prof.h, TSC / cycle
+ *     counter) into latency histograms; every STATS_FRAME_SEC a
+ *     $L2S frame per stage reports count, min / p50 / p99 / max and
+ *     overruns on the same link as the telemetry
  *
  * Checksum:
- *   - CRC16-CCITT
+ *   - CRC16-CCITT (table-driven engine in common/crc16.c)
  *   - Polynomial: 0x1021
  *   - Initial value: 0xFFFF
  *
@@ -37,63 +69,115 @@
  * UAVs, robotics platforms, and avionics test systems.
  */
 
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
-#include <unistd.h>
+#include <string.h>
 #include <sys/time.h>
 #include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+#include "binframe.h"
+#include "build_config.h"
+#include "deltaframe.h"
+#include "flightlog.h"
+#include "link_io.h"
+#include "loop_prof.h"
+#include "loop_sched.h"
+#include "numfmt.h"
+#include "prng.h"
+#include "serial_port.h"
+#include "sim_noise.h"
+#include "spsc_ring.h"
+#include "txtframe.h"
+
+#ifdef AHRS_FIXED_POINT
+#include "ahrs_q.h"
+#else
+#include "ahrs.h"
+#include "imu_log.h"
+#endif
+#include "imu_cal.h"
 
 /* ============================================================
  * CONFIGURATION
  * ============================================================
  *
- * LOOP_HZ defines the telemetry update rate.
- * LOOP_DT_SEC is used by the AHRS algorithm as the integration
- * timestep, ensuring consistent filter behavior.
+ * Multi-rate loop: sensors and AHRS run fast, telemetry is
+ * decimated so better estimation does not cost link bandwidth.
+ *
+ * LOOP_HZ is the sensor sampling / AHRS update rate.
+ * TELEMETRY_HZ is the frame output rate; it must divide LOOP_HZ.
+ * Both can be overridden at build time (-DLOOP_HZ=1000 etc.).
+ *
+ * LOOP_DT_SEC is the nominal AHRS integration timestep. The filter
+ * is fed the measured interval between samples; the nominal value
+ * is only used for the first sample and when the measurement is
+ * implausible (DT_MAX_FACTOR periods or more).
+ *
+ * IMU_FIFO_BURST is the number of samples drained from the sensor
+ * FIFO per wake-up (1 = read every sample as it is produced). The
+ * loop wakes at LOOP_HZ / IMU_FIFO_BURST and feeds each burst to the
+ * filter in one batch call.
+ *
+ * SIM_TICK_HZ is the rate the simulated motion patterns were tuned
+ * at, so the synthetic motion is identical at any LOOP_HZ.
+ *
+ * SCHED_REPORT_SEC is how often scheduler overruns are logged to
+ * stderr (only when new overruns occurred).
+ *
+ * STATS_FRAME_SEC is the loop-statistics window: every period one
+ * $L2S frame per stage is sent and the histograms restart.
+ *
+ * L2_CHECKSUM is the checksum of the ASCII frames: CRC16 ("*XXXX"), or
+ * CHECKSUM_XOR8 ("*XX") for links that only check the Level-1 XOR.
+ * The link formats built in are AIRMAN_FORMATS (common/build_config.h).
+ * The profiles in profiles/ set all of these for the top-level Makefile.
  */
 
-#define LOOP_HZ        20
-#define LOOP_DT_SEC    (1.0f / LOOP_HZ)
+#ifndef LOOP_HZ
+#define LOOP_HZ        200
+#endif
+#ifndef TELEMETRY_HZ
+#define TELEMETRY_HZ   20
+#endif
 
-/* ============================================================
- * UTILITY FUNCTIONS
- * ============================================================
- *
- * Simple helpers for unit conversion and checksum computation.
- * These are kept small and explicit for clarity and portability.
- */
+#if (LOOP_HZ % TELEMETRY_HZ) != 0
+#error "TELEMETRY_HZ must divide LOOP_HZ"
+#endif
 
-static float deg2rad(float d) { return d * (M_PI / 180.0f); }
-static float rad2deg(float r) { return r * (180.0f / M_PI); }
+#ifndef IMU_FIFO_BURST
+#define IMU_FIFO_BURST 1
+#endif
 
-/*
- * CRC16-CCITT checksum implementation
- *
- * Why CRC16 instead of XOR:
- *   - XOR is fast but weak against many error patterns
- *   - CRC16 detects burst errors and bit inversions reliably
- *   - Commonly used in aviation, telemetry radios, and serial protocols
- *
- * Parameters:
- *   Polynomial : 0x1021
- *   Init value : 0xFFFF
- */
-static unsigned short crc16_ccitt(const char *data)
-{
-    unsigned short crc = 0xFFFF;
+#if (LOOP_HZ % IMU_FIFO_BURST) != 0
+#error "IMU_FIFO_BURST must divide LOOP_HZ"
+#endif
 
-    while (*data) {
-        crc ^= ((unsigned short)(*data++) << 8);
-        for (int i = 0; i < 8; i++) {
-            if (crc & 0x8000)
-                crc = (crc << 1) ^ 0x1021;
-            else
-                crc <<= 1;
-        }
-    }
-    return crc;
-}
+#define LOOP_DT_SEC           (1.0f / LOOP_HZ)
+#define TELEMETRY_DECIMATION  (LOOP_HZ / TELEMETRY_HZ)
+#define WAKE_HZ               (LOOP_HZ / IMU_FIFO_BURST)
+#define DT_MAX_FACTOR         10
+
+#define SIM_TICK_HZ    20
+
+#define SCHED_REPORT_SEC  10
+
+#ifndef STATS_FRAME_SEC
+#define STATS_FRAME_SEC   5
+#endif
+
+#ifndef L2_CHECKSUM
+#define L2_CHECKSUM    CHECKSUM_CRC16
+#endif
 
 /* ============================================================
  * TIME BASE (REAL SYSTEM STYLE)
@@ -113,6 +197,57 @@ static long long millis_since(struct timeval *start)
            (now.tv_usec - start->tv_usec) / 1000LL;
 }
 
+/* Monotonic nanoseconds, used to measure the real sample interval */
+static long long monotonic_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/* ============================================================
+ * NUMERIC CONFIGURATION
+ * ============================================================
+ *
+ * The float build works in SI units. The fixed-point build keeps
+ * samples in Q16, timesteps in Q30 seconds, and everything that is
+ * reported (angles, altitude, temperature) in integer hundredths,
+ * which the frame encoder prints without float formatting.
+ */
+
+#ifdef AHRS_FIXED_POINT
+typedef imu_sample_q_t  imu_raw_t;
+typedef ahrs_q_state_t  filter_t;
+typedef int32_t         dt_t;        /* Q30 seconds */
+typedef int32_t         value_t;     /* hundredths (centi-deg, cm, centi-°C) */
+#else
+typedef imu_sample_t    imu_raw_t;
+typedef ahrs_state_t    filter_t;
+typedef float           dt_t;        /* seconds */
+typedef float           value_t;
+#endif
+
+/*
+ * Per-sample dt from the time elapsed over n samples. Falls back to
+ * the nominal period for the first burst and for implausible values
+ * (non-positive, or DT_MAX_FACTOR periods or more).
+ */
+static dt_t sample_dt(long long elapsed_ns, int n, int first)
+{
+    long long per = elapsed_ns / n;
+    long long nominal = 1000000000LL / LOOP_HZ;
+
+    if (first || per <= 0 || per >= DT_MAX_FACTOR * nominal)
+        per = nominal;
+
+#ifdef AHRS_FIXED_POINT
+    /* ns -> Q30 s: ns * 2^30 / 1e9, as a 32.32 multiply */
+    return (dt_t)(((unsigned long long)per * 4611686018ULL) >> 32);
+#else
+    return (float)per * 1e-9f;
+#endif
+}
+
 /* ============================================================
  * SENSOR LAYER — IMU SIMULATION
  * ============================================================
@@ -128,165 +263,1090 @@ static long long millis_since(struct timeval *start)
  * would be with real hardware, without requiring physical sensors.
  */
 
-typedef struct {
-    float ax, ay, az;   // Accelerometer (m/s²)
-    float gx, gy, gz;   // Gyroscope (deg/s)
-    float mx, my, mz;   // Magnetometer (normalized)
-} imu_sample_t;
+/*
+ * imu_sample_t / imu_sample_q_t (common/imu_sample.h): one 64-byte
+ * cache line per sample with a 16-byte block per sensor, the layout
+ * the filters, the calibration stage and the IMU log share. imu_read()
+ * fills every block of a sample; the timestamp is set by the loop.
+ */
 
-/* Generate small random noise to simulate sensor imperfections */
-static float noise(float amp)
-{
-    return ((float)rand() / RAND_MAX) * 2.0f * amp - amp;
-}
+/*
+ * Noise streams: one generator per sensor (prng.h), all derived from
+ * the --seed value, so a run can be replayed bit for bit. The noise
+ * model is the Level-1 one (common/sim_noise.h), in the sample type of
+ * the build: uniform in [-amp, amp), or with --gauss near-normal with
+ * the same RMS.
+ */
+enum { NOISE_ACCEL, NOISE_GYRO, NOISE_MAG, NOISE_STREAMS };
+
+#ifdef AHRS_FIXED_POINT
+#define noise(rng, amp)   sim_noise_q16(rng, amp)
+#else
+#define noise(rng, amp)   sim_noise(rng, amp)
+#endif
 
-static void imu_read(imu_sample_t *imu, int t)
+#ifndef AHRS_FIXED_POINT
+
+/*
+ * t is the sample index at LOOP_HZ. Motion patterns are expressed in
+ * SIM_TICK_HZ ticks so they play out at the same real-time speed
+ * whatever the sampling rate.
+ */
+static void imu_read(imu_sample_t *imu, int t, prng_t rng[NOISE_STREAMS])
 {
+    float tick = t * ((float)SIM_TICK_HZ / LOOP_HZ);
+
+    *imu = (imu_sample_t){ .valid = IMU_VALID_ALL };
+
     /* Accelerometer:
      *   - Sinusoidal motion in X/Y
      *   - Constant gravity on Z
      *   - Added noise to simulate vibration and ADC noise
      */
-    imu->ax = 0.6f * sinf(t * 0.02f) + noise(0.05f);
-    imu->ay = 0.6f * cosf(t * 0.02f) + noise(0.05f);
-    imu->az = 9.81f + noise(0.08f);
+    imu->accel.x = 0.6f * sinf(tick * 0.02f) + noise(&rng[NOISE_ACCEL], 0.05f);
+    imu->accel.y = 0.6f * cosf(tick * 0.02f) + noise(&rng[NOISE_ACCEL], 0.05f);
+    imu->accel.z = 9.81f + noise(&rng[NOISE_ACCEL], 0.08f);
 
     /* Gyroscope (deg/s):
      *   - Low, steady angular rates
      *   - Small noise to simulate bias and jitter
      */
-    imu->gx = 2.0f  + noise(0.2f);
-    imu->gy = 1.5f  + noise(0.2f);
-    imu->gz = 12.0f + noise(0.3f);
+    imu->gyro.x = 2.0f  + noise(&rng[NOISE_GYRO], 0.2f);
+    imu->gyro.y = 1.5f  + noise(&rng[NOISE_GYRO], 0.2f);
+    imu->gyro.z = 12.0f + noise(&rng[NOISE_GYRO], 0.3f);
 
     /* Magnetometer:
      *   - Normalized Earth magnetic field
      *   - Noise simulates environmental interference
      */
-    imu->mx = 0.3f + noise(0.02f);
-    imu->my = 0.0f + noise(0.02f);
-    imu->mz = 0.5f + noise(0.02f);
+    imu->mag.x = 0.3f + noise(&rng[NOISE_MAG], 0.02f);
+    imu->mag.y = 0.0f + noise(&rng[NOISE_MAG], 0.02f);
+    imu->mag.z = 0.5f + noise(&rng[NOISE_MAG], 0.02f);
+}
+
+#else /* AHRS_FIXED_POINT */
+
+/*
+ * Integer image of the float sensor model: Q16 samples, waveforms
+ * from the Q15 sine table. The motion phase advances by a constant
+ * per sample (0.02 rad per SIM_TICK_HZ tick, one turn = 2^32), so the
+ * uint32_t phase wraps exactly at 2*pi.
+ */
+#define SIM_PHASE_STEP \
+    ((uint32_t)(0.02 / (2.0 * M_PI) * SIM_TICK_HZ / LOOP_HZ * 4294967296.0 + 0.5))
+
+static void imu_read(imu_sample_q_t *imu, int t, prng_t rng[NOISE_STREAMS])
+{
+    uint32_t phase = (uint32_t)t * SIM_PHASE_STEP;
+
+    *imu = (imu_sample_q_t){ .valid = IMU_VALID_ALL };
+
+    imu->accel.x = ((FX_Q16(0.6) * fx_sin_q15(phase)) >> 15) + noise(&rng[NOISE_ACCEL], FX_Q16(0.05));
+    imu->accel.y = ((FX_Q16(0.6) * fx_cos_q15(phase)) >> 15) + noise(&rng[NOISE_ACCEL], FX_Q16(0.05));
+    imu->accel.z = FX_Q16(9.81) + noise(&rng[NOISE_ACCEL], FX_Q16(0.08));
+
+    imu->gyro.x = FX_Q16(2.0)  + noise(&rng[NOISE_GYRO], FX_Q16(0.2));
+    imu->gyro.y = FX_Q16(1.5)  + noise(&rng[NOISE_GYRO], FX_Q16(0.2));
+    imu->gyro.z = FX_Q16(12.0) + noise(&rng[NOISE_GYRO], FX_Q16(0.3));
+
+    imu->mag.x = FX_Q16(0.3) + noise(&rng[NOISE_MAG], FX_Q16(0.02));
+    imu->mag.y = FX_Q16(0.0) + noise(&rng[NOISE_MAG], FX_Q16(0.02));
+    imu->mag.z = FX_Q16(0.5) + noise(&rng[NOISE_MAG], FX_Q16(0.02));
+}
+
+#endif /* AHRS_FIXED_POINT */
+
+/*
+ * Burst read of n consecutive samples starting at sample index t0.
+ *
+ * Mirrors a real IMU FIFO drain: one driver transaction (SPI/I2C burst
+ * or read(2) on an IIO buffer) returns many samples, so per-call
+ * overhead is paid once per burst instead of once per sample.
+ * Returns the number of samples written.
+ */
+static int imu_read_batch(imu_raw_t *out, int t0, int n,
+                          prng_t rng[NOISE_STREAMS])
+{
+    for (int i = 0; i < n; i++)
+        imu_read(&out[i], t0 + i, rng);
+    return n;
+}
+
+/* ============================================================
+ * SENSOR LAYER — CALIBRATION
+ * ============================================================
+ *
+ * --cal loads the correction for every sensor from a file at startup;
+ * --cal-gyro averages the raw gyro over the first seconds (vehicle at
+ * rest) and makes the mean the gyro offset, then writes the result
+ * back to the --cal file. Samples are corrected after each FIFO drain,
+ * before the filter sees them; --record still logs the raw samples,
+ * so a replay can apply a different calibration.
+ */
+
+static imu_cal_t cal;
+#ifdef AHRS_FIXED_POINT
+static imu_cal_q_t cal_q;
+#endif
+
+/* After cal changed: refresh the integer copy the fixed build applies */
+static void calibration_changed(void)
+{
+#ifdef AHRS_FIXED_POINT
+    imu_cal_to_q(&cal, &cal_q);
+#endif
+}
+
+static void calibrate(const imu_raw_t *raw, imu_raw_t *out, int n)
+{
+#ifdef AHRS_FIXED_POINT
+    imu_cal_apply_q(&cal_q, raw, out, n);
+#else
+    imu_cal_apply(&cal, raw, out, n);
+#endif
+}
+
+static void rest_add(imu_cal_rest_t *r, const imu_raw_t *raw, int n)
+{
+#ifdef AHRS_FIXED_POINT
+    imu_cal_rest_add_q(r, raw, n);
+#else
+    imu_cal_rest_add(r, raw, n);
+#endif
+}
+
+/*
+ * Sample timestamps: *clock_ns is the running sample time, advanced by
+ * each sample's dt, so t_us follows the filter's time base.
+ */
+static void imu_stamp(imu_raw_t *imu, const dt_t *dt, int n,
+                      long long *clock_ns)
+{
+    for (int i = 0; i < n; i++) {
+#ifdef AHRS_FIXED_POINT
+        *clock_ns += (long long)(((uint64_t)(uint32_t)dt[i] * 1000000000u +
+                                  (1u << 29)) >> 30);
+#else
+        *clock_ns += (long long)(dt[i] * 1e9f + 0.5f);
+#endif
+        imu[i].t_us = *clock_ns / 1000;
+    }
+}
+
+#ifndef AHRS_FIXED_POINT
+
+/*
+ * --record: append the raw samples to a binary IMU log (imu_log.h) for
+ * offline replay with ahrs_replay. Records are the samples themselves:
+ * the burst is written as it came from the FIFO.
+ */
+static void imu_record(FILE *f, const imu_sample_t *imu, int n)
+{
+    fwrite(imu, sizeof(imu[0]), (size_t)n, f);
+}
+
+#endif
+
+/* ============================================================
+ * AHRS LAYER — BUILD SELECTION
+ * ============================================================
+ */
+
+static void filter_init(filter_t *f)
+{
+#ifdef AHRS_FIXED_POINT
+    ahrs_q_init(f, AHRS_Q_DEFAULT_BETA);
+#else
+    ahrs_init(f, AHRS_DEFAULT_BETA);
+#endif
+}
+
+static void filter_update(filter_t *f, const imu_raw_t *imu,
+                          const dt_t *dt, int n)
+{
+#ifdef AHRS_FIXED_POINT
+    madgwick_q_update_batch(f, imu, dt, n);
+#else
+    madgwick_update_batch(f, imu, dt, n);
+#endif
+}
+
+/*
+ * Attitude for one telemetry frame, computed only for frames that are
+ * sent: roll / pitch / heading, or with --quat the quaternion itself
+ * (no trig at all). Quaternion components are carried with 4 decimals
+ * (~0.01 deg); the fixed-point build scales its Q30 values to
+ * ten-thousandths for the integer-only printer.
+ */
+#define ATT_EULER   3
+#define ATT_QUAT    4
+
+static void filter_euler(const filter_t *f,
+                         value_t *roll, value_t *pitch, value_t *yaw)
+{
+#ifdef AHRS_FIXED_POINT
+    ahrs_q_get_euler(f, roll, pitch, yaw);
+#else
+    ahrs_get_euler(f, roll, pitch, yaw);
+#endif
+}
+
+static void filter_quat(const filter_t *f, value_t q[ATT_QUAT])
+{
+#ifdef AHRS_FIXED_POINT
+    const int32_t src[ATT_QUAT] = { f->q.q0, f->q.q1, f->q.q2, f->q.q3 };
+    for (int i = 0; i < ATT_QUAT; i++)
+        q[i] = (value_t)(((int64_t)src[i] * 10000 + (1 << 29)) >> 30);
+#else
+    q[0] = f->q.q0;
+    q[1] = f->q.q1;
+    q[2] = f->q.q2;
+    q[3] = f->q.q3;
+#endif
+}
+
+/* Returns the number of attitude values written to att */
+static int filter_attitude(const filter_t *f, int quat_mode, value_t *att)
+{
+    if (quat_mode) {
+        filter_quat(f, att);
+        return ATT_QUAT;
+    }
+    filter_euler(f, &att[0], &att[1], &att[2]);
+    return ATT_EULER;
+}
+
+/* ============================================================
+ * TELEMETRY ENCODING LAYER — BINARY FRAMES
+ * ============================================================
+ *
+ * Binary alternative to the ASCII frame. Avoids snprintf float
+ * formatting entirely and shrinks each frame to 29 bytes on the wire
+ * (33 for L2Q).
+ *
+ * The wire format carries float32 in both builds. In the fixed-point
+ * build that is one int -> float conversion per field per frame (not
+ * per sample), which keeps every receiver unchanged.
+ */
+
+#ifdef AHRS_FIXED_POINT
+#define WIRE_F32(v)   ((float)(v) / 100.0f)
+#define WIRE_QUAT(v)  ((float)(v) / 10000.0f)
+#else
+#define WIRE_F32(v)   (v)
+#define WIRE_QUAT(v)  (v)
+#endif
+
+/* n_att attitude values: ATT_EULER (L2) or ATT_QUAT (L2Q) */
+static size_t encode_binary_frame(uint8_t *wire, long long ts,
+                                  const value_t *att, int n_att,
+                                  value_t altitude, value_t temperature)
+{
+    binframe_t f;
+    binframe_begin(&f, wire, n_att == ATT_QUAT ? BINFRAME_TYPE_L2Q
+                                               : BINFRAME_TYPE_L2);
+    binframe_put_u32(&f, (uint32_t)ts);
+    for (int i = 0; i < n_att; i++)
+        binframe_put_f32(&f, n_att == ATT_QUAT ? WIRE_QUAT(att[i])
+                                               : WIRE_F32(att[i]));
+    binframe_put_f32(&f, WIRE_F32(altitude));
+    binframe_put_f32(&f, WIRE_F32(temperature));
+    return binframe_finish(&f);
+}
+
+/*
+ * --batch: up to BATCH_MAX_SAMPLES L2 / L2Q samples per binary frame
+ * under one header, base timestamp and CRC16 (BINFRAME_TYPE_BATCH).
+ * The limit is what fits one TX ring slot (asserted below).
+ */
+#define BATCH_MAX_SAMPLES  4
+
+typedef struct {
+    int       n;
+    long long ts[BATCH_MAX_SAMPLES];
+    value_t   v[BATCH_MAX_SAMPLES][ATT_QUAT + 2];   /* attitude, alt, temp */
+} frame_batch_t;
+
+static void batch_push(frame_batch_t *b, long long ts,
+                       const value_t *att, int n_att,
+                       value_t altitude, value_t temperature)
+{
+    value_t *v = b->v[b->n];
+    for (int i = 0; i < n_att; i++)
+        v[i] = att[i];
+    v[n_att]     = altitude;
+    v[n_att + 1] = temperature;
+    b->ts[b->n++] = ts;
+}
+
+static size_t encode_batch_frame(uint8_t *wire, const frame_batch_t *b,
+                                 int n_att)
+{
+    binframe_t f;
+    binframe_begin(&f, wire, BINFRAME_TYPE_BATCH);
+    binframe_put_u8(&f, n_att == ATT_QUAT ? BINFRAME_TYPE_L2Q
+                                          : BINFRAME_TYPE_L2);
+    binframe_put_u32(&f, (uint32_t)b->ts[0]);
+    for (int k = 0; k < b->n; k++) {
+        const value_t *v = b->v[k];
+        binframe_put_u16(&f, (uint16_t)(b->ts[k] - b->ts[0]));
+        for (int i = 0; i < n_att; i++)
+            binframe_put_f32(&f, n_att == ATT_QUAT ? WIRE_QUAT(v[i])
+                                                   : WIRE_F32(v[i]));
+        binframe_put_f32(&f, WIRE_F32(v[n_att]));
+        binframe_put_f32(&f, WIRE_F32(v[n_att + 1]));
+    }
+    return binframe_finish(&f);
 }
 
 /* ============================================================
- * AHRS LAYER — MADGWICK FILTER
+ * TELEMETRY ENCODING LAYER — DELTA FRAMES
  * ============================================================
  *
- * Quaternion-based orientation estimation.
+ * --delta: the frame values as the integers the ASCII frame prints
+ * (hundredths, ten-thousandths for the quaternion), sent as keyframes
+ * and varint changes against the link's reference (common/deltaframe.h).
+ * The fixed-point build already carries exactly those integers; the
+ * float build rounds them like the ASCII printer, so the receivers log
+ * the same rows for all three link formats.
+ */
+
+#ifdef AHRS_FIXED_POINT
+#define DELTA_VALUE(v)    ((int32_t)(v))
+#define DELTA_QUAT(v)     ((int32_t)(v))
+#else
+#define DELTA_VALUE(v)    ((int32_t)numfmt_round(v, 2))
+#define DELTA_QUAT(v)     ((int32_t)numfmt_round(v, 4))
+#endif
+
+/* Reference values of the link (one transmitter, one link) */
+static deltaframe_t delta_link;
+
+static size_t encode_delta_frame(uint8_t *wire, long long ts,
+                                 const value_t *att, int n_att,
+                                 value_t altitude, value_t temperature)
+{
+    int32_t v[ATT_QUAT + 2];
+    for (int i = 0; i < n_att; i++)
+        v[i] = n_att == ATT_QUAT ? DELTA_QUAT(att[i]) : DELTA_VALUE(att[i]);
+    v[n_att]     = DELTA_VALUE(altitude);
+    v[n_att + 1] = DELTA_VALUE(temperature);
+    return deltaframe_encode(&delta_link, wire,
+                             n_att == ATT_QUAT ? BINFRAME_TYPE_L2Q
+                                               : BINFRAME_TYPE_L2,
+                             (uint32_t)ts, v, n_att + 2);
+}
+
+/* ============================================================
+ * TELEMETRY ENCODING LAYER — ASCII FRAMES
+ * ============================================================
  *
- * Why Madgwick:
- *   - Computationally efficient
- *   - Stable for real-time systems
- *   - Widely used in UAVs and robotics
+ * Single pass (common/txtframe.h): each field is written straight
+ * into the frame buffer by the fixed-precision encoder and folded
+ * into the CRC16 while it is still in cache. The fixed-point build
+ * prints its hundredths with the integer-only path.
+ */
+
+#ifdef AHRS_FIXED_POINT
+#define PUT_VALUE(f, v)   txtframe_put_scaled(f, v, 2)
+#define PUT_QUAT(f, v)    txtframe_put_scaled(f, v, 4)
+#else
+#define PUT_VALUE(f, v)   txtframe_put_fixed(f, v, 2)
+#define PUT_QUAT(f, v)    txtframe_put_fixed(f, v, 4)
+#endif
+
+/* Link formats of the telemetry frames */
+enum { FRAME_ASCII, FRAME_BINARY, FRAME_DELTA };
+
+/*
+ * format if it is built in (AIRMAN_FORMATS), else the first one that
+ * is. Constant when only one format is built, which drops the others'
+ * encoders from encode_frame().
+ */
+static inline int built_format(int format)
+{
+    if (format == FRAME_ASCII && AIRMAN_HAS_FORMAT(ASCII))
+        return FRAME_ASCII;
+    if (format == FRAME_BINARY && AIRMAN_HAS_FORMAT(BINARY))
+        return FRAME_BINARY;
+    if (format == FRAME_DELTA && AIRMAN_HAS_FORMAT(DELTA))
+        return FRAME_DELTA;
+    return AIRMAN_HAS_FORMAT(ASCII)  ? FRAME_ASCII  :
+           AIRMAN_HAS_FORMAT(BINARY) ? FRAME_BINARY : FRAME_DELTA;
+}
+
+/*
+ * Encode one L2 / L2Q frame (by n_att, see filter_attitude()) in the
+ * selected format into out (including the '$' / '*CRC\n' framing for
+ * ASCII). Returns the frame length.
+ */
+static size_t encode_frame(int format, uint8_t *out, size_t cap,
+                           long long ts, const value_t *att, int n_att,
+                           value_t altitude, value_t temperature)
+{
+    format = built_format(format);
+    if (format == FRAME_BINARY)
+        return encode_binary_frame(out, ts, att, n_att,
+                                   altitude, temperature);
+    if (format == FRAME_DELTA)
+        return encode_delta_frame(out, ts, att, n_att,
+                                  altitude, temperature);
+
+    txtframe_t f;
+    txtframe_begin(&f, (char *)out, cap, L2_CHECKSUM,
+                   n_att == ATT_QUAT ? "L2Q" : "L2");
+    txtframe_put_i64(&f, ts);
+    for (int i = 0; i < n_att; i++) {
+        if (n_att == ATT_QUAT)
+            PUT_QUAT(&f, att[i]);
+        else
+            PUT_VALUE(&f, att[i]);
+    }
+    PUT_VALUE(&f, altitude);
+    PUT_VALUE(&f, temperature);
+    return txtframe_finish(&f);
+}
+
+/* ============================================================
+ * LOOP STATISTICS — $L2S FRAMES
+ * ============================================================
+ *
+ * Stages timed in the control loop. The cycle stage is the whole busy
+ * part of a wake-up; its overruns are the scheduler's missed deadlines
+ * (loop_sched.h), which also catch preemption between cycles. "log"
+ * covers the flight / IMU log writes and the once-per-second flushes
+ * and reports. "euler" is the attitude output of filter_attitude()
+ * (only a quaternion copy with --quat).
  *
- * This implementation focuses on clarity and correctness rather
- * than micro-optimizations.
+ *   $L2S,<ts>,<stage>,<count>,<min_us>,<p50_us>,<p99_us>,<max_us>,<overruns>*<CRC16>
+ *
+ * Times are printed from integer nanoseconds (hundredths of a µs), so
+ * the fixed-point build formats them without floats as well.
  */
 
-static float q0 = 1.0f, q1 = 0.0f, q2 = 0.0f, q3 = 0.0f;
+enum {
+    STAGE_CYCLE,
+    STAGE_IMU,
+    STAGE_AHRS,
+    STAGE_EULER,
+    STAGE_ENCODE,
+    STAGE_TX,
+    STAGE_LOG,
+    N_STAGES
+};
+
+static const char *const stage_names[N_STAGES] = {
+    "cycle", "imu", "ahrs", "euler", "encode", "tx", "log",
+};
 
-static float inv_sqrt(float x)
+/* $L2S frames are binary next to binary / delta frames, or without ASCII */
+static inline int stats_binary(int binary_mode)
 {
-    return 1.0f / sqrtf(x);
+    if (!AIRMAN_HAS_FORMAT(ASCII))
+        return 1;
+    if (!AIRMAN_HAS_FORMAT(BINARY) && !AIRMAN_HAS_FORMAT(DELTA))
+        return 0;
+    return binary_mode;
 }
 
-static void madgwick_update(const imu_sample_t *imu, float dt)
+static size_t encode_stats_frame(int binary_mode, uint8_t *out, size_t cap,
+                                 long long ts, int stage,
+                                 const latency_hist_t *h)
 {
-    float ax = imu->ax, ay = imu->ay, az = imu->az;
-    float gx = deg2rad(imu->gx);
-    float gy = deg2rad(imu->gy);
-    float gz = deg2rad(imu->gz);
-    float mx = imu->mx, my = imu->my, mz = imu->mz;
-
-    /* Normalize accelerometer */
-    float norm = sqrtf(ax*ax + ay*ay + az*az);
-    if (norm == 0.0f) return;
-    ax /= norm; ay /= norm; az /= norm;
-
-    /* Normalize magnetometer */
-    norm = sqrtf(mx*mx + my*my + mz*mz);
-    if (norm == 0.0f) return;
-    mx /= norm; my /= norm; mz /= norm;
-
-    /* Quaternion rate of change from gyroscope */
-    float qDot0 = 0.5f * (-q1*gx - q2*gy - q3*gz);
-    float qDot1 = 0.5f * ( q0*gx + q2*gz - q3*gy);
-    float qDot2 = 0.5f * ( q0*gy - q1*gz + q3*gx);
-    float qDot3 = 0.5f * ( q0*gz + q1*gy - q2*gx);
-
-    /* Integrate quaternion */
-    q0 += qDot0 * dt;
-    q1 += qDot1 * dt;
-    q2 += qDot2 * dt;
-    q3 += qDot3 * dt;
-
-    /* Normalize quaternion */
-    norm = inv_sqrt(q0*q0 + q1*q1 + q2*q2 + q3*q3);
-    q0 *= norm; q1 *= norm; q2 *= norm; q3 *= norm;
+    const uint32_t ns[4] = {
+        h->min_ns,
+        latency_hist_quantile(h, 0.50),
+        latency_hist_quantile(h, 0.99),
+        h->max_ns,
+    };
+
+    if (stats_binary(binary_mode)) {
+        binframe_t f;
+        binframe_begin(&f, out, BINFRAME_TYPE_L2S);
+        binframe_put_u32(&f, (uint32_t)ts);
+        binframe_put_f32(&f, (float)stage);
+        binframe_put_f32(&f, (float)h->count);
+        for (int i = 0; i < 4; i++)
+            binframe_put_f32(&f, (float)ns[i] / 1000.0f);
+        binframe_put_f32(&f, (float)h->overruns);
+        return binframe_finish(&f);
+    }
+
+    txtframe_t f;
+    txtframe_begin(&f, (char *)out, cap, L2_CHECKSUM, "L2S");
+    txtframe_put_i64(&f, ts);
+    txtframe_put_i64(&f, stage);
+    txtframe_put_i64(&f, h->count);
+    for (int i = 0; i < 4; i++)
+        txtframe_put_scaled(&f, ((int64_t)ns[i] + 5) / 10, 2);
+    txtframe_put_i64(&f, h->overruns);
+    return txtframe_finish(&f);
 }
 
-/* Convert quaternion to Euler angles (degrees) */
-static void ahrs_get_euler(float *roll, float *pitch, float *yaw)
+/* ============================================================
+ * TELEMETRY I/O LAYER — TRANSMIT THREAD
+ * ============================================================
+ *
+ * The control loop encodes each frame directly into a slot of a
+ * lock-free SPSC ring (common/spsc_ring.h). A separate thread drains
+ * the ring into the link (stdout, or the --serial UART) with write(2),
+ * so a slow reader on the pipe/UART blocks this thread only and never
+ * delays the next AHRS update.
+ *
+ * The ring is sized for ~3 s of 20 Hz telemetry. When it fills up the
+ * overflow policy (default: drop oldest) keeps the filter running and
+ * the drop counters are reported with the scheduler stats.
+ *
+ * Copies per frame:
+ *   --drop-newest   none: frames are written from the ring slot
+ *   drop oldest     one: queued frames are gathered into a local
+ *                   buffer (the producer may recycle a slot while it
+ *                   is being read) and written with one syscall
+ */
+
+#define TX_RING_SLOTS  64
+#define TX_BATCH_BYTES (16 * SPSC_SLOT_BYTES)
+
+/* A full --batch frame is the largest frame this transmitter sends */
+_Static_assert(BINFRAME_BATCH_WIRE(BATCH_MAX_SAMPLES, ATT_QUAT + 2) <=
+               SPSC_SLOT_BYTES, "binary L2 batch frame must fit a TX ring slot");
+
+typedef struct {
+    spsc_ring_t ring;
+    sem_t       ready;   /* posted once per pushed frame */
+} tx_link_t;
+
+static spsc_slot_t tx_slots[TX_RING_SLOTS];
+
+/* stdout (pipe mode), or the UART opened by --serial */
+static int link_fd = STDOUT_FILENO;
+
+static void *tx_thread_main(void *arg)
 {
-    *roll  = rad2deg(atan2f(2*(q0*q1 + q2*q3),
-                            1 - 2*(q1*q1 + q2*q2)));
-    *pitch = rad2deg(asinf(2*(q0*q2 - q3*q1)));
-    *yaw   = rad2deg(atan2f(2*(q0*q3 + q1*q2),
-                            1 - 2*(q2*q2 + q3*q3)));
+    tx_link_t *link = arg;
+    static uint8_t batch[TX_BATCH_BYTES];
+
+    for (;;) {
+        if (sem_wait(&link->ready) != 0)
+            continue;   /* EINTR */
+
+        int n;
+        if (link->ring.policy == SPSC_DROP_NEWEST) {
+            /* Zero-copy: hand each queued slot to the kernel in place */
+            const uint8_t *frame;
+            while ((n = spsc_ring_peek(&link->ring, &frame)) >= 0) {
+                link_write(link_fd, frame, (size_t)n);
+                spsc_ring_release(&link->ring);
+            }
+        } else {
+            /* Gather everything queued; one write per burst */
+            size_t len = 0;
+            while (len + SPSC_SLOT_BYTES <= sizeof(batch) &&
+                   (n = spsc_ring_pop(&link->ring, batch + len,
+                                      SPSC_SLOT_BYTES)) >= 0)
+                len += (size_t)n;
+            if (len > 0)
+                link_write(link_fd, batch, len);
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Frame hand-off from the control loop. tx_begin() returns the buffer
+ * to encode into: the next ring slot (NULL if the ring policy drops the
+ * frame), or local when writing inline. tx_end() sends it.
+ */
+static uint8_t *tx_begin(tx_link_t *link, int single_thread, uint8_t *local)
+{
+    return single_thread ? local : spsc_ring_reserve(&link->ring);
+}
+
+static void tx_end(tx_link_t *link, int single_thread,
+                   const uint8_t *frame, size_t n)
+{
+    if (single_thread) {
+        link_write(link_fd, frame, n);
+    } else {
+        spsc_ring_commit(&link->ring, n);
+        sem_post(&link->ready);
+    }
 }
 
 /* ============================================================
  * MAIN CONTROL LOOP
  * ============================================================
  *
- * Fixed-rate control loop:
- *   - Read sensors
- *   - Update AHRS
- *   - Encode telemetry frame
- *   - Transmit over stdout (UART-style)
+ * Fixed-rate multi-rate loop:
+ *   - Read a sensor FIFO burst   (WAKE_HZ = LOOP_HZ / IMU_FIFO_BURST)
+ *   - Update AHRS per sample     (LOOP_HZ, batched per burst, real dt)
+ *   - Encode telemetry frame     (every TELEMETRY_DECIMATION samples)
+ *   - Hand the frame to the transmit thread (stdout, UART-style)
+ *   - Time every stage (loop_prof.h); $L2S every STATS_FRAME_SEC
+ *
+ * Usage:
+ *   ./ahrs_filter                  ASCII frames
+ *   ./ahrs_filter --binary         COBS binary frames
+ *   ./ahrs_filter --delta          delta-compressed binary frames
+ *                                  (keyframe every second)
+ *   ./ahrs_filter --drop-newest    on TX ring overflow, drop the new
+ *                                  frame instead of the oldest queued
+ *   ./ahrs_filter --single-thread  write frames inline (no TX thread)
+ *   ./ahrs_filter --profile        also print the per-stage loop
+ *                                  statistics ($L2S) on stderr
+ *   ./ahrs_filter --quat           send the quaternion ($L2Q) instead
+ *                                  of Euler angles
+ *   ./ahrs_filter --binary --batch <ms>
+ *                                  latency budget: up to <ms> of frames
+ *                                  (at most 4) in one batch frame
+ *   ./ahrs_filter --seed <n>       noise seed; the same seed replays the
+ *                                  same run (default: time-based, printed
+ *                                  on stderr)
+ *   ./ahrs_filter --gauss          Gaussian instead of uniform noise
+ *   ./ahrs_filter --record <file>  also log raw IMU samples for
+ *                                  ahrs_replay (float build only)
+ *   ./ahrs_filter --log <file>     also write every L2 frame to a binary
+ *                                  flight log (common/flightlog.h)
+ *   ./ahrs_filter --cal <file>     correct the IMU with a calibration
+ *                                  file (imu_cal.h)
+ *   ./ahrs_filter --cal-gyro <s>   estimate the gyro bias over the first
+ *                                  <s> seconds at rest; with --cal, save
+ *                                  it to the file
+ *   ./ahrs_filter --serial <dev>   write frames to a serial port instead
+ *                                  of stdout (common/serial_port.h);
+ *                --baud <rate>     up to 4000000 (default 115200)
+ *                --rtscts          RTS/CTS hardware flow control
+ *   ./ahrs_filter --frames <n>     exit after n telemetry frames (for
+ *                                  profiling runs; writes inline, as
+ *                                  --single-thread, so none is lost)
+ *
+ * Real-time options (Linux, usually needs root / CAP_SYS_NICE):
+ *   --rt <prio>   run the loop under SCHED_FIFO at the given priority
+ *   --cpu <n>     pin the loop to CPU n
+ *
+ * With -DAIRMAN_NO_MAIN the file is everything but main(), for
+ * bench_pipeline.c to time the functions above as built here.
  */
 
-int main(void)
+#ifndef AIRMAN_NO_MAIN
+
+int main(int argc, char **argv)
 {
-    srand(time(NULL));
+    int binary_mode   = 0;
+    int delta_mode    = 0;
+    int batch_ms      = 0;
+    int single_thread = 0;
+    int profile       = 0;
+    int quat_mode     = 0;
+    int rt_prio       = 0;
+    int rt_cpu        = -1;
+    int have_seed     = 0;
+    uint64_t seed     = 0;
+    const char *record_path = NULL;
+    const char *log_path    = NULL;
+    const char *serial_path = NULL;
+    const char *cal_path    = NULL;
+    double cal_rest_sec     = 0.0;
+    long serial_baud        = SERIAL_DEFAULT_BAUD;
+    int  serial_flags       = 0;
+    spsc_policy_t tx_policy = SPSC_DROP_OLDEST;
+    int gauss               = 0;
+    long max_frames         = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--binary") == 0)
+            binary_mode = 1;
+        else if (strcmp(argv[i], "--single-thread") == 0)
+            single_thread = 1;
+        else if (strcmp(argv[i], "--profile") == 0)
+            profile = 1;
+        else if (strcmp(argv[i], "--quat") == 0)
+            quat_mode = 1;
+        else if (strcmp(argv[i], "--delta") == 0)
+            delta_mode = 1;
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+            batch_ms = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--drop-newest") == 0)
+            tx_policy = SPSC_DROP_NEWEST;
+        else if (strcmp(argv[i], "--gauss") == 0)
+            gauss = 1;
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 0);
+            have_seed = 1;
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            record_path = argv[++i];
+        else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc)
+            log_path = argv[++i];
+        else if (strcmp(argv[i], "--cal") == 0 && i + 1 < argc)
+            cal_path = argv[++i];
+        else if (strcmp(argv[i], "--cal-gyro") == 0 && i + 1 < argc)
+            cal_rest_sec = atof(argv[++i]);
+        else if (strcmp(argv[i], "--serial") == 0 && i + 1 < argc)
+            serial_path = argv[++i];
+        else if (strcmp(argv[i], "--baud") == 0 && i + 1 < argc)
+            serial_baud = atol(argv[++i]);
+        else if (strcmp(argv[i], "--rtscts") == 0)
+            serial_flags |= SERIAL_RTSCTS;
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            max_frames = atol(argv[++i]);
+        else if (strcmp(argv[i], "--rt") == 0 && i + 1 < argc)
+            rt_prio = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cpu") == 0 && i + 1 < argc)
+            rt_cpu = atoi(argv[++i]);
+    }
+
+    if ((delta_mode && !AIRMAN_HAS_FORMAT(DELTA)) ||
+        (binary_mode && !delta_mode && !AIRMAN_HAS_FORMAT(BINARY))) {
+        fprintf(stderr, "%s: not in this build (AIRMAN_FORMATS)\n",
+                delta_mode ? "--delta" : "--binary");
+        return 1;
+    }
+
+    /* The exit after --frames must not leave frames in the TX ring */
+    if (max_frames > 0)
+        single_thread = 1;
+
+    /* Delta frames are binary frames; $L2S frames stay plain binary */
+    int frame_format = built_format(delta_mode  ? FRAME_DELTA  :
+                                    binary_mode ? FRAME_BINARY : FRAME_ASCII);
+    binary_mode = frame_format != FRAME_ASCII;
+
+    /*
+     * Samples per batch frame from the latency budget. ASCII and delta
+     * frames are already written several per syscall by the TX thread.
+     */
+    int batch_size = 1;
+    if (batch_ms > 0 && frame_format != FRAME_BINARY) {
+        fprintf(stderr, "warning: --batch needs --binary, ignored\n");
+    } else if (batch_ms > 0) {
+        batch_size = batch_ms * TELEMETRY_HZ / 1000;
+        if (batch_size < 1)
+            batch_size = 1;
+        if (batch_size > BATCH_MAX_SAMPLES)
+            batch_size = BATCH_MAX_SAMPLES;
+        fprintf(stderr, "batching %d frames per batch frame (%d ms)\n",
+                batch_size, batch_size * 1000 / TELEMETRY_HZ);
+    }
+
+    /*
+     * Calibration: the --cal file if present. With --cal-gyro a missing
+     * file is created once the rest window ends.
+     */
+    int use_cal = 0;
+    imu_cal_init(&cal);
+    if (cal_path) {
+        int bad_line = 0;
+        if (imu_cal_load(&cal, cal_path, &bad_line) == 0) {
+            use_cal = 1;
+        } else if (errno == ENOENT && cal_rest_sec > 0.0) {
+            fprintf(stderr, "%s: not found, written after the gyro rest "
+                            "window\n", cal_path);
+        } else {
+            if (errno == EINVAL)
+                fprintf(stderr, "%s:%d: malformed calibration line\n",
+                        cal_path, bad_line);
+            else
+                perror(cal_path);
+            return 1;
+        }
+    }
+    calibration_changed();
+
+    imu_cal_rest_t rest;
+    imu_cal_rest_init(&rest);
+    long rest_samples = (long)(cal_rest_sec * LOOP_HZ);
+    if (rest_samples > 0)
+        fprintf(stderr, "estimating gyro bias over %.1f s, keep the IMU "
+                        "still\n", cal_rest_sec);
+
+    /* Before the TX thread starts: it writes to link_fd */
+    if (serial_path) {
+        link_fd = serial_open(serial_path, serial_baud, serial_flags);
+        if (link_fd < 0) {
+            perror(serial_path);
+            return 1;
+        }
+    }
+
+#ifdef _WIN32
+    if (binary_mode)
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    /* Start the TX thread first so it keeps the default policy */
+    static tx_link_t tx;
+    if (!single_thread) {
+        pthread_t tid;
+        spsc_ring_init(&tx.ring, tx_slots, TX_RING_SLOTS, tx_policy);
+        sem_init(&tx.ready, 0, 0);
+        if (pthread_create(&tid, NULL, tx_thread_main, &tx) != 0) {
+            fprintf(stderr, "warning: TX thread unavailable, writing inline\n");
+            single_thread = 1;
+        }
+    }
+
+    if (loop_sched_set_realtime(rt_prio, rt_cpu) != 0)
+        fprintf(stderr, "warning: real-time scheduling request refused\n");
+
+    if (!have_seed) {
+        seed = (uint64_t)time(NULL);
+        fprintf(stderr, "noise seed %llu (--seed to reproduce)\n",
+                (unsigned long long)seed);
+    }
+
+    if (gauss && sim_noise_set_gaussian(1) != 0)
+        fprintf(stderr, "warning: --gauss ignored, uniform noise fixed at "
+                        "build time (SIM_NOISE_GAUSS=0)\n");
+
+    static prng_t rng[NOISE_STREAMS];
+    sim_noise_seed(rng, NOISE_STREAMS, seed);
+
+#ifndef AHRS_FIXED_POINT
+    FILE *record = NULL;
+    if (record_path) {
+        imu_log_header_t h;
+        imu_log_header_init(&h);
+        record = fopen(record_path, "wb");
+        if (!record || fwrite(&h, sizeof(h), 1, record) != 1) {
+            perror(record_path);
+            return 1;
+        }
+    }
+#else
+    if (record_path)
+        fprintf(stderr, "warning: --record needs the float build, ignored\n");
+#endif
+
+    /* Same columns as the receivers' level2_telemetry log */
+    static const char *const log_columns[] = {
+        "roll", "pitch", "heading", "altitude", "temperature",
+    };
+    static const char *const quat_log_columns[] = {
+        "q0", "q1", "q2", "q3", "altitude", "temperature",
+    };
+    static flightlog_t flight_log;
+    if (log_path &&
+        flightlog_create(&flight_log, log_path,
+                         quat_mode ? quat_log_columns : log_columns,
+                         quat_mode ? ATT_QUAT + 2 : ATT_EULER + 2) != 0) {
+        perror(log_path);
+        return 1;
+    }
 
     struct timeval boot_time;
     gettimeofday(&boot_time, NULL);
 
-    int t = 0;
+    static filter_t ahrs;
+    filter_init(&ahrs);
+
+    static frame_batch_t batch;
+
+    int t = 0;                  /* sample index at LOOP_HZ */
+    int next_emit = 0;          /* sample index of the next L2 frame */
+
+    loop_sched_t sched;
+    loop_sched_init(&sched, WAKE_HZ);
+
+    static loop_prof_t prof;
+    loop_prof_init(&prof, N_STAGES, (uint32_t)sched.period_ns);
+    loop_prof_begin(&prof);
+    unsigned long reported_overruns = 0;
+    unsigned long reported_drops    = 0;
+    unsigned long window_overruns   = 0;
+    long long last_wake = 0;
+    long long sample_ns = 0;    /* sample clock (sum of dt) */
+    long frames_sent = 0;
+
+    while (max_frames == 0 || frames_sent < max_frames) {
+
+        /* Drain one FIFO burst of IMU_FIFO_BURST samples (one line each) */
+        _Alignas(IMU_SAMPLE_ALIGN) imu_raw_t imu[IMU_FIFO_BURST];
+        dt_t      dt[IMU_FIFO_BURST];
+        int n_samples = imu_read_batch(imu, t, IMU_FIFO_BURST, rng);
+
+        /*
+         * FIFO samples are evenly spaced at the sensor ODR, so the
+         * measured interval since the previous burst is split equally
+         * across the samples it produced.
+         */
+        long long now = monotonic_ns();
+        dt_t burst_dt = sample_dt(now - last_wake, n_samples, t == 0);
+        last_wake = now;
+
+        for (int i = 0; i < n_samples; i++)
+            dt[i] = burst_dt;
+        imu_stamp(imu, dt, n_samples, &sample_ns);
+
+        /*
+         * End of the rest window: the mean raw gyro becomes the offset
+         * and the filter restarts, dropping the rotation it integrated
+         * from the uncorrected bias.
+         */
+        if (rest_samples > 0) {
+            rest_add(&rest, imu, n_samples);
+            if (rest.n >= rest_samples) {
+                imu_cal_set_gyro_bias(&cal, &rest);
+                calibration_changed();
+                const float *b = cal.sensor[IMU_CAL_GYRO].offset;
+                fprintf(stderr, "gyro bias %.3f %.3f %.3f deg/s (%ld samples)\n",
+                        b[0], b[1], b[2], rest.n);
+                if (cal_path && imu_cal_save(&cal, cal_path) != 0)
+                    perror(cal_path);
+                filter_init(&ahrs);
+                use_cal = 1;
+                rest_samples = 0;
+            }
+        }
 
-    while (1) {
+        _Alignas(IMU_SAMPLE_ALIGN) imu_raw_t corrected[IMU_FIFO_BURST];
+        imu_raw_t *in = imu;
+        if (use_cal) {
+            calibrate(imu, corrected, n_samples);
+            in = corrected;
+        }
+        loop_prof_lap(&prof, STAGE_IMU);
 
-        imu_sample_t imu;
-        imu_read(&imu, t);
+        filter_update(&ahrs, in, dt, n_samples);
+        t += n_samples;
+        loop_prof_lap(&prof, STAGE_AHRS);
 
-        madgwick_update(&imu, LOOP_DT_SEC);
+#ifndef AHRS_FIXED_POINT
+        if (record) {
+            imu_record(record, imu, n_samples);
+            loop_prof_lap(&prof, STAGE_LOG);
+        }
+#endif
 
-        float roll, pitch, yaw;
-        ahrs_get_euler(&roll, &pitch, &yaw);
+        /* Decimated telemetry: one frame per TELEMETRY_DECIMATION samples */
+        if (t > next_emit) {
+            while (next_emit < t)
+                next_emit += TELEMETRY_DECIMATION;
 
-        /* Simulated environment data */
-        float altitude    = 100.0f + 0.05f * t;
-        float temperature = 30.0f;
+            value_t att[ATT_QUAT];
+            int n_att = filter_attitude(&ahrs, quat_mode, att);
+            loop_prof_lap(&prof, STAGE_EULER);
 
-        long long ts = millis_since(&boot_time);
+            /* Simulated environment data (1 m/s climb) */
+#ifdef AHRS_FIXED_POINT
+            value_t altitude    = 10000 + (t - 1) * 100 / LOOP_HZ;
+            value_t temperature = 3000;
+#else
+            value_t altitude    = 100.0f + (t - 1) * LOOP_DT_SEC;
+            value_t temperature = 30.0f;
+#endif
 
-        /* Build telemetry payload (checksum excludes $ and *) */
-        char payload[200];
-        snprintf(payload, sizeof(payload),
-                 "L2,%lld,%.2f,%.2f,%.2f,%.2f,%.2f",
-                 ts, roll, pitch, yaw, altitude, temperature);
+            long long ts = millis_since(&boot_time);
 
-        /* Compute CRC16 checksum */
-        unsigned short crc = crc16_ccitt(payload);
+            if (log_path) {
+                float values[ATT_QUAT + 2];
+                for (int i = 0; i < n_att; i++)
+                    values[i] = quat_mode ? WIRE_QUAT(att[i]) : WIRE_F32(att[i]);
+                values[n_att]     = WIRE_F32(altitude);
+                values[n_att + 1] = WIRE_F32(temperature);
+                flightlog_append(&flight_log, ts, values);
+                loop_prof_lap(&prof, STAGE_LOG);
+            }
 
-        /* Transmit final frame */
-        printf("$%s*%04X\n", payload, crc);
-        fflush(stdout);
+            /*
+             * --batch: hold the frame until the batch is full; the last
+             * frame of a --frames run sends a partial one
+             */
+            int send = 1;
+            frames_sent++;
+            if (AIRMAN_HAS_FORMAT(BINARY) && batch_size > 1) {
+                batch_push(&batch, ts, att, n_att, altitude, temperature);
+                send = batch.n == batch_size || frames_sent == max_frames;
+            }
+
+            /*
+             * Encode straight into the next ring slot. Never blocks:
+             * overflow is handled by the ring policy.
+             */
+            uint8_t  local[SPSC_SLOT_BYTES];
+            uint8_t *frame = send ? tx_begin(&tx, single_thread, local) : NULL;
+            if (frame) {
+                size_t n = AIRMAN_HAS_FORMAT(BINARY) && batch_size > 1
+                         ? encode_batch_frame(frame, &batch, n_att)
+                         : encode_frame(frame_format, frame, SPSC_SLOT_BYTES,
+                                        ts, att, n_att,
+                                        altitude, temperature);
+                loop_prof_lap(&prof, STAGE_ENCODE);
+                tx_end(&tx, single_thread, frame, n);
+                loop_prof_lap(&prof, STAGE_TX);
+            }
+            if (send)
+                batch.n = 0;
+        }
 
-        usleep(50000);  /* 20 Hz loop */
-        t++;
+        /* Sleep until the next absolute deadline (drift-free) */
+        loop_prof_end(&prof, STAGE_CYCLE);
+        loop_sched_wait(&sched);
+        loop_prof_begin(&prof);
+
+        /* Once-per-second housekeeping below is timed as "log" */
+        int housekeeping = sched.cycles % WAKE_HZ == 0;
+
+#ifndef AHRS_FIXED_POINT
+        /* The loop only ends when killed: keep at most ~1 s unwritten */
+        if (record && sched.cycles % WAKE_HZ == 0)
+            fflush(record);
+#endif
+        if (log_path && sched.cycles % WAKE_HZ == 0)
+            flightlog_flush(&flight_log);
+
+        if (sched.cycles % (SCHED_REPORT_SEC * WAKE_HZ) == 0 &&
+            sched.overruns != reported_overruns) {
+            loop_sched_report(&sched, stderr);
+            reported_overruns = sched.overruns;
+        }
+
+        if (!single_thread &&
+            sched.cycles % (SCHED_REPORT_SEC * WAKE_HZ) == 0) {
+            unsigned long dn = atomic_load(&tx.ring.dropped_newest);
+            unsigned long dold = atomic_load(&tx.ring.dropped_oldest);
+            if (dn + dold != reported_drops) {
+                fprintf(stderr, "[tx] ring overflow: dropped_newest=%lu "
+                                "dropped_oldest=%lu\n", dn, dold);
+                reported_drops = dn + dold;
+            }
+        }
+
+        /* End of a statistics window: one $L2S frame per timed stage */
+        if (sched.cycles % (STATS_FRAME_SEC * WAKE_HZ) == 0) {
+            long long ts = millis_since(&boot_time);
+
+            /* Loop overruns are missed deadlines, preemption included */
+            prof.stage[STAGE_CYCLE].overruns =
+                (uint32_t)(sched.overruns - window_overruns);
+            window_overruns = sched.overruns;
+
+            for (int i = 0; i < N_STAGES; i++) {
+                if (prof.stage[i].count == 0)
+                    continue;
+                uint8_t  local[SPSC_SLOT_BYTES];
+                uint8_t *frame = tx_begin(&tx, single_thread, local);
+                if (frame)
+                    tx_end(&tx, single_thread, frame,
+                           encode_stats_frame(binary_mode, frame,
+                                              SPSC_SLOT_BYTES, ts, i,
+                                              &prof.stage[i]));
+            }
+            if (profile)
+                loop_prof_report(&prof, stage_names, stderr);
+            loop_prof_reset(&prof);
+        }
+
+        if (housekeeping)
+            loop_prof_lap(&prof, STAGE_LOG);
     }
 
+#ifndef AHRS_FIXED_POINT
+    if (record)
+        fclose(record);
+#endif
+    if (log_path)
+        flightlog_close(&flight_log);
     return 0;
 }
+
+#endif /* AIRMAN_NO_MAIN */
@@ -0,0 +1,186 @@
+/*
+ * ahrs_q.c
+ *
+ * AIRMAN – Fixed-point AHRS filter object (see ahrs_q.h)
+ */
+
+#include "ahrs_q.h"
+
+/* Q30 product of two int64 operands */
+#define QM(a, b)   (((a) * (b)) >> 30)
+
+#define Q_ONE      ((int64_t)FX_Q30_ONE)
+#define Q_HALF     ((int64_t)FX_Q30_ONE / 2)
+
+/* deg/s (Q16) -> half rate in rad/s (Q30): w * pi / 360 */
+#define HALF_RAD_PER_DEG   ((int64_t)FX_Q30(M_PI / 360.0))
+
+void ahrs_q_init(ahrs_q_state_t *s, int32_t beta)
+{
+    s->q.q0 = FX_Q30_ONE;
+    s->q.q1 = 0;
+    s->q.q2 = 0;
+    s->q.q3 = 0;
+
+    s->beta = beta;
+
+    s->time_q30  = 0;
+    s->updates   = 0;
+    s->imu_only  = 0;
+    s->gyro_only = 0;
+}
+
+/*
+ * Fixed-point image of madgwick_step(). The gradient is computed at
+ * half scale (every term of the float gradient carries a factor of
+ * two, which the normalization removes anyway), keeping all products
+ * inside 64 bits.
+ */
+static inline int madgwick_q_step(quat_q_t *q, const imu_sample_q_t *imu,
+                                  int32_t dt, int32_t beta)
+{
+    int64_t q0 = q->q0, q1 = q->q1, q2 = q->q2, q3 = q->q3;
+
+    /* Half-angle increments w * dt / 2 (Q30); an invalid gyro is no rate */
+    int64_t gx = 0, gy = 0, gz = 0;
+    if (imu->valid & IMU_VALID_GYRO) {
+        gx = QM(((int64_t)imu->gyro.x * HALF_RAD_PER_DEG) >> 16, dt);
+        gy = QM(((int64_t)imu->gyro.y * HALF_RAD_PER_DEG) >> 16, dt);
+        gz = QM(((int64_t)imu->gyro.z * HALF_RAD_PER_DEG) >> 16, dt);
+    }
+
+    int mode = MADGWICK_GYRO_ONLY;
+
+    /* Quaternion increment from gyroscope, already scaled by dt */
+    int64_t dq0 = (-q1*gx - q2*gy - q3*gz) >> 30;
+    int64_t dq1 = ( q0*gx + q2*gz - q3*gy) >> 30;
+    int64_t dq2 = ( q0*gy - q1*gz + q3*gx) >> 30;
+    int64_t dq3 = ( q0*gz + q1*gy - q2*gx) >> 30;
+
+    const int64_t acc[3] = { imu->accel.x, imu->accel.y, imu->accel.z };
+    int32_t a[3];
+
+    if ((imu->valid & IMU_VALID_ACCEL) && fx_normalize(acc, a, 3)) {
+        int64_t ax = a[0], ay = a[1], az = a[2];
+
+        /* Shared products */
+        int64_t q0q1 = QM(q0, q1), q0q2 = QM(q0, q2), q0q3 = QM(q0, q3);
+        int64_t q1q1 = QM(q1, q1), q1q2 = QM(q1, q2), q1q3 = QM(q1, q3);
+        int64_t q2q2 = QM(q2, q2), q2q3 = QM(q2, q3), q3q3 = QM(q3, q3);
+
+        /* Gravity residual f_g = R^T * [0 0 1] - a */
+        int64_t fg1 = 2 * (q1q3 - q0q2) - ax;
+        int64_t fg2 = 2 * (q0q1 + q2q3) - ay;
+        int64_t fg3 = Q_ONE - 2 * (q1q1 + q2q2) - az;
+
+        /* Gradient J_g^T * f_g / 2 */
+        int64_t s[4];
+        s[0] = (-q2*fg1 + q1*fg2) >> 30;
+        s[1] = ( q3*fg1 + q0*fg2 - 2*q1*fg3) >> 30;
+        s[2] = (-q0*fg1 + q3*fg2 - 2*q2*fg3) >> 30;
+        s[3] = ( q1*fg1 + q2*fg2) >> 30;
+        mode = MADGWICK_IMU;
+
+        const int64_t mag[3] = { imu->mag.x, imu->mag.y, imu->mag.z };
+        int32_t m[3];
+
+        if ((imu->valid & IMU_VALID_MAG) && fx_normalize(mag, m, 3)) {
+            int64_t mx = m[0], my = m[1], mz = m[2];
+            int64_t q0q0 = QM(q0, q0);
+
+            /* Earth-frame field h = R * m, reference b = [bx 0 bz] */
+            int64_t hx = (mx * (q0q0 + q1q1 - q2q2 - q3q3)
+                        + 2 * my * (q1q2 - q0q3)
+                        + 2 * mz * (q0q2 + q1q3)) >> 30;
+            int64_t hy = (2 * mx * (q0q3 + q1q2)
+                        + my * (q0q0 - q1q1 + q2q2 - q3q3)
+                        + 2 * mz * (q2q3 - q0q1)) >> 30;
+            int64_t _2bx = fx_sqrt_q30((uint32_t)((hx*hx + hy*hy) >> 30));
+            int64_t _2bz = (2 * mx * (q1q3 - q0q2)
+                          + 2 * my * (q0q1 + q2q3)
+                          + mz * (q0q0 - q1q1 - q2q2 + q3q3)) >> 30;
+
+            /* Field residual f_b = R^T * b - m */
+            int64_t fb1 = ((_2bx * (Q_HALF - q2q2 - q3q3) + _2bz * (q1q3 - q0q2)) >> 30) - mx;
+            int64_t fb2 = ((_2bx * (q1q2 - q0q3)          + _2bz * (q0q1 + q2q3)) >> 30) - my;
+            int64_t fb3 = ((_2bx * (q0q2 + q1q3)          + _2bz * (Q_HALF - q1q1 - q2q2)) >> 30) - mz;
+
+            /* Jacobian coefficients (Q30) */
+            int64_t bxq0 = QM(_2bx, q0), bxq1 = QM(_2bx, q1);
+            int64_t bxq2 = QM(_2bx, q2), bxq3 = QM(_2bx, q3);
+            int64_t bzq0 = QM(_2bz, q0), bzq1 = QM(_2bz, q1);
+            int64_t bzq2 = QM(_2bz, q2), bzq3 = QM(_2bz, q3);
+
+            /* Gradient J_b^T * f_b / 2 (each product shifted separately) */
+            s[0] += ((-bzq2) * fb1 >> 31) + ((bzq1 - bxq3) * fb2 >> 31)
+                  + (bxq2 * fb3 >> 31);
+            s[1] += (bzq3 * fb1 >> 31) + ((bxq2 + bzq0) * fb2 >> 31)
+                  + ((bxq3 - 2*bzq1) * fb3 >> 31);
+            s[2] += ((-2*bxq2 - bzq0) * fb1 >> 31) + ((bxq1 + bzq3) * fb2 >> 31)
+                  + ((bxq0 - 2*bzq2) * fb3 >> 31);
+            s[3] += ((-2*bxq3 + bzq1) * fb1 >> 31) + ((bzq2 - bxq0) * fb2 >> 31)
+                  + (bxq1 * fb3 >> 31);
+            mode = MADGWICK_MARG;
+        }
+
+        /* Normalize step and apply feedback (skip if already optimal) */
+        int32_t sh[4];
+        if (fx_normalize(s, sh, 4)) {
+            int64_t bdt = QM((int64_t)beta, dt);
+            dq0 -= QM(bdt, sh[0]);
+            dq1 -= QM(bdt, sh[1]);
+            dq2 -= QM(bdt, sh[2]);
+            dq3 -= QM(bdt, sh[3]);
+        }
+    }
+
+    /* Integrate quaternion */
+    q0 += dq0;
+    q1 += dq1;
+    q2 += dq2;
+    q3 += dq3;
+
+    /*
+     * Normalize quaternion. |q| stays within ~1e-5 of one per step, so
+     * one Newton step from 1.0 (y = (3 - |q|^2) / 2) is exact to Q30.
+     */
+    int64_t n2 = (q0*q0 + q1*q1 + q2*q2 + q3*q3) >> 30;
+    int64_t y  = (3 * Q_ONE - n2) >> 1;
+    q->q0 = (int32_t)QM(q0, y); q->q1 = (int32_t)QM(q1, y);
+    q->q2 = (int32_t)QM(q2, y); q->q3 = (int32_t)QM(q3, y);
+    return mode;
+}
+
+void madgwick_q_update_batch(ahrs_q_state_t *s, const imu_sample_q_t *imu,
+                             const int32_t *dt, int n)
+{
+    quat_q_t q         = s->q;
+    uint64_t time_q30  = s->time_q30;
+    uint32_t imu_only  = 0;
+    uint32_t gyro_only = 0;
+
+    for (int i = 0; i < n; i++) {
+        int mode = madgwick_q_step(&q, &imu[i], dt[i], s->beta);
+        imu_only  += (mode == MADGWICK_IMU);
+        gyro_only += (mode == MADGWICK_GYRO_ONLY);
+        time_q30  += (uint32_t)dt[i];
+    }
+
+    s->q          = q;
+    s->time_q30   = time_q30;
+    s->updates   += (uint32_t)n;
+    s->imu_only  += imu_only;
+    s->gyro_only += gyro_only;
+}
+
+void ahrs_q_get_euler(const ahrs_q_state_t *s,
+                      int32_t *roll, int32_t *pitch, int32_t *yaw)
+{
+    int64_t q0 = s->q.q0, q1 = s->q.q1, q2 = s->q.q2, q3 = s->q.q3;
+
+    *roll  = fx_atan2_cdeg((int32_t)(2 * (QM(q0, q1) + QM(q2, q3))),
+                           (int32_t)(Q_ONE - 2 * (QM(q1, q1) + QM(q2, q2))));
+    *pitch = fx_asin_cdeg((int32_t)(2 * (QM(q0, q2) - QM(q3, q1))));
+    *yaw   = fx_atan2_cdeg((int32_t)(2 * (QM(q0, q3) + QM(q1, q2))),
+                           (int32_t)(Q_ONE - 2 * (QM(q2, q2) + QM(q3, q3))));
+}
@@ -0,0 +1,61 @@
+/*
+ * ahrs_q.h
+ *
+ * AIRMAN – Fixed-Point AHRS Filter Object
+ * ---------------------------------------
+ *
+ * Integer-only counterpart of ahrs.h for FPU-less MCUs (Cortex-M0+),
+ * selected in ahrs_filter.c with -DAHRS_FIXED_POINT. Same Madgwick
+ * MARG / IMU-only / gyro-only step as madgwick.h, same reentrant,
+ * cache-line-aligned handle, no float anywhere in the update path.
+ *
+ * Formats (see fixmath.h):
+ *   samples      Q16   accel m/s^2, gyro deg/s, mag normalized units
+ *   quaternion   Q30
+ *   dt, beta     Q30   (seconds, gain)
+ *   Euler out    int32 centi-degrees
+ *
+ * The gyro rate is folded into dt before it touches the quaternion
+ * (q += q (x) [0, w*dt/2]), so rates up to ±2000 deg/s never leave
+ * the Q30 range. Accuracy against the float filter is checked by
+ * bench_ahrs_fixed.c.
+ */
+
+#ifndef AIRMAN_AHRS_Q_H
+#define AIRMAN_AHRS_Q_H
+
+#include <stdint.h>
+
+#include "fixmath.h"
+#include "madgwick.h"
+
+#define AHRS_Q_DEFAULT_BETA   FX_Q30(0.1)
+
+/* imu_sample_q_t: common/imu_sample.h (Q16 lanes) */
+
+typedef struct {
+    int32_t q0, q1, q2, q3;   /* Q30 */
+} quat_q_t;
+
+typedef struct {
+    _Alignas(64)
+    quat_q_t q;               /* orientation, body -> earth */
+    int32_t  beta;            /* correction gain, Q30 */
+    uint64_t time_q30;        /* integrated filter time (sum of dt), Q30 s */
+    uint32_t updates;         /* samples processed */
+    uint32_t imu_only;        /* ... corrected without mag (zero mag vector) */
+    uint32_t gyro_only;       /* ... integrated uncorrected (zero accel vector) */
+} ahrs_q_state_t;
+
+/* Identity orientation, given gain (Q30) */
+void ahrs_q_init(ahrs_q_state_t *s, int32_t beta);
+
+/* Process n samples with per-sample dt (Q30 seconds) */
+void madgwick_q_update_batch(ahrs_q_state_t *s, const imu_sample_q_t *imu,
+                             const int32_t *dt, int n);
+
+/* Convert the current quaternion to Euler angles (centi-degrees) */
+void ahrs_q_get_euler(const ahrs_q_state_t *s,
+                      int32_t *roll, int32_t *pitch, int32_t *yaw);
+
+#endif /* AIRMAN_AHRS_Q_H */
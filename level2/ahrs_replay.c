@@ -0,0 +1,270 @@
+/*
+ * ahrs_replay.c
+ *
+ * AIRMAN – Deterministic AHRS Log Replay
+ * --------------------------------------
+ *
+ * Runs recorded IMU data through the same Madgwick filter as
+ * ahrs_filter.c, as fast as the CPU allows, using the recorded sample
+ * timing instead of the wall clock. Hours of flight data reprocess in
+ * seconds, and the same log + beta always gives the same output, so
+ * filter gains can be tuned offline and results diffed.
+ *
+ * Inputs: a binary IMU log or a Level-1 CSV (see replay_src.h),
+ * memory-mapped and parsed in place. Samples are gathered into chunks
+ * and fed to madgwick_update_batch() with the per-sample dt from the
+ * timestamps.
+ *
+ * Output: CSV "timestamp_ms,roll,pitch,yaw" (degrees), one row per
+ * --every samples.
+ *
+ * Usage:
+ *   ./ahrs_replay <log> [-o out.csv] [--every N] [--beta B]
+ *                       [--max-dt S] [--no-output] [--to-bin out.imu]
+ *                       [--cal FILE]
+ *
+ *   --every N       one Euler row per N samples (default 1)
+ *   --beta B        filter gain (default AHRS_DEFAULT_BETA)
+ *   --max-dt S      intervals longer than S seconds (log gaps) reuse the
+ *                   previous dt instead of integrating across the gap
+ *                   (default 0.5)
+ *   --no-output     run the filter only (throughput measurement)
+ *   --to-bin FILE   also write the parsed samples as a binary IMU log,
+ *                   so later replays of a CSV skip text parsing
+ *   --cal FILE      correct the samples with a calibration file
+ *                   (imu_cal.h) before filtering; --to-bin still
+ *                   writes them uncorrected
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ahrs.h"
+#include "imu_cal.h"
+#include "imu_log.h"
+#include "numfmt.h"
+#include "replay_src.h"
+
+/* Samples per madgwick_update_batch() call */
+#define REPLAY_CHUNK     256
+
+/* Buffered output, flushed with one fwrite() when nearly full */
+#define OUT_BUF_BYTES    (1 << 16)
+#define OUT_ROW_MAX      (4 * (NUMFMT_MAX_CHARS + 1))
+
+#define DEFAULT_MAX_DT   0.5
+
+/* ============================================================
+ * OUTPUT
+ * ============================================================
+ */
+
+typedef struct {
+    FILE  *f;
+    char   buf[OUT_BUF_BYTES];
+    size_t len;
+} out_t;
+
+static void out_flush(out_t *o)
+{
+    if (o->len > 0)
+        fwrite(o->buf, 1, o->len, o->f);
+    o->len = 0;
+}
+
+static void out_row(out_t *o, int64_t t_us, float roll, float pitch, float yaw)
+{
+    if (OUT_BUF_BYTES - o->len < OUT_ROW_MAX)
+        out_flush(o);
+
+    char *p = o->buf + o->len;
+    p = numfmt_i64(p, t_us / 1000);
+    *p++ = ',';
+    p = numfmt_fixed(p, roll, 2);
+    *p++ = ',';
+    p = numfmt_fixed(p, pitch, 2);
+    *p++ = ',';
+    p = numfmt_fixed(p, yaw, 2);
+    *p++ = '\n';
+    o->len = (size_t)(p - o->buf);
+}
+
+/* Raw samples re-emitted as a binary IMU log (--to-bin) */
+static void write_bin(FILE *f, const imu_sample_t *imu, int n)
+{
+    fwrite(imu, sizeof(imu[0]), (size_t)n, f);
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================
+ */
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: ahrs_replay <log> [-o out.csv] [--every N] [--beta B]\n"
+            "                         [--max-dt S] [--no-output] [--to-bin out.imu]\n"
+            "                         [--cal FILE]\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *in_path  = NULL;
+    const char *out_path = NULL;
+    const char *bin_path = NULL;
+    const char *cal_path = NULL;
+    long   every     = 1;
+    float  beta      = AHRS_DEFAULT_BETA;
+    double max_dt    = DEFAULT_MAX_DT;
+    int    no_output = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            out_path = argv[++i];
+        else if (strcmp(argv[i], "--every") == 0 && i + 1 < argc)
+            every = atol(argv[++i]);
+        else if (strcmp(argv[i], "--beta") == 0 && i + 1 < argc)
+            beta = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--max-dt") == 0 && i + 1 < argc)
+            max_dt = atof(argv[++i]);
+        else if (strcmp(argv[i], "--no-output") == 0)
+            no_output = 1;
+        else if (strcmp(argv[i], "--to-bin") == 0 && i + 1 < argc)
+            bin_path = argv[++i];
+        else if (strcmp(argv[i], "--cal") == 0 && i + 1 < argc)
+            cal_path = argv[++i];
+        else if (argv[i][0] != '-' && !in_path)
+            in_path = argv[i];
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (!in_path || every < 1) {
+        usage();
+        return 2;
+    }
+
+    static imu_cal_t cal;
+    if (cal_path) {
+        int bad_line = 0;
+        if (imu_cal_load(&cal, cal_path, &bad_line) != 0) {
+            if (errno == EINVAL)
+                fprintf(stderr, "%s:%d: malformed calibration line\n",
+                        cal_path, bad_line);
+            else
+                perror(cal_path);
+            return 1;
+        }
+    }
+
+    replay_map_t in;
+    if (replay_map(&in, in_path) != 0) {
+        perror(in_path);
+        return 1;
+    }
+
+    static out_t out;
+    out.f = stdout;
+    if (out_path && !no_output) {
+        out.f = fopen(out_path, "w");
+        if (!out.f) {
+            perror(out_path);
+            return 1;
+        }
+    }
+
+    FILE *bin = NULL;
+    if (bin_path) {
+        bin = fopen(bin_path, "wb");
+        if (!bin) {
+            perror(bin_path);
+            return 1;
+        }
+        imu_log_header_t h;
+        imu_log_header_init(&h);
+        fwrite(&h, sizeof(h), 1, bin);
+    }
+
+    replay_src_t src;
+    replay_src_init(&src, in.data, in.len, max_dt);
+
+    static ahrs_state_t ahrs;
+    ahrs_init(&ahrs, beta);
+
+    if (!no_output) {
+        static const char header[] = "timestamp_ms,roll,pitch,yaw\n";
+        memcpy(out.buf, header, sizeof(header) - 1);
+        out.len = sizeof(header) - 1;
+    }
+
+    static _Alignas(IMU_SAMPLE_ALIGN) imu_sample_t imu[REPLAY_CHUNK];
+    int64_t      t_us[REPLAY_CHUNK];
+    float        dt[REPLAY_CHUNK];
+    int64_t      last_us = 0;
+    long         left = every;
+    int          n;
+
+    double t0 = now_sec();
+
+    while ((n = replay_src_next(&src, imu, t_us, dt,
+                                left < REPLAY_CHUNK ? (int)left : REPLAY_CHUNK)) > 0) {
+        if (bin)
+            write_bin(bin, imu, n);
+        if (cal_path)
+            imu_cal_apply(&cal, imu, imu, n);
+        madgwick_update_batch(&ahrs, imu, dt, n);
+        last_us = t_us[n - 1];
+
+        left -= n;
+        if (left == 0) {
+            left = every;
+            if (!no_output) {
+                float roll, pitch, yaw;
+                ahrs_get_euler(&ahrs, &roll, &pitch, &yaw);
+                out_row(&out, last_us, roll, pitch, yaw);
+            }
+        }
+    }
+
+    /* Trailing partial group */
+    if (left != every && !no_output) {
+        float roll, pitch, yaw;
+        ahrs_get_euler(&ahrs, &roll, &pitch, &yaw);
+        out_row(&out, last_us, roll, pitch, yaw);
+    }
+    if (!no_output)
+        out_flush(&out);
+
+    double elapsed = now_sec() - t0;
+    double flight  = src.samples ? (double)(src.prev_us - src.first_us) * 1e-6 : 0.0;
+
+    fprintf(stderr,
+            "replayed %lu samples (%.1f s of %s data) in %.3f s: "
+            "%.2f M samples/s, %.0fx real time\n",
+            src.samples, flight, src.binary ? "binary" : "CSV", elapsed,
+            elapsed > 0 ? src.samples / elapsed * 1e-6 : 0.0,
+            elapsed > 0 ? flight / elapsed : 0.0);
+    if (src.bad_lines || src.gaps || src.backwards)
+        fprintf(stderr, "skipped %lu bad lines, %lu gaps > %.3f s, "
+                "%lu non-increasing timestamps\n",
+                src.bad_lines, src.gaps, max_dt, src.backwards);
+
+    if (bin)
+        fclose(bin);
+    if (out.f != stdout)
+        fclose(out.f);
+    replay_unmap(&in);
+    return 0;
+}
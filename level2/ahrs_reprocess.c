@@ -0,0 +1,781 @@
+/*
+ * ahrs_reprocess.c
+ *
+ * AIRMAN – Parallel Flight Log Reprocessing
+ * -----------------------------------------
+ *
+ * Batch counterpart of ahrs_replay: runs a whole archive of recorded
+ * logs through the AHRS filter and the link frame checks on every core,
+ * and writes one row of statistics per log.
+ *
+ * Inputs (any mix, detected per file):
+ *   - binary IMU logs and Level-1 CSV (replay_src.h): every sample goes
+ *     through madgwick_update_batch(), as in ahrs_replay
+ *   - raw link captures, ASCII or COBS binary (`telemetry_tx > cap`,
+ *     `ahrs_filter --binary > cap`): every frame is checked by the
+ *     receiver core (common/rx_stream.h). L1 frames are run through the
+ *     filter; L2 / L2Q frames contribute the attitude they carry.
+ *
+ * Scheduling:
+ *   one task per log on a work-stealing pool (common/work_pool.h),
+ *   largest first, so one huge log does not hold up the end of the
+ *   batch. With --split, IMU logs and CSVs larger than the given size
+ *   are cut into parts at record / line boundaries. Each part first
+ *   replays --warmup samples from before its start with its statistics
+ *   off, so the filter has converged when counting begins (with
+ *   --warmup 0, only the timing of the sample before it); sample
+ *   counts and timing are exact, attitude is within the warm-up error.
+ *   Captures are never split. All per-worker state (filter, sample
+ *   chunk, receiver, the statistics of the current part) is cache-line
+ *   aligned, so workers share no lines.
+ *
+ * Output: CSV, one row per log in argument order:
+ *
+ *   file,format,samples,duration_s,bad_records,frames,crc_fail,
+ *   crc_fail_pct,roll_rms,pitch_rms,dt_mean_ms,dt_jitter_ms,dt_max_ms,
+ *   gaps,backwards
+ *
+ *   bad_records    unparsable CSV lines, or malformed link frames
+ *   crc_fail_pct   checksum failures per received frame (captures)
+ *   roll/pitch_rms attitude RMS in degrees (one value per --every
+ *                  samples, or per L2 frame)
+ *   dt_jitter_ms   standard deviation of the sample interval
+ *   gaps           intervals longer than --max-dt (previous dt reused)
+ *   backwards      non-increasing timestamps
+ *
+ * Usage:
+ *   ./ahrs_reprocess <log>... [--list FILE] [-o out.csv] [-j N]
+ *                    [--split MB] [--warmup N] [--every N] [--beta B]
+ *                    [--max-dt S] [--cal FILE]
+ *
+ *   --list FILE     also read log paths from FILE, one per line ("-":
+ *                   stdin)
+ *   -j N            worker threads (default: online CPUs)
+ *   --split MB      split IMU logs / CSVs larger than MB megabytes
+ *                   (default 64; 0 disables)
+ *   --warmup N      samples replayed ahead of each part (default 2000)
+ *   --every N       attitude sampled once per N samples (default 10; the
+ *                   filter runs in batches of up to N samples)
+ *   --cal FILE      correct IMU samples with a calibration file
+ *
+ * Exit status 1 when a log could not be read (its row is left out).
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "ahrs.h"
+#include "binframe.h"
+#include "imu_cal.h"
+#include "imu_log.h"
+#include "replay_src.h"
+#include "rx_stream.h"
+#include "work_pool.h"
+
+#define REPROCESS_CHUNK    256
+
+#define DEFAULT_SPLIT_MB   64
+#define DEFAULT_WARMUP     2000
+#define DEFAULT_MAX_DT     0.5
+#define DEFAULT_EVERY      10
+
+/* Bytes inspected to tell a CSV from a link capture */
+#define PROBE_BYTES        512
+
+enum { FMT_IMU_LOG, FMT_CSV, FMT_CAPTURE, FMT_CAPTURE_BIN };
+
+static const char *const fmt_names[] = {
+    "imu_log", "csv", "capture", "capture_bin",
+};
+
+/* ============================================================
+ * STATISTICS
+ * ============================================================
+ *
+ * Running mean / variance (Welford), merged across parts with Chan's
+ * formula, so a split log gives the same numbers as a whole one.
+ */
+
+typedef struct {
+    double n, mean, m2, max;
+} run_stat_t;
+
+static void stat_add(run_stat_t *s, double x)
+{
+    double d = x - s->mean;
+    s->n    += 1.0;
+    s->mean += d / s->n;
+    s->m2   += d * (x - s->mean);
+    if (s->n == 1.0 || x > s->max)
+        s->max = x;
+}
+
+static void stat_merge(run_stat_t *a, const run_stat_t *b)
+{
+    if (b->n == 0.0)
+        return;
+    if (a->n == 0.0) {
+        *a = *b;
+        return;
+    }
+    double n = a->n + b->n;
+    double d = b->mean - a->mean;
+    a->mean += d * b->n / n;
+    a->m2   += b->m2 + d * d * a->n * b->n / n;
+    a->max   = b->max > a->max ? b->max : a->max;
+    a->n     = n;
+}
+
+static double stat_std(const run_stat_t *s)
+{
+    return s->n > 0.0 ? sqrt(s->m2 / s->n) : 0.0;
+}
+
+static double stat_rms(const run_stat_t *s)
+{
+    return s->n > 0.0 ? sqrt(s->m2 / s->n + s->mean * s->mean) : 0.0;
+}
+
+/* Everything one part (or, merged, one log) contributes to its row */
+typedef struct {
+    int           err;              /* errno of a failed open, else 0 */
+    int           format;
+    unsigned long samples;
+    unsigned long bad_records;
+    unsigned long frames;
+    unsigned long crc_fail;
+    unsigned long gaps;
+    unsigned long backwards;
+    int64_t       first_us, last_us;
+    int           have_time;
+    run_stat_t    roll, pitch;      /* degrees */
+    run_stat_t    dt;               /* seconds, positive intervals */
+} log_stats_t;
+
+static void stats_merge(log_stats_t *a, const log_stats_t *b)
+{
+    if (b->err)
+        a->err = b->err;
+    a->samples     += b->samples;
+    a->bad_records += b->bad_records;
+    a->frames      += b->frames;
+    a->crc_fail    += b->crc_fail;
+    a->gaps        += b->gaps;
+    a->backwards   += b->backwards;
+    if (b->have_time) {
+        if (!a->have_time || b->first_us < a->first_us)
+            a->first_us = b->first_us;
+        if (!a->have_time || b->last_us > a->last_us)
+            a->last_us = b->last_us;
+        a->have_time = 1;
+    }
+    stat_merge(&a->roll, &b->roll);
+    stat_merge(&a->pitch, &b->pitch);
+    stat_merge(&a->dt, &b->dt);
+}
+
+/* ============================================================
+ * PER-WORKER STATE
+ * ============================================================
+ */
+
+typedef struct {
+    float  beta;
+    double max_dt;
+    long   every;
+    long   warmup;
+    const imu_cal_t *cal;           /* NULL: uncorrected */
+} options_t;
+
+typedef struct {
+    _Alignas(IMU_SAMPLE_ALIGN)
+    imu_sample_t  imu[REPROCESS_CHUNK];
+    int64_t       t_us[REPROCESS_CHUNK];
+    float         dt[REPROCESS_CHUNK];
+    int           n;                /* samples waiting in imu[] */
+
+    ahrs_state_t  ahrs;
+    rx_stream_t   rx;
+    const options_t *opt;
+
+    /* Timing, carried across the warm-up into the part */
+    int           have_prev;
+    int64_t       prev_us;
+    float         prev_dt;
+    long          left;             /* samples to the next attitude sample */
+
+    int           counting;         /* 0 during warm-up */
+
+    /*
+     * The current part's row, updated per sample. It lives in the
+     * worker's own (line-aligned) state rather than in the shared
+     * per-task array, so workers never write to the same cache line;
+     * run_task() copies it out once the part is done.
+     */
+    log_stats_t   st;
+} worker_state_t;
+
+static void worker_begin(worker_state_t *w, const options_t *opt)
+{
+    ahrs_init(&w->ahrs, opt->beta);
+    w->opt       = opt;
+    w->n         = 0;
+    w->have_prev = 0;
+    w->prev_dt   = 0.0f;
+    w->left      = opt->every;
+    w->counting  = 1;
+    memset(&w->st, 0, sizeof(w->st));
+}
+
+/* dt for the sample at t_us, with the same gap rules as replay_src.h */
+static float worker_time(worker_state_t *w, int64_t t_us)
+{
+    log_stats_t *st = &w->st;
+    float d = 0.0f;
+
+    if (w->counting) {
+        st->samples++;
+        if (!st->have_time)
+            st->first_us = t_us;
+        st->last_us   = t_us;
+        st->have_time = 1;
+    }
+
+    if (w->have_prev) {
+        int64_t iv = t_us - w->prev_us;
+        d = (float)iv * 1e-6f;
+        if (d <= 0.0f) {
+            st->backwards += w->counting;
+            d = 0.0f;
+        } else {
+            if (w->counting)
+                stat_add(&st->dt, iv * 1e-6);
+            if (d > w->opt->max_dt) {
+                st->gaps += w->counting;
+                d = w->prev_dt;
+            } else {
+                w->prev_dt = d;
+            }
+        }
+    }
+    w->have_prev = 1;
+    w->prev_us   = t_us;
+    return d;
+}
+
+/* Room before the next attitude sample is due */
+static int worker_room(const worker_state_t *w)
+{
+    return w->left < REPROCESS_CHUNK ? (int)w->left : REPROCESS_CHUNK;
+}
+
+static void add_attitude(log_stats_t *st, float roll, float pitch)
+{
+    stat_add(&st->roll, roll);
+    stat_add(&st->pitch, pitch);
+}
+
+/* Filter the n samples in imu[] (n <= worker_room()) */
+static void worker_filter(worker_state_t *w, int n)
+{
+    if (n <= 0)
+        return;
+    if (w->opt->cal)
+        imu_cal_apply(w->opt->cal, w->imu, w->imu, n);
+    madgwick_update_batch(&w->ahrs, w->imu, w->dt, n);
+
+    w->left -= n;
+    if (w->left == 0) {
+        w->left = w->opt->every;
+        if (w->counting) {
+            float roll, pitch, yaw;
+            ahrs_get_euler(&w->ahrs, &roll, &pitch, &yaw);
+            add_attitude(&w->st, roll, pitch);
+        }
+    }
+    w->n = 0;
+}
+
+/* ============================================================
+ * IMU LOGS AND CSV
+ * ============================================================
+ */
+
+static void run_samples(worker_state_t *w, replay_src_t *src)
+{
+    int n;
+    while ((n = replay_src_next(src, w->imu, w->t_us, w->dt,
+                                worker_room(w))) > 0) {
+        for (int i = 0; i < n; i++)
+            w->dt[i] = worker_time(w, w->t_us[i]);
+        worker_filter(w, n);
+    }
+}
+
+/* Part `part` of n_parts: bytes [len * part / n_parts, ...) at boundaries */
+static void process_samples(worker_state_t *w, const replay_map_t *m,
+                            int part, int n_parts)
+{
+    replay_src_t src;
+    replay_src_init(&src, m->data, m->len, w->opt->max_dt);
+
+    size_t begin = replay_src_boundary(&src, (size_t)((double)m->len * part / n_parts));
+    size_t end   = part + 1 == n_parts
+                 ? m->len
+                 : replay_src_boundary(&src, (size_t)((double)m->len * (part + 1) / n_parts));
+
+    /*
+     * Even without a warm-up, the sample before the part sets the timing
+     * state, so the part's first interval is counted as in a whole run
+     */
+    if (part > 0) {
+        long   n_warm = w->opt->warmup > 0 ? w->opt->warmup : 1;
+        size_t warm   = replay_src_rewind(&src, begin, n_warm);
+        w->counting = 0;
+        replay_src_range(&src, warm, begin);
+        if (w->opt->warmup > 0)
+            run_samples(w, &src);
+        else if (replay_src_next(&src, w->imu, w->t_us, w->dt, 1) == 1)
+            worker_time(w, w->t_us[0]);
+        w->left     = w->opt->every;
+        w->counting = 1;
+    }
+
+    unsigned long bad = src.bad_lines;
+    replay_src_range(&src, begin, end);
+    run_samples(w, &src);
+    w->st.bad_records += src.bad_lines - bad;
+}
+
+/* ============================================================
+ * LINK CAPTURES
+ * ============================================================
+ */
+
+static void on_frame(void *ctx, const rx_frame_t *f)
+{
+    worker_state_t *w = ctx;
+
+    if (f->layout->side)
+        return;
+
+    if (f->layout->type == BINFRAME_TYPE_L1) {
+        imu_sample_t *imu = &w->imu[w->n];
+        int64_t t_us = f->ts_ms * 1000;
+        imu->accel    = vec3(f->v[0], f->v[1], f->v[2]);
+        imu->gyro     = vec3(f->v[3], f->v[4], f->v[5]);
+        imu->mag      = vec3(0.0f, 0.0f, 0.0f);
+        imu->t_us     = t_us;
+        imu->valid    = IMU_VALID_ACCEL | IMU_VALID_GYRO;
+        imu->reserved = 0;
+        w->dt[w->n++] = worker_time(w, t_us);
+        if (w->n == worker_room(w))
+            worker_filter(w, w->n);
+        return;
+    }
+
+    /* Attitude computed on the vehicle */
+    worker_time(w, f->ts_ms * 1000);
+    if (f->layout->type == BINFRAME_TYPE_L2) {
+        add_attitude(&w->st, f->v[0], f->v[1]);
+    } else if (f->layout->type == BINFRAME_TYPE_L2Q) {
+        ahrs_state_t q;
+        ahrs_init(&q, 0.0f);
+        q.q = (quat_t){ f->v[0], f->v[1], f->v[2], f->v[3] };
+        float roll, pitch, yaw;
+        ahrs_get_euler(&q, &roll, &pitch, &yaw);
+        add_attitude(&w->st, roll, pitch);
+    }
+}
+
+static void process_capture(worker_state_t *w, const replay_map_t *m,
+                            int binary)
+{
+    rx_stream_init(&w->rx, binary, on_frame, w);
+    rx_stream_feed(&w->rx, m->data, m->len);
+    worker_filter(w, w->n);
+
+    w->st.frames      += w->rx.n.frames;
+    w->st.crc_fail    += w->rx.n.bad_checksum;
+    w->st.bad_records += w->rx.n.bad_format;
+}
+
+/* ============================================================
+ * TASKS
+ * ============================================================
+ */
+
+static int log_format(const uint8_t *data, size_t len)
+{
+    if (imu_log_version(data, len))
+        return FMT_IMU_LOG;
+
+    size_t n = len < PROBE_BYTES ? len : PROBE_BYTES;
+    if (memchr(data, 0x00, n))
+        return FMT_CAPTURE_BIN;         /* COBS frame delimiters */
+    if (memchr(data, '$', n))
+        return FMT_CAPTURE;
+    return FMT_CSV;
+}
+
+typedef struct {
+    int    log;                     /* index into the log list */
+    int    part, n_parts;
+    size_t bytes;                   /* scheduling weight */
+} task_t;
+
+typedef struct {
+    const options_t *opt;
+    char           **paths;
+    task_t          *tasks;
+    log_stats_t     *part_stats;    /* one per task */
+    worker_state_t  *workers;
+} batch_t;
+
+static void run_task(void *ctx, int task, int worker)
+{
+    batch_t        *b  = ctx;
+    const task_t   *t  = &b->tasks[task];
+    worker_state_t *w  = &b->workers[worker];
+    log_stats_t    *st = &w->st;
+
+    replay_map_t m;
+    if (replay_map(&m, b->paths[t->log]) != 0) {
+        b->part_stats[task].err = errno;
+        return;
+    }
+
+    worker_begin(w, b->opt);
+    st->format = log_format(m.data, m.len);
+
+    switch (st->format) {
+    case FMT_IMU_LOG:
+    case FMT_CSV:
+        process_samples(w, &m, t->part, t->n_parts);
+        break;
+    case FMT_CAPTURE:
+    case FMT_CAPTURE_BIN:
+        process_capture(w, &m, st->format == FMT_CAPTURE_BIN);
+        break;
+    }
+    replay_unmap(&m);
+    b->part_stats[task] = *st;
+}
+
+/* Largest first; ties in argument order */
+static int cmp_tasks(const void *a, const void *b)
+{
+    const task_t *x = a, *y = b;
+    if (x->bytes != y->bytes)
+        return x->bytes < y->bytes ? 1 : -1;
+    if (x->log != y->log)
+        return x->log < y->log ? -1 : 1;
+    return x->part - y->part;
+}
+
+/*
+ * Parts for a log of the given size: only IMU logs and CSVs larger
+ * than split are read (their first bytes) to find out, so a batch of
+ * small logs costs one stat() each here.
+ */
+static int count_parts(const char *path, size_t *bytes, size_t split)
+{
+    struct stat st;
+    *bytes = stat(path, &st) == 0 && st.st_size > 0 ? (size_t)st.st_size : 0;
+    if (split == 0 || *bytes <= split)
+        return 1;
+
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return 1;
+    uint8_t head[PROBE_BYTES];
+    size_t  n = fread(head, 1, sizeof(head), f);
+    fclose(f);
+
+    int fmt = log_format(head, n);
+    if (fmt != FMT_IMU_LOG && fmt != FMT_CSV)
+        return 1;
+    return (int)((*bytes + split - 1) / split);
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================
+ */
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: ahrs_reprocess <log>... [--list FILE] [-o out.csv] [-j N]\n"
+            "                      [--split MB] [--warmup N] [--every N]\n"
+            "                      [--beta B] [--max-dt S] [--cal FILE]\n");
+}
+
+/* Append a copy of p; every entry is owned by the list (free_paths()) */
+static int add_path(char ***paths, int *n, int *cap, const char *p)
+{
+    if (*n == *cap) {
+        int c = *cap ? *cap * 2 : 64;
+        char **grown = realloc(*paths, (size_t)c * sizeof(**paths));
+        if (!grown)
+            return -1;
+        *paths = grown;
+        *cap   = c;
+    }
+    char *copy = strdup(p);
+    if (!copy)
+        return -1;
+    (*paths)[(*n)++] = copy;
+    return 0;
+}
+
+static void free_paths(char **paths, int n)
+{
+    for (int i = 0; i < n; i++)
+        free(paths[i]);
+    free(paths);
+}
+
+/* One path per line; blank lines and '#' comments skipped */
+static int read_list(const char *list, char ***paths, int *n, int *cap)
+{
+    FILE *f = strcmp(list, "-") == 0 ? stdin : fopen(list, "r");
+    if (!f)
+        return -1;
+
+    char line[4096];
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#')
+            continue;
+        if (add_path(paths, n, cap, line) != 0) {
+            if (f != stdin)
+                fclose(f);
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    if (f != stdin)
+        fclose(f);
+    return 0;
+}
+
+/*
+ * Schedule and run the tasks for n_logs paths and write the rows to
+ * out. Returns the exit status.
+ */
+static int reprocess(const options_t *opt, char **paths, int n_logs,
+                     int threads, double split_mb, FILE *out)
+{
+    /* Tasks: one per log, or one per part of a split log */
+    size_t split = (size_t)(split_mb * 1024.0 * 1024.0);
+    size_t total_bytes = 0;
+    int    n_tasks = 0, task_cap = n_logs;
+    task_t *tasks  = malloc((size_t)task_cap * sizeof(*tasks));
+
+    for (int i = 0; tasks && i < n_logs; i++) {
+        size_t bytes;
+        int    n_parts = count_parts(paths[i], &bytes, split);
+        total_bytes += bytes;
+
+        if (n_tasks + n_parts > task_cap) {
+            task_cap = (n_tasks + n_parts) * 2;
+            task_t *grown = realloc(tasks, (size_t)task_cap * sizeof(*tasks));
+            if (!grown) {
+                free(tasks);
+                tasks = NULL;
+                break;
+            }
+            tasks = grown;
+        }
+        for (int k = 0; k < n_parts; k++)
+            tasks[n_tasks++] = (task_t){ i, k, n_parts, bytes / (size_t)n_parts };
+    }
+    if (!tasks) {
+        perror("ahrs_reprocess");
+        return 1;
+    }
+    qsort(tasks, (size_t)n_tasks, sizeof(*tasks), cmp_tasks);
+
+    if (threads > n_tasks)
+        threads = n_tasks;
+    if (threads > WORK_POOL_MAX_THREADS)
+        threads = WORK_POOL_MAX_THREADS;
+
+    batch_t b = {
+        .opt        = opt,
+        .paths      = paths,
+        .tasks      = tasks,
+        .part_stats = calloc((size_t)n_tasks, sizeof(log_stats_t)),
+        .workers    = aligned_alloc(IMU_SAMPLE_ALIGN,
+                                    (size_t)threads * sizeof(worker_state_t)),
+    };
+    log_stats_t       *logs  = calloc((size_t)n_logs, sizeof(*logs));
+    work_pool_stats_t *pstat = calloc((size_t)threads, sizeof(*pstat));
+    int                status = 0;
+
+    if (!b.part_stats || !b.workers || !logs || !pstat) {
+        perror("ahrs_reprocess");
+        status = 1;
+    } else {
+        double t0 = now_sec();
+        if (work_pool_run(threads, n_tasks, run_task, &b, pstat) != 0)
+            perror("ahrs_reprocess: worker thread");
+        double elapsed = now_sec() - t0;
+
+        /* Merge parts back into their logs */
+        for (int i = 0; i < n_tasks; i++) {
+            log_stats_t *l = &logs[tasks[i].log];
+            if (tasks[i].part == 0)
+                l->format = b.part_stats[i].format;
+            stats_merge(l, &b.part_stats[i]);
+        }
+
+        fprintf(out, "file,format,samples,duration_s,bad_records,frames,crc_fail,"
+                     "crc_fail_pct,roll_rms,pitch_rms,dt_mean_ms,dt_jitter_ms,"
+                     "dt_max_ms,gaps,backwards\n");
+
+        unsigned long samples = 0;
+        for (int i = 0; i < n_logs; i++) {
+            const log_stats_t *l = &logs[i];
+            if (l->err) {
+                fprintf(stderr, "%s: %s\n", paths[i], strerror(l->err));
+                status = 1;
+                continue;
+            }
+            unsigned long rx = l->frames + l->crc_fail;
+            fprintf(out, "%s,%s,%lu,%.3f,%lu,%lu,%lu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%lu,%lu\n",
+                    paths[i], fmt_names[l->format], l->samples,
+                    l->have_time ? (l->last_us - l->first_us) * 1e-6 : 0.0,
+                    l->bad_records, l->frames, l->crc_fail,
+                    rx ? 100.0 * l->crc_fail / rx : 0.0,
+                    stat_rms(&l->roll), stat_rms(&l->pitch),
+                    l->dt.mean * 1e3, stat_std(&l->dt) * 1e3, l->dt.max * 1e3,
+                    l->gaps, l->backwards);
+            samples += l->samples;
+        }
+
+        unsigned long stolen = 0;
+        for (int i = 0; i < threads; i++)
+            stolen += pstat[i].stolen;
+
+        fprintf(stderr,
+                "reprocessed %d logs (%d tasks, %.1f MB) in %.3f s on %d threads: "
+                "%.2f M samples/s, %lu tasks stolen\n",
+                n_logs, n_tasks, total_bytes / (1024.0 * 1024.0), elapsed, threads,
+                elapsed > 0 ? samples / elapsed * 1e-6 : 0.0, stolen);
+    }
+
+    free(b.part_stats);
+    free(b.workers);
+    free(logs);
+    free(pstat);
+    free(tasks);
+    return status;
+}
+
+int main(int argc, char **argv)
+{
+    const char *out_path = NULL;
+    const char *cal_path = NULL;
+    char      **paths    = NULL;
+    int    n_logs   = 0, cap = 0;
+    int    threads  = work_pool_cpus();
+    double split_mb = DEFAULT_SPLIT_MB;
+
+    options_t opt = {
+        .beta   = AHRS_DEFAULT_BETA,
+        .max_dt = DEFAULT_MAX_DT,
+        .every  = DEFAULT_EVERY,
+        .warmup = DEFAULT_WARMUP,
+        .cal    = NULL,
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            out_path = argv[++i];
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--list") == 0 && i + 1 < argc) {
+            const char *list = argv[++i];
+            if (read_list(list, &paths, &n_logs, &cap) != 0) {
+                perror(list);
+                free_paths(paths, n_logs);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--split") == 0 && i + 1 < argc)
+            split_mb = atof(argv[++i]);
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            opt.warmup = atol(argv[++i]);
+        else if (strcmp(argv[i], "--every") == 0 && i + 1 < argc)
+            opt.every = atol(argv[++i]);
+        else if (strcmp(argv[i], "--beta") == 0 && i + 1 < argc)
+            opt.beta = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--max-dt") == 0 && i + 1 < argc)
+            opt.max_dt = atof(argv[++i]);
+        else if (strcmp(argv[i], "--cal") == 0 && i + 1 < argc)
+            cal_path = argv[++i];
+        else if (argv[i][0] != '-') {
+            if (add_path(&paths, &n_logs, &cap, argv[i]) != 0) {
+                perror("ahrs_reprocess");
+                free_paths(paths, n_logs);
+                return 1;
+            }
+        }
+        else {
+            usage();
+            free_paths(paths, n_logs);
+            return 2;
+        }
+    }
+    if (n_logs == 0 || opt.every < 1 || threads < 1 || opt.warmup < 0) {
+        usage();
+        free_paths(paths, n_logs);
+        return 2;
+    }
+
+    static imu_cal_t cal;
+    if (cal_path) {
+        int bad_line = 0;
+        if (imu_cal_load(&cal, cal_path, &bad_line) != 0) {
+            if (errno == EINVAL)
+                fprintf(stderr, "%s:%d: malformed calibration line\n",
+                        cal_path, bad_line);
+            else
+                perror(cal_path);
+            free_paths(paths, n_logs);
+            return 1;
+        }
+        opt.cal = &cal;
+    }
+
+    FILE *out = stdout;
+    if (out_path) {
+        out = fopen(out_path, "w");
+        if (!out) {
+            perror(out_path);
+            free_paths(paths, n_logs);
+            return 1;
+        }
+    }
+
+    int status = reprocess(&opt, paths, n_logs, threads, split_mb, out);
+
+    if (out != stdout)
+        fclose(out);
+    free_paths(paths, n_logs);
+    return status;
+}
@@ -0,0 +1,386 @@
+/*
+ * ahrs_simd.c
+ *
+ * AIRMAN – Multi-stream SIMD Madgwick kernel (see ahrs_simd.h)
+ *
+ * The kernel is written once against a tiny vector abstraction
+ * (v_add, v_mul, ...) that maps to the widest ISA enabled at compile
+ * time. Each lane performs exactly the operations of madgwick_step();
+ * the scalar branches (mag / accel availability, zero step) become
+ * per-lane masks.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ahrs_simd.h"
+#include "madgwick.h"
+
+#define SOA_ALIGN   64
+#define SOA_PAD     16     /* lanes; multiple of every vector width */
+
+/* ============================================================
+ * VECTOR ABSTRACTION
+ * ============================================================
+ *
+ * vf      : vector of VW floats
+ * vm      : per-lane mask
+ * v_nz(a) : mask of lanes where a != 0
+ * v_gt0(a): mask of lanes where a > 0
+ * v_sel(m, a, b) : a where m is set, b elsewhere
+ */
+
+#if defined(AHRS_SIMD_SCALAR)
+
+/* Forced scalar build (-DAHRS_SIMD_SCALAR, the SIMD=none profiles) */
+#define ISA_NAME "scalar"
+#define VW 1
+
+#elif defined(__AVX512F__)
+
+#include <immintrin.h>
+#define ISA_NAME "avx512"
+#define VW 16
+typedef __m512    vf;
+typedef __mmask16 vm;
+#define v_load(p)       _mm512_load_ps(p)
+#define v_store(p, a)   _mm512_store_ps(p, a)
+#define v_set1(x)       _mm512_set1_ps(x)
+#define v_add(a, b)     _mm512_add_ps(a, b)
+#define v_sub(a, b)     _mm512_sub_ps(a, b)
+#define v_mul(a, b)     _mm512_mul_ps(a, b)
+#define v_div(a, b)     _mm512_div_ps(a, b)
+#define v_sqrt(a)       _mm512_sqrt_ps(a)
+#define v_nz(a)         _mm512_cmp_ps_mask(a, _mm512_setzero_ps(), _CMP_NEQ_UQ)
+#define v_gt0(a)        _mm512_cmp_ps_mask(a, _mm512_setzero_ps(), _CMP_GT_OQ)
+#define v_and_m(a, b)   ((vm)((a) & (b)))
+#define v_or_m(a, b)    ((vm)((a) | (b)))
+#define v_sel(m, a, b)  _mm512_mask_blend_ps(m, b, a)
+
+#elif defined(__AVX2__)
+
+#include <immintrin.h>
+#define ISA_NAME "avx2"
+#define VW 8
+typedef __m256 vf;
+typedef __m256 vm;
+#define v_load(p)       _mm256_load_ps(p)
+#define v_store(p, a)   _mm256_store_ps(p, a)
+#define v_set1(x)       _mm256_set1_ps(x)
+#define v_add(a, b)     _mm256_add_ps(a, b)
+#define v_sub(a, b)     _mm256_sub_ps(a, b)
+#define v_mul(a, b)     _mm256_mul_ps(a, b)
+#define v_div(a, b)     _mm256_div_ps(a, b)
+#define v_sqrt(a)       _mm256_sqrt_ps(a)
+#define v_nz(a)         _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_NEQ_UQ)
+#define v_gt0(a)        _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_GT_OQ)
+#define v_and_m(a, b)   _mm256_and_ps(a, b)
+#define v_or_m(a, b)    _mm256_or_ps(a, b)
+#define v_sel(m, a, b)  _mm256_blendv_ps(b, a, m)
+
+#elif defined(__SSE2__)
+
+#include <emmintrin.h>
+#define ISA_NAME "sse2"
+#define VW 4
+typedef __m128 vf;
+typedef __m128 vm;
+#define v_load(p)       _mm_load_ps(p)
+#define v_store(p, a)   _mm_store_ps(p, a)
+#define v_set1(x)       _mm_set1_ps(x)
+#define v_add(a, b)     _mm_add_ps(a, b)
+#define v_sub(a, b)     _mm_sub_ps(a, b)
+#define v_mul(a, b)     _mm_mul_ps(a, b)
+#define v_div(a, b)     _mm_div_ps(a, b)
+#define v_sqrt(a)       _mm_sqrt_ps(a)
+#define v_nz(a)         _mm_cmpneq_ps(a, _mm_setzero_ps())
+#define v_gt0(a)        _mm_cmpgt_ps(a, _mm_setzero_ps())
+#define v_and_m(a, b)   _mm_and_ps(a, b)
+#define v_or_m(a, b)    _mm_or_ps(a, b)
+#define v_sel(m, a, b)  _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+#include <arm_neon.h>
+#define ISA_NAME "neon"
+#define VW 4
+typedef float32x4_t vf;
+typedef uint32x4_t  vm;
+#define v_load(p)       vld1q_f32(p)
+#define v_store(p, a)   vst1q_f32(p, a)
+#define v_set1(x)       vdupq_n_f32(x)
+#define v_add(a, b)     vaddq_f32(a, b)
+#define v_sub(a, b)     vsubq_f32(a, b)
+#define v_mul(a, b)     vmulq_f32(a, b)
+#define v_div(a, b)     vdivq_f32(a, b)
+#define v_sqrt(a)       vsqrtq_f32(a)
+#define v_nz(a)         vmvnq_u32(vceqq_f32(a, vdupq_n_f32(0.0f)))
+#define v_gt0(a)        vcgtq_f32(a, vdupq_n_f32(0.0f))
+#define v_and_m(a, b)   vandq_u32(a, b)
+#define v_or_m(a, b)    vorrq_u32(a, b)
+#define v_sel(m, a, b)  vbslq_f32(m, a, b)
+
+#else
+
+#define ISA_NAME "scalar"
+#define VW 1
+
+#endif
+
+/* ============================================================
+ * ALLOCATION
+ * ============================================================ */
+
+static float *soa_block(size_t arrays, size_t cap)
+{
+    size_t bytes = arrays * cap * sizeof(float);
+    float *p;
+
+#ifdef _WIN32
+    p = _aligned_malloc(bytes, SOA_ALIGN);
+#else
+    p = aligned_alloc(SOA_ALIGN, bytes);
+#endif
+    if (p)
+        memset(p, 0, bytes);
+    return p;
+}
+
+static void soa_block_free(float *p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+static size_t soa_cap(size_t n)
+{
+    return (n + SOA_PAD - 1) / SOA_PAD * SOA_PAD;
+}
+
+int ahrs_soa_alloc(ahrs_soa_t *s, size_t n, float beta)
+{
+    s->n    = n;
+    s->beta = beta;
+    s->cap = soa_cap(n ? n : 1);
+
+    float *p = soa_block(4, s->cap);
+    if (!p)
+        return -1;
+
+    s->q0 = p;
+    s->q1 = p + s->cap;
+    s->q2 = p + s->cap * 2;
+    s->q3 = p + s->cap * 3;
+
+    for (size_t i = 0; i < s->cap; i++)
+        s->q0[i] = 1.0f;
+    return 0;
+}
+
+void ahrs_soa_free(ahrs_soa_t *s)
+{
+    soa_block_free(s->q0);
+    s->q0 = s->q1 = s->q2 = s->q3 = NULL;
+}
+
+int imu_soa_alloc(imu_soa_t *in, size_t n)
+{
+    in->n   = n;
+    in->cap = soa_cap(n ? n : 1);
+
+    float *p = soa_block(10, in->cap);
+    if (!p)
+        return -1;
+
+    float **fields[10] = { &in->ax, &in->ay, &in->az,
+                           &in->gx, &in->gy, &in->gz,
+                           &in->mx, &in->my, &in->mz, &in->dt };
+    for (int k = 0; k < 10; k++)
+        *fields[k] = p + in->cap * (size_t)k;
+    return 0;
+}
+
+void imu_soa_free(imu_soa_t *in)
+{
+    soa_block_free(in->ax);
+    memset(in, 0, sizeof(*in));
+}
+
+/* ============================================================
+ * SCALAR REFERENCE PATH
+ * ============================================================ */
+
+void ahrs_soa_update_scalar(ahrs_soa_t *s, const imu_soa_t *in)
+{
+    for (size_t i = 0; i < s->n; i++) {
+        quat_t q = { s->q0[i], s->q1[i], s->q2[i], s->q3[i] };
+        imu_sample_t imu = {
+            .accel = vec3(in->ax[i], in->ay[i], in->az[i]),
+            .gyro  = vec3(in->gx[i], in->gy[i], in->gz[i]),
+            .mag   = vec3(in->mx[i], in->my[i], in->mz[i]),
+            .valid = IMU_VALID_ALL,
+        };
+
+        madgwick_step(&q, &imu, in->dt[i], s->beta);
+
+        s->q0[i] = q.q0; s->q1[i] = q.q1;
+        s->q2[i] = q.q2; s->q3[i] = q.q3;
+    }
+}
+
+/* ============================================================
+ * VECTOR KERNEL
+ * ============================================================ */
+
+#if VW > 1
+
+void ahrs_soa_update(ahrs_soa_t *s, const imu_soa_t *in)
+{
+    const vf zero  = v_set1(0.0f);
+    const vf half  = v_set1(0.5f);
+    const vf one   = v_set1(1.0f);
+    const vf two   = v_set1(2.0f);
+    const vf four  = v_set1(4.0f);
+    const vf d2r   = v_set1((float)(M_PI / 180.0));
+    const vf beta  = v_set1(s->beta);
+
+#define V_INV_SQRT(x)  v_div(one, v_sqrt(x))
+#define V_SUM3(a, b, c) v_add(v_add(a, b), c)
+
+    for (size_t i = 0; i < s->n; i += VW) {
+        vf q0 = v_load(s->q0 + i), q1 = v_load(s->q1 + i);
+        vf q2 = v_load(s->q2 + i), q3 = v_load(s->q3 + i);
+
+        vf ax = v_load(in->ax + i), ay = v_load(in->ay + i), az = v_load(in->az + i);
+        vf mx = v_load(in->mx + i), my = v_load(in->my + i), mz = v_load(in->mz + i);
+        vf gx = v_mul(v_load(in->gx + i), d2r);
+        vf gy = v_mul(v_load(in->gy + i), d2r);
+        vf gz = v_mul(v_load(in->gz + i), d2r);
+        vf dt = v_load(in->dt + i);
+
+        /* Which lanes have usable accel / mag vectors */
+        vm acc_ok = v_or_m(v_or_m(v_nz(ax), v_nz(ay)), v_nz(az));
+        vm mag_ok = v_or_m(v_or_m(v_nz(mx), v_nz(my)), v_nz(mz));
+
+        /* Quaternion rate of change from gyroscope */
+        vf qd0 = v_mul(half, v_sub(v_sub(v_sub(zero, v_mul(q1, gx)), v_mul(q2, gy)), v_mul(q3, gz)));
+        vf qd1 = v_mul(half, v_sub(v_add(v_mul(q0, gx), v_mul(q2, gz)), v_mul(q3, gy)));
+        vf qd2 = v_mul(half, v_add(v_sub(v_mul(q0, gy), v_mul(q1, gz)), v_mul(q3, gx)));
+        vf qd3 = v_mul(half, v_sub(v_add(v_mul(q0, gz), v_mul(q1, gy)), v_mul(q2, gx)));
+
+        /* Normalize accelerometer and magnetometer */
+        vf norm = V_INV_SQRT(V_SUM3(v_mul(ax, ax), v_mul(ay, ay), v_mul(az, az)));
+        ax = v_mul(ax, norm); ay = v_mul(ay, norm); az = v_mul(az, norm);
+        norm = V_INV_SQRT(V_SUM3(v_mul(mx, mx), v_mul(my, my), v_mul(mz, mz)));
+        mx = v_mul(mx, norm); my = v_mul(my, norm); mz = v_mul(mz, norm);
+
+        /* Shared products */
+        vf _2q0 = v_mul(two, q0), _2q1 = v_mul(two, q1);
+        vf _2q2 = v_mul(two, q2), _2q3 = v_mul(two, q3);
+        vf q0q0 = v_mul(q0, q0), q0q1 = v_mul(q0, q1), q0q2 = v_mul(q0, q2), q0q3 = v_mul(q0, q3);
+        vf q1q1 = v_mul(q1, q1), q1q2 = v_mul(q1, q2), q1q3 = v_mul(q1, q3);
+        vf q2q2 = v_mul(q2, q2), q2q3 = v_mul(q2, q3), q3q3 = v_mul(q3, q3);
+
+        /* Gravity residual and gradient */
+        vf fg1 = v_sub(v_mul(two, v_sub(q1q3, q0q2)), ax);
+        vf fg2 = v_sub(v_mul(two, v_add(q0q1, q2q3)), ay);
+        vf fg3 = v_sub(v_sub(one, v_mul(two, v_add(q1q1, q2q2))), az);
+
+        vf s0 = v_add(v_sub(zero, v_mul(_2q2, fg1)), v_mul(_2q1, fg2));
+        vf s1 = v_sub(v_add(v_mul(_2q3, fg1), v_mul(_2q0, fg2)), v_mul(v_mul(four, q1), fg3));
+        vf s2 = v_sub(v_sub(v_mul(_2q3, fg2), v_mul(_2q0, fg1)), v_mul(v_mul(four, q2), fg3));
+        vf s3 = v_add(v_mul(_2q1, fg1), v_mul(_2q2, fg2));
+
+        /* Earth-frame field and reference direction */
+        vf hx = V_SUM3(v_mul(mx, v_sub(v_sub(v_add(q0q0, q1q1), q2q2), q3q3)),
+                       v_mul(v_mul(two, my), v_sub(q1q2, q0q3)),
+                       v_mul(v_mul(two, mz), v_add(q0q2, q1q3)));
+        vf hy = V_SUM3(v_mul(v_mul(two, mx), v_add(q0q3, q1q2)),
+                       v_mul(my, v_sub(v_add(v_sub(q0q0, q1q1), q2q2), q3q3)),
+                       v_mul(v_mul(two, mz), v_sub(q2q3, q0q1)));
+        vf _2bx = v_sqrt(v_add(v_mul(hx, hx), v_mul(hy, hy)));
+        vf _2bz = V_SUM3(v_mul(v_mul(two, mx), v_sub(q1q3, q0q2)),
+                         v_mul(v_mul(two, my), v_add(q0q1, q2q3)),
+                         v_mul(mz, v_add(v_sub(v_sub(q0q0, q1q1), q2q2), q3q3)));
+        vf _4bx = v_mul(two, _2bx);
+        vf _4bz = v_mul(two, _2bz);
+
+        /* Field residual and gradient */
+        vf fb1 = V_SUM3(v_mul(_2bx, v_sub(v_sub(half, q2q2), q3q3)),
+                        v_mul(_2bz, v_sub(q1q3, q0q2)), v_sub(zero, mx));
+        vf fb2 = V_SUM3(v_mul(_2bx, v_sub(q1q2, q0q3)),
+                        v_mul(_2bz, v_add(q0q1, q2q3)), v_sub(zero, my));
+        vf fb3 = V_SUM3(v_mul(_2bx, v_add(q0q2, q1q3)),
+                        v_mul(_2bz, v_sub(v_sub(half, q1q1), q2q2)), v_sub(zero, mz));
+
+        vf m0 = V_SUM3(v_sub(zero, v_mul(v_mul(_2bz, q2), fb1)),
+                       v_mul(v_add(v_sub(zero, v_mul(_2bx, q3)), v_mul(_2bz, q1)), fb2),
+                       v_mul(v_mul(_2bx, q2), fb3));
+        vf m1 = V_SUM3(v_mul(v_mul(_2bz, q3), fb1),
+                       v_mul(v_add(v_mul(_2bx, q2), v_mul(_2bz, q0)), fb2),
+                       v_mul(v_sub(v_mul(_2bx, q3), v_mul(_4bz, q1)), fb3));
+        vf m2 = V_SUM3(v_mul(v_sub(v_sub(zero, v_mul(_4bx, q2)), v_mul(_2bz, q0)), fb1),
+                       v_mul(v_add(v_mul(_2bx, q1), v_mul(_2bz, q3)), fb2),
+                       v_mul(v_sub(v_mul(_2bx, q0), v_mul(_4bz, q2)), fb3));
+        vf m3 = V_SUM3(v_mul(v_add(v_sub(zero, v_mul(_4bx, q3)), v_mul(_2bz, q1)), fb1),
+                       v_mul(v_add(v_sub(zero, v_mul(_2bx, q0)), v_mul(_2bz, q2)), fb2),
+                       v_mul(v_mul(_2bx, q1), fb3));
+
+        /* Mag terms only where the magnetometer is usable */
+        s0 = v_add(s0, v_sel(mag_ok, m0, zero));
+        s1 = v_add(s1, v_sel(mag_ok, m1, zero));
+        s2 = v_add(s2, v_sel(mag_ok, m2, zero));
+        s3 = v_add(s3, v_sel(mag_ok, m3, zero));
+
+        /* Normalized feedback where accel is usable and step is non-zero */
+        vf snorm = v_add(v_add(v_mul(s0, s0), v_mul(s1, s1)),
+                         v_add(v_mul(s2, s2), v_mul(s3, s3)));
+        vm fb_ok = v_and_m(acc_ok, v_gt0(snorm));
+        vf gain  = v_sel(fb_ok, v_mul(beta, V_INV_SQRT(snorm)), zero);
+
+        qd0 = v_sub(qd0, v_mul(gain, v_sel(fb_ok, s0, zero)));
+        qd1 = v_sub(qd1, v_mul(gain, v_sel(fb_ok, s1, zero)));
+        qd2 = v_sub(qd2, v_mul(gain, v_sel(fb_ok, s2, zero)));
+        qd3 = v_sub(qd3, v_mul(gain, v_sel(fb_ok, s3, zero)));
+
+        /* Integrate quaternion */
+        q0 = v_add(q0, v_mul(qd0, dt));
+        q1 = v_add(q1, v_mul(qd1, dt));
+        q2 = v_add(q2, v_mul(qd2, dt));
+        q3 = v_add(q3, v_mul(qd3, dt));
+
+        /* Normalize quaternion */
+        norm = V_INV_SQRT(v_add(v_add(v_mul(q0, q0), v_mul(q1, q1)),
+                                v_add(v_mul(q2, q2), v_mul(q3, q3))));
+
+        v_store(s->q0 + i, v_mul(q0, norm));
+        v_store(s->q1 + i, v_mul(q1, norm));
+        v_store(s->q2 + i, v_mul(q2, norm));
+        v_store(s->q3 + i, v_mul(q3, norm));
+    }
+
+#undef V_INV_SQRT
+#undef V_SUM3
+}
+
+#else
+
+void ahrs_soa_update(ahrs_soa_t *s, const imu_soa_t *in)
+{
+    ahrs_soa_update_scalar(s, in);
+}
+
+#endif
+
+const char *ahrs_simd_isa(void)
+{
+    return ISA_NAME;
+}
+
+int ahrs_simd_width(void)
+{
+    return VW;
+}
@@ -0,0 +1,74 @@
+/*
+ * ahrs_simd.h
+ *
+ * AIRMAN – Multi-Stream SIMD Madgwick Kernel
+ * ------------------------------------------
+ *
+ * Ground-side replay runs the same filter over logs from many vehicles
+ * at once. Instead of one madgwick_step() call per stream, the
+ * quaternions and samples of N streams are stored as structure-of-
+ * arrays and one vector instruction advances 4/8/16 filters:
+ *
+ *   AVX-512F   16 streams per vector
+ *   AVX2        8 streams per vector
+ *   SSE2        4 streams per vector
+ *   NEON        4 streams per vector (AArch64)
+ *   scalar      fallback, one stream at a time
+ *
+ * The instruction set is chosen at compile time from the target flags
+ * (-mavx2, -mavx512f, -march=native, ...); -DAHRS_SIMD_SCALAR forces
+ * the scalar fallback.
+ *
+ * Results match the scalar madgwick_step() within float rounding (see
+ * bench_ahrs_simd.c for the tolerance check).
+ *
+ * Layout rules:
+ *   - Arrays are allocated by ahrs_soa_alloc() / imu_soa_alloc(),
+ *     64-byte aligned and padded to a whole number of vectors.
+ *   - Padding lanes hold all-zero samples and an identity quaternion,
+ *     which the filter leaves unchanged, so they never disturb the
+ *     real streams.
+ */
+
+#ifndef AIRMAN_AHRS_SIMD_H
+#define AIRMAN_AHRS_SIMD_H
+
+#include <stddef.h>
+
+/* Filter state of N streams */
+typedef struct {
+    size_t n;              /* streams in use */
+    size_t cap;            /* allocated lanes (multiple of 16) */
+    float  beta;           /* correction gain shared by all streams */
+    float *q0, *q1, *q2, *q3;
+} ahrs_soa_t;
+
+/* One sample per stream (SoA), plus per-stream dt in seconds */
+typedef struct {
+    size_t n;
+    size_t cap;
+    float *ax, *ay, *az;   /* accelerometer (m/s²) */
+    float *gx, *gy, *gz;   /* gyroscope (deg/s) */
+    float *mx, *my, *mz;   /* magnetometer (normalized) */
+    float *dt;
+} imu_soa_t;
+
+/* Allocate n streams at the identity quaternion with gain beta. 0 / -1. */
+int  ahrs_soa_alloc(ahrs_soa_t *s, size_t n, float beta);
+void ahrs_soa_free(ahrs_soa_t *s);
+
+/* Allocate a zeroed sample block for n streams. 0 / -1. */
+int  imu_soa_alloc(imu_soa_t *in, size_t n);
+void imu_soa_free(imu_soa_t *in);
+
+/* Advance every stream by one sample with the compiled-in ISA */
+void ahrs_soa_update(ahrs_soa_t *s, const imu_soa_t *in);
+
+/* Same update through the scalar madgwick_step() (reference path) */
+void ahrs_soa_update_scalar(ahrs_soa_t *s, const imu_soa_t *in);
+
+/* Name and lane count of the compiled-in ISA, e.g. "avx2", 8 */
+const char *ahrs_simd_isa(void);
+int         ahrs_simd_width(void);
+
+#endif /* AIRMAN_AHRS_SIMD_H */
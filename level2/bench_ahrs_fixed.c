@@ -0,0 +1,163 @@
+/*
+ * bench_ahrs_fixed.c
+ *
+ * AIRMAN – Fixed-point vs float AHRS check and benchmark
+ * ------------------------------------------------------
+ *
+ * Feeds the same sample stream (the transmitter's simulated motion,
+ * MARG, 200 Hz) to the float filter (ahrs.c) and the fixed-point
+ * filter (ahrs_q.c), then reports:
+ *
+ *   - max |roll|, |pitch|, |heading| difference in degrees
+ *   - ns and cycles (x86 TSC) per update for each build, timed by the
+ *     shared harness (bench_suite.h) as batches over the same stream
+ *
+ * Build & run:
+ *   gcc -O2 bench_ahrs_fixed.c ahrs.c ahrs_q.c fixmath.c ../common/bench_suite.c -I../common -o bench_ahrs_fixed -lm
+ *   ./bench_ahrs_fixed [steps] [--quick] [--csv PATH] [--baseline PATH]
+ *
+ * On the target the same loop can be timed with SysTick; host cycle
+ * counts mainly show the relative cost of 64-bit integer math versus
+ * hardware float.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ahrs.h"
+#include "ahrs_q.h"
+#include "bench_suite.h"
+
+#define DEFAULT_STEPS   200000
+#define DT_SEC          0.005f
+#define TOLERANCE_DEG   0.5f
+
+static float frand(float lo, float hi)
+{
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+/* Shortest signed difference of two angles in degrees */
+static float angle_diff(float a, float b)
+{
+    float d = fmodf(a - b + 540.0f, 360.0f) - 180.0f;
+    return fabsf(d);
+}
+
+/* The quantized stream, shared by the timed cases */
+static imu_sample_t   *f;
+static imu_sample_q_t *x;
+static float          *dtf;
+static int32_t        *dtq;
+static int             steps;
+
+/* n updates as batches over the stream */
+static void run_float(void *ctx, long n)
+{
+    ahrs_state_t *fs = ctx;
+    ahrs_init(fs, AHRS_DEFAULT_BETA);
+    for (long i = 0; i < n; i += steps)
+        madgwick_update_batch(fs, f, dtf, n - i < steps ? (int)(n - i) : steps);
+}
+
+static void run_fixed(void *ctx, long n)
+{
+    ahrs_q_state_t *qs = ctx;
+    ahrs_q_init(qs, AHRS_Q_DEFAULT_BETA);
+    for (long i = 0; i < n; i += steps)
+        madgwick_q_update_batch(qs, x, dtq, n - i < steps ? (int)(n - i) : steps);
+}
+
+int main(int argc, char **argv)
+{
+    bench_suite_t suite;
+    if (bench_suite_init(&suite, "ahrs_fixed", argc, argv) != 0)
+        return 2;
+
+    steps = (int)bench_arg(&suite, 0, DEFAULT_STEPS);
+
+    f   = imu_sample_alloc((size_t)steps);
+    x   = imu_sample_alloc((size_t)steps);
+    dtf = malloc(steps * sizeof(*dtf));
+    dtq = malloc(steps * sizeof(*dtq));
+    if (!f || !x || !dtf || !dtq) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    /* Same motion as ahrs_filter.c imu_read(), quantized to Q16 */
+    srand(1);
+    for (int i = 0; i < steps; i++) {
+        float tick = i * 0.1f;
+        float v[9];
+        v[0] = 0.6f * sinf(tick * 0.02f) + frand(-0.05f, 0.05f);
+        v[1] = 0.6f * cosf(tick * 0.02f) + frand(-0.05f, 0.05f);
+        v[2] = 9.81f + frand(-0.08f, 0.08f);
+        v[3] = 2.0f  + frand(-0.2f, 0.2f);
+        v[4] = 1.5f  + frand(-0.2f, 0.2f);
+        v[5] = 12.0f + frand(-0.3f, 0.3f);
+        v[6] = 0.3f + frand(-0.02f, 0.02f);
+        v[7] = 0.0f + frand(-0.02f, 0.02f);
+        v[8] = 0.5f + frand(-0.02f, 0.02f);
+
+        /* Quantize to Q16; the float filter gets identical inputs */
+        int32_t q[9];
+        for (int k = 0; k < 9; k++) {
+            q[k] = (int32_t)lrintf(v[k] * 65536.0f);
+            v[k] = q[k] / 65536.0f;
+        }
+        f[i].accel = vec3(v[0], v[1], v[2]);
+        f[i].gyro  = vec3(v[3], v[4], v[5]);
+        f[i].mag   = vec3(v[6], v[7], v[8]);
+        f[i].valid = IMU_VALID_ALL;
+        x[i].accel = vec3_q(q[0], q[1], q[2]);
+        x[i].gyro  = vec3_q(q[3], q[4], q[5]);
+        x[i].mag   = vec3_q(q[6], q[7], q[8]);
+        x[i].valid = IMU_VALID_ALL;
+
+        dtf[i] = DT_SEC;
+        dtq[i] = FX_Q30(DT_SEC);
+    }
+
+    /* Accuracy: step both filters and compare Euler output */
+    static ahrs_state_t   fs;
+    static ahrs_q_state_t qs;
+    ahrs_init(&fs, AHRS_DEFAULT_BETA);
+    ahrs_q_init(&qs, AHRS_Q_DEFAULT_BETA);
+
+    float max_err[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < steps; i++) {
+        madgwick_update_batch(&fs, &f[i], &dtf[i], 1);
+        madgwick_q_update_batch(&qs, &x[i], &dtq[i], 1);
+
+        float   e[3];
+        int32_t c[3];
+        ahrs_get_euler(&fs, &e[0], &e[1], &e[2]);
+        ahrs_q_get_euler(&qs, &c[0], &c[1], &c[2]);
+        for (int k = 0; k < 3; k++) {
+            float d = angle_diff(e[k], c[k] / 100.0f);
+            if (d > max_err[k])
+                max_err[k] = d;
+        }
+    }
+
+    printf("steps=%d dt=%.3f s\n", steps, DT_SEC);
+    bench_run(&suite, "float", "update", run_float, &fs);
+    bench_run(&suite, "fixed", "update", run_fixed, &qs);
+
+    float worst = max_err[0];
+    for (int k = 1; k < 3; k++)
+        if (max_err[k] > worst)
+            worst = max_err[k];
+
+    printf("max |d| roll=%.4f pitch=%.4f heading=%.4f deg (tolerance %.2f) %s\n",
+           max_err[0], max_err[1], max_err[2], TOLERANCE_DEG,
+           worst <= TOLERANCE_DEG ? "PASS" : "FAIL");
+
+    int status = bench_suite_finish(&suite);
+    free(f);
+    free(x);
+    free(dtf);
+    free(dtq);
+    return worst <= TOLERANCE_DEG ? status : 1;
+}
@@ -0,0 +1,140 @@
+/*
+ * bench_ahrs_simd.c
+ *
+ * AIRMAN – SIMD Madgwick kernel benchmark & tolerance check
+ * ---------------------------------------------------------
+ *
+ * Runs NUM_STREAMS independent filters for NUM_STEPS samples through
+ * both the scalar reference (madgwick_step per stream) and the SoA
+ * vector kernel, then:
+ *   1. checks every quaternion component agrees within TOLERANCE
+ *   2. times one step of all streams per path with the shared harness
+ *      (bench_suite.h) and reports stream-updates per second and the
+ *      speedup
+ *
+ * Build & run (pick the ISA with -m flags or -march=native):
+ *   gcc -O2 -mavx2 bench_ahrs_simd.c ahrs_simd.c ../common/bench_suite.c -I../common -o bench_ahrs_simd -lm
+ *   ./bench_ahrs_simd [streams] [steps] [--quick] [--csv PATH] [--baseline PATH]
+ *
+ * Exit status is non-zero if the tolerance check fails.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "ahrs_simd.h"
+#include "bench_suite.h"
+#include "madgwick.h"
+
+#define NUM_STREAMS   64
+#define NUM_STEPS     20000
+#define INPUT_SETS    64        /* distinct sample sets, cycled */
+#define TOLERANCE     1e-4f
+#define BETA          0.1f
+
+static float frand(float lo, float hi)
+{
+    return lo + (hi - lo) * ((float)rand() / RAND_MAX);
+}
+
+/* Plausible per-vehicle samples around the simulator's operating point */
+static void fill_inputs(imu_soa_t *in)
+{
+    for (size_t i = 0; i < in->n; i++) {
+        in->ax[i] = frand(-0.7f, 0.7f);
+        in->ay[i] = frand(-0.7f, 0.7f);
+        in->az[i] = frand(9.7f, 9.9f);
+        in->gx[i] = frand(-30.0f, 30.0f);
+        in->gy[i] = frand(-30.0f, 30.0f);
+        in->gz[i] = frand(-90.0f, 90.0f);
+        in->mx[i] = frand(0.28f, 0.32f);
+        in->my[i] = frand(-0.02f, 0.02f);
+        in->mz[i] = frand(0.48f, 0.52f);
+        in->dt[i] = 0.005f;
+    }
+}
+
+typedef void (*update_fn)(ahrs_soa_t *, const imu_soa_t *);
+
+static imu_soa_t sets[INPUT_SETS];
+
+static void run(update_fn fn, ahrs_soa_t *s, long steps)
+{
+    for (long k = 0; k < steps; k++)
+        fn(s, &sets[k % INPUT_SETS]);
+}
+
+static ahrs_soa_t ref, vec;
+
+static void run_scalar(void *ctx, long n)
+{
+    (void)ctx;
+    run(ahrs_soa_update_scalar, &ref, n);
+}
+
+static void run_simd(void *ctx, long n)
+{
+    (void)ctx;
+    run(ahrs_soa_update, &vec, n);
+}
+
+int main(int argc, char **argv)
+{
+    bench_suite_t suite;
+    if (bench_suite_init(&suite, "ahrs_simd", argc, argv) != 0)
+        return 2;
+
+    size_t streams = (size_t)bench_arg(&suite, 0, NUM_STREAMS);
+    int    steps   = (int)bench_arg(&suite, 1, NUM_STEPS);
+
+    srand(1);
+    for (int k = 0; k < INPUT_SETS; k++) {
+        if (imu_soa_alloc(&sets[k], streams) != 0)
+            return 1;
+        fill_inputs(&sets[k]);
+    }
+    if (ahrs_soa_alloc(&ref, streams, BETA) != 0 ||
+        ahrs_soa_alloc(&vec, streams, BETA) != 0)
+        return 1;
+
+    run(ahrs_soa_update_scalar, &ref, steps);
+    run(ahrs_soa_update, &vec, steps);
+
+    /* Tolerance check against the scalar path */
+    float max_err = 0.0f;
+    for (size_t i = 0; i < streams; i++) {
+        float e0 = fabsf(ref.q0[i] - vec.q0[i]);
+        float e1 = fabsf(ref.q1[i] - vec.q1[i]);
+        float e2 = fabsf(ref.q2[i] - vec.q2[i]);
+        float e3 = fabsf(ref.q3[i] - vec.q3[i]);
+        float e  = fmaxf(fmaxf(e0, e1), fmaxf(e2, e3));
+        if (e > max_err)
+            max_err = e;
+    }
+
+    printf("isa=%s width=%d streams=%zu steps=%d\n",
+           ahrs_simd_isa(), ahrs_simd_width(), streams, steps);
+    printf("max |dq| = %.3g (tolerance %.1g) %s\n",
+           max_err, TOLERANCE, max_err <= TOLERANCE ? "PASS" : "FAIL");
+
+    /* Timed on the checked states; one op is one step of all streams */
+    const bench_case_t *c_ref = bench_run(&suite, "scalar", "step", run_scalar, NULL);
+    const bench_case_t *c_vec = bench_run(&suite, "simd", "step", run_simd, NULL);
+    if (c_ref)
+        printf("scalar : %8.2f M updates/s\n", streams / c_ref->ns_per_op * 1e3);
+    if (c_vec)
+        printf("simd   : %8.2f M updates/s", streams / c_vec->ns_per_op * 1e3);
+    if (c_ref && c_vec)
+        printf("  (%.1fx)", c_ref->ns_per_op / c_vec->ns_per_op);
+    if (c_vec)
+        printf("\n");
+
+    for (int k = 0; k < INPUT_SETS; k++)
+        imu_soa_free(&sets[k]);
+    ahrs_soa_free(&ref);
+    ahrs_soa_free(&vec);
+
+    int status = bench_suite_finish(&suite);
+    return max_err <= TOLERANCE ? status : 1;
+}
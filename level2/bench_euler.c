@@ -0,0 +1,140 @@
+/*
+ * bench_euler.c
+ *
+ * AIRMAN – Euler extraction check and benchmark
+ * ---------------------------------------------
+ *
+ * Compares ahrs_get_euler_approx() (polynomial atan2 / asin) with the
+ * libm path of ahrs_get_euler() over random orientations, including
+ * pitch within a hair of +-90 deg, and reports:
+ *
+ *   - max |roll|, |pitch|, |heading| difference in degrees
+ *   - ns and cycles (x86 TSC) per conversion for each path, timed by
+ *     the shared harness (bench_suite.h)
+ *
+ * Build & run:
+ *   gcc -O2 bench_euler.c ahrs.c ../common/bench_suite.c -I../common -o bench_euler -lm
+ *   ./bench_euler [orientations] [--quick] [--csv PATH] [--baseline PATH]
+ *
+ * (without -DAHRS_FAST_TRIG, so ahrs_get_euler() is the libm reference)
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ahrs.h"
+#include "bench_suite.h"
+
+#define DEFAULT_COUNT   (1 << 20)
+#define TOLERANCE_DEG   0.001f
+
+typedef void (*euler_fn)(const ahrs_state_t *, float *, float *, float *);
+
+static float frand(float lo, float hi)
+{
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+/* Shortest difference of two angles in degrees */
+static float angle_diff(float a, float b)
+{
+    float d = fmodf(a - b + 540.0f, 360.0f) - 180.0f;
+    return fabsf(d);
+}
+
+/* Uniformly random unit quaternions; every 16th one near gimbal lock */
+static void fill_states(ahrs_state_t *s, int n)
+{
+    for (int i = 0; i < n; i++) {
+        quat_t q;
+        if (i % 16 == 0) {
+            /* pitch = +-(90 - up to 0.01) deg, any heading */
+            float p = (float)(M_PI / 2) - frand(0.0f, 1.7e-4f);
+            float y = frand(-(float)M_PI, (float)M_PI);
+            if (i % 32 == 0)
+                p = -p;
+            q.q0 = cosf(p / 2) * cosf(y / 2);
+            q.q1 = -sinf(p / 2) * sinf(y / 2);
+            q.q2 = sinf(p / 2) * cosf(y / 2);
+            q.q3 = cosf(p / 2) * sinf(y / 2);
+        } else {
+            q.q0 = frand(-1, 1); q.q1 = frand(-1, 1);
+            q.q2 = frand(-1, 1); q.q3 = frand(-1, 1);
+            float norm = sqrtf(q.q0*q.q0 + q.q1*q.q1 + q.q2*q.q2 + q.q3*q.q3);
+            q.q0 /= norm; q.q1 /= norm; q.q2 /= norm; q.q3 /= norm;
+        }
+        ahrs_init(&s[i], AHRS_DEFAULT_BETA);
+        s[i].q = q;
+    }
+}
+
+static volatile float sink;
+
+static const ahrs_state_t *states;
+static int                 n_states;
+
+/* n conversions, cycling through the orientations */
+static void run_euler(void *ctx, long n)
+{
+    euler_fn fn = *(const euler_fn *)ctx;
+    float acc = 0.0f;
+    int i = 0;
+    for (long k = 0; k < n; k++) {
+        float r, p, y;
+        fn(&states[i], &r, &p, &y);
+        acc += r + p + y;
+        if (++i == n_states)
+            i = 0;
+    }
+    sink = acc;
+}
+
+int main(int argc, char **argv)
+{
+    bench_suite_t suite;
+    if (bench_suite_init(&suite, "euler", argc, argv) != 0)
+        return 2;
+
+    int n = (int)bench_arg(&suite, 0, DEFAULT_COUNT);
+
+    ahrs_state_t *s = malloc((size_t)n * sizeof(*s));
+    if (!s) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    srand(1);
+    fill_states(s, n);
+
+    float max_err[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < n; i++) {
+        float e[3], a[3];
+        ahrs_get_euler(&s[i], &e[0], &e[1], &e[2]);
+        ahrs_get_euler_approx(&s[i], &a[0], &a[1], &a[2]);
+        for (int k = 0; k < 3; k++) {
+            float d = angle_diff(e[k], a[k]);
+            if (d > max_err[k])
+                max_err[k] = d;
+        }
+    }
+
+    printf("orientations=%d\n", n);
+    euler_fn libm = ahrs_get_euler, approx = ahrs_get_euler_approx;
+    states   = s;
+    n_states = n;
+    bench_run(&suite, "libm", "conversion", run_euler, &libm);
+    bench_run(&suite, "approx", "conversion", run_euler, &approx);
+
+    float worst = max_err[0];
+    for (int k = 1; k < 3; k++)
+        if (max_err[k] > worst)
+            worst = max_err[k];
+
+    printf("max |d| roll=%.5f pitch=%.5f heading=%.5f deg (tolerance %.3f) %s\n",
+           max_err[0], max_err[1], max_err[2], TOLERANCE_DEG,
+           worst <= TOLERANCE_DEG ? "PASS" : "FAIL");
+
+    int status = bench_suite_finish(&suite);
+    free(s);
+    return worst <= TOLERANCE_DEG ? status : 1;
+}
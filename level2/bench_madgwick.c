@@ -0,0 +1,165 @@
+/*
+ * bench_madgwick.c
+ *
+ * AIRMAN – Madgwick step micro-benchmark
+ * --------------------------------------
+ *
+ * Times one scalar filter update in each of its modes against the
+ * original gyro-integration-only step the filter used to run:
+ *
+ *   baseline   old gyro-only step (copied below, for reference)
+ *   gyro-only  madgwick_step() with a zero accelerometer vector
+ *   IMU-only   madgwick_step() with a zero magnetometer vector
+ *   MARG       madgwick_step() with all three sensors
+ *
+ * Build & run:
+ *   gcc -O2 bench_madgwick.c ../common/bench_suite.c -I../common -o bench_madgwick -lm
+ *   gcc -O2 -DMADGWICK_FAST_INV_SQRT bench_madgwick.c ../common/bench_suite.c -I../common -o bench_madgwick -lm
+ *   ./bench_madgwick [--quick] [--csv PATH] [--baseline PATH]
+ *
+ * Cost per update is timed by the shared harness (bench_suite.h: ns,
+ * and cycles on x86), plus flop/cycle from a static operation count of
+ * each path (add, mul, div and sqrt each counted as one flop).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_suite.h"
+#include "madgwick.h"
+
+#define NUM_SAMPLES   4096
+#define DT            0.005f
+#define BETA          0.1f
+
+/* Static flop counts per update, counted from the source of each path */
+#define FLOPS_BASELINE   48
+#define FLOPS_GYRO       48
+#define FLOPS_IMU       118
+#define FLOPS_MARG      235
+
+/* The step the filter shipped with: gyro integration, no correction */
+static inline void baseline_step(quat_t *q, const imu_sample_t *imu, float dt)
+{
+    float gx = deg2rad(imu->gyro.x);
+    float gy = deg2rad(imu->gyro.y);
+    float gz = deg2rad(imu->gyro.z);
+
+    float q0 = q->q0, q1 = q->q1, q2 = q->q2, q3 = q->q3;
+
+    float qDot0 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    float qDot1 = 0.5f * ( q0 * gx + q2 * gz - q3 * gy);
+    float qDot2 = 0.5f * ( q0 * gy - q1 * gz + q3 * gx);
+    float qDot3 = 0.5f * ( q0 * gz + q1 * gy - q2 * gx);
+
+    q0 += qDot0 * dt;
+    q1 += qDot1 * dt;
+    q2 += qDot2 * dt;
+    q3 += qDot3 * dt;
+
+    float norm = 1.0f / sqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q->q0 = q0 * norm;
+    q->q1 = q1 * norm;
+    q->q2 = q2 * norm;
+    q->q3 = q3 * norm;
+}
+
+static float frand(float lo, float hi)
+{
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+/* Sink so the compiler cannot drop the timed loop */
+static volatile float q_sink;
+
+enum { MODE_BASELINE, MODE_STEP };
+
+typedef struct {
+    const char         *name;
+    int                 mode;
+    const imu_sample_t *samples;
+    int                 flops;
+} step_case_t;
+
+/* n updates, cycling through the sample set */
+static void run_step(void *ctx, long n)
+{
+    const step_case_t *c = ctx;
+    quat_t q = { 1.0f, 0.0f, 0.0f, 0.0f };
+    int i = 0;
+
+    for (long k = 0; k < n; k++) {
+        if (c->mode == MODE_BASELINE)
+            baseline_step(&q, &c->samples[i], DT);
+        else
+            madgwick_step(&q, &c->samples[i], DT, BETA);
+        if (++i == NUM_SAMPLES)
+            i = 0;
+    }
+    q_sink = q.q0;
+}
+
+int main(int argc, char **argv)
+{
+    static _Alignas(IMU_SAMPLE_ALIGN) imu_sample_t marg[NUM_SAMPLES];
+    static _Alignas(IMU_SAMPLE_ALIGN) imu_sample_t imu[NUM_SAMPLES];
+    static _Alignas(IMU_SAMPLE_ALIGN) imu_sample_t gyro[NUM_SAMPLES];
+
+    srand(1);
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        marg[i].accel.x = frand(-0.7f, 0.7f);
+        marg[i].accel.y = frand(-0.7f, 0.7f);
+        marg[i].accel.z = frand(9.0f, 9.8f);
+        marg[i].gyro.x  = frand(-5.0f, 5.0f);
+        marg[i].gyro.y  = frand(-5.0f, 5.0f);
+        marg[i].gyro.z  = frand(-5.0f, 5.0f);
+        marg[i].mag.x   = frand(0.28f, 0.32f);
+        marg[i].mag.y   = frand(-0.02f, 0.02f);
+        marg[i].mag.z   = frand(0.48f, 0.52f);
+        marg[i].valid   = IMU_VALID_ALL;
+
+        imu[i] = marg[i];
+        imu[i].mag = vec3(0.0f, 0.0f, 0.0f);
+
+        gyro[i] = imu[i];
+        gyro[i].accel = vec3(0.0f, 0.0f, 0.0f);
+    }
+
+    bench_suite_t suite;
+    if (bench_suite_init(&suite, "madgwick", argc, argv) != 0)
+        return 2;
+
+#ifdef MADGWICK_FAST_INV_SQRT
+    printf("inv_sqrt=fast  samples=%d\n", NUM_SAMPLES);
+#else
+    printf("inv_sqrt=exact samples=%d\n", NUM_SAMPLES);
+#endif
+
+    const step_case_t cases[] = {
+        { "baseline",  MODE_BASELINE, gyro, FLOPS_BASELINE },
+        { "gyro-only", MODE_STEP,     gyro, FLOPS_GYRO     },
+        { "IMU-only",  MODE_STEP,     imu,  FLOPS_IMU      },
+        { "MARG",      MODE_STEP,     marg, FLOPS_MARG     },
+    };
+    enum { NUM_CASES = sizeof(cases) / sizeof(cases[0]) };
+
+    const bench_case_t *res[NUM_CASES];
+    for (int i = 0; i < NUM_CASES; i++)
+        res[i] = bench_run(&suite, cases[i].name, "update", run_step,
+                           (void *)&cases[i]);
+
+    printf("\n");
+    for (int i = 0; i < NUM_CASES; i++) {
+        const bench_case_t *c = res[i];
+        if (!c)
+            continue;
+        if (c->cycles_per_op > 0.0)
+            printf("%-10s: %4d flop  %5.2f flop/cycle\n", c->name,
+                   cases[i].flops, cases[i].flops / c->cycles_per_op);
+        else
+            printf("%-10s: %4d flop  %5.2f flop/ns\n", c->name,
+                   cases[i].flops, cases[i].flops / c->ns_per_op);
+    }
+
+    return bench_suite_finish(&suite);
+}
@@ -0,0 +1,369 @@
+/*
+ * bench_pipeline.c
+ *
+ * AIRMAN – Level 2 sensor → AHRS → frame benchmark
+ * ------------------------------------------------
+ *
+ * Times every stage of the transmitter's control loop in ns/op with a
+ * fixed noise seed, plus the whole loop in frames/s, through the shared
+ * harness (common/bench_suite.h):
+ *
+ *   noise, noise_gauss        one noise draw (uniform / Gaussian)
+ *   imu_read                  one simulated MARG sample
+ *   imu_calibrate             per sample, 16-sample bursts through the
+ *                             calibration pass (imu_cal.h)
+ *   madgwick_update           one filter update (MARG)
+ *   madgwick_update_batch     per sample, 16-sample FIFO bursts
+ *   ahrs_get_euler            quaternion → roll / pitch / heading
+ *   crc16_ccitt               CRC16 over one $L2 frame body
+ *   encode_ascii / _binary /  one L2 frame from ready values
+ *   encode_delta              (--delta: keyframes and varint deltas)
+ *   encode_batch              per sample, BATCH_MAX_SAMPLES-sample batch
+ *                             frames (--binary --batch)
+ *   encode_stats              one $L2S frame (two quantile lookups)
+ *   loop_prof_lap             stage-timer overhead per lap
+ *   pipeline_ascii / _binary  TELEMETRY_DECIMATION samples, updates and
+ *                             one encoded frame, per frame (no link I/O)
+ *   pipeline_quat             the same with $L2Q frames (--quat, no trig)
+ *   pipeline_delta            the same with delta frames (--delta)
+ *
+ * ahrs_filter.c is compiled into this file without its main(), so the
+ * timed functions are the transmitter's as configured here. The same
+ * build flags select the same variant: with -DAHRS_FIXED_POINT the
+ * cases run the integer sensor model and filter (suite "l2q").
+ *
+ * Build & run:
+ *   gcc -O2 bench_pipeline.c ahrs.c imu_cal.c ../common/bench_suite.c ../common/prng.c ../common/sim_noise.c ../common/flightlog.c ../common/binframe.c ../common/deltaframe.c ../common/cobs.c ../common/crc16.c ../common/loop_sched.c ../common/loop_prof.c ../common/spsc_ring.c ../common/numfmt.c ../common/txtframe.c ../common/link_io.c ../common/serial_port.c -I../common -pthread -o bench_pipeline -lm
+ *   ./bench_pipeline [--csv PATH] [--baseline PATH] [--tolerance PCT]
+ *
+ * Fixed point: add -DAHRS_FIXED_POINT and build ahrs_q.c fixmath.c in
+ * place of ahrs.c.
+ */
+
+/* main()'s helpers are left unused here */
+#if defined(__GNUC__)
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+#define AIRMAN_NO_MAIN
+#include "ahrs_filter.c"
+
+#include "bench_suite.h"
+#include "crc16.h"
+
+#define BENCH_SEED     1
+#define IMU_SAMPLES    4096          /* power of two */
+#define BENCH_BURST    16
+
+#ifdef AHRS_FIXED_POINT
+#define BENCH_SUITE    "l2q"
+#define NOISE_AMP      FX_Q16(0.05)
+#define ALTITUDE       11234
+#define TEMPERATURE    3102
+#else
+#define BENCH_SUITE    "l2"
+#define NOISE_AMP      0.05f
+#define ALTITUDE       112.34f
+#define TEMPERATURE    31.02f
+#endif
+
+static prng_t    rng[NOISE_STREAMS];
+static _Alignas(IMU_SAMPLE_ALIGN) imu_raw_t samples[IMU_SAMPLES];
+static dt_t      nominal_dt[BENCH_BURST];
+static filter_t  filter;
+static char      sample_frame[128];
+
+static volatile value_t  sink_v;
+static volatile unsigned sink_u;
+
+/* ============================================================
+ * CHECKS
+ * ============================================================
+ */
+
+/*
+ * Delta frames across a loss of `lost` frames after the first keyframe:
+ * every frame the decoder accepts must carry exactly the encoded values,
+ * and it must be back in sync by the end. 128 lost frames used to wrap
+ * the 7-bit counter into step.
+ */
+static int check_delta_loss(int lost)
+{
+    const int n_frames = 1 + lost + 2 * DELTAFRAME_KEY_INTERVAL;
+    deltaframe_t tx, rx;
+    int synced = 0;
+
+    deltaframe_init(&tx);
+    deltaframe_init(&rx);
+    for (int k = 0; k < n_frames; k++) {
+        uint8_t wire[BINFRAME_MAX_WIRE], raw[BINFRAME_MAX_WIRE];
+        int32_t v[4];
+        for (int i = 0; i < 4; i++)
+            v[i] = k * (37 + i) - i * 1000;
+
+        size_t len = deltaframe_encode(&tx, wire, BINFRAME_TYPE_L2,
+                                       (uint32_t)k * 50, v, 4);
+        if (k >= 1 && k <= lost)
+            continue;
+
+        size_t n = binframe_decode(wire, len - 1, raw);
+        int    r = deltaframe_decode(&rx, raw, n);
+        if (r == DELTAFRAME_OK &&
+            (rx.ts_ms != (uint32_t)k * 50 || rx.n_values != 4 ||
+             memcmp(rx.v, v, sizeof(v)) != 0)) {
+            printf("MISMATCH: delta frame %d after %d lost\n", k, lost);
+            return 1;
+        }
+        synced = r == DELTAFRAME_OK;
+    }
+    if (!synced) {
+        printf("MISMATCH: no delta resync after %d lost\n", lost);
+        return 1;
+    }
+    return 0;
+}
+
+/* ============================================================
+ * CASES
+ * ============================================================
+ */
+
+static void run_noise(void *ctx, long n)
+{
+    (void)ctx;
+    value_t acc = 0;
+    for (long i = 0; i < n; i++)
+        acc += noise(&rng[NOISE_ACCEL], NOISE_AMP);
+    sink_v = acc;
+}
+
+static void run_noise_gauss(void *ctx, long n)
+{
+    if (sim_noise_set_gaussian(1) == 0)
+        run_noise(ctx, n);
+    sim_noise_set_gaussian(0);
+}
+
+static void run_imu_read(void *ctx, long n)
+{
+    (void)ctx;
+    imu_raw_t imu;
+    value_t acc = 0;
+    for (long i = 0; i < n; i++) {
+        imu_read(&imu, (int)(i & 0xFFFFFF), rng);
+        acc += imu.accel.x;
+    }
+    sink_v = acc;
+}
+
+static void run_calibrate(void *ctx, long n)
+{
+    (void)ctx;
+    _Alignas(IMU_SAMPLE_ALIGN) imu_raw_t out[BENCH_BURST];
+    value_t acc = 0;
+    for (long i = 0; i < n; i += BENCH_BURST) {
+        calibrate(&samples[i & (IMU_SAMPLES - 1)], out, BENCH_BURST);
+        acc += out[0].gyro.z;
+    }
+    sink_v = acc;
+}
+
+static void run_update(void *ctx, long n)
+{
+    (void)ctx;
+    for (long i = 0; i < n; i++)
+        filter_update(&filter, &samples[i & (IMU_SAMPLES - 1)], nominal_dt, 1);
+}
+
+static void run_update_batch(void *ctx, long n)
+{
+    (void)ctx;
+    for (long i = 0; i < n; i += BENCH_BURST)
+        filter_update(&filter, &samples[i & (IMU_SAMPLES - 1)], nominal_dt,
+                      BENCH_BURST);
+}
+
+static void run_euler(void *ctx, long n)
+{
+    (void)ctx;
+    value_t roll, pitch, yaw, acc = 0;
+    for (long i = 0; i < n; i++) {
+        filter_euler(&filter, &roll, &pitch, &yaw);
+        acc += yaw;
+    }
+    sink_v = acc;
+}
+
+/* CRC16 over the bytes between '$' and '*' of a real frame */
+static void run_crc16(void *ctx, long n)
+{
+    (void)ctx;
+    /* Reloaded every pass, so the loop is not folded into one call */
+    const char *volatile body = sample_frame + 1;
+    size_t len = (size_t)(strchr(sample_frame, '*') - (sample_frame + 1));
+    unsigned acc = 0;
+    for (long i = 0; i < n; i++)
+        acc += crc16_ccitt(body, len);
+    sink_u = acc;
+}
+
+static void run_encode(int format, long n)
+{
+    uint8_t frame[BINFRAME_MAX_WIRE > 128 ? BINFRAME_MAX_WIRE : 128];
+    size_t total = 0;
+    for (long i = 0; i < n; i++) {
+        const imu_raw_t *s = &samples[i & (IMU_SAMPLES - 1)];
+        const value_t att[ATT_EULER] = { s->gyro.x, s->gyro.y, s->gyro.z };
+        total += encode_frame(format, frame, sizeof(frame),
+                              i & 0xFFFFFF, att, ATT_EULER,
+                              ALTITUDE, TEMPERATURE);
+    }
+    sink_u = (unsigned)total;
+}
+
+static void run_encode_ascii(void *ctx, long n)  { (void)ctx; run_encode(FRAME_ASCII, n); }
+static void run_encode_binary(void *ctx, long n) { (void)ctx; run_encode(FRAME_BINARY, n); }
+static void run_encode_delta(void *ctx, long n)  { (void)ctx; run_encode(FRAME_DELTA, n); }
+
+static void run_encode_batch(void *ctx, long n)
+{
+    (void)ctx;
+    uint8_t frame[BINFRAME_MAX_WIRE > 128 ? BINFRAME_MAX_WIRE : 128];
+    frame_batch_t b;
+    size_t total = 0;
+    for (long i = 0; i < n; i += BATCH_MAX_SAMPLES) {
+        b.n = 0;
+        for (int k = 0; k < BATCH_MAX_SAMPLES; k++) {
+            const imu_raw_t *s = &samples[(i + k) & (IMU_SAMPLES - 1)];
+            const value_t att[ATT_EULER] = { s->gyro.x, s->gyro.y, s->gyro.z };
+            batch_push(&b, (i + k) & 0xFFFFFF, att, ATT_EULER,
+                       ALTITUDE, TEMPERATURE);
+        }
+        total += encode_batch_frame(frame, &b, ATT_EULER);
+    }
+    sink_u = (unsigned)total;
+}
+
+static void run_encode_stats(void *ctx, long n)
+{
+    const latency_hist_t *h = ctx;
+    uint8_t frame[BINFRAME_MAX_WIRE > 128 ? BINFRAME_MAX_WIRE : 128];
+    size_t total = 0;
+    for (long i = 0; i < n; i++)
+        total += encode_stats_frame(0, frame, sizeof(frame), i & 0xFFFFFF,
+                                    STAGE_AHRS, h);
+    sink_u = (unsigned)total;
+}
+
+static void run_prof_lap(void *ctx, long n)
+{
+    loop_prof_t *p = ctx;
+    loop_prof_begin(p);
+    for (long i = 0; i < n; i++)
+        loop_prof_lap(p, STAGE_AHRS);
+    loop_prof_reset(p);
+}
+
+/* The control loop's work per frame, minus scheduling and link_write() */
+static void run_pipeline(int format, int quat_mode, long n)
+{
+    uint8_t frame[BINFRAME_MAX_WIRE > 128 ? BINFRAME_MAX_WIRE : 128];
+    imu_raw_t imu[TELEMETRY_DECIMATION];
+    dt_t dt[TELEMETRY_DECIMATION];
+    size_t total = 0;
+
+    for (int i = 0; i < TELEMETRY_DECIMATION; i++)
+        dt[i] = nominal_dt[0];
+
+    for (long k = 0; k < n; k++) {
+        int t = (int)((k * TELEMETRY_DECIMATION) & 0xFFFFFF);
+        int got = imu_read_batch(imu, t, TELEMETRY_DECIMATION, rng);
+        filter_update(&filter, imu, dt, got);
+
+        value_t att[ATT_QUAT];
+        int n_att = filter_attitude(&filter, quat_mode, att);
+        total += encode_frame(format, frame, sizeof(frame),
+                              t * 1000LL / LOOP_HZ, att, n_att,
+                              ALTITUDE, TEMPERATURE);
+    }
+    sink_u = (unsigned)total;
+}
+
+static void run_pipeline_ascii(void *ctx, long n)  { (void)ctx; run_pipeline(FRAME_ASCII, 0, n); }
+static void run_pipeline_binary(void *ctx, long n) { (void)ctx; run_pipeline(FRAME_BINARY, 0, n); }
+static void run_pipeline_quat(void *ctx, long n)   { (void)ctx; run_pipeline(FRAME_ASCII, 1, n); }
+static void run_pipeline_delta(void *ctx, long n)  { (void)ctx; run_pipeline(FRAME_DELTA, 0, n); }
+
+int main(int argc, char **argv)
+{
+    const int losses[] = { 1, 127, 128, 129, 256 };
+    for (size_t i = 0; i < sizeof(losses) / sizeof(losses[0]); i++)
+        if (check_delta_loss(losses[i]) != 0)
+            return 1;
+
+    bench_suite_t s;
+    if (bench_suite_init(&s, BENCH_SUITE, argc, argv) != 0)
+        return 2;
+
+    sim_noise_seed(rng, NOISE_STREAMS, BENCH_SEED);
+    for (int i = 0; i < IMU_SAMPLES; i++)
+        imu_read(&samples[i], i, rng);
+    for (int i = 0; i < BENCH_BURST; i++)
+        nominal_dt[i] = sample_dt(0, 1, 1);
+    filter_init(&filter);
+    filter_update(&filter, samples, nominal_dt, 1);
+
+    /* The simulated gyro offset, as --cal-gyro would estimate it */
+    imu_cal_init(&cal);
+    cal.sensor[IMU_CAL_GYRO].offset[0] = 2.0f;
+    cal.sensor[IMU_CAL_GYRO].offset[1] = 1.5f;
+    cal.sensor[IMU_CAL_GYRO].offset[2] = 12.0f;
+    imu_cal_update(&cal);
+    calibration_changed();
+
+    /* An ASCII frame for crc16_ccitt, also in builds without that format */
+    {
+        value_t att[ATT_QUAT];
+        int n_att = filter_attitude(&filter, 0, att);
+        txtframe_t f;
+        txtframe_begin(&f, sample_frame, sizeof(sample_frame), L2_CHECKSUM, "L2");
+        txtframe_put_i64(&f, 123456);
+        for (int i = 0; i < n_att; i++)
+            PUT_VALUE(&f, att[i]);
+        PUT_VALUE(&f, ALTITUDE);
+        PUT_VALUE(&f, TEMPERATURE);
+        txtframe_finish(&f);
+    }
+
+    /* A realistic $L2S window: a few thousand ~2 µs samples */
+    static loop_prof_t prof;
+    loop_prof_init(&prof, N_STAGES, 1000000000u / WAKE_HZ);
+    for (int i = 0; i < 5000; i++)
+        latency_hist_record(&prof.stage[STAGE_AHRS],
+                            1500 + (uint32_t)(prng_next_u32(&rng[0]) % 1500),
+                            prof.budget_ns);
+    static latency_hist_t window;
+    window = prof.stage[STAGE_AHRS];
+
+    bench_run(&s, "noise",                 "op",     run_noise,           NULL);
+    bench_run(&s, "noise_gauss",           "op",     run_noise_gauss,     NULL);
+    bench_run(&s, "imu_read",              "sample", run_imu_read,        NULL);
+    bench_run(&s, "imu_calibrate",         "sample", run_calibrate,       NULL);
+    bench_run(&s, "madgwick_update",       "sample", run_update,          NULL);
+    bench_run(&s, "madgwick_update_batch", "sample", run_update_batch,    NULL);
+    bench_run(&s, "ahrs_get_euler",        "op",     run_euler,           NULL);
+    bench_run(&s, "crc16_ccitt",           "frame",  run_crc16,           NULL);
+    bench_run(&s, "encode_ascii",          "frame",  run_encode_ascii,    NULL);
+    bench_run(&s, "encode_binary",         "frame",  run_encode_binary,   NULL);
+    bench_run(&s, "encode_delta",          "frame",  run_encode_delta,    NULL);
+    bench_run(&s, "encode_batch",          "sample", run_encode_batch,    NULL);
+    bench_run(&s, "encode_stats",          "frame",  run_encode_stats,    &window);
+    bench_run(&s, "loop_prof_lap",         "op",     run_prof_lap,        &prof);
+    bench_run(&s, "pipeline_ascii",        "frame",  run_pipeline_ascii,  NULL);
+    bench_run(&s, "pipeline_binary",       "frame",  run_pipeline_binary, NULL);
+    bench_run(&s, "pipeline_quat",         "frame",  run_pipeline_quat,   NULL);
+    bench_run(&s, "pipeline_delta",        "frame",  run_pipeline_delta,  NULL);
+
+    return bench_suite_finish(&s);
+}
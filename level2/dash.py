@@ -8,13 +8,35 @@ This Streamlit application acts as a lightweight Ground Control Station (GCS)
 for the Level-2 AHRS telemetry system.
 
 Core Responsibilities:
-- Read validated telemetry data from a CSV flight log
+- Read validated telemetry data from the flight log: the binary
+  fixed-record log (common/flightlog.py) when present, otherwise the
+  CSV log; either way only the data appended since the last refresh
+  is parsed
+- With --log-dir, follow one vehicle of a multi-vehicle fleet logged
+  by common/ground_station (selected in the sidebar)
+- With --feed, subscribe to the receiver's live feed socket
+  (telemetry_rx / plot_live.py --feed, common/live_feed.py) and redraw
+  as soon as frames arrive, instead of polling the logs once a second
 - Display real-time attitude and environmental metrics
 - Visualize roll, pitch, and heading trends over time
+- Show the transmitter's loop timing per stage ($L2S statistics
+  frames: p50 / p99 / max and overruns)
 
 Optional Bonus Feature:
 - 3D attitude cube visualization that rotates with roll, pitch, and heading
 
+Quaternion telemetry ($L2Q, ahrs_filter --quat): the cube is rotated by
+the quaternion directly, and roll / pitch / heading for the cards and
+charts are derived on the ground, vectorized over the window.
+
+Refresh cost stays constant over a long flight:
+- New records are read from a tracked file offset (CSV) or record
+  index (binary log), never by reloading the whole file; the live feed
+  delivers only new records by construction
+- Plots show a bounded window of the most recent WINDOW_SAMPLES
+  samples, downsampled to MAX_PLOT_POINTS with LTTB
+- Figures are built once and their trace data replaced on refresh
+
 Design Philosophy:
 - Clear separation of concerns (logging vs visualization)
 - File-based telemetry source to mimic real flight logs
@@ -26,8 +48,18 @@ import pandas as pd
 import plotly.graph_objects as go
 import numpy as np
 from pathlib import Path
+import argparse
+import csv
+import io
+import sys
 import time
 
+# Binary flight log reader and live feed subscriber (common/)
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "common"))
+import binframe
+import flightlog
+import live_feed
+
 # ============================================================
 # Page configuration
 # ============================================================
@@ -42,8 +74,28 @@ st.set_page_config(
 # ============================================================
 
 CSV_PATH = Path("level2_telemetry.csv")
+FLOG_PATH = Path("level2_telemetry.flog")   # plot_live.py --flog / ahrs_filter --log
+STATS_CSV_PATH = Path("level2_loop_stats.csv")   # plot_live.py / telemetry_rx --loop-csv
 REFRESH_SEC = 1.0   # UI refresh rate (not telemetry rate)
 
+# Loop stages reported in $L2S frames, in ahrs_filter.c order
+STAGE_NAMES = ["cycle", "imu", "ahrs", "euler", "encode", "tx", "log"]
+STATS_TAIL_BYTES = 4096   # enough for the newest report
+
+# streamlit run dash.py -- --log-dir DIR   (ground_station --log-dir DIR)
+# streamlit run dash.py -- --feed SOCKET   (telemetry_rx --feed SOCKET)
+_parser = argparse.ArgumentParser()
+_parser.add_argument("--log-dir", type=Path,
+                     help="ground station log directory (one log per vehicle)")
+_parser.add_argument("--feed", type=Path,
+                     help="live feed socket of the receiver (no file polling)")
+_args = _parser.parse_known_args()[0]
+LOG_DIR = _args.log_dir
+FEED_PATH = _args.feed
+
+WINDOW_SAMPLES = 20000    # most recent samples kept for plotting
+MAX_PLOT_POINTS = 1500    # per trace, after downsampling
+
 # ============================================================
 # Custom CSS – Professional GCS Styling
 # ============================================================
@@ -97,13 +149,13 @@ def metric_card(label, value, unit=""):
         unsafe_allow_html=True
     )
 
-def make_plot(df, y_col, title, y_label):
-    """Generate a Plotly time-series plot."""
+def make_plot(title, y_label):
+    """Generate an (empty) Plotly time-series plot."""
     fig = go.Figure()
     fig.add_trace(
         go.Scatter(
-            x=df["timestamp_ms"],
-            y=df[y_col],
+            x=[],
+            y=[],
             mode="lines",
             line=dict(width=2)
         )
@@ -118,6 +170,55 @@ def make_plot(df, y_col, title, y_label):
     )
     return fig
 
+def cached_figure(key, build):
+    """Figure built once per session, then updated in place."""
+    figs = st.session_state.setdefault("figures", {})
+    if key not in figs:
+        figs[key] = build()
+    return figs[key]
+
+def lttb(x, y, n_out):
+    """
+    Largest-Triangle-Three-Buckets downsampling to n_out points.
+
+    Keeps the first and last points; from each of the n_out - 2 buckets
+    in between it keeps the point forming the largest triangle with the
+    previously kept point and the mean of the next bucket, which
+    preserves peaks and the visual shape of the trace.
+    """
+    n = len(x)
+    if n_out >= n or n_out < 3:
+        return x, y
+
+    every = (n - 2) / (n_out - 2)
+    keep = np.empty(n_out, dtype=np.int64)
+    keep[0], keep[-1] = 0, n - 1
+    a = 0
+
+    for i in range(n_out - 2):
+        start = int(i * every) + 1
+        end = int((i + 1) * every) + 1
+        nxt_end = min(int((i + 2) * every) + 1, n)
+
+        avg_x = x[end:nxt_end].mean()
+        avg_y = y[end:nxt_end].mean()
+
+        area = np.abs((x[a] - avg_x) * (y[start:end] - y[a]) -
+                      (x[a] - x[start:end]) * (avg_y - y[a]))
+        a = start + int(area.argmax())
+        keep[i + 1] = a
+
+    return x[keep], y[keep]
+
+def plot_window(df, y_col, title, y_label):
+    """Downsampled time-series figure of the current window."""
+    fig = cached_figure(y_col, lambda: make_plot(title, y_label))
+    x, y = lttb(df["timestamp_ms"].to_numpy(dtype=float),
+                df[y_col].to_numpy(dtype=float), MAX_PLOT_POINTS)
+    fig.data[0].x = x
+    fig.data[0].y = y
+    return fig
+
 # ============================================================
 # 3D Attitude Cube Helpers (Bonus Feature)
 # ============================================================
@@ -144,30 +245,44 @@ def rotation_matrix(roll, pitch, yaw):
 
     return Rz @ Ry @ Rx
 
-def make_attitude_cube(roll, pitch, yaw):
-    """Create a 3D rotating cube representing attitude."""
-    vertices = np.array([
-        [-1,-1,-1],[1,-1,-1],[1,1,-1],[-1,1,-1],
-        [-1,-1, 1],[1,-1, 1],[1,1, 1],[-1,1, 1]
+def quat_rotation_matrix(q0, q1, q2, q3):
+    """Rotation matrix (body -> earth) straight from a unit quaternion."""
+    return np.array([
+        [1 - 2*(q2*q2 + q3*q3), 2*(q1*q2 - q0*q3),     2*(q1*q3 + q0*q2)],
+        [2*(q1*q2 + q0*q3),     1 - 2*(q1*q1 + q3*q3), 2*(q2*q3 - q0*q1)],
+        [2*(q1*q3 - q0*q2),     2*(q2*q3 + q0*q1),     1 - 2*(q1*q1 + q2*q2)]
     ])
-    edges = [
-        (0,1),(1,2),(2,3),(3,0),
-        (4,5),(5,6),(6,7),(7,4),
-        (0,4),(1,5),(2,6),(3,7)
-    ]
 
-    R = rotation_matrix(roll, pitch, yaw)
-    rotated = vertices @ R.T
+def add_euler_columns(df):
+    """
+    Roll / pitch / heading (degrees) for an L2Q window, same convention
+    as ahrs_get_euler() on the transmitter.
+    """
+    q0, q1, q2, q3 = (df[c].to_numpy(dtype=float) for c in ("q0", "q1", "q2", "q3"))
+    return df.assign(
+        roll=np.degrees(np.arctan2(2*(q0*q1 + q2*q3), 1 - 2*(q1*q1 + q2*q2))),
+        pitch=np.degrees(np.arcsin(np.clip(2*(q0*q2 - q3*q1), -1, 1))),
+        heading=np.degrees(np.arctan2(2*(q0*q3 + q1*q2), 1 - 2*(q2*q2 + q3*q3))),
+    )
 
+CUBE_VERTICES = np.array([
+    [-1,-1,-1],[1,-1,-1],[1,1,-1],[-1,1,-1],
+    [-1,-1, 1],[1,-1, 1],[1,1, 1],[-1,1, 1]
+])
+CUBE_EDGES = [
+    (0,1),(1,2),(2,3),(3,0),
+    (4,5),(5,6),(6,7),(7,4),
+    (0,4),(1,5),(2,6),(3,7)
+]
+
+def make_attitude_cube():
+    """Create the 3D cube figure (one line trace, edges split by gaps)."""
     fig = go.Figure()
-    for e in edges:
-        fig.add_trace(go.Scatter3d(
-            x=[rotated[e[0],0], rotated[e[1],0]],
-            y=[rotated[e[0],1], rotated[e[1],1]],
-            z=[rotated[e[0],2], rotated[e[1],2]],
-            mode="lines",
-            line=dict(color="cyan", width=6)
-        ))
+    fig.add_trace(go.Scatter3d(
+        x=[], y=[], z=[],
+        mode="lines",
+        line=dict(color="cyan", width=6)
+    ))
 
     fig.update_layout(
         title="3D Attitude Visualization (Bonus)",
@@ -182,6 +297,262 @@ def make_attitude_cube(roll, pitch, yaw):
     )
     return fig
 
+def attitude_cube(R):
+    """Cube figure rotated by the attitude matrix R."""
+    fig = cached_figure("cube", make_attitude_cube)
+
+    rotated = CUBE_VERTICES @ R.T
+
+    xs, ys, zs = [], [], []
+    for e in CUBE_EDGES:
+        for axis, out in enumerate((xs, ys, zs)):
+            out += [rotated[e[0], axis], rotated[e[1], axis], None]
+
+    fig.data[0].x = xs
+    fig.data[0].y = ys
+    fig.data[0].z = zs
+    return fig
+
+# ============================================================
+# Telemetry source
+# ============================================================
+#
+# TelemetryFeed lives in st.session_state, so it survives Streamlit
+# reruns. Each refresh parses only what was appended since the last
+# one, from a tracked byte offset (CSV) or record index (binary flight
+# log, memory-mapped), and keeps the most recent WINDOW_SAMPLES rows.
+# A log that shrinks (logger restarted) is re-read from the start.
+#
+# The live feed ("live") has no file to poll: poll() blocks on the
+# socket until the receiver publishes, so the rerun that follows draws
+# the frame as it arrives. The window starts when the dashboard
+# connects; a receiver restart is followed by a reconnect.
+#
+
+class TelemetryFeed:
+    def __init__(self, kind, path, vehicle=None):
+        self.kind = kind          # "flog", "csv" or "live"
+        self.path = path
+        self.vehicle = vehicle    # ground station vehicle ID (--log-dir)
+        self.reader = None        # FlightLogReader (flog)
+        self.offset = 0           # bytes consumed (csv)
+        self.columns = None       # CSV header (csv)
+        self.sub = None           # LiveFeedSubscriber (live)
+        self.layout = None        # telemetry frame type (live)
+        self.stats = None         # newest $L2S rows as a DataFrame (live)
+        self.latency_ms = None    # publication to receipt, newest message (live)
+        self.total = 0            # samples since the log started
+        self.window = None        # DataFrame, at most WINDOW_SAMPLES rows
+
+    def close(self):
+        if self.reader is not None:
+            self.reader.close()
+        if self.sub is not None:
+            self.sub.close()
+
+    def _reset(self):
+        self.close()
+        self.__init__(self.kind, self.path, self.vehicle)
+
+    def _new_flog_rows(self):
+        if self.reader is None:
+            self.reader = flightlog.FlightLogReader(self.path)
+        elif self.reader.count() < self.reader.next_index:
+            self._reset()
+            return self._new_flog_rows()
+
+        # After a long absence only the window is worth reading
+        if self.reader.count() - self.reader.next_index > WINDOW_SAMPLES:
+            self.total += self.reader.count() - WINDOW_SAMPLES - self.reader.next_index
+            self.reader.seek(self.reader.count() - WINDOW_SAMPLES)
+
+        raw = self.reader.read_new_raw()
+        if not raw:
+            return None
+        return pd.DataFrame(np.frombuffer(raw, dtype=self.reader.numpy_dtype()))
+
+    def _new_csv_rows(self):
+        size = self.path.stat().st_size
+        if size < self.offset:
+            self._reset()
+        if size == self.offset:
+            return None
+
+        with open(self.path, "rb") as f:
+            f.seek(self.offset)
+            chunk = f.read(size - self.offset)
+
+        # Only complete lines; a row being written waits for next time
+        end = chunk.rfind(b"\n") + 1
+        if end == 0:
+            return None
+        self.offset += end
+        chunk = chunk[:end]
+
+        if self.columns is None:
+            nl = chunk.index(b"\n")
+            self.columns = chunk[:nl].decode().strip().split(",")
+            chunk = chunk[nl + 1:]
+            if not chunk:
+                return None
+
+        return pd.read_csv(io.BytesIO(chunk), header=None, names=self.columns)
+
+    def _new_live_rows(self):
+        if self.sub is None:
+            try:
+                self.sub = live_feed.LiveFeedSubscriber(self.path)
+            except OSError:
+                return None       # receiver not started (yet)
+
+        raw = self.sub.recv_raw(timeout=REFRESH_SEC)
+        if self.sub.closed:
+            self.sub.close()
+            self.sub = None
+        if not raw:
+            return None
+
+        rec = np.frombuffer(raw, dtype=live_feed.NUMPY_DTYPE)
+        self.latency_ms = (time.monotonic_ns() - int(rec["pub_ns"][-1])) * 1e-6
+
+        def frame(rows):
+            names = live_feed.COLUMNS[int(rows["type"][0])]
+            cols = {"timestamp_ms": rows["ts_ms"]}
+            cols.update((n, rows["v"][:, i]) for i, n in enumerate(names))
+            return pd.DataFrame(cols)
+
+        side = rec[rec["type"] == binframe.TYPE_L2S]
+        if len(side):
+            self.stats = frame(side[side["ts_ms"] == side["ts_ms"].max()])
+
+        rec = rec[rec["type"] != binframe.TYPE_L2S]
+        if self.layout is None and len(rec):
+            self.layout = int(rec["type"][0])   # first frame selects, as in the receivers
+        rec = rec[rec["type"] == self.layout]
+        return frame(rec) if len(rec) else None
+
+    def wait(self):
+        """Pause before the next refresh; a connected live feed waits in poll()."""
+        if self.kind != "live" or self.sub is None:
+            time.sleep(REFRESH_SEC)
+
+    def poll(self):
+        """Current window DataFrame (possibly empty)."""
+        if self.kind == "live":
+            new = self._new_live_rows()
+        elif self.kind == "flog":
+            new = self._new_flog_rows()
+        else:
+            new = self._new_csv_rows()
+
+        if new is not None and not new.empty:
+            self.total += len(new)
+            if self.window is None or self.window.empty:
+                self.window = new
+            else:
+                self.window = pd.concat([self.window, new], ignore_index=True)
+            if len(self.window) > WINDOW_SAMPLES:
+                self.window = self.window.iloc[-WINDOW_SAMPLES:].reset_index(drop=True)
+
+        return self.window if self.window is not None else pd.DataFrame()
+
+
+def fleet_vehicles(log_dir):
+    """{vehicle id: source} of the L2 vehicles in a ground station log."""
+    index = log_dir / "vehicles.csv"
+    if not index.exists():
+        return {}
+    with open(index, newline="") as f:
+        return {int(row["vehicle"]): row["source"]
+                for row in csv.DictReader(f) if row["layout"] in ("L2", "L2Q")}
+
+
+def telemetry_source():
+    """(kind, path, vehicle) of the log to show, or None if none exists yet."""
+    if FEED_PATH is not None:
+        return "live", FEED_PATH, None
+    if LOG_DIR is not None:
+        vehicles = fleet_vehicles(LOG_DIR)
+        if not vehicles:
+            return None
+        vehicle = st.sidebar.selectbox(
+            "Vehicle", sorted(vehicles),
+            format_func=lambda v: f"{v} – {vehicles[v]}")
+        return "flog", LOG_DIR / f"vehicle_{vehicle}.flog", vehicle
+
+    if FLOG_PATH.exists() and flightlog.is_flight_log(FLOG_PATH):
+        return "flog", FLOG_PATH, None
+    if CSV_PATH.exists():
+        return "csv", CSV_PATH, None
+    return None
+
+
+def load_telemetry():
+    """TelemetryFeed for the active log, or None if no log exists yet."""
+    source = telemetry_source()
+    if source is None:
+        return None
+    kind, path, vehicle = source
+
+    feed = st.session_state.get("feed")
+    if feed is None or feed.kind != kind or feed.path != path:
+        if feed is not None:
+            feed.close()
+        feed = st.session_state.feed = TelemetryFeed(kind, path, vehicle)
+    return feed
+
+def latest_loop_stats(vehicle):
+    """
+    The newest $L2S report as (DataFrame with one row per stage, end of
+    its window in ms), or None.
+
+    Only the tail of the statistics log is read: the ground station's
+    per-vehicle vehicle_<ID>_L2S.flog with --log-dir, otherwise
+    STATS_CSV_PATH.
+    """
+    if vehicle is not None:
+        path = LOG_DIR / f"vehicle_{vehicle}_L2S.flog"
+        if not path.exists():
+            return None
+        reader = flightlog.FlightLogReader(path)
+        try:
+            reader.seek(max(0, reader.count() - 2 * len(STAGE_NAMES)))
+            raw = reader.read_new_raw()
+            df = pd.DataFrame(np.frombuffer(raw, dtype=reader.numpy_dtype())) \
+                if raw else None
+        finally:
+            reader.close()
+    else:
+        if not STATS_CSV_PATH.exists():
+            return None
+        with open(STATS_CSV_PATH, "rb") as f:
+            header = f.readline()
+            size = f.seek(0, io.SEEK_END)
+            start = max(len(header), size - STATS_TAIL_BYTES)
+            f.seek(start)
+            tail = f.read()
+        if start > len(header):
+            tail = tail[tail.find(b"\n") + 1:]     # partial first row
+        tail = tail[:tail.rfind(b"\n") + 1]        # row being written
+        df = pd.read_csv(io.BytesIO(header + tail)) if tail else None
+
+    if df is None or df.empty:
+        return None
+    return stats_table(df[df["timestamp_ms"] == df["timestamp_ms"].max()])
+
+def stats_table(df):
+    """(table, end of window in ms) for the $L2S rows of one report."""
+    return pd.DataFrame({
+        "Stage": [STAGE_NAMES[int(i)] if int(i) < len(STAGE_NAMES) else str(int(i))
+                  for i in df["stage"]],
+        "Samples": df["count"].astype(int).to_numpy(),
+        "min (µs)": df["min_us"].to_numpy(),
+        "p50 (µs)": df["p50_us"].to_numpy(),
+        "p99 (µs)": df["p99_us"].to_numpy(),
+        "max (µs)": df["max_us"].to_numpy(),
+        "Overruns": df["overruns"].astype(int).to_numpy(),
+    }), int(df["timestamp_ms"].iloc[0])
+
 # ============================================================
 # Dashboard Header
 # ============================================================
@@ -196,17 +567,21 @@ st.markdown("---")
 
 while True:
 
-    if not CSV_PATH.exists():
-        st.warning("⏳ Waiting for telemetry logger to create CSV file...")
+    feed = load_telemetry()
+    if feed is None:
+        st.warning("⏳ Waiting for telemetry logger to create a log file...")
         time.sleep(REFRESH_SEC)
         st.rerun()
 
-    df = pd.read_csv(CSV_PATH)
+    df = feed.poll()
     if df.empty:
         st.info("📡 Telemetry stream detected, waiting for data...")
-        time.sleep(REFRESH_SEC)
+        feed.wait()
         st.rerun()
 
+    quat = "q0" in df.columns
+    if quat:
+        df = add_euler_columns(df)
     latest = df.iloc[-1]
 
     # ========================================================
@@ -223,8 +598,10 @@ while True:
     with s2:
         st.markdown("### 📋 Frame Info")
         st.markdown(f"**Last Timestamp:** `{int(latest['timestamp_ms'])} ms`")
-        st.markdown(f"**Samples Logged:** `{len(df)}`")
-        st.markdown("**Mode:** Level-2 AHRS")
+        st.markdown(f"**Samples Logged:** `{feed.total}`")
+        st.markdown("**Mode:** Level-2 AHRS" + (" (quaternion)" if quat else ""))
+        if feed.vehicle is not None:
+            st.markdown(f"**Vehicle:** `{feed.vehicle}`")
 
     st.markdown("---")
 
@@ -250,28 +627,55 @@ while True:
     left, right = st.columns([2, 1])
 
     with left:
-        st.plotly_chart(make_plot(df, "roll", "Roll vs Time", "Degrees"), width="stretch")
-        st.plotly_chart(make_plot(df, "pitch", "Pitch vs Time", "Degrees"), width="stretch")
-        st.plotly_chart(make_plot(df, "heading", "Heading vs Time", "Degrees"), width="stretch")
+        st.plotly_chart(plot_window(df, "roll", "Roll vs Time", "Degrees"), width="stretch")
+        st.plotly_chart(plot_window(df, "pitch", "Pitch vs Time", "Degrees"), width="stretch")
+        st.plotly_chart(plot_window(df, "heading", "Heading vs Time", "Degrees"), width="stretch")
 
     with right:
-        st.plotly_chart(
-            make_attitude_cube(
-                latest["roll"],
-                latest["pitch"],
-                latest["heading"]
-            ),
-            width="stretch"
+        if quat:
+            R = quat_rotation_matrix(latest["q0"], latest["q1"],
+                                     latest["q2"], latest["q3"])
+        else:
+            R = rotation_matrix(latest["roll"], latest["pitch"], latest["heading"])
+        st.plotly_chart(attitude_cube(R), width="stretch")
+
+    # ========================================================
+    # Transmitter Loop Timing ($L2S)
+    # ========================================================
+
+    if feed.kind == "live":
+        loop_stats = stats_table(feed.stats) if feed.stats is not None else None
+    else:
+        loop_stats = latest_loop_stats(feed.vehicle)
+    if loop_stats is not None:
+        table, window_end = loop_stats
+        st.markdown("---")
+        st.markdown('<div class="section-title">Transmitter Loop Timing</div>',
+                    unsafe_allow_html=True)
+        st.dataframe(table, hide_index=True, width="stretch")
+        st.markdown(
+            '<div class="subtle">'
+            f'Statistics window ending at {window_end} ms. Cycle overruns '
+            'are missed loop deadlines; stage overruns are single stages '
+            'longer than the loop period.'
+            '</div>',
+            unsafe_allow_html=True
         )
 
+    if feed.kind == "live":
+        source = "live feed"
+        if feed.latency_ms is not None:
+            source += f" ({feed.latency_ms:.2f} ms receiver to dashboard)"
+    else:
+        source = f'{"binary" if feed.kind == "flog" else "CSV"} flight log'
     st.markdown(
         '<div class="subtle">'
         'Dashboard refreshes automatically. '
-        'Data source: CSV flight log.'
+        f'Data source: {source}, last {len(df)} samples shown.'
         '</div>',
         unsafe_allow_html=True
     )
 
-    time.sleep(REFRESH_SEC)
+    feed.wait()
     st.rerun()
 
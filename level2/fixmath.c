@@ -0,0 +1,179 @@
+/*
+ * fixmath.c
+ *
+ * AIRMAN – Fixed-point math helpers (see fixmath.h)
+ */
+
+#include "fixmath.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* ============================================================
+ * RECIPROCAL SQUARE ROOT
+ * ============================================================
+ *
+ * Seed from a 32-entry table indexed by the top bits of s (the
+ * reciprocal root at each bin's midpoint, Q28), then three Newton
+ * iterations y' = y * (3 - s*y^2) / 2. The worst-case seed error is
+ * ~10 %, which converges below the Q28 resolution.
+ */
+
+static const int32_t rsqrt_seed[33] = {
+     960383883,  960383883,  960383883,  811672525,
+     715827883,  647490682,  595604800,  554477894,
+     520841289,  492666537,  468619351,  447781295,
+     429496730,  413283421,  398777702,  385699449,
+     373828920,  362990988,  353044137,  343872592,
+     335380600,  327488186,  320127961,  313242684,
+     306783378,  300707858,  294979565,  289566636,
+     284441158,  279578557,  274957106,  270557508,
+     268435456,
+};
+
+int32_t fx_rsqrt_q30(int32_t s)
+{
+    int64_t y = rsqrt_seed[(uint32_t)s >> 25];
+
+    for (int i = 0; i < 3; i++) {
+        int64_t yy = (y * y) >> 28;                 /* Q28 */
+        int64_t u  = ((int64_t)s * yy) >> 30;       /* Q28 */
+        y = (y * ((3LL << 28) - u)) >> 29;          /* Q28 */
+    }
+    return (int32_t)y;
+}
+
+int32_t fx_sqrt_q30(uint32_t s)
+{
+    if (s == 0)
+        return 0;
+
+    /* Bring s into [1/16, 1] by an even shift, sqrt(s) = s / sqrt(s) */
+    int k = 0;
+    while (s < (1u << 26)) { s <<= 2; k++; }
+    while (s > (1u << 30)) { s >>= 2; k--; }
+
+    int64_t root = ((int64_t)s * fx_rsqrt_q30((int32_t)s)) >> 28;
+    return (int32_t)(k >= 0 ? root >> k : root << -k);
+}
+
+int fx_normalize(const int64_t *in, int32_t *out, int n)
+{
+    uint64_t m = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t a = in[i] < 0 ? (uint64_t)-in[i] : (uint64_t)in[i];
+        if (a > m)
+            m = a;
+    }
+    if (m == 0)
+        return 0;
+
+    /* Scale so the largest component lies in [2^28, 2^29) */
+    int rsh = 0, lsh = 0;
+    while ((m >> rsh) >= (1ULL << 29)) rsh++;
+    while ((m << lsh) <  (1ULL << 28)) lsh++;
+
+    int32_t v[4];
+    int64_t s = 0;
+    for (int i = 0; i < n; i++) {
+        v[i] = (int32_t)(rsh ? in[i] >> rsh : in[i] * ((int64_t)1 << lsh));
+        s += (int64_t)v[i] * v[i];
+    }
+
+    /* Sum of squares is now within [1/16, 1] in Q30 */
+    int64_t r = fx_rsqrt_q30((int32_t)(s >> 30));
+    for (int i = 0; i < n; i++)
+        out[i] = (int32_t)((v[i] * r) >> 28);
+    return 1;
+}
+
+/* ============================================================
+ * SINE (QUARTER-WAVE TABLE)
+ * ============================================================
+ *
+ * 64 segments per quadrant with linear interpolation; max error
+ * ~1e-4, plenty for the simulated sensor waveforms.
+ */
+
+static const q15_t sin_quarter[65] = {
+        0,   804,  1608,  2411,  3212,  4011,  4808,  5602,
+     6393,  7180,  7962,  8740,  9512, 10279, 11039, 11793,
+    12540, 13279, 14010, 14733, 15447, 16151, 16846, 17531,
+    18205, 18868, 19520, 20160, 20788, 21403, 22006, 22595,
+    23170, 23732, 24279, 24812, 25330, 25833, 26320, 26791,
+    27246, 27684, 28106, 28511, 28899, 29269, 29622, 29957,
+    30274, 30572, 30853, 31114, 31357, 31581, 31786, 31972,
+    32138, 32286, 32413, 32522, 32610, 32679, 32729, 32758,
+    32767,
+};
+
+q15_t fx_sin_q15(uint32_t phase)
+{
+    uint32_t quad = phase >> 30;
+    uint32_t p    = phase & 0x3FFFFFFFu;
+
+    if (quad & 1)
+        p = 0x40000000u - p;
+
+    uint32_t idx  = p >> 24;               /* 0..64 */
+    int32_t  frac = (int32_t)((p >> 8) & 0xFFFF);
+    int32_t  a    = sin_quarter[idx];
+    int32_t  b    = sin_quarter[idx < 64 ? idx + 1 : 64];
+    int32_t  v    = a + (((b - a) * frac) >> 16);
+
+    return (q15_t)((quad & 2) ? -v : v);
+}
+
+/* ============================================================
+ * INVERSE TRIGONOMETRY (EULER OUTPUT)
+ * ============================================================
+ *
+ * atan on [0, 1] by an 11th-order odd minimax polynomial (error
+ * ~1e-5 rad), extended to all quadrants by symmetry.
+ */
+
+#define CDEG_PER_RAD_Q16   ((int64_t)FX_Q16(18000.0 / M_PI))
+
+static int64_t atan_unit_q30(int64_t r)
+{
+    int64_t r2 = (r * r) >> 30;
+    int64_t p  = FX_Q30(-0.01172120);
+    p = FX_Q30( 0.05265332) + ((p * r2) >> 30);
+    p = FX_Q30(-0.11643287) + ((p * r2) >> 30);
+    p = FX_Q30( 0.19354346) + ((p * r2) >> 30);
+    p = FX_Q30(-0.33262347) + ((p * r2) >> 30);
+    p = FX_Q30( 0.99997726) + ((p * r2) >> 30);
+    return (p * r) >> 30;
+}
+
+int32_t fx_atan2_cdeg(int32_t y, int32_t x)
+{
+    if (x == 0 && y == 0)
+        return 0;
+
+    int64_t ax = x < 0 ? -(int64_t)x : x;
+    int64_t ay = y < 0 ? -(int64_t)y : y;
+    int     swap = ay > ax;
+
+    int64_t num = swap ? ax : ay;
+    int64_t den = swap ? ay : ax;
+    int64_t a   = atan_unit_q30((num << 30) / den);      /* Q30 rad */
+
+    if (swap)
+        a = (int64_t)FX_Q30(M_PI / 2.0) - a;
+    if (x < 0)
+        a = ((int64_t)FX_Q30(M_PI / 2.0) << 1) - a;
+
+    int32_t cdeg = (int32_t)((a * CDEG_PER_RAD_Q16 + (1LL << 45)) >> 46);
+    return y < 0 ? -cdeg : cdeg;
+}
+
+int32_t fx_asin_cdeg(int32_t x)
+{
+    if (x >  FX_Q30_ONE) x =  FX_Q30_ONE;
+    if (x < -FX_Q30_ONE) x = -FX_Q30_ONE;
+
+    uint32_t c2 = (uint32_t)(FX_Q30_ONE - (((int64_t)x * x) >> 30));
+    return fx_atan2_cdeg(x, fx_sqrt_q30(c2));
+}
@@ -0,0 +1,69 @@
+/*
+ * fixmath.h
+ *
+ * AIRMAN – Fixed-Point Math Helpers
+ * ---------------------------------
+ *
+ * Integer-only building blocks for the fixed-point AHRS build
+ * (AHRS_FIXED_POINT), aimed at FPU-less parts such as Cortex-M0+
+ * where every float operation is a soft-float library call.
+ *
+ * Formats used throughout:
+ *   Q15   int16_t, 1.0 = 1 << 15   (sine table, sensor waveforms)
+ *   Q16   int32_t, 1.0 = 1 << 16   (raw sensor units)
+ *   Q30   int32_t, 1.0 = 1 << 30   (unit vectors, quaternions, dt)
+ *
+ * Q30 products are formed in 64 bits and shifted back; no helper
+ * divides except fx_atan2_cdeg(), which is only used once per
+ * telemetry frame. Angles leave the fixed-point domain as integer
+ * centi-degrees.
+ *
+ * FX_Q16() / FX_Q30() convert constants at compile time only.
+ */
+
+#ifndef AIRMAN_FIXMATH_H
+#define AIRMAN_FIXMATH_H
+
+#include <stdint.h>
+
+typedef int16_t q15_t;
+
+#define FX_Q30_ONE      (1 << 30)
+
+#define FX_Q16(x)  ((int32_t)((x) * 65536.0      + ((x) >= 0 ? 0.5 : -0.5)))
+#define FX_Q30(x)  ((int32_t)((x) * 1073741824.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+/* Q30 x Q30 -> Q30 */
+static inline int32_t fx_mul_q30(int32_t a, int32_t b)
+{
+    return (int32_t)(((int64_t)a * b) >> 30);
+}
+
+/* 1/sqrt(s) for s in Q30 within [1/16, 1]; result in Q28 */
+int32_t fx_rsqrt_q30(int32_t s);
+
+/* sqrt(s) for s >= 0 in Q30 */
+int32_t fx_sqrt_q30(uint32_t s);
+
+/*
+ * Scale the n-vector in[] (any common fixed-point scale, n <= 4) to
+ * unit length in Q30. Returns 0 (and leaves out[] untouched) for the
+ * zero vector, 1 otherwise.
+ */
+int fx_normalize(const int64_t *in, int32_t *out, int n);
+
+/* Sine of a phase where one full turn is 2^32; result in Q15 */
+q15_t fx_sin_q15(uint32_t phase);
+
+static inline q15_t fx_cos_q15(uint32_t phase)
+{
+    return fx_sin_q15(phase + 0x40000000u);
+}
+
+/* atan2(y, x) in centi-degrees, for any common scale of x and y */
+int32_t fx_atan2_cdeg(int32_t y, int32_t x);
+
+/* asin(x) in centi-degrees, x in Q30 (clamped to [-1, 1]) */
+int32_t fx_asin_cdeg(int32_t x);
+
+#endif /* AIRMAN_FIXMATH_H */
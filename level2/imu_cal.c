@@ -0,0 +1,224 @@
+/*
+ * imu_cal.c
+ *
+ * AIRMAN – IMU calibration stage (see imu_cal.h)
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "imu_cal.h"
+
+static const char *const sensor_names[IMU_CAL_SENSORS] = {
+    "accel", "gyro", "mag",
+};
+
+void imu_cal_init(imu_cal_t *cal)
+{
+    memset(cal, 0, sizeof(*cal));
+    for (int s = 0; s < IMU_CAL_SENSORS; s++)
+        for (int i = 0; i < 3; i++)
+            cal->sensor[s].matrix[i][i] = 1.0f;
+    imu_cal_update(cal);
+}
+
+void imu_cal_update(imu_cal_t *cal)
+{
+    for (int s = 0; s < IMU_CAL_SENSORS; s++) {
+        const imu_cal_sensor_t *p = &cal->sensor[s];
+        for (int i = 0; i < 3; i++) {
+            double c = 0.0;
+            for (int j = 0; j < 3; j++) {
+                cal->m[s][i][j] = p->matrix[i][j];
+                c -= (double)p->matrix[i][j] * p->offset[j];
+            }
+            cal->c[s][i] = (float)c;
+        }
+    }
+}
+
+/* ============================================================
+ * CALIBRATION FILE
+ * ============================================================
+ */
+
+int imu_cal_load(imu_cal_t *cal, const char *path, int *bad_line)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return -1;
+
+    imu_cal_init(cal);
+
+    char line[512];
+    int  line_no = 0;
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        char *hash = strchr(line, '#');
+        if (hash)
+            *hash = '\0';
+
+        char name[16];
+        imu_cal_sensor_t p;
+        int n = sscanf(line, "%15s %f %f %f %f %f %f %f %f %f %f %f %f",
+                       name, &p.offset[0], &p.offset[1], &p.offset[2],
+                       &p.matrix[0][0], &p.matrix[0][1], &p.matrix[0][2],
+                       &p.matrix[1][0], &p.matrix[1][1], &p.matrix[1][2],
+                       &p.matrix[2][0], &p.matrix[2][1], &p.matrix[2][2]);
+        if (n <= 0)
+            continue;                       /* blank or comment */
+
+        int s = 0;
+        while (s < IMU_CAL_SENSORS && strcmp(name, sensor_names[s]) != 0)
+            s++;
+        if (n != 13 || s == IMU_CAL_SENSORS) {
+            if (bad_line)
+                *bad_line = line_no;
+            fclose(f);
+            errno = EINVAL;
+            return -1;
+        }
+        cal->sensor[s] = p;
+    }
+
+    int err = ferror(f);
+    fclose(f);
+    if (err) {
+        errno = EIO;
+        return -1;
+    }
+    imu_cal_update(cal);
+    return 0;
+}
+
+int imu_cal_save(const imu_cal_t *cal, const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return -1;
+
+    fprintf(f, "# AIRMAN IMU calibration: corrected = M (raw - offset)\n"
+               "# sensor  offset[3]  M row-major[9]\n");
+    for (int s = 0; s < IMU_CAL_SENSORS; s++) {
+        const imu_cal_sensor_t *p = &cal->sensor[s];
+        fprintf(f, "%-6s %.9g %.9g %.9g ", sensor_names[s],
+                p->offset[0], p->offset[1], p->offset[2]);
+        for (int i = 0; i < 3; i++)
+            fprintf(f, " %.9g %.9g %.9g",
+                    p->matrix[i][0], p->matrix[i][1], p->matrix[i][2]);
+        fputc('\n', f);
+    }
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+/* ============================================================
+ * CORRECTION PASS
+ * ============================================================
+ *
+ * One loop over the burst, all three sensor blocks per iteration.
+ * Each sample is loaded whole before it is stored, so the pass also
+ * works in place; timestamp and validity bits are carried over.
+ */
+
+static inline vec3_t cal_vec3(const float m[3][3], const float c[3], vec3_t v)
+{
+    return vec3(m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z + c[0],
+                m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z + c[1],
+                m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z + c[2]);
+}
+
+void imu_cal_apply(const imu_cal_t *cal, const imu_sample_t *in,
+                   imu_sample_t *out, int n)
+{
+    for (int i = 0; i < n; i++) {
+        imu_sample_t s = in[i];
+        s.accel = cal_vec3(cal->m[IMU_CAL_ACCEL], cal->c[IMU_CAL_ACCEL], s.accel);
+        s.gyro  = cal_vec3(cal->m[IMU_CAL_GYRO],  cal->c[IMU_CAL_GYRO],  s.gyro);
+        s.mag   = cal_vec3(cal->m[IMU_CAL_MAG],   cal->c[IMU_CAL_MAG],   s.mag);
+        out[i] = s;
+    }
+}
+
+/* Round to the nearest integer of the given scale */
+static int32_t to_fixed(double v, double scale)
+{
+    double x = v * scale;
+    return (int32_t)(x >= 0.0 ? x + 0.5 : x - 0.5);
+}
+
+void imu_cal_to_q(const imu_cal_t *cal, imu_cal_q_t *q)
+{
+    for (int s = 0; s < IMU_CAL_SENSORS; s++)
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++)
+                q->m[s][i][j] = to_fixed(cal->m[s][i][j], 1073741824.0);
+            q->c[s][i] = to_fixed(cal->c[s][i], 65536.0);
+        }
+}
+
+/* Q30 matrix x Q16 sample: 64-bit sums, |m| < 2 keeps them in range */
+static inline vec3_q_t cal_vec3_q(const int32_t m[3][3], const int32_t c[3],
+                                  vec3_q_t v)
+{
+    int64_t x = v.x, y = v.y, z = v.z;
+    return vec3_q((int32_t)((m[0][0] * x + m[0][1] * y + m[0][2] * z) >> 30) + c[0],
+                  (int32_t)((m[1][0] * x + m[1][1] * y + m[1][2] * z) >> 30) + c[1],
+                  (int32_t)((m[2][0] * x + m[2][1] * y + m[2][2] * z) >> 30) + c[2]);
+}
+
+void imu_cal_apply_q(const imu_cal_q_t *cal, const imu_sample_q_t *in,
+                     imu_sample_q_t *out, int n)
+{
+    for (int i = 0; i < n; i++) {
+        imu_sample_q_t s = in[i];
+        s.accel = cal_vec3_q(cal->m[IMU_CAL_ACCEL], cal->c[IMU_CAL_ACCEL], s.accel);
+        s.gyro  = cal_vec3_q(cal->m[IMU_CAL_GYRO],  cal->c[IMU_CAL_GYRO],  s.gyro);
+        s.mag   = cal_vec3_q(cal->m[IMU_CAL_MAG],   cal->c[IMU_CAL_MAG],   s.mag);
+        out[i] = s;
+    }
+}
+
+/* ============================================================
+ * GYRO BIAS AT REST
+ * ============================================================
+ */
+
+void imu_cal_rest_init(imu_cal_rest_t *r)
+{
+    memset(r, 0, sizeof(*r));
+}
+
+void imu_cal_rest_add(imu_cal_rest_t *r, const imu_sample_t *imu, int n)
+{
+    for (int i = 0; i < n; i++) {
+        r->sum[0] += imu[i].gyro.x;
+        r->sum[1] += imu[i].gyro.y;
+        r->sum[2] += imu[i].gyro.z;
+    }
+    r->n += n;
+}
+
+/* Integer sums per burst, one conversion per call */
+void imu_cal_rest_add_q(imu_cal_rest_t *r, const imu_sample_q_t *imu, int n)
+{
+    int64_t sx = 0, sy = 0, sz = 0;
+    for (int i = 0; i < n; i++) {
+        sx += imu[i].gyro.x;
+        sy += imu[i].gyro.y;
+        sz += imu[i].gyro.z;
+    }
+    r->sum[0] += sx / 65536.0;
+    r->sum[1] += sy / 65536.0;
+    r->sum[2] += sz / 65536.0;
+    r->n += n;
+}
+
+void imu_cal_set_gyro_bias(imu_cal_t *cal, const imu_cal_rest_t *r)
+{
+    if (r->n == 0)
+        return;
+    for (int i = 0; i < 3; i++)
+        cal->sensor[IMU_CAL_GYRO].offset[i] = (float)(r->sum[i] / r->n);
+    imu_cal_update(cal);
+}
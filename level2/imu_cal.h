@@ -0,0 +1,107 @@
+/*
+ * imu_cal.h
+ *
+ * AIRMAN – IMU Calibration Stage
+ * ------------------------------
+ *
+ * Corrects raw accelerometer, gyroscope and magnetometer samples before
+ * they reach the filter. Each sensor has a 3x3 scale / misalignment
+ * matrix M and an offset b in raw units:
+ *
+ *   corrected = M (raw - b)
+ *
+ * The parameters are folded into M and c = -M b once, when they are
+ * loaded or changed, so applying them is one pass over a FIFO burst
+ * with three multiply-adds plus one add per sensor axis, all three
+ * vec3 blocks of a sample (common/imu_sample.h) in the same loop
+ * iteration.
+ *
+ * Gyro bias at rest:
+ *   the synthetic (and any real) gyro reads a constant rate when the
+ *   vehicle is still, which the filter would integrate as rotation.
+ *   imu_cal_rest_t averages the raw gyro over a rest window at startup
+ *   and imu_cal_set_gyro_bias() makes that mean the gyro offset.
+ *
+ * Calibration file (text, one line per sensor, '#' comments):
+ *
+ *   accel  <b0> <b1> <b2>  <m00> <m01> <m02> <m10> ... <m22>
+ *   gyro   ...
+ *   mag    ...
+ *
+ * Offsets in raw sensor units, the matrix row-major. Sensors missing
+ * from the file keep the identity. imu_cal_save() writes the same
+ * format.
+ *
+ * Fixed-point build: imu_cal_to_q() converts the folded parameters to
+ * a Q30 matrix and Q16 constant once; imu_cal_apply_q() is integer
+ * only.
+ */
+
+#ifndef AIRMAN_IMU_CAL_H
+#define AIRMAN_IMU_CAL_H
+
+#include <stdint.h>
+
+#include "imu_sample.h"
+
+enum { IMU_CAL_ACCEL, IMU_CAL_GYRO, IMU_CAL_MAG, IMU_CAL_SENSORS };
+
+typedef struct {
+    float offset[3];          /* raw units, removed before the matrix */
+    float matrix[3][3];       /* scale / misalignment, row-major */
+} imu_cal_sensor_t;
+
+typedef struct {
+    imu_cal_sensor_t sensor[IMU_CAL_SENSORS];     /* as in the file */
+
+    /* Folded by imu_cal_update(): corrected = m raw + c */
+    _Alignas(64)
+    float m[IMU_CAL_SENSORS][3][3];
+    float c[IMU_CAL_SENSORS][3];
+} imu_cal_t;
+
+typedef struct {
+    _Alignas(64)
+    int32_t m[IMU_CAL_SENSORS][3][3];     /* Q30 */
+    int32_t c[IMU_CAL_SENSORS][3];        /* Q16 */
+} imu_cal_q_t;
+
+/* Gyro mean over a rest window */
+typedef struct {
+    double sum[3];            /* raw deg/s */
+    long   n;
+} imu_cal_rest_t;
+
+/* Identity matrices, zero offsets */
+void imu_cal_init(imu_cal_t *cal);
+
+/* Refold m / c after changing cal->sensor[] */
+void imu_cal_update(imu_cal_t *cal);
+
+/*
+ * Read a calibration file into cal (starting from the identity).
+ * Returns 0, or -1 with errno set (EINVAL for a malformed line, whose
+ * number is stored in *bad_line when bad_line is not NULL).
+ */
+int imu_cal_load(imu_cal_t *cal, const char *path, int *bad_line);
+
+/* Write cal->sensor[] to path. Returns 0, or -1 (errno set) */
+int imu_cal_save(const imu_cal_t *cal, const char *path);
+
+/* Correct n samples; out may be the same array as in */
+void imu_cal_apply(const imu_cal_t *cal, const imu_sample_t *in,
+                   imu_sample_t *out, int n);
+
+void imu_cal_to_q(const imu_cal_t *cal, imu_cal_q_t *q);
+
+void imu_cal_apply_q(const imu_cal_q_t *cal, const imu_sample_q_t *in,
+                     imu_sample_q_t *out, int n);
+
+void imu_cal_rest_init(imu_cal_rest_t *r);
+void imu_cal_rest_add(imu_cal_rest_t *r, const imu_sample_t *imu, int n);
+void imu_cal_rest_add_q(imu_cal_rest_t *r, const imu_sample_q_t *imu, int n);
+
+/* Gyro offset := rest mean (no-op without samples); refolds m / c */
+void imu_cal_set_gyro_bias(imu_cal_t *cal, const imu_cal_rest_t *r);
+
+#endif /* AIRMAN_IMU_CAL_H */
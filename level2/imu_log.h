@@ -0,0 +1,96 @@
+/*
+ * imu_log.h
+ *
+ * AIRMAN – Binary IMU Log Format
+ * ------------------------------
+ *
+ * Raw IMU samples as recorded by `ahrs_filter --record` and consumed by
+ * ahrs_replay. Fixed-size records make the file directly addressable
+ * once mapped: record i is at header + i * rec_size, with no parsing.
+ *
+ * Layout (host byte order; all supported hosts are little-endian):
+ *
+ *   imu_log_header_t                     16 bytes
+ *   imu_log_rec_t  x N                   64 bytes each
+ *
+ * Since version 2 a record is the in-memory imu_sample_t itself
+ * (common/imu_sample.h), timestamp and validity bits included, so a
+ * FIFO burst is written with one fwrite() and read back with no
+ * repacking. Version 1 logs (48-byte records, no validity bits) are
+ * still read through imu_log_rec_from_v1().
+ *
+ * Timestamps are microseconds on any monotonic time base; replay takes
+ * dt from the difference between consecutive records.
+ */
+
+#ifndef AIRMAN_IMU_LOG_H
+#define AIRMAN_IMU_LOG_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "imu_sample.h"
+
+#define IMU_LOG_MAGIC     "AIMU"
+#define IMU_LOG_VERSION   2
+
+typedef struct {
+    char     magic[4];        /* IMU_LOG_MAGIC, not NUL-terminated */
+    uint32_t version;         /* IMU_LOG_VERSION */
+    uint32_t rec_size;        /* sizeof(imu_log_rec_t) */
+    uint32_t reserved;
+} imu_log_header_t;
+
+typedef imu_sample_t imu_log_rec_t;
+
+/* Version 1 record */
+typedef struct {
+    int64_t t_us;
+    float   ax, ay, az, gx, gy, gz, mx, my, mz;
+    float   reserved;
+} imu_log_rec_v1_t;
+
+_Static_assert(sizeof(imu_log_header_t) == 16, "imu_log header layout");
+_Static_assert(sizeof(imu_log_rec_t) == 64, "imu_log record layout");
+_Static_assert(sizeof(imu_log_rec_v1_t) == 48, "imu_log v1 record layout");
+
+static inline void imu_log_header_init(imu_log_header_t *h)
+{
+    memcpy(h->magic, IMU_LOG_MAGIC, 4);
+    h->version  = IMU_LOG_VERSION;
+    h->rec_size = sizeof(imu_log_rec_t);
+    h->reserved = 0;
+}
+
+/*
+ * Version of the log starting at buf (len bytes): IMU_LOG_VERSION or 1
+ * when this build can read it, 0 otherwise.
+ */
+static inline int imu_log_version(const void *buf, size_t len)
+{
+    imu_log_header_t h;
+    if (len < sizeof(h))
+        return 0;
+    memcpy(&h, buf, sizeof(h));
+    if (memcmp(h.magic, IMU_LOG_MAGIC, 4) != 0)
+        return 0;
+    if (h.version == IMU_LOG_VERSION && h.rec_size == sizeof(imu_log_rec_t))
+        return IMU_LOG_VERSION;
+    if (h.version == 1 && h.rec_size == sizeof(imu_log_rec_v1_t))
+        return 1;
+    return 0;
+}
+
+/* Widen a version 1 record (all blocks valid; a zero mag stays absent) */
+static inline void imu_log_rec_from_v1(const imu_log_rec_v1_t *r,
+                                       imu_sample_t *imu)
+{
+    imu->accel    = vec3(r->ax, r->ay, r->az);
+    imu->gyro     = vec3(r->gx, r->gy, r->gz);
+    imu->mag      = vec3(r->mx, r->my, r->mz);
+    imu->t_us     = r->t_us;
+    imu->valid    = IMU_VALID_ALL;
+    imu->reserved = 0;
+}
+
+#endif /* AIRMAN_IMU_LOG_H */
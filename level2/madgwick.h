@@ -0,0 +1,195 @@
+/*
+ * madgwick.h
+ *
+ * AIRMAN – Madgwick AHRS Step (shared scalar kernel)
+ * --------------------------------------------------
+ *
+ * Single-sample Madgwick update on a caller-held quaternion. Samples
+ * are imu_sample_t (common/imu_sample.h): vec3 sensor blocks plus a
+ * timestamp and validity bits.
+ *
+ * Header-only so that the transmitter (ahrs_filter.c), the SIMD
+ * multi-stream kernel (ahrs_simd.c) and the benchmarks all inline the
+ * identical scalar math.
+ *
+ * Each step integrates the gyro rate and applies Madgwick's gradient-
+ * descent correction towards the measured gravity (and magnetic field)
+ * direction, scaled by the gain beta:
+ *
+ *   MARG      accel + gyro + mag   heading is observable, no yaw drift
+ *   IMU-only  accel + gyro         used when the mag vector is zero or
+ *                                  flagged invalid
+ *   gyro-only                      used when the accel vector is zero or
+ *                                  flagged invalid
+ *
+ * The objective-function residuals (f_g, f_b) are computed once and
+ * shared by all four gradient components instead of being re-expanded
+ * per component.
+ *
+ * Define MADGWICK_FAST_INV_SQRT to replace 1/sqrtf() with a bit-level
+ * estimate plus one Newton iteration (relative error < 0.2 %), for
+ * targets where sqrtf/division are slow. Every normalization re-projects
+ * onto unit length, so the error does not accumulate.
+ */
+
+#ifndef AIRMAN_MADGWICK_H
+#define AIRMAN_MADGWICK_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "imu_sample.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* madgwick_step() return values: which correction was applied */
+#define MADGWICK_GYRO_ONLY   0
+#define MADGWICK_IMU         1
+#define MADGWICK_MARG        2
+
+typedef struct {
+    float q0, q1, q2, q3;
+} quat_t;
+
+static inline float deg2rad(float d) { return d * (M_PI / 180.0f); }
+
+static inline float inv_sqrt(float x)
+{
+#ifdef MADGWICK_FAST_INV_SQRT
+    float    y;
+    uint32_t i;
+
+    memcpy(&i, &x, sizeof(i));
+    i = 0x5F375A86u - (i >> 1);
+    memcpy(&y, &i, sizeof(y));
+    return y * (1.5f - 0.5f * x * y * y);
+#else
+    return 1.0f / sqrtf(x);
+#endif
+}
+
+/*
+ * One filter step on a caller-held quaternion. Inlined into every
+ * caller so a batch keeps the quaternion in registers instead of
+ * reloading/storing state for every sample.
+ *
+ * Returns MADGWICK_MARG, MADGWICK_IMU or MADGWICK_GYRO_ONLY depending
+ * on which measurements were usable.
+ */
+static inline int madgwick_step(quat_t *q, const imu_sample_t *imu,
+                                float dt, float beta)
+{
+    float q0 = q->q0, q1 = q->q1, q2 = q->q2, q3 = q->q3;
+
+    float ax = imu->accel.x, ay = imu->accel.y, az = imu->accel.z;
+    float gx = deg2rad(imu->gyro.x);
+    float gy = deg2rad(imu->gyro.y);
+    float gz = deg2rad(imu->gyro.z);
+    float mx = imu->mag.x, my = imu->mag.y, mz = imu->mag.z;
+
+    /* An invalid block counts as absent, like a zero vector */
+    if (!(imu->valid & IMU_VALID_GYRO))
+        gx = gy = gz = 0.0f;
+    int have_accel = (imu->valid & IMU_VALID_ACCEL) &&
+                     !(ax == 0.0f && ay == 0.0f && az == 0.0f);
+    int have_mag   = (imu->valid & IMU_VALID_MAG) &&
+                     !(mx == 0.0f && my == 0.0f && mz == 0.0f);
+
+    int mode = MADGWICK_GYRO_ONLY;
+
+    /* Quaternion rate of change from gyroscope */
+    float qDot0 = 0.5f * (-q1*gx - q2*gy - q3*gz);
+    float qDot1 = 0.5f * ( q0*gx + q2*gz - q3*gy);
+    float qDot2 = 0.5f * ( q0*gy - q1*gz + q3*gx);
+    float qDot3 = 0.5f * ( q0*gz + q1*gy - q2*gx);
+
+    if (have_accel) {
+        /* Normalize accelerometer */
+        float norm = inv_sqrt(ax*ax + ay*ay + az*az);
+        ax *= norm; ay *= norm; az *= norm;
+
+        /* Shared products */
+        float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1;
+        float _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+        float q0q1 = q0*q1, q0q2 = q0*q2, q0q3 = q0*q3;
+        float q1q1 = q1*q1, q1q2 = q1*q2, q1q3 = q1*q3;
+        float q2q2 = q2*q2, q2q3 = q2*q3, q3q3 = q3*q3;
+
+        /* Gravity residual f_g = R^T * [0 0 1] - a */
+        float fg1 = 2.0f * (q1q3 - q0q2) - ax;
+        float fg2 = 2.0f * (q0q1 + q2q3) - ay;
+        float fg3 = 1.0f - 2.0f * (q1q1 + q2q2) - az;
+
+        /* Gradient J_g^T * f_g */
+        float s0 = -_2q2 * fg1 + _2q1 * fg2;
+        float s1 =  _2q3 * fg1 + _2q0 * fg2 - 4.0f * q1 * fg3;
+        float s2 = -_2q0 * fg1 + _2q3 * fg2 - 4.0f * q2 * fg3;
+        float s3 =  _2q1 * fg1 + _2q2 * fg2;
+        mode = MADGWICK_IMU;
+
+        if (have_mag) {
+            /* Normalize magnetometer */
+            norm = inv_sqrt(mx*mx + my*my + mz*mz);
+            mx *= norm; my *= norm; mz *= norm;
+
+            float q0q0 = q0*q0;
+
+            /* Earth-frame field h = R * m, reference b = [bx 0 bz] */
+            float hx = mx * (q0q0 + q1q1 - q2q2 - q3q3)
+                     + 2.0f * my * (q1q2 - q0q3)
+                     + 2.0f * mz * (q0q2 + q1q3);
+            float hy = 2.0f * mx * (q0q3 + q1q2)
+                     + my * (q0q0 - q1q1 + q2q2 - q3q3)
+                     + 2.0f * mz * (q2q3 - q0q1);
+            float _2bx = sqrtf(hx*hx + hy*hy);
+            float _2bz = 2.0f * mx * (q1q3 - q0q2)
+                       + 2.0f * my * (q0q1 + q2q3)
+                       + mz * (q0q0 - q1q1 - q2q2 + q3q3);
+            float _4bx = 2.0f * _2bx;
+            float _4bz = 2.0f * _2bz;
+
+            /* Field residual f_b = R^T * b - m */
+            float fb1 = _2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx;
+            float fb2 = _2bx * (q1q2 - q0q3)        + _2bz * (q0q1 + q2q3) - my;
+            float fb3 = _2bx * (q0q2 + q1q3)        + _2bz * (0.5f - q1q1 - q2q2) - mz;
+
+            /* Gradient J_b^T * f_b */
+            s0 += -_2bz * q2 * fb1 + (-_2bx * q3 + _2bz * q1) * fb2
+                +  _2bx * q2 * fb3;
+            s1 +=  _2bz * q3 * fb1 + ( _2bx * q2 + _2bz * q0) * fb2
+                + ( _2bx * q3 - _4bz * q1) * fb3;
+            s2 += (-_4bx * q2 - _2bz * q0) * fb1 + (_2bx * q1 + _2bz * q3) * fb2
+                + ( _2bx * q0 - _4bz * q2) * fb3;
+            s3 += (-_4bx * q3 + _2bz * q1) * fb1 + (-_2bx * q0 + _2bz * q2) * fb2
+                +  _2bx * q1 * fb3;
+            mode = MADGWICK_MARG;
+        }
+
+        /* Normalize step and apply feedback (skip if already optimal) */
+        float snorm = s0*s0 + s1*s1 + s2*s2 + s3*s3;
+        if (snorm > 0.0f) {
+            norm = beta * inv_sqrt(snorm);
+            qDot0 -= norm * s0;
+            qDot1 -= norm * s1;
+            qDot2 -= norm * s2;
+            qDot3 -= norm * s3;
+        }
+    }
+
+    /* Integrate quaternion */
+    q0 += qDot0 * dt;
+    q1 += qDot1 * dt;
+    q2 += qDot2 * dt;
+    q3 += qDot3 * dt;
+
+    /* Normalize quaternion */
+    float norm = inv_sqrt(q0*q0 + q1*q1 + q2*q2 + q3*q3);
+    q->q0 = q0 * norm; q->q1 = q1 * norm;
+    q->q2 = q2 * norm; q->q3 = q3 * norm;
+    return mode;
+}
+
+#endif /* AIRMAN_MADGWICK_H */
@@ -8,10 +8,20 @@ This script acts as the Ground Station telemetry ingestion layer
 for the Level-2 AHRS system.
 
 Core Responsibilities:
-- Receive Level-2 telemetry frames via STDIN (pipe mode)
+- Receive Level-2 telemetry frames via STDIN (pipe mode) or a
+  serial port (--serial), either ASCII ($L2,...*CRC) or COBS
+  binary (--binary, plain or delta-compressed); quaternion frames ($L2Q, ahrs_filter --quat)
+  are logged with q0..q3 columns instead of roll / pitch / heading
 - Validate frame integrity using CRC16-CCITT
 - Parse AHRS and environmental data
-- Log validated telemetry into a CSV flight log
+- Log validated telemetry into a CSV flight log and/or a binary
+  fixed-record flight log (--flog, common/flightlog.py)
+- Log the transmitter's loop statistics ($L2S frames: per-stage
+  timing percentiles and overruns) into level2_loop_stats.csv for the
+  dashboard
+- Optionally publish every validated frame to a live feed socket
+  (--feed, common/live_feed.py) that the dashboard blocks on, instead
+  of polling the logs
 
 Design Philosophy:
 - Keep ingestion simple, deterministic, and reliable
@@ -22,6 +32,31 @@ Design Philosophy:
 
 import sys
 import csv
+import argparse
+import binascii
+from pathlib import Path
+
+# Shared binary frame decoder and flight log (common/)
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "common"))
+import binframe
+import flightlog
+import live_feed
+import serial_link
+
+# Telemetry layouts: the first valid frame selects the log columns
+LOG_COLUMNS = {
+    "L2": ["roll", "pitch", "heading", "altitude", "temperature"],
+    "L2Q": ["q0", "q1", "q2", "q3", "altitude", "temperature"],
+}
+# Binary frame type -> tag, and the ASCII precision of each field
+BINARY_TAGS = {binframe.TYPE_L2: "L2", binframe.TYPE_L2Q: "L2Q"}
+FEED_TYPES = {tag: t for t, tag in BINARY_TAGS.items()}
+DECIMALS = {"L2": [2] * 5, "L2Q": [4, 4, 4, 4, 2, 2]}
+
+# $L2S loop statistics, one frame per stage (ahrs_filter.c)
+STATS_CSV_PATH = "level2_loop_stats.csv"
+STATS_COLUMNS = ["stage", "count", "min_us", "p50_us", "p99_us", "max_us",
+                 "overruns"]
 
 # ============================================================
 # CRC16-CCITT IMPLEMENTATION
@@ -42,51 +77,36 @@ def calculate_crc16(payload: str) -> int:
     The checksum is calculated over the exact payload content
     (everything between '$' and '*').
 
+    binascii.crc_hqx implements the same polynomial (0x1021, MSB
+    first) in C with a lookup table, which is far cheaper than a
+    bit-by-bit Python loop at high frame rates.
+
     Args:
         payload (str): Telemetry payload string
 
     Returns:
         int: 16-bit CRC value
     """
-    crc = 0xFFFF
-
-    for ch in payload:
-        crc ^= ord(ch) << 8
-        for _ in range(8):
-            if crc & 0x8000:
-                crc = (crc << 1) ^ 0x1021
-            else:
-                crc <<= 1
-            crc &= 0xFFFF
-
-    return crc
+    return binascii.crc_hqx(payload.encode("latin-1"), 0xFFFF)
 
 # ============================================================
 # TELEMETRY FRAME PARSER
 # ============================================================
 
-def parse_line(line: str):
+def validate_line(line: str):
     """
-    Parse and validate a single Level-2 telemetry frame.
-
-    Expected frame format:
-    $L2,<timestamp_ms>,<roll>,<pitch>,<heading>,<alt>,<temp>*<CRC16>
-
-    Validation steps:
-    1. Check frame start ('$') and checksum delimiter ('*')
-    2. Extract payload and received CRC
-    3. Recalculate CRC and compare
-    4. Validate field count and frame type
-
-    Args:
-        line (str): Raw telemetry line
+    Resync and CRC-check one ASCII frame of any tag.
 
     Returns:
-        tuple or None:
-            (timestamp_ms, roll, pitch, heading, altitude, temperature)
-            if frame is valid, otherwise None
+        list or None: the payload fields (tag first) if the frame is
+        intact, otherwise None
     """
 
+    # Resync past a torn frame: parse from the last '$' before '*'
+    start = line.rfind("$", 0, max(line.rfind("*"), 0))
+    if start > 0:
+        line = line[start:]
+
     # Basic structural validation
     if not line.startswith("$") or "*" not in line:
         return None
@@ -104,16 +124,109 @@ def parse_line(line: str):
     if calculate_crc16(payload) != recv_crc:
         return None
 
-    # Split CSV fields
-    parts = payload.split(",")
+    return payload.split(",")
 
-    # Validate Level-2 frame structure
-    if len(parts) != 7 or parts[0] != "L2":
+def parse_telemetry(parts):
+    """
+    Check validated frame fields against the Level-2 layouts.
+
+    Expected frame formats:
+    $L2,<timestamp_ms>,<roll>,<pitch>,<heading>,<alt>,<temp>*<CRC16>
+    $L2Q,<timestamp_ms>,<q0>,<q1>,<q2>,<q3>,<alt>,<temp>*<CRC16>
+
+    Args:
+        parts: validate_line() result (tag first)
+
+    Returns:
+        tuple or None:
+            (tag, (timestamp_ms, values...)) if the frame is an L2 / L2Q
+            telemetry frame with the right field count, otherwise None
+    """
+    if parts is None or parts[0] not in LOG_COLUMNS:
+        return None
+    if len(parts) != 2 + len(LOG_COLUMNS[parts[0]]):
         return None
+    return parts[0], tuple(parts[1:])
 
-    _, ts, roll, pitch, yaw, alt, temp = parts
+def parse_line(line: str):
+    """
+    Parse and validate a single Level-2 telemetry frame.
 
-    return ts, roll, pitch, yaw, alt, temp
+    Validation steps:
+    1. Check frame start ('$') and checksum delimiter ('*')
+    2. Extract payload and received CRC
+    3. Recalculate CRC and compare
+    4. Validate field count and frame type
+
+    Args:
+        line (str): Raw telemetry line
+
+    Returns:
+        tuple or None: see parse_telemetry()
+    """
+    return parse_telemetry(validate_line(line))
+
+def format_fixed(v, decimals):
+    """
+    v with the given decimals as the transmitter prints it.
+
+    Like numfmt_fixed() (common/numfmt.h), a value that rounds to zero
+    has no sign ("0.00", not "-0.00"), so float and delta frames log the
+    same text as ASCII frames.
+    """
+    text = f"{v:.{decimals}f}"
+    return text[1:] if text.startswith("-") and float(text) == 0 else text
+
+def parse_binary(decoded):
+    """
+    Convert a decoded binary frame into the same tuple as parse_line().
+
+    Floats are rounded to the ASCII frame precision so the CSV log is
+    identical regardless of link format.
+
+    Args:
+        decoded: result of binframe.decode_frame() (or None)
+
+    Returns:
+        tuple or None: (tag, (timestamp_ms, values...))
+    """
+    if decoded is None:
+        return None
+
+    frame_type, fields = decoded
+    if frame_type == binframe.TYPE_DELTA:
+        # Scaled integers at the ASCII precision (ahrs_filter --delta)
+        tag = BINARY_TAGS.get(fields[0])
+        if tag is None or len(fields) != 2 + len(DECIMALS[tag]):
+            return None
+        ts = fields[1]
+        return tag, (ts,) + tuple(format_fixed(q / 10 ** d, d)
+                                  for q, d in zip(fields[2:], DECIMALS[tag]))
+
+    tag = BINARY_TAGS.get(frame_type)
+    if tag is None:
+        return None
+
+    ts = fields[0]
+    return tag, (ts,) + tuple(format_fixed(v, d)
+                              for v, d in zip(fields[1:], DECIMALS[tag]))
+
+def parse_stats(parts=None, decoded=None):
+    """
+    Row for level2_loop_stats.csv from an ASCII $L2S frame (validated
+    fields) or a decoded binary TYPE_L2S frame; None for anything else.
+    Binary values are printed like the ASCII frame.
+    """
+    if parts is not None:
+        if len(parts) == 2 + len(STATS_COLUMNS) and parts[0] == "L2S":
+            return parts[1:]
+        return None
+
+    if decoded is None or decoded[0] != binframe.TYPE_L2S:
+        return None
+    ts, stage, count, *times, overruns = decoded[1]
+    return ([ts, int(stage), int(count)] + [f"{v:.2f}" for v in times] +
+            [int(overruns)])
 
 # ============================================================
 # MAIN LOGGING LOOP
@@ -125,23 +238,122 @@ def parse_line(line: str):
 # Using sys.stdin.buffer ensures compatibility with Windows
 # piping and avoids encoding-related issues.
 #
+# Usage:
+#   ./ahrs_filter | python plot_live.py
+#   ./ahrs_filter --binary | python plot_live.py --binary
+#   ./ahrs_filter --delta | python plot_live.py --binary
+#   ./ahrs_filter | python plot_live.py --flog level2_telemetry.flog
+#   python plot_live.py --serial /dev/ttyUSB0 --baud 921600 [--binary]
+#   ./ahrs_filter | python plot_live.py --feed /tmp/airman.feed
+#
+# With --flog the dashboard memory-maps the binary log and reads only the
+# records appended since its last refresh.
+#
 
-print("📡 Level-2 telemetry logger started")
-print("📁 Logging to level2_telemetry.csv")
-
-with open("level2_telemetry.csv", "w", newline="") as csv_file:
-    writer = csv.writer(csv_file)
-
-    # CSV header mirrors telemetry payload fields
-    writer.writerow(
-        ["timestamp_ms", "roll", "pitch", "heading", "altitude", "temperature"]
-    )
+parser = argparse.ArgumentParser(description="AIRMAN Level-2 logger")
+parser.add_argument("--binary", action="store_true",
+                    help="decode COBS binary frames instead of ASCII")
+parser.add_argument("--flog", metavar="PATH",
+                    help="also write a binary flight log (common/flightlog.py)")
+parser.add_argument("--no-csv", action="store_true",
+                    help="do not write level2_telemetry.csv")
+parser.add_argument("--feed", metavar="SOCKET",
+                    help="publish frames to live subscribers (dash.py --feed)")
+serial_link.add_arguments(parser)
+args = parser.parse_args()
 
+print("📡 Level-2 telemetry logger started")
+if not args.no_csv:
+    print("📁 Logging to level2_telemetry.csv")
+if args.flog:
+    print(f"📁 Logging to {args.flog}")
+if args.feed:
+    print(f"📤 Publishing to {args.feed}")
+
+csv_file = None if args.no_csv else open("level2_telemetry.csv", "w", newline="")
+writer = csv.writer(csv_file) if csv_file else None
+flog = None
+layout = None     # tag of the logged telemetry layout, set by the first frame
+feed = live_feed.LiveFeedPublisher(args.feed) if args.feed else None
+
+
+stats_file = None
+stats_writer = None
+
+
+def log_stats(row):
+    """Append one $L2S row (file created by the first one)."""
+    global stats_file, stats_writer
+    if stats_writer is None:
+        stats_file = open(STATS_CSV_PATH, "w", newline="")
+        stats_writer = csv.writer(stats_file)
+        stats_writer.writerow(["timestamp_ms"] + STATS_COLUMNS)
+    stats_writer.writerow(row)
+    stats_file.flush()
+    if feed:
+        feed.put(binframe.TYPE_L2S, int(row[0]), [float(v) for v in row[1:]])
+        feed.flush()
+
+
+def log_frame(telemetry):
+    """
+    Write one validated frame to every enabled log. The first frame
+    selects the layout (L2 or L2Q) and writes the headers; frames of the
+    other layout are dropped, like telemetry_rx does.
+    """
+    global flog, layout
+    tag, parsed = telemetry
+    if layout is None:
+        layout = tag
+        if writer:
+            # CSV header mirrors telemetry payload fields
+            writer.writerow(["timestamp_ms"] + LOG_COLUMNS[tag])
+        if args.flog:
+            flog = flightlog.FlightLogWriter(args.flog, LOG_COLUMNS[tag])
+    elif tag != layout:
+        return
+
+    if writer:
+        writer.writerow(parsed)
+        csv_file.flush()
+    if flog:
+        flog.append(int(parsed[0]), [float(v) for v in parsed[1:]])
+    if feed:
+        # One message per frame: the Python reader has one frame per wakeup
+        feed.put(FEED_TYPES[tag], int(parsed[0]), [float(v) for v in parsed[1:]])
+        feed.flush()
+
+
+try:
     # Read incoming telemetry frames (pipe mode)
-    for raw in sys.stdin.buffer:
-        line = raw.decode(errors="ignore").strip()
-
-        parsed = parse_line(line)
-        if parsed:
-            writer.writerow(parsed)
-            csv_file.flush()
+    stream = serial_link.open_input(args)
+    if args.binary:
+        for decoded in binframe.iter_frames(stream):
+            parsed = parse_binary(decoded)
+            stats = None if parsed else parse_stats(decoded=decoded)
+            if parsed:
+                log_frame(parsed)
+            elif stats is not None:
+                log_stats(stats)
+    else:
+        for raw in stream:
+            line = raw.decode(errors="ignore").strip()
+
+            parts = validate_line(line)
+            if parts is None:
+                continue
+            telemetry = parse_telemetry(parts)
+            stats = None if telemetry else parse_stats(parts)
+            if telemetry:
+                log_frame(telemetry)
+            elif stats is not None:
+                log_stats(stats)
+finally:
+    if csv_file:
+        csv_file.close()
+    if stats_file:
+        stats_file.close()
+    if flog:
+        flog.close()
+    if feed:
+        feed.close()
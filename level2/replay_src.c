@@ -0,0 +1,261 @@
+/*
+ * replay_src.c
+ *
+ * AIRMAN – Recorded IMU sample source (see replay_src.h)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "imu_log.h"
+#include "numfmt.h"
+#include "replay_src.h"
+
+/* ============================================================
+ * INPUT MAPPING
+ * ============================================================
+ */
+
+int replay_map(replay_map_t *m, const char *path)
+{
+#ifdef _WIN32
+    /* No mmap: read the whole file into memory instead */
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return -1;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    m->heap = malloc(len > 0 ? (size_t)len : 1);
+    m->len  = m->heap ? fread(m->heap, 1, (size_t)len, f) : 0;
+    m->data = m->heap;
+    fclose(f);
+    return m->heap ? 0 : -1;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    m->len  = (size_t)st.st_size;
+    m->data = NULL;
+    if (m->len > 0) {
+        void *p = mmap(NULL, m->len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        /* One front-to-back pass: let the kernel read ahead aggressively */
+        madvise(p, m->len, MADV_SEQUENTIAL);
+        m->data = p;
+    }
+    close(fd);
+    return 0;
+#endif
+}
+
+void replay_unmap(replay_map_t *m)
+{
+#ifdef _WIN32
+    free(m->heap);
+#else
+    if (m->len > 0)
+        munmap((void *)m->data, m->len);
+#endif
+}
+
+/* ============================================================
+ * CSV PARSING
+ * ============================================================
+ *
+ * The mapped file is not NUL-terminated, so strtod() cannot be used
+ * safely at the end of the buffer; numfmt_parse() is bounded by the
+ * end of the line.
+ */
+
+/* Parse "ts,ax,ay,az,gx,gy,gz,..." from [p, eol); 0 on success */
+static int parse_csv_line(const char *p, const char *eol,
+                          int64_t *t_us, imu_sample_t *imu)
+{
+    double v[7];
+
+    for (int i = 0; i < 7; i++) {
+        if (i > 0) {
+            if (p >= eol || *p != ',')
+                return -1;
+            p++;
+        }
+        p = numfmt_parse(p, eol, &v[i]);
+        if (!p)
+            return -1;
+    }
+
+    *t_us      = (int64_t)(v[0] * 1000.0 + (v[0] < 0 ? -0.5 : 0.5));
+    imu->accel = vec3((float)v[1], (float)v[2], (float)v[3]);
+    imu->gyro  = vec3((float)v[4], (float)v[5], (float)v[6]);
+    imu->mag   = vec3(0.0f, 0.0f, 0.0f);
+    imu->t_us  = *t_us;
+    imu->valid = IMU_VALID_ACCEL | IMU_VALID_GYRO;     /* no magnetometer */
+    imu->reserved = 0;
+    return 0;
+}
+
+/* ============================================================
+ * SAMPLE SOURCE
+ * ============================================================
+ */
+
+void replay_src_init(replay_src_t *s, const uint8_t *data, size_t len,
+                     double max_dt)
+{
+    memset(s, 0, sizeof(*s));
+    s->data   = data;
+    s->len    = len;
+    s->p      = data;
+    s->end    = data + len;
+    s->max_dt = (float)max_dt;
+    s->binary = imu_log_version(data, len);
+
+    if (s->binary) {
+        s->p       += sizeof(imu_log_header_t);
+        s->rec_size = s->binary == IMU_LOG_VERSION ? sizeof(imu_log_rec_t)
+                                                   : sizeof(imu_log_rec_v1_t);
+    }
+}
+
+size_t replay_src_boundary(const replay_src_t *s, size_t off)
+{
+    if (s->binary) {
+        size_t base = sizeof(imu_log_header_t);
+        if (off <= base)
+            return base;
+        size_t k = (off - base + s->rec_size - 1) / s->rec_size;
+        size_t b = base + k * s->rec_size;
+        return b < s->len ? b : s->len;
+    }
+
+    if (off == 0)
+        return 0;
+    if (off >= s->len)
+        return s->len;
+    const uint8_t *nl = memchr(s->data + off - 1, '\n', s->len - off + 1);
+    return nl ? (size_t)(nl - s->data) + 1 : s->len;
+}
+
+size_t replay_src_rewind(const replay_src_t *s, size_t off, long n)
+{
+    if (s->binary) {
+        size_t base = sizeof(imu_log_header_t);
+        size_t back = (size_t)n * s->rec_size;
+        return off - base > back ? off - back : base;
+    }
+
+    while (n-- > 0 && off > 0) {
+        off--;                          /* '\n' ending the previous line */
+        while (off > 0 && s->data[off - 1] != '\n')
+            off--;
+    }
+    return off;
+}
+
+void replay_src_range(replay_src_t *s, size_t begin, size_t end)
+{
+    s->p   = s->data + begin;
+    s->end = s->data + (end < s->len ? end : s->len);
+}
+
+/* Next raw sample; 0 on success, -1 at end of input */
+static int src_read(replay_src_t *s, int64_t *t_us, imu_sample_t *imu)
+{
+    if (s->binary == IMU_LOG_VERSION) {
+        if ((size_t)(s->end - s->p) < sizeof(imu_log_rec_t))
+            return -1;
+        memcpy(imu, s->p, sizeof(*imu));
+        s->p += sizeof(*imu);
+        *t_us = imu->t_us;
+        return 0;
+    }
+    if (s->binary) {
+        if ((size_t)(s->end - s->p) < sizeof(imu_log_rec_v1_t))
+            return -1;
+        imu_log_rec_v1_t rec;
+        memcpy(&rec, s->p, sizeof(rec));
+        s->p += sizeof(rec);
+        imu_log_rec_from_v1(&rec, imu);
+        *t_us = rec.t_us;
+        return 0;
+    }
+
+    while (s->p < s->end) {
+        const char *line = (const char *)s->p;
+        const char *eol  = memchr(line, '\n', (size_t)(s->end - s->p));
+        if (!eol)
+            eol = (const char *)s->end;
+        s->p = (const uint8_t *)eol + (eol < (const char *)s->end);
+
+        const char *stop = eol;
+        if (stop > line && stop[-1] == '\r')
+            stop--;
+        if (stop == line)
+            continue;
+
+        if (parse_csv_line(line, stop, t_us, imu) == 0)
+            return 0;
+
+        /* The header row is expected; anything else is counted */
+        if (!(*line >= 'a' && *line <= 'z'))
+            s->bad_lines++;
+    }
+    return -1;
+}
+
+int replay_src_next(replay_src_t *s, imu_sample_t *imu, int64_t *t_us,
+                    float *dt, int max)
+{
+    int n = 0;
+    int64_t t;
+
+    while (n < max && src_read(s, &t, &imu[n]) == 0) {
+        float d = 0.0f;
+
+        if (!s->have_prev) {
+            s->have_prev = 1;
+            s->first_us  = t;
+        } else {
+            d = (float)(t - s->prev_us) * 1e-6f;
+            if (d <= 0.0f) {
+                s->backwards++;
+                d = 0.0f;
+            } else if (d > s->max_dt) {
+                s->gaps++;
+                d = s->prev_dt;
+            } else {
+                s->prev_dt = d;
+            }
+        }
+
+        s->prev_us = t;
+        t_us[n] = t;
+        dt[n]   = d;
+        n++;
+    }
+
+    s->samples += (unsigned long)n;
+    return n;
+}
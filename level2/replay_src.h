@@ -0,0 +1,93 @@
+/*
+ * replay_src.h
+ *
+ * AIRMAN – Recorded IMU Sample Source
+ * -----------------------------------
+ *
+ * Input side of the offline tools (ahrs_replay, ahrs_reprocess): maps a
+ * recorded file and turns it into chunks of IMU samples with the dt
+ * taken from their timestamps.
+ *
+ * Inputs (detected from the file contents):
+ *   - Binary IMU log (imu_log.h, version 1 or 2), e.g. from
+ *     `ahrs_filter --record`
+ *   - Level-1 CSV written by level1/uart_rx.py:
+ *       timestamp_ms,ax,ay,az,gx,gy,gz,alt,temp
+ *     (no magnetometer: the filter runs in IMU-only mode)
+ *
+ * The file is memory-mapped and parsed in place: no read() copies and
+ * no per-line stdio.
+ *
+ * Part of a file:
+ *   replay_src_range() restricts reading to a byte range, so one long
+ *   log can be split among threads. replay_src_boundary() moves an
+ *   offset to the next record (binary) or line (CSV) start and
+ *   replay_src_rewind() steps back a number of samples, for a warm-up
+ *   run ahead of a part. Range changes keep the timing state, so the
+ *   first sample after a warm-up gets its real dt.
+ */
+
+#ifndef AIRMAN_REPLAY_SRC_H
+#define AIRMAN_REPLAY_SRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "imu_sample.h"
+
+typedef struct {
+    const uint8_t *data;
+    size_t         len;
+#ifdef _WIN32
+    void          *heap;
+#endif
+} replay_map_t;
+
+/* Map path read-only (whole file). Returns 0, or -1 (errno set) */
+int  replay_map(replay_map_t *m, const char *path);
+void replay_unmap(replay_map_t *m);
+
+typedef struct {
+    const uint8_t *data, *p, *end;
+    size_t         len;
+    int            binary;        /* IMU log version, 0 for CSV */
+    size_t         rec_size;      /* binary record size */
+
+    int64_t        prev_us;
+    int            have_prev;
+    float          prev_dt;
+    float          max_dt;
+
+    /* Statistics */
+    unsigned long  samples;
+    unsigned long  bad_lines;
+    unsigned long  gaps;          /* dt > max_dt, previous dt reused */
+    unsigned long  backwards;     /* dt <= 0, sample not integrated */
+    int64_t        first_us;
+} replay_src_t;
+
+/*
+ * Read the whole of data[0..len). Intervals longer than max_dt seconds
+ * (log gaps) reuse the previous dt.
+ */
+void replay_src_init(replay_src_t *s, const uint8_t *data, size_t len,
+                     double max_dt);
+
+/* First record / line start at or after byte off */
+size_t replay_src_boundary(const replay_src_t *s, size_t off);
+
+/* Start of the sample n samples before boundary off (not before the first) */
+size_t replay_src_rewind(const replay_src_t *s, size_t off, long n);
+
+/* Continue reading at boundary begin, stop at boundary end */
+void replay_src_range(replay_src_t *s, size_t begin, size_t end);
+
+/*
+ * Fill up to max samples with their times (us) and dt (s). The first
+ * sample only sets the time origin (dt 0). Returns the number of
+ * samples, 0 at the end of the range.
+ */
+int replay_src_next(replay_src_t *s, imu_sample_t *imu, int64_t *t_us,
+                    float *dt, int max);
+
+#endif /* AIRMAN_REPLAY_SRC_H */
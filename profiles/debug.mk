@@ -0,0 +1,10 @@
+# AIRMAN build profile: debug
+#
+# Every feature of the default profile, unoptimized for the debugger,
+# with AddressSanitizer and UBSan.
+
+include profiles/default.mk
+
+OPT      = -Og
+DEBUG    = 1
+SANITIZE = 1
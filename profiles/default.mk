@@ -0,0 +1,46 @@
+# AIRMAN build profile: default
+#
+# The configuration of the hand builds in the readmes: -O2, float AHRS,
+# every link format, table CRC16, noise distribution chosen at run time
+# (--gauss), vector ISA of the compiler's default target.
+#
+# Variables (all profiles; any of them can be set on the command line):
+#
+#   OPT           optimization flags
+#   L1_LOOP_HZ    Level-1 frame rate (telemetry_tx LOOP_HZ)
+#   L2_LOOP_HZ    Level-2 sensor / AHRS rate (ahrs_filter LOOP_HZ)
+#   TELEMETRY_HZ  Level-2 frame rate, divides L2_LOOP_HZ
+#   IMU_BURST     samples per IMU FIFO read (IMU_FIFO_BURST)
+#   FORMATS       link formats built in: ascii binary delta
+#                 (common/build_config.h); the first is the default
+#   L1_CHECKSUM   ASCII frame checksum: xor8 | crc16
+#   L2_CHECKSUM   ASCII frame checksum: xor8 | crc16
+#   FIXED         1: fixed-point Level-2 transmitter (AHRS_FIXED_POINT)
+#   FAST_TRIG     1: polynomial Euler angles (AHRS_FAST_TRIG)
+#   SIMD          base | native | avx2 | avx512 | none (scalar only)
+#   CRC_ENGINE    bitwise | table | slice8 | hw (common/crc16.h)
+#   NOISE         runtime | uniform | gauss (common/sim_noise.h)
+#   LTO           1: link-time optimization across program and library
+#   FASTMATH      1: the IEEE-exact part of -ffast-math (see Makefile)
+#   GC_SECTIONS   1: drop unreferenced functions and data at link time
+#   SANITIZE      1: AddressSanitizer + UBSan
+#   DEBUG         1: debug info
+
+OPT          = -O2
+L1_LOOP_HZ   = 20
+L2_LOOP_HZ   = 200
+TELEMETRY_HZ = 20
+IMU_BURST    = 1
+FORMATS      = ascii binary delta
+L1_CHECKSUM  = xor8
+L2_CHECKSUM  = crc16
+FIXED        = 0
+FAST_TRIG    = 0
+SIMD         = base
+CRC_ENGINE   = table
+NOISE        = runtime
+LTO          = 0
+FASTMATH     = 0
+GC_SECTIONS  = 0
+SANITIZE     = 0
+DEBUG        = 0
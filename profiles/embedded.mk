@@ -0,0 +1,19 @@
+# AIRMAN build profile: embedded
+#
+# Image for an FPU-less flight controller: fixed-point Level-2 filter,
+# binary frames only (the ASCII and delta encoders, txtframe and
+# deltaframe are not linked), uniform noise fixed at build time, scalar
+# code, size optimization, and LTO plus section GC so functions that no
+# path reaches (spare CRC engines, unused library code) are dropped.
+# Build the transmitters with `make PROFILE=embedded tx`.
+
+include profiles/default.mk
+
+OPT         = -Os
+FORMATS     = binary
+FIXED       = 1
+SIMD        = none
+NOISE       = uniform
+LTO         = 1
+FASTMATH    = 1
+GC_SECTIONS = 1
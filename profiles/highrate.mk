@@ -0,0 +1,14 @@
+# AIRMAN build profile: highrate
+#
+# 1 kHz sensor loops for soak testing links and receivers: Level-1
+# frames at 1 kHz, Level-2 AHRS at 1 kHz drained from a 10-sample IMU
+# FIFO with 100 Hz telemetry, binary and delta frames only (ASCII does
+# not fit a 115200 baud link at these rates), release code generation.
+
+include profiles/release.mk
+
+L1_LOOP_HZ   = 1000
+L2_LOOP_HZ   = 1000
+TELEMETRY_HZ = 100
+IMU_BURST    = 10
+FORMATS      = binary delta
@@ -0,0 +1,19 @@
+# AIRMAN build profile: release
+#
+# Host / companion-computer build: -O3 with LTO across the programs and
+# libairman.a, the IEEE-exact fast-math flags, every vector extension
+# of this CPU (not portable to older ones: use SIMD=avx2 / base to ship
+# binaries) and the 8-byte CRC16 engine. `make PROFILE=release pgo`
+# adds profile-guided optimization.
+#
+# The fast-math flags leave seeded output bit-identical to the default
+# profile; FMA from SIMD=native can move the last digit of a value
+# (fused multiply-add rounds once). SIMD=base gives identical output.
+
+include profiles/default.mk
+
+OPT        = -O3
+SIMD       = native
+CRC_ENGINE = slice8
+LTO        = 1
+FASTMATH   = 1